@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+//
+//      AllocationCounter.cpp
+//
+//      Replaces the global operator new/delete for the benchmark executable.
+//      This file is compiled as native code (no /clr).
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "Windows.h"
+#include <stdlib.h>
+#include <new>
+#include "AllocationCounter.h"
+
+static volatile LONG64 s_allocationCount = 0;
+static volatile LONG64 s_allocatedBytes = 0;
+
+void* operator new(size_t _size)
+{
+	InterlockedIncrement64(&s_allocationCount);
+	InterlockedExchangeAdd64(&s_allocatedBytes, (LONG64)_size);
+	void* p = malloc(_size ? _size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* _p)
+{
+	free(_p);
+}
+
+long long OpenZWave::Benchmarks::GetNativeAllocationCount()
+{
+	return InterlockedCompareExchange64(&s_allocationCount, 0, 0);
+}
+
+long long OpenZWave::Benchmarks::GetNativeAllocatedBytes()
+{
+	return InterlockedCompareExchange64(&s_allocatedBytes, 0, 0);
+}
@@ -0,0 +1,39 @@
+//-----------------------------------------------------------------------------
+//
+//      AllocationCounter.h
+//
+//      Counts native heap allocations made through operator new so that the
+//      benchmarks can report allocations and bytes per operation.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+namespace OpenZWave
+{
+	namespace Benchmarks
+	{
+		/// Total number of native allocations made since the process started.
+		long long GetNativeAllocationCount();
+
+		/// Total number of native bytes allocated since the process started.
+		long long GetNativeAllocatedBytes();
+	}
+}
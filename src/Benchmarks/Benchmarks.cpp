@@ -0,0 +1,468 @@
+//-----------------------------------------------------------------------------
+//
+//      Benchmarks.cpp
+//
+//      Micro benchmarks for the hot paths of the .NET wrapper.
+//
+//      The wrapper sources are compiled into this executable against the mock
+//      OpenZWave headers in MockOpenZWave\, so every call goes through the real
+//      ZWManager/ZWValueId/ZWNotification code but never touches a controller.
+//
+//      Usage: OpenZWaveBenchmarks [--filter <text>] [--time <ms>] [--json <file>]
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWManager.h"
+#include "ZWOptions.h"
+#include "ZWNotificationCodec.h"
+#include "AllocationCounter.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Diagnostics;
+using namespace System::Globalization;
+using namespace System::IO;
+using namespace System::Text;
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	namespace Benchmarks
+	{
+		delegate void BenchmarkBody(int32 iterations);
+
+		//-----------------------------------------------------------------------------
+		// Result of a single benchmark run
+		//-----------------------------------------------------------------------------
+		ref class BenchmarkResult sealed
+		{
+		public:
+			String^	Name;
+			int64	Iterations;
+			double	NsPerOp;
+			double	AllocsPerOp;
+			double	BytesPerOp;
+			double	ManagedBytesPerOp;
+		};
+
+		//-----------------------------------------------------------------------------
+		// Runs a benchmark body with enough iterations to fill the time budget
+		//-----------------------------------------------------------------------------
+		ref class BenchmarkRunner sealed
+		{
+		public:
+			BenchmarkRunner(String^ filter, int32 targetMilliseconds) :
+				m_filter(filter),
+				m_targetMilliseconds(targetMilliseconds),
+				m_results(gcnew List<BenchmarkResult^>())
+			{
+				AppDomain::MonitoringIsEnabled = true;
+			}
+
+			property List<BenchmarkResult^>^ Results { List<BenchmarkResult^>^ get() { return m_results; } }
+
+			bool IsSelected(String^ name)
+			{
+				return m_filter == nullptr || name->IndexOf(m_filter, StringComparison::OrdinalIgnoreCase) >= 0;
+			}
+
+			void Run(String^ name, BenchmarkBody^ body)
+			{
+				if (!IsSelected(name))
+					return;
+
+				// Warm up and find an iteration count that runs for roughly the target time
+				int32 iterations = 1;
+				body(iterations);
+				for (;;)
+				{
+					Stopwatch^ probe = Stopwatch::StartNew();
+					body(iterations);
+					probe->Stop();
+					if (probe->ElapsedMilliseconds >= m_targetMilliseconds / 10 || iterations >= (1 << 26))
+					{
+						double perOp = (double)probe->ElapsedTicks / iterations;
+						double target = (double)m_targetMilliseconds * Stopwatch::Frequency / 1000.0;
+						iterations = (int32)Math::Max(1.0, Math::Min(target / Math::Max(perOp, 1e-3), (double)(1 << 28)));
+						break;
+					}
+					iterations *= 2;
+				}
+
+				GC::Collect();
+				GC::WaitForPendingFinalizers();
+				GC::Collect();
+
+				int64 allocs = GetNativeAllocationCount();
+				int64 bytes = GetNativeAllocatedBytes();
+				int64 managed = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize;
+				Stopwatch^ stopwatch = Stopwatch::StartNew();
+				body(iterations);
+				stopwatch->Stop();
+				allocs = GetNativeAllocationCount() - allocs;
+				bytes = GetNativeAllocatedBytes() - bytes;
+				managed = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize - managed;
+
+				BenchmarkResult^ result = gcnew BenchmarkResult();
+				result->Name = name;
+				result->Iterations = iterations;
+				result->NsPerOp = (double)stopwatch->ElapsedTicks * 1.0e9 / Stopwatch::Frequency / iterations;
+				result->AllocsPerOp = (double)allocs / iterations;
+				result->BytesPerOp = (double)bytes / iterations;
+				result->ManagedBytesPerOp = (double)managed / iterations;
+				m_results->Add(result);
+
+				Console::WriteLine(String::Format(CultureInfo::InvariantCulture, "{0,-40} {1,12:F1} ns/op {2,8:F2} allocs/op {3,10:F1} B/op {4,10:F1} managed B/op",
+					name, result->NsPerOp, result->AllocsPerOp, result->BytesPerOp, result->ManagedBytesPerOp));
+			}
+
+			// Records a footprint measurement.  "op" is one node: the native and
+			// managed byte counts are what the wrapper retains per node.
+			void AddFootprint(String^ name, int32 nodes, double allocsPerNode, double bytesPerNode, double managedBytesPerNode)
+			{
+				BenchmarkResult^ result = gcnew BenchmarkResult();
+				result->Name = name;
+				result->Iterations = nodes;
+				result->NsPerOp = 0.0;
+				result->AllocsPerOp = allocsPerNode;
+				result->BytesPerOp = bytesPerNode;
+				result->ManagedBytesPerOp = managedBytesPerNode;
+				m_results->Add(result);
+
+				Console::WriteLine(String::Format(CultureInfo::InvariantCulture, "{0,-40} {1,12} nodes   {2,8:F2} allocs/node {3,8:F1} B/node {4,8:F1} managed B/node",
+					name, nodes, allocsPerNode, bytesPerNode, managedBytesPerNode));
+			}
+
+			void WriteJson(String^ path)
+			{
+				StringBuilder^ json = gcnew StringBuilder();
+				json->Append("{\n");
+				json->AppendFormat(CultureInfo::InvariantCulture, "  \"openzwave\": \"{0}\",\n", ZWManager::Instance->GetVersionAsString());
+				json->AppendFormat(CultureInfo::InvariantCulture, "  \"runtime\": \"{0}\",\n", Environment::Version);
+				json->Append("  \"benchmarks\": [\n");
+				for (int32 i = 0; i < m_results->Count; ++i)
+				{
+					BenchmarkResult^ r = m_results[i];
+					json->AppendFormat(CultureInfo::InvariantCulture,
+						"    {{ \"name\": \"{0}\", \"iterations\": {1}, \"nsPerOp\": {2:F3}, \"allocsPerOp\": {3:F3}, \"bytesPerOp\": {4:F3}, \"managedBytesPerOp\": {5:F3} }}{6}\n",
+						r->Name, r->Iterations, r->NsPerOp, r->AllocsPerOp, r->BytesPerOp, r->ManagedBytesPerOp, (i + 1 < m_results->Count) ? "," : "");
+				}
+				json->Append("  ]\n}\n");
+				File::WriteAllText(path, json->ToString());
+			}
+
+		private:
+			String^						m_filter;
+			int32						m_targetMilliseconds;
+			List<BenchmarkResult^>^		m_results;
+		};
+
+		//-----------------------------------------------------------------------------
+		// The benchmarked hot paths
+		//-----------------------------------------------------------------------------
+		ref class HotPaths abstract sealed
+		{
+		public:
+			static void Setup()
+			{
+				ZWOptions::Instance->Initialize("config/", ".", "");
+				ZWOptions::Instance->AddOptionBool("Logging", false);
+				ZWOptions::Instance->AddOptionInt("PollInterval", 30000);
+				ZWOptions::Instance->AddOptionString("NetworkKey", "0x01,0x02,0x03,0x04", false);
+				ZWOptions::Instance->Lock();
+
+				ZWManager::Instance->Initialize();
+				ZWManager::Instance->NotificationReceived += gcnew NotificationReceivedEventHandler(&HotPaths::OnNotification);
+				Manager::Get()->MockPopulate(HomeId, 32);
+
+				s_bool = CreateId(ValueID::ValueType_Bool);
+				s_byte = CreateId(ValueID::ValueType_Byte);
+				s_decimal = CreateId(ValueID::ValueType_Decimal);
+				s_int = CreateId(ValueID::ValueType_Int);
+				s_short = CreateId(ValueID::ValueType_Short);
+				s_string = CreateId(ValueID::ValueType_String);
+				s_list = CreateId(ValueID::ValueType_List);
+				s_raw = CreateId(ValueID::ValueType_Raw);
+				s_topology = ZWManager::Instance->GetNetworkTopology(HomeId);
+				s_planner = gcnew ZWHealPlanner(HomeId);
+				s_notification = new Notification(Notification::Type_ValueChanged, Manager::MockValueID(HomeId, NodeId, ValueID::ValueType_Int));
+			}
+
+			static void NotificationCapture(int32 n)
+			{
+				for (int32 i = 0; i < n; ++i)
+					s_sink = gcnew ZWNotification(s_notification);
+			}
+
+			static void NotificationDispatch(int32 n)
+			{
+				for (int32 i = 0; i < n; ++i)
+					Manager::Get()->MockNotify(*s_notification);
+			}
+
+			static void ValueIdConstruct(int32 n)
+			{
+				for (int32 i = 0; i < n; ++i)
+					s_sink = gcnew ZWValueId(HomeId, NodeId, ZWValueGenre::User, 0x25, 1, 0, ZWValueType::Bool, 0);
+			}
+
+			static void ValueIdCopy(int32 n)
+			{
+				for (int32 i = 0; i < n; ++i)
+					s_sink = gcnew ZWValueId(s_int->CreateUnmanagedValueID());
+			}
+
+			static void ValueIdCompare(int32 n)
+			{
+				int32 equal = 0;
+				for (int32 i = 0; i < n; ++i)
+				{
+					if (s_int->operator==(s_short))
+						++equal;
+				}
+				s_sink = equal;
+			}
+
+			static void GetValueAsBool(int32 n) { bool v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsBool(s_bool, v); }
+			static void GetValueAsByte(int32 n) { Byte v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsByte(s_byte, v); }
+			static void GetValueAsFloat(int32 n) { float v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsFloat(s_decimal, v); }
+			static void GetValueAsInt(int32 n) { int32 v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsInt(s_int, v); }
+			static void GetValueAsShort(int32 n) { int16 v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsShort(s_short, v); }
+			static void GetValueAsString(int32 n) { String^ v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsString(s_string, v); }
+			static void GetValueListSelection(int32 n) { String^ v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueListSelection(s_list, v); }
+			static void GetValueListItems(int32 n) { cli::array<String^>^ v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueListItems(s_list, v); }
+			static void GetValueAsRaw(int32 n) { cli::array<Byte>^ v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetValueAsRaw(s_raw, v); }
+			static void GetNodeNeighbors(int32 n) { cli::array<Byte>^ v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->GetNodeNeighbors(HomeId, NodeId, v); }
+			static void TopologyBuild(int32 n) { for (int32 i = 0; i < n; ++i) s_sink = ZWManager::Instance->GetNetworkTopology(HomeId); }
+			static void TopologyHopCounts(int32 n) { for (int32 i = 0; i < n; ++i) s_sink = s_topology->GetHopCounts(NodeId); }
+			static void HealPlannerPlan(int32 n) { for (int32 i = 0; i < n; ++i) s_planner->Plan(); }
+			static void AssociationGraph(int32 n) { for (int32 i = 0; i < n; ++i) s_sink = ZWManager::Instance->GetAssociationGraph(HomeId); }
+
+			// The node registry is filled by the NodeAdded notifications of the driver
+			static void NodeRegistrySetup()
+			{
+				for (int32 node = 1; node <= 32; ++node)
+					Manager::Get()->MockNotify(Notification(Notification::Type_NodeAdded, Manager::MockValueID(HomeId, (uint8)node, ValueID::ValueType_Bool)));
+			}
+
+			static void NodeRegistryFindNode(int32 n) { ZWSnapshotNode v; for (int32 i = 0; i < n; ++i) ZWManager::Instance->FindNode(HomeId, NodeId, v); }
+			static void NodeRegistryGetNodeInfo(int32 n) { for (int32 i = 0; i < n; ++i) s_sink = ZWManager::Instance->GetNodeInfo(HomeId, NodeId); }
+
+			// A batch of 256 ValueChanged notifications of an Int, as a gateway
+			// forwards them.  One op encodes or decodes the whole batch.
+			static void CodecSetup()
+			{
+				s_batch = gcnew cli::array<ZWNotification^>(256);
+				for (int32 i = 0; i < s_batch->Length; ++i)
+					s_batch[i] = gcnew ZWNotification(s_notification);
+				s_buffer = gcnew cli::array<Byte>(64 * 1024);
+				int32 length;
+				ZWNotificationCodec::EncodeBatch(s_batch, 0, s_buffer, 0, length);
+				s_encodedLength = length;
+			}
+
+			static void CodecEncode(int32 n)
+			{
+				int32 length;
+				for (int32 i = 0; i < n; ++i)
+					ZWNotificationCodec::EncodeBatch(s_batch, 0, s_buffer, 0, length);
+			}
+
+			static void CodecDecode(int32 n)
+			{
+				int32 consumed;
+				for (int32 i = 0; i < n; ++i)
+					s_sink = ZWNotificationCodec::DecodeBatch(s_buffer, 0, s_encodedLength, consumed);
+			}
+
+			// A full ring of one sample a minute, aggregated into a 32-point sparkline
+			static void HistorySetup()
+			{
+				ZWManager::Instance->ValueHistoryEnabled = true;
+				ValueID valueId = s_int->CreateUnmanagedValueID();
+				for (int64 i = 0; i < 256; ++i)
+					Native::ValueHistory::Record(valueId, i * HistoryStep, (double)(i % 17));
+			}
+
+			static void HistoryAggregate(int32 n) { for (int32 i = 0; i < n; ++i) s_sink = ZWManager::Instance->GetValueHistoryAggregates(s_int, 0, 256 * HistoryStep, 32); }
+			static void HistoryTeardown() { ZWManager::Instance->ValueHistoryEnabled = false; }
+
+			// Detail messages logged into the sink's ring and drained in batches, with no file
+			static void LogSinkSetup() { ZWManager::Instance->StartLogSink(ZWLogLevel::Detail, 0, nullptr); }
+
+			static void LogSinkWrite(int32 n)
+			{
+				for (int32 i = 0; i < n; ++i)
+				{
+					Log::Write(LogLevel_Detail, NodeId, "Received SwitchMultiLevel report: level=%d", i & 0xff);
+					if ((i & 1023) == 1023)
+						ZWManager::Instance->FlushLogSink();
+				}
+			}
+
+			static void LogSinkTeardown() { ZWManager::Instance->StopLogSink(); }
+
+			// ConvertString is private; these go through the thinnest public methods that use it
+			static void ConvertStringToManaged(int32 n) { for (int32 i = 0; i < n; ++i) s_sink = ZWManager::Instance->GetNodeName(HomeId, NodeId); }
+			static void ConvertStringToNative(int32 n) { String^ name = "Living room dimmer"; for (int32 i = 0; i < n; ++i) ZWManager::Instance->SetNodeName(HomeId, NodeId, name); }
+
+			static void GetOptionAsBool(int32 n) { bool v; for (int32 i = 0; i < n; ++i) ZWOptions::Instance->GetOptionAsBool("Logging", &v); }
+			static void GetOptionAsInt(int32 n) { int v; for (int32 i = 0; i < n; ++i) ZWOptions::Instance->GetOptionAsInt("PollInterval", &v); }
+			static void GetOptionAsString(int32 n) { String^ v; for (int32 i = 0; i < n; ++i) ZWOptions::Instance->GetOptionAsString("NetworkKey", &v); }
+
+			// Retains a ZWValueId for every value of a full network, as an application
+			// mirroring the network would, and reports what the wrapper holds per node.
+			// Runs last because it repopulates the mock network.
+			static void MeasureFootprint(BenchmarkRunner^ runner)
+			{
+				String^ name = "Memory.BytesPerNode";
+				if (!runner->IsSelected(name))
+					return;
+
+				int32 const numNodes = 232;
+				Manager::Get()->MockPopulate(HomeId, (uint8)numNodes);
+				ZWManager::Instance->MemoryTrackingEnabled = true;
+
+				List<ZWValueId^>^ retained = gcnew List<ZWValueId^>();
+				GC::Collect();
+				GC::WaitForPendingFinalizers();
+				GC::Collect();
+				int64 managed = GC::GetTotalMemory(true);
+				int64 allocs = GetNativeAllocationCount();
+
+				MockNetwork& network = Manager::Get()->MockGetNetwork();
+				for (map<ValueID, MockValue>::iterator it = network.m_values.begin(); it != network.m_values.end(); ++it)
+				{
+					Manager::Get()->MockNotify(Notification(Notification::Type_ValueAdded, it->first));
+					retained->Add(gcnew ZWValueId(it->first));
+				}
+				s_sink = nullptr;
+
+				allocs = GetNativeAllocationCount() - allocs;
+				managed = GC::GetTotalMemory(true) - managed;
+				ZWMemoryReport^ report = ZWManager::Instance->GetMemoryReport();
+				ZWManager::Instance->MemoryTrackingEnabled = false;
+
+				runner->AddFootprint(name, numNodes, (double)allocs / numNodes, (double)report->NativeBytes / numNodes, (double)managed / numNodes);
+				GC::KeepAlive(retained);
+			}
+
+		private:
+			literal uint32 HomeId = 0xC0FFEE01;
+			literal uint8 NodeId = 5;
+			literal int64 HistoryStep = 60LL * 10000000;		// One minute in file time units
+
+			static ZWValueId^ CreateId(ValueID::ValueType type)
+			{
+				return gcnew ZWValueId(Manager::MockValueID(HomeId, NodeId, type));
+			}
+
+			static void OnNotification(ZWManager^ sender, NotificationReceivedEventArgs^ e)
+			{
+				s_sink = e->Notification;
+			}
+
+			static Object^			s_sink;
+			static ZWValueId^		s_bool;
+			static ZWValueId^		s_byte;
+			static ZWValueId^		s_decimal;
+			static ZWValueId^		s_int;
+			static ZWValueId^		s_short;
+			static ZWValueId^		s_string;
+			static ZWValueId^		s_list;
+			static ZWValueId^		s_raw;
+			static ZWNetworkTopology^	s_topology;
+			static ZWHealPlanner^		s_planner;
+			static Notification*	s_notification;
+			static cli::array<ZWNotification^>^	s_batch;
+			static cli::array<Byte>^	s_buffer;
+			static int32			s_encodedLength;
+		};
+	}
+}
+
+using namespace OpenZWave::Benchmarks;
+
+int main(cli::array<String^>^ args)
+{
+	String^ filter = nullptr;
+	String^ jsonPath = nullptr;
+	int32 targetMilliseconds = 500;
+	for (int32 i = 0; i + 1 < args->Length; i += 2)
+	{
+		if (args[i] == "--filter")
+			filter = args[i + 1];
+		else if (args[i] == "--json")
+			jsonPath = args[i + 1];
+		else if (args[i] == "--time")
+			targetMilliseconds = Int32::Parse(args[i + 1], CultureInfo::InvariantCulture);
+		else
+		{
+			Console::Error->WriteLine("Usage: OpenZWaveBenchmarks [--filter <text>] [--time <ms>] [--json <file>]");
+			return 1;
+		}
+	}
+
+	HotPaths::Setup();
+
+	BenchmarkRunner^ runner = gcnew BenchmarkRunner(filter, targetMilliseconds);
+	runner->Run("Notification.Capture", gcnew BenchmarkBody(&HotPaths::NotificationCapture));
+	runner->Run("Notification.Dispatch", gcnew BenchmarkBody(&HotPaths::NotificationDispatch));
+	HotPaths::CodecSetup();
+	runner->Run("NotificationCodec.EncodeBatch256", gcnew BenchmarkBody(&HotPaths::CodecEncode));
+	runner->Run("NotificationCodec.DecodeBatch256", gcnew BenchmarkBody(&HotPaths::CodecDecode));
+	runner->Run("ValueId.Construct", gcnew BenchmarkBody(&HotPaths::ValueIdConstruct));
+	runner->Run("ValueId.Copy", gcnew BenchmarkBody(&HotPaths::ValueIdCopy));
+	runner->Run("ValueId.Compare", gcnew BenchmarkBody(&HotPaths::ValueIdCompare));
+	runner->Run("GetValueAsBool", gcnew BenchmarkBody(&HotPaths::GetValueAsBool));
+	runner->Run("GetValueAsByte", gcnew BenchmarkBody(&HotPaths::GetValueAsByte));
+	runner->Run("GetValueAsFloat", gcnew BenchmarkBody(&HotPaths::GetValueAsFloat));
+	runner->Run("GetValueAsInt", gcnew BenchmarkBody(&HotPaths::GetValueAsInt));
+	runner->Run("GetValueAsShort", gcnew BenchmarkBody(&HotPaths::GetValueAsShort));
+	runner->Run("GetValueAsString", gcnew BenchmarkBody(&HotPaths::GetValueAsString));
+	runner->Run("GetValueListSelection", gcnew BenchmarkBody(&HotPaths::GetValueListSelection));
+	runner->Run("GetValueListItems", gcnew BenchmarkBody(&HotPaths::GetValueListItems));
+	runner->Run("GetValueAsRaw", gcnew BenchmarkBody(&HotPaths::GetValueAsRaw));
+	runner->Run("GetNodeNeighbors", gcnew BenchmarkBody(&HotPaths::GetNodeNeighbors));
+	runner->Run("Topology.Build", gcnew BenchmarkBody(&HotPaths::TopologyBuild));
+	runner->Run("Topology.HopCounts", gcnew BenchmarkBody(&HotPaths::TopologyHopCounts));
+	runner->Run("HealPlanner.Plan", gcnew BenchmarkBody(&HotPaths::HealPlannerPlan));
+	runner->Run("Associations.Graph", gcnew BenchmarkBody(&HotPaths::AssociationGraph));
+	HotPaths::NodeRegistrySetup();
+	runner->Run("NodeRegistry.FindNode", gcnew BenchmarkBody(&HotPaths::NodeRegistryFindNode));
+	runner->Run("NodeRegistry.GetNodeInfo", gcnew BenchmarkBody(&HotPaths::NodeRegistryGetNodeInfo));
+	HotPaths::HistorySetup();
+	runner->Run("History.Aggregate", gcnew BenchmarkBody(&HotPaths::HistoryAggregate));
+	HotPaths::HistoryTeardown();
+	HotPaths::LogSinkSetup();
+	runner->Run("LogSink.Write", gcnew BenchmarkBody(&HotPaths::LogSinkWrite));
+	HotPaths::LogSinkTeardown();
+	runner->Run("ConvertString.ToManaged", gcnew BenchmarkBody(&HotPaths::ConvertStringToManaged));
+	runner->Run("ConvertString.ToNative", gcnew BenchmarkBody(&HotPaths::ConvertStringToNative));
+	runner->Run("Options.GetOptionAsBool", gcnew BenchmarkBody(&HotPaths::GetOptionAsBool));
+	runner->Run("Options.GetOptionAsInt", gcnew BenchmarkBody(&HotPaths::GetOptionAsInt));
+	runner->Run("Options.GetOptionAsString", gcnew BenchmarkBody(&HotPaths::GetOptionAsString));
+	HotPaths::MeasureFootprint(runner);
+
+	if (jsonPath != nullptr)
+		runner->WriteJson(jsonPath);
+	return 0;
+}
@@ -0,0 +1,50 @@
+//-----------------------------------------------------------------------------
+//
+//      Defs.h
+//
+//      Mock of the OpenZWave basic definitions used by the benchmark build.
+//      Only the subset of the OpenZWave API that the wrapper touches is
+//      provided; see Manager.h for the simulated network.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+
+typedef signed char			int8;
+typedef unsigned char		uint8;
+typedef signed short		int16;
+typedef unsigned short		uint16;
+typedef signed int			int32;
+typedef unsigned int		uint32;
+typedef signed long long	int64;
+typedef unsigned long long	uint64;
+
+using namespace std;
+
+#define OPENZWAVE_MAX_NODES		232
+#define NUM_NODE_BITFIELD_BYTES	29
@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+//
+//      Driver.h
+//
+//      Mock of the OpenZWave Driver class used by the benchmark build.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Driver
+	{
+	public:
+		enum ControllerInterface
+		{
+			ControllerInterface_Unknown = 0,
+			ControllerInterface_Serial,
+			ControllerInterface_Hid
+		};
+
+		enum ControllerState
+		{
+			ControllerState_Normal = 0,
+			ControllerState_Starting,
+			ControllerState_Cancel,
+			ControllerState_Error,
+			ControllerState_Waiting,
+			ControllerState_Sleeping,
+			ControllerState_InProgress,
+			ControllerState_Completed,
+			ControllerState_Failed,
+			ControllerState_NodeOK,
+			ControllerState_NodeFailed
+		};
+
+		// Same fields as OpenZWave 1.6, so the wrapper compiles against either header
+		struct DriverData
+		{
+			uint32	m_SOFCnt;
+			uint32	m_ACKWaiting;
+			uint32	m_readAborts;
+			uint32	m_badChecksum;
+			uint32	m_readCnt;
+			uint32	m_writeCnt;
+			uint32	m_CANCnt;
+			uint32	m_NAKCnt;
+			uint32	m_ACKCnt;
+			uint32	m_OOFCnt;
+			uint32	m_dropped;
+			uint32	m_retries;
+			uint32	m_callbacks;
+			uint32	m_badroutes;
+			uint32	m_noack;
+			uint32	m_netbusy;
+			uint32	m_notidle;
+			uint32	m_txverified;
+			uint32	m_nondelivery;
+			uint32	m_routedbusy;
+			uint32	m_broadcastReadCnt;
+			uint32	m_broadcastWriteCnt;
+		};
+	};
+}
@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------
+//
+//      Log.h
+//
+//      Mock of the OpenZWave Log class used by the benchmark build.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstdarg>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	enum LogLevel
+	{
+		LogLevel_Invalid,
+		LogLevel_None,
+		LogLevel_Always,
+		LogLevel_Fatal,
+		LogLevel_Error,
+		LogLevel_Warning,
+		LogLevel_Alert,
+		LogLevel_Info,
+		LogLevel_Detail,
+		LogLevel_Debug,
+		LogLevel_StreamDetail,
+		LogLevel_Internal
+	};
+
+	class i_LogImpl
+	{
+	public:
+		i_LogImpl() {}
+		virtual ~i_LogImpl() {}
+		virtual void Write(LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args) = 0;
+		virtual void QueueDump() = 0;
+		virtual void QueueClear() = 0;
+		virtual void SetLoggingState(LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger) = 0;
+		virtual void SetLogFileName(const string &_filename) = 0;
+	};
+
+	class Log
+	{
+	public:
+		static bool SetLoggingClass(i_LogImpl *_logClass) { delete Impl(); Impl() = _logClass; return true; }
+		static void SetLoggingState(bool _dologging) { State() = _dologging; }
+		static bool GetLoggingState() { return State(); }
+		static void SetLogFileName(const string &_filename) { FileName() = _filename; }
+
+		static void Write(LogLevel _level, uint8 const _nodeId, char const* _format, ...)
+		{
+			if (State() && Impl() != NULL)
+			{
+				va_list args;
+				va_start(args, _format);
+				Impl()->Write(_level, _nodeId, _format, args);
+				va_end(args);
+			}
+		}
+
+	private:
+		static bool& State() { static bool s_state = false; return s_state; }
+		static string& FileName() { static string s_fileName; return s_fileName; }
+		static i_LogImpl*& Impl() { static i_LogImpl* s_impl = NULL; return s_impl; }
+	};
+}
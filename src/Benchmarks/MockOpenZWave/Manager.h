@@ -0,0 +1,540 @@
+//-----------------------------------------------------------------------------
+//
+//      Manager.h
+//
+//      Mock of the OpenZWave Manager class used by the benchmark build.
+//
+//      Every Manager method called by the wrapper is implemented here against
+//      a simulated in-memory network (MockNetwork).  No serial port is opened
+//      and no Z-Wave traffic is generated, so the benchmarks measure only the
+//      cost of the wrapper itself plus a cheap, predictable lookup.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Defs.h"
+#include "ValueID.h"
+#include "Notification.h"
+#include "Options.h"
+#include "Driver.h"
+#include "Node.h"
+#include "Log.h"
+
+namespace OpenZWave
+{
+	//-----------------------------------------------------------------------------
+	// Simulated network state
+	//-----------------------------------------------------------------------------
+	struct MockValue
+	{
+		MockValue() : m_readOnly(false), m_polled(false), m_intensity(0), m_bool(false), m_byte(0), m_int(0), m_short(0), m_float(0.0f), m_selection(0) {}
+
+		string			m_label;
+		string			m_units;
+		string			m_help;
+		bool			m_readOnly;
+		bool			m_polled;
+		uint8			m_intensity;
+		bool			m_bool;
+		uint8			m_byte;
+		int32			m_int;
+		int16			m_short;
+		float			m_float;
+		string			m_string;
+		vector<string>	m_items;
+		vector<int32>	m_itemValues;
+		int32			m_selection;
+		vector<uint8>	m_raw;
+	};
+
+	struct MockGroup
+	{
+		string			m_label;
+		uint8			m_maxAssociations;
+		bool			m_multiInstance;
+		vector<uint8>	m_targets;
+	};
+
+	struct MockNode
+	{
+		MockNode() : m_exists(false), m_listening(true), m_failed(false), m_basic(4), m_generic(0x10), m_specific(1), m_version(4), m_security(0), m_stats()
+		{
+			memset(m_neighbors, 0, sizeof(m_neighbors));
+		}
+
+		bool				m_exists;
+		bool				m_listening;
+		bool				m_failed;
+		uint8				m_basic;
+		uint8				m_generic;
+		uint8				m_specific;
+		uint8				m_version;
+		uint8				m_security;
+		string				m_name;
+		string				m_location;
+		string				m_manufacturerName;
+		string				m_productName;
+		string				m_manufacturerId;
+		string				m_productType;
+		string				m_productId;
+		uint8				m_neighbors[NUM_NODE_BITFIELD_BYTES];
+		vector<MockGroup>	m_groups;
+		Node::NodeData		m_stats;
+	};
+
+	struct MockNetwork
+	{
+		MockNetwork() : m_homeId(0), m_controllerNodeId(1) {}
+
+		uint32						m_homeId;
+		uint8						m_controllerNodeId;
+		MockNode					m_nodes[OPENZWAVE_MAX_NODES + 1];
+		map<ValueID, MockValue>		m_values;
+	};
+
+	//-----------------------------------------------------------------------------
+	// Manager
+	//-----------------------------------------------------------------------------
+	class Manager
+	{
+	public:
+		typedef void(*pfnOnNotification_t)(Notification const* _pNotification, void* _context);
+
+		static Manager* Create()
+		{
+			if (s_instance() == NULL)
+				s_instance() = new Manager();
+			return s_instance();
+		}
+		static Manager* Get() { return s_instance(); }
+		static void Destroy()
+		{
+			delete s_instance();
+			s_instance() = NULL;
+		}
+
+		static string getVersionAsString() { return "1.6.0-mock"; }
+
+		bool AddWatcher(pfnOnNotification_t _watcher, void* _context)
+		{
+			Watcher watcher = { _watcher, _context };
+			m_watchers.push_back(watcher);
+			return true;
+		}
+
+		//-----------------------------------------------------------------------------
+		// Mock control
+		//-----------------------------------------------------------------------------
+
+		// Build a network of _numNodes nodes, each of which has one value of every
+		// type the wrapper can read, two association groups and a handful of neighbors.
+		// Every tenth node has poor statistics and every fiftieth node has failed.
+		void MockPopulate(uint32 const _homeId, uint8 const _numNodes)
+		{
+			m_network = MockNetwork();
+			m_network.m_homeId = _homeId;
+			for (uint32 n = 1; n <= _numNodes; ++n)
+			{
+				MockNode& node = m_network.m_nodes[n];
+				node.m_exists = true;
+				node.m_listening = (n % 4) != 0;
+				node.m_name = "Node " + to_string(n);
+				node.m_location = "Room " + to_string(n % 16);
+				node.m_manufacturerName = "Aeotec";
+				node.m_productName = "Multisensor 6";
+				node.m_manufacturerId = "0x0086";
+				node.m_productType = "0x0102";
+				node.m_productId = "0x0064";
+				node.m_failed = (n % 50) == 0;
+				node.m_stats.m_sentCnt = 100;
+				node.m_stats.m_sentFailed = (n % 10) == 0 ? 20 : 0;
+				node.m_stats.m_retries = (n % 10) == 0 ? 40 : 2;
+				node.m_stats.m_averageRequestRTT = (n % 10) == 0 ? 1200 : 80;
+				for (uint32 k = 1; k <= 4; ++k)
+				{
+					uint32 neighbor = ((n + k * 7 - 1) % _numNodes) + 1;
+					if (neighbor != n)
+						node.m_neighbors[(neighbor - 1) >> 3] |= (uint8)(1 << ((neighbor - 1) & 7));
+				}
+				for (uint8 g = 1; g <= 2; ++g)
+				{
+					MockGroup group;
+					group.m_label = (g == 1) ? "Lifeline" : "Basic Set";
+					group.m_maxAssociations = 5;
+					group.m_multiInstance = false;
+					group.m_targets.push_back(m_network.m_controllerNodeId);
+					node.m_groups.push_back(group);
+				}
+				for (uint8 t = ValueID::ValueType_Bool; t <= ValueID::ValueType_Raw; ++t)
+				{
+					MockValue value;
+					value.m_label = "Value " + to_string(t);
+					value.m_units = "C";
+					value.m_help = "Simulated value";
+					value.m_bool = true;
+					value.m_byte = 99;
+					value.m_int = 123456;
+					value.m_short = 1234;
+					value.m_float = 21.5f;
+					value.m_string = "21.50";
+					if (t == ValueID::ValueType_List)
+					{
+						for (int32 i = 0; i < 8; ++i)
+						{
+							value.m_items.push_back("Item " + to_string(i));
+							value.m_itemValues.push_back(i);
+						}
+						value.m_selection = 3;
+					}
+					if (t == ValueID::ValueType_Raw)
+					{
+						value.m_raw.assign(16, 0xA5);
+					}
+					m_network.m_values[MockValueID(_homeId, (uint8)n, (ValueID::ValueType)t)] = value;
+				}
+			}
+		}
+
+		// The ValueID that MockPopulate created for the given node and value type.
+		static ValueID MockValueID(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueType const _type)
+		{
+			return ValueID(_homeId, _nodeId, ValueID::ValueGenre_User, (uint8)(0x20 + _type), 1, 0, _type);
+		}
+
+		// Deliver a notification to every watcher, as the driver thread would.
+		void MockNotify(Notification const& _notification)
+		{
+			for (size_t i = 0; i < m_watchers.size(); ++i)
+			{
+				m_watchers[i].m_callback(&_notification, m_watchers[i].m_context);
+			}
+		}
+
+		MockNetwork& MockGetNetwork() { return m_network; }
+
+		//-----------------------------------------------------------------------------
+		// Drivers
+		//-----------------------------------------------------------------------------
+		bool AddDriver(string const& _controllerPath, Driver::ControllerInterface const& _interface = Driver::ControllerInterface_Serial) { m_controllerPath = _controllerPath; return true; }
+		bool RemoveDriver(string const& _controllerPath) { return true; }
+		void WriteConfig(uint32 const _homeId) {}
+		uint8 GetControllerNodeId(uint32 const _homeId) { return m_network.m_controllerNodeId; }
+		uint8 GetSUCNodeId(uint32 const _homeId) { return m_network.m_controllerNodeId; }
+		bool IsPrimaryController(uint32 const _homeId) { return true; }
+		bool IsStaticUpdateController(uint32 const _homeId) { return true; }
+		bool IsBridgeController(uint32 const _homeId) { return false; }
+		string GetLibraryVersion(uint32 const _homeId) { return "Z-Wave 4.05"; }
+		string GetLibraryTypeName(uint32 const _homeId) { return "Static Controller"; }
+		int32 GetSendQueueCount(uint32 const _homeId) { return 0; }
+		void LogDriverStatistics(uint32 const _homeId) {}
+		void GetDriverStatistics(uint32 const _homeId, Driver::DriverData* _data) { memset(_data, 0, sizeof(*_data)); }
+		Driver::ControllerInterface GetControllerInterfaceType(uint32 const _homeId) { return Driver::ControllerInterface_Serial; }
+		string GetControllerPath(uint32 const _homeId) { return m_controllerPath; }
+
+		//-----------------------------------------------------------------------------
+		// Polling
+		//-----------------------------------------------------------------------------
+		int32 GetPollInterval() { return m_pollInterval; }
+		void SetPollInterval(int32 _milliseconds, bool _bIntervalBetweenPolls) { m_pollInterval = _milliseconds; }
+		bool EnablePoll(ValueID const& _valueId, uint8 const _intensity = 1)
+		{
+			MockValue* value = Find(_valueId);
+			if (value == NULL)
+				return false;
+			value->m_polled = true;
+			value->m_intensity = _intensity;
+			return true;
+		}
+		bool DisablePoll(ValueID const& _valueId)
+		{
+			MockValue* value = Find(_valueId);
+			if (value == NULL)
+				return false;
+			value->m_polled = false;
+			value->m_intensity = 0;
+			return true;
+		}
+		bool isPolled(ValueID const& _valueId) { MockValue* value = Find(_valueId); return value != NULL && value->m_polled; }
+		void SetPollIntensity(ValueID const& _valueId, uint8 const _intensity) { MockValue* value = Find(_valueId); if (value != NULL) value->m_intensity = _intensity; }
+		uint8 GetPollIntensity(ValueID const& _valueId) { MockValue* value = Find(_valueId); return value != NULL ? value->m_intensity : 0; }
+
+		//-----------------------------------------------------------------------------
+		// Node information
+		//-----------------------------------------------------------------------------
+		bool RefreshNodeInfo(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool RequestNodeState(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool RequestNodeDynamic(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool IsNodeListeningDevice(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_listening; }
+		bool IsNodeFrequentListeningDevice(uint32 const _homeId, uint8 const _nodeId) { return false; }
+		bool IsNodeBeamingDevice(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool IsNodeRoutingDevice(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_listening; }
+		bool IsNodeSecurityDevice(uint32 const _homeId, uint8 const _nodeId) { return false; }
+		bool IsNodeZWavePlus(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		uint32 GetNodeMaxBaudRate(uint32 const _homeId, uint8 const _nodeId) { return 100000; }
+		uint8 GetNodeVersion(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_version; }
+		uint8 GetNodeSecurity(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_security; }
+		uint8 GetNodeBasic(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_exists ? Node(_nodeId).m_basic : 0; }
+		uint8 GetNodeGeneric(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_generic; }
+		uint8 GetNodeSpecific(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_specific; }
+		string GetNodeType(uint32 const _homeId, uint8 const _nodeId) { return "Binary Switch"; }
+		uint32 GetNodeNeighbors(uint32 const _homeId, uint8 const _nodeId, uint8** o_neighbors)
+		{
+			MockNode const& node = Node(_nodeId);
+			uint32 numNeighbors = 0;
+			for (uint32 i = 0; i < NUM_NODE_BITFIELD_BYTES; ++i)
+			{
+				for (uint32 b = 0; b < 8; ++b)
+				{
+					if (node.m_neighbors[i] & (1 << b))
+						++numNeighbors;
+				}
+			}
+			if (numNeighbors == 0)
+			{
+				*o_neighbors = NULL;
+				return 0;
+			}
+			uint8* neighbors = new uint8[numNeighbors];
+			uint32 index = 0;
+			for (uint32 i = 0; i < NUM_NODE_BITFIELD_BYTES; ++i)
+			{
+				for (uint32 b = 0; b < 8; ++b)
+				{
+					if (node.m_neighbors[i] & (1 << b))
+						neighbors[index++] = (uint8)(i * 8 + b + 1);
+				}
+			}
+			*o_neighbors = neighbors;
+			return numNeighbors;
+		}
+		string GetNodeManufacturerName(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_manufacturerName; }
+		string GetNodeProductName(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_productName; }
+		string GetNodeName(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_name; }
+		string GetNodeLocation(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_location; }
+		string GetNodeManufacturerId(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_manufacturerId; }
+		string GetNodeProductType(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_productType; }
+		string GetNodeProductId(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_productId; }
+		void SetNodeManufacturerName(uint32 const _homeId, uint8 const _nodeId, string const& _manufacturerName) { Node(_nodeId).m_manufacturerName = _manufacturerName; }
+		void SetNodeProductName(uint32 const _homeId, uint8 const _nodeId, string const& _productName) { Node(_nodeId).m_productName = _productName; }
+		void SetNodeName(uint32 const _homeId, uint8 const _nodeId, string const& _nodeName) { Node(_nodeId).m_name = _nodeName; }
+		void SetNodeLocation(uint32 const _homeId, uint8 const _nodeId, string const& _location) { Node(_nodeId).m_location = _location; }
+		bool IsNodeInfoReceived(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_exists; }
+		bool GetNodeClassInformation(uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, string* o_name = NULL, uint8* o_version = NULL)
+		{
+			if (o_name != NULL)
+				*o_name = "COMMAND_CLASS_MOCK";
+			if (o_version != NULL)
+				*o_version = 1;
+			return true;
+		}
+		bool IsNodeAwake(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_listening; }
+		bool IsNodeFailed(uint32 const _homeId, uint8 const _nodeId) { return Node(_nodeId).m_failed; }
+		string GetNodeQueryStage(uint32 const _homeId, uint8 const _nodeId) { return "Complete"; }
+		void GetNodeStatistics(uint32 const _homeId, uint8 const _nodeId, Node::NodeData* _data) { *_data = Node(_nodeId).m_stats; }
+
+		//-----------------------------------------------------------------------------
+		// Values
+		//-----------------------------------------------------------------------------
+		string GetValueLabel(ValueID const& _id, int32 _pos = -1) { MockValue* value = Find(_id); return value != NULL ? value->m_label : string(); }
+		void SetValueLabel(ValueID const& _id, string const& _value, int32 _pos = -1) { MockValue* value = Find(_id); if (value != NULL) value->m_label = _value; }
+		string GetValueUnits(ValueID const& _id) { MockValue* value = Find(_id); return value != NULL ? value->m_units : string(); }
+		string GetValueHelp(ValueID const& _id, int32 _pos = -1) { MockValue* value = Find(_id); return value != NULL ? value->m_help : string(); }
+		void SetValueHelp(ValueID const& _id, string const& _value, int32 _pos = -1) { MockValue* value = Find(_id); if (value != NULL) value->m_help = _value; }
+		bool IsValueReadOnly(ValueID const& _id) { MockValue* value = Find(_id); return value != NULL && value->m_readOnly; }
+		bool IsValueSet(ValueID const& _id) { return Find(_id) != NULL; }
+		bool IsValuePolled(ValueID const& _id) { return isPolled(_id); }
+
+		bool GetValueAsBool(ValueID const& _id, bool* o_value) { MockValue* value = Find(_id, ValueID::ValueType_Bool); if (value == NULL) return false; *o_value = value->m_bool; return true; }
+		bool GetValueAsByte(ValueID const& _id, uint8* o_value) { MockValue* value = Find(_id, ValueID::ValueType_Byte); if (value == NULL) return false; *o_value = value->m_byte; return true; }
+		bool GetValueAsFloat(ValueID const& _id, float* o_value) { MockValue* value = Find(_id, ValueID::ValueType_Decimal); if (value == NULL) return false; *o_value = value->m_float; return true; }
+		bool GetValueAsInt(ValueID const& _id, int32* o_value) { MockValue* value = Find(_id, ValueID::ValueType_Int); if (value == NULL) return false; *o_value = value->m_int; return true; }
+		bool GetValueAsShort(ValueID const& _id, int16* o_value) { MockValue* value = Find(_id, ValueID::ValueType_Short); if (value == NULL) return false; *o_value = value->m_short; return true; }
+		bool GetValueAsString(ValueID const& _id, string* o_value) { MockValue* value = Find(_id); if (value == NULL) return false; *o_value = value->m_string; return true; }
+		bool GetValueAsRaw(ValueID const& _id, uint8** o_value, uint8* o_length)
+		{
+			MockValue* value = Find(_id, ValueID::ValueType_Raw);
+			if (value == NULL)
+				return false;
+			*o_length = (uint8)value->m_raw.size();
+			*o_value = new uint8[*o_length];
+			memcpy(*o_value, value->m_raw.data(), *o_length);
+			return true;
+		}
+		bool GetValueAsBitSet(ValueID const& _id, uint8 _pos, bool* o_value) { MockValue* value = Find(_id); if (value == NULL) return false; *o_value = ((value->m_int >> _pos) & 1) != 0; return true; }
+		bool GetValueListSelection(ValueID const& _id, string* o_value) { MockValue* value = Find(_id, ValueID::ValueType_List); if (value == NULL) return false; *o_value = value->m_items[value->m_selection]; return true; }
+		bool GetValueListSelection(ValueID const& _id, int32* o_value) { MockValue* value = Find(_id, ValueID::ValueType_List); if (value == NULL) return false; *o_value = value->m_itemValues[value->m_selection]; return true; }
+		bool GetValueListItems(ValueID const& _id, vector<string>* o_value) { MockValue* value = Find(_id, ValueID::ValueType_List); if (value == NULL) return false; *o_value = value->m_items; return true; }
+		bool GetValueListValues(ValueID const& _id, vector<int32>* o_value) { MockValue* value = Find(_id, ValueID::ValueType_List); if (value == NULL) return false; *o_value = value->m_itemValues; return true; }
+
+		bool SetValue(ValueID const& _id, bool const _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_bool = _value; return true; }
+		bool SetValue(ValueID const& _id, uint8 const _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_byte = _value; return true; }
+		bool SetValue(ValueID const& _id, float const _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_float = _value; return true; }
+		bool SetValue(ValueID const& _id, int32 const _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_int = _value; return true; }
+		bool SetValue(ValueID const& _id, int16 const _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_short = _value; return true; }
+		bool SetValue(ValueID const& _id, uint8 const* _value, uint8 const _length) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_raw.assign(_value, _value + _length); return true; }
+		bool SetValue(ValueID const& _id, string const& _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_string = _value; return true; }
+		bool SetValue(ValueID const& _id, uint8 _pos, bool const _value) { MockValue* value = Find(_id); if (value == NULL) return false; value->m_int = _value ? (value->m_int | (1 << _pos)) : (value->m_int & ~(1 << _pos)); return true; }
+		bool SetBitMask(ValueID const& _id, uint32 _mask) { return Find(_id) != NULL; }
+		bool GetBitMask(ValueID const& _id, int32* o_mask) { if (Find(_id) == NULL) return false; *o_mask = -1; return true; }
+		bool GetBitSetSize(ValueID const& _id, uint8* o_size) { if (Find(_id) == NULL) return false; *o_size = 4; return true; }
+		bool SetValueListSelection(ValueID const& _id, string const& _selectedItem)
+		{
+			MockValue* value = Find(_id, ValueID::ValueType_List);
+			if (value == NULL)
+				return false;
+			for (size_t i = 0; i < value->m_items.size(); ++i)
+			{
+				if (value->m_items[i] == _selectedItem)
+				{
+					value->m_selection = (int32)i;
+					return true;
+				}
+			}
+			return false;
+		}
+		bool RefreshValue(ValueID const& _id) { return Find(_id) != NULL; }
+		void SetChangeVerified(ValueID const& _id, bool _verify) {}
+		bool PressButton(ValueID const& _id) { return Find(_id) != NULL; }
+		bool ReleaseButton(ValueID const& _id) { return Find(_id) != NULL; }
+
+		//-----------------------------------------------------------------------------
+		// Climate Control Schedules
+		//-----------------------------------------------------------------------------
+		uint8 GetNumSwitchPoints(ValueID const& _id) { return 0; }
+		bool SetSwitchPoint(ValueID const& _id, uint8 const _hours, uint8 const _minutes, int8 const _setback) { return true; }
+		bool RemoveSwitchPoint(ValueID const& _id, uint8 const _hours, uint8 const _minutes) { return true; }
+		void ClearSwitchPoints(ValueID const& _id) {}
+		bool GetSwitchPoint(ValueID const& _id, uint8 const _idx, uint8* o_hours, uint8* o_minutes, int8* o_setback) { return false; }
+
+		//-----------------------------------------------------------------------------
+		// Configuration Parameters
+		//-----------------------------------------------------------------------------
+		bool SetConfigParam(uint32 const _homeId, uint8 const _nodeId, uint8 const _param, int32 _value, uint8 const _size = 2) { return true; }
+		void RequestConfigParam(uint32 const _homeId, uint8 const _nodeId, uint8 const _param) {}
+		void RequestAllConfigParams(uint32 const _homeId, uint8 const _nodeId) {}
+
+		//-----------------------------------------------------------------------------
+		// Groups
+		//-----------------------------------------------------------------------------
+		uint8 GetNumGroups(uint32 const _homeId, uint8 const _nodeId) { return (uint8)Node(_nodeId).m_groups.size(); }
+		uint32 GetAssociations(uint32 const _homeId, uint8 const _nodeId, uint8 const _groupIdx, uint8** o_associations)
+		{
+			MockGroup* group = Group(_nodeId, _groupIdx);
+			if (group == NULL || group->m_targets.empty())
+			{
+				*o_associations = NULL;
+				return 0;
+			}
+			*o_associations = new uint8[group->m_targets.size()];
+			memcpy(*o_associations, group->m_targets.data(), group->m_targets.size());
+			return (uint32)group->m_targets.size();
+		}
+		uint8 GetMaxAssociations(uint32 const _homeId, uint8 const _nodeId, uint8 const _groupIdx) { MockGroup* group = Group(_nodeId, _groupIdx); return group != NULL ? group->m_maxAssociations : 0; }
+		bool IsMultiInstance(uint32 const _homeId, uint8 const _nodeId, uint8 const _groupIdx) { MockGroup* group = Group(_nodeId, _groupIdx); return group != NULL && group->m_multiInstance; }
+		string GetGroupLabel(uint32 const _homeId, uint8 const _nodeId, uint8 const _groupIdx) { MockGroup* group = Group(_nodeId, _groupIdx); return group != NULL ? group->m_label : string(); }
+		void AddAssociation(uint32 const _homeId, uint8 const _nodeId, uint8 const _groupIdx, uint8 const _targetNodeId, uint8 const _instance = 0x00)
+		{
+			MockGroup* group = Group(_nodeId, _groupIdx);
+			if (group != NULL)
+				group->m_targets.push_back(_targetNodeId);
+		}
+		void RemoveAssociation(uint32 const _homeId, uint8 const _nodeId, uint8 const _groupIdx, uint8 const _targetNodeId, uint8 const _instance = 0x00)
+		{
+			MockGroup* group = Group(_nodeId, _groupIdx);
+			if (group == NULL)
+				return;
+			for (vector<uint8>::iterator it = group->m_targets.begin(); it != group->m_targets.end(); ++it)
+			{
+				if (*it == _targetNodeId)
+				{
+					group->m_targets.erase(it);
+					return;
+				}
+			}
+		}
+
+		//-----------------------------------------------------------------------------
+		// Network and controller commands
+		//-----------------------------------------------------------------------------
+		void ResetController(uint32 const _homeId) {}
+		void SoftReset(uint32 const _homeId) {}
+		bool CancelControllerCommand(uint32 const _homeId) { return true; }
+		void TestNetworkNode(uint32 const _homeId, uint8 const _nodeId, uint32 const _count) {}
+		void TestNetwork(uint32 const _homeId, uint32 const _count) {}
+		void HealNetworkNode(uint32 const _homeId, uint8 const _nodeId, bool _doRR) {}
+		void HealNetwork(uint32 const _homeId, bool _doRR) {}
+		bool AddNode(uint32 const _homeId, bool _doSecurity = true) { return true; }
+		bool RemoveNode(uint32 const _homeId) { return true; }
+		bool RemoveFailedNode(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool HasNodeFailed(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool AssignReturnRoute(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool RequestNodeNeighborUpdate(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool DeleteAllReturnRoutes(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool SendNodeInformation(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool CreateNewPrimary(uint32 const _homeId) { return true; }
+		bool ReceiveConfiguration(uint32 const _homeId) { return true; }
+		bool ReplaceFailedNode(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool TransferPrimaryRole(uint32 const _homeId) { return true; }
+		bool RequestNetworkUpdate(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool ReplicationSend(uint32 const _homeId, uint8 const _nodeId) { return true; }
+		bool CreateButton(uint32 const _homeId, uint8 const _nodeId, uint8 const _buttonid) { return true; }
+		bool DeleteButton(uint32 const _homeId, uint8 const _nodeId, uint8 const _buttonid) { return true; }
+
+	private:
+		struct Watcher
+		{
+			pfnOnNotification_t	m_callback;
+			void*				m_context;
+		};
+
+		Manager() : m_pollInterval(30000) {}
+
+		static Manager*& s_instance() { static Manager* s_manager = NULL; return s_manager; }
+
+		MockNode& Node(uint8 const _nodeId) { return m_network.m_nodes[_nodeId]; }
+
+		MockGroup* Group(uint8 const _nodeId, uint8 const _groupIdx)
+		{
+			MockNode& node = Node(_nodeId);
+			if (_groupIdx == 0 || _groupIdx > node.m_groups.size())
+				return NULL;
+			return &node.m_groups[_groupIdx - 1];
+		}
+
+		MockValue* Find(ValueID const& _id)
+		{
+			map<ValueID, MockValue>::iterator it = m_network.m_values.find(_id);
+			return (it == m_network.m_values.end()) ? NULL : &it->second;
+		}
+
+		MockValue* Find(ValueID const& _id, ValueID::ValueType const _type)
+		{
+			if (_id.GetType() != _type)
+				return NULL;
+			return Find(_id);
+		}
+
+		MockNetwork			m_network;
+		vector<Watcher>		m_watchers;
+		string				m_controllerPath;
+		int32				m_pollInterval;
+	};
+}
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+//
+//      Node.h
+//
+//      Mock of the OpenZWave Node class used by the benchmark build.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <list>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Node
+	{
+	public:
+		struct CommandClassData
+		{
+			uint8	m_commandClassId;
+			uint32	m_sentCnt;
+			uint32	m_receivedCnt;
+		};
+
+		// Same fields as OpenZWave 1.6, so the wrapper compiles against either header
+		struct NodeData
+		{
+			uint32	m_sentCnt;
+			uint32	m_sentFailed;
+			uint32	m_retries;
+			uint32	m_receivedCnt;
+			uint32	m_receivedDups;
+			uint32	m_receivedUnsolicited;
+			string	m_sentTS;
+			string	m_receivedTS;
+			uint32	m_lastRequestRTT;
+			uint32	m_averageRequestRTT;
+			uint32	m_lastResponseRTT;
+			uint32	m_averageResponseRTT;
+			uint8	m_quality;
+			uint8	m_lastReceivedMessage[254];
+			list<CommandClassData>	m_ccData;
+			bool	m_txStatusReportSupported;
+			uint16	m_txTime;
+			uint8	m_hops;
+			char	m_rssi_1[8];
+			char	m_rssi_2[8];
+			char	m_rssi_3[8];
+			char	m_rssi_4[8];
+			char	m_rssi_5[8];
+			uint8	m_ackChannel;
+			uint8	m_lastTxChannel;
+			uint8	m_routeScheme;
+			uint8	m_routeUsed[4];
+			uint8	m_routeSpeed;
+			uint8	m_routeTries;
+			uint8	m_lastFailedLinkFrom;
+			uint8	m_lastFailedLinkTo;
+		};
+	};
+}
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------
+//
+//      Notification.h
+//
+//      Mock of the OpenZWave Notification class used by the benchmark build.
+//      Unlike the real class, notifications can be constructed directly so
+//      the benchmarks can feed them through the watcher callback.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Defs.h"
+#include "ValueID.h"
+
+namespace OpenZWave
+{
+	class Notification
+	{
+	public:
+		enum NotificationType
+		{
+			Type_ValueAdded = 0,
+			Type_ValueRemoved,
+			Type_ValueChanged,
+			Type_ValueRefreshed,
+			Type_Group,
+			Type_NodeNew,
+			Type_NodeAdded,
+			Type_NodeRemoved,
+			Type_NodeProtocolInfo,
+			Type_NodeNaming,
+			Type_NodeEvent,
+			Type_PollingDisabled,
+			Type_PollingEnabled,
+			Type_SceneEvent,
+			Type_CreateButton,
+			Type_DeleteButton,
+			Type_ButtonOn,
+			Type_ButtonOff,
+			Type_DriverReady,
+			Type_DriverFailed,
+			Type_DriverReset,
+			Type_EssentialNodeQueriesComplete,
+			Type_NodeQueriesComplete,
+			Type_AwakeNodesQueried,
+			Type_AllNodesQueriedSomeDead,
+			Type_AllNodesQueried,
+			Type_Notification,
+			Type_DriverRemoved,
+			Type_ControllerCommand,
+			Type_NodeReset,
+			Type_UserAlerts,
+			Type_ManufacturerSpecificDBReady
+		};
+
+		enum NotificationCode
+		{
+			Code_MsgComplete = 0,
+			Code_Timeout,
+			Code_NoOperation,
+			Code_Awake,
+			Code_Sleep,
+			Code_Dead,
+			Code_Alive
+		};
+
+		Notification(NotificationType _type, ValueID const& _valueId, uint8 _byte = 0, uint8 _event = 0) :
+			m_type(_type),
+			m_valueId(_valueId),
+			m_byte(_byte),
+			m_event(_event)
+		{
+		}
+
+		NotificationType GetType()const { return m_type; }
+		uint32 GetHomeId()const { return m_valueId.GetHomeId(); }
+		uint8 GetNodeId()const { return m_valueId.GetNodeId(); }
+		ValueID const& GetValueID()const { return m_valueId; }
+		uint8 GetGroupIdx()const { return m_byte; }
+		uint8 GetEvent()const { return m_event; }
+		uint8 GetButtonId()const { return m_byte; }
+		uint8 GetSceneId()const { return m_byte; }
+		uint8 GetNotification()const { return m_byte; }
+		uint8 GetByte()const { return m_byte; }
+
+	private:
+		NotificationType	m_type;
+		ValueID				m_valueId;
+		uint8				m_byte;
+		uint8				m_event;
+	};
+}
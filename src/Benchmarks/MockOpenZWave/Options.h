@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------
+//
+//      Options.h
+//
+//      Mock of the OpenZWave Options class used by the benchmark build.
+//      Options are kept in a simple map, which is close enough to the real
+//      implementation for measuring the wrapper's lookup overhead.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Options
+	{
+	public:
+		enum OptionType
+		{
+			OptionType_Invalid = 0,
+			OptionType_Bool,
+			OptionType_Int,
+			OptionType_String
+		};
+
+		static Options* Create(string const& _configPath, string const& _userPath, string const& _commandLine)
+		{
+			if (s_instance() == NULL)
+			{
+				s_instance() = new Options();
+				s_instance()->m_configPath = _configPath;
+				s_instance()->m_userPath = _userPath;
+			}
+			return s_instance();
+		}
+
+		static bool Destroy()
+		{
+			delete s_instance();
+			s_instance() = NULL;
+			return true;
+		}
+
+		static Options* Get() { return s_instance(); }
+
+		bool Lock() { m_locked = true; return true; }
+		bool AreLocked()const { return m_locked; }
+
+		bool AddOptionBool(string const& _name, bool const _default) { return AddOption(_name, OptionType_Bool, _default ? "true" : "false"); }
+		bool AddOptionInt(string const& _name, int32 const _default) { return AddOption(_name, OptionType_Int, to_string(_default)); }
+		bool AddOptionString(string const& _name, string const& _default, bool const _append) { return AddOption(_name, OptionType_String, _default); }
+
+		bool GetOptionAsBool(string const& _name, bool* o_value)
+		{
+			map<string, Option>::const_iterator it = m_options.find(_name);
+			if (it == m_options.end() || it->second.m_type != OptionType_Bool)
+				return false;
+			*o_value = (it->second.m_value == "true");
+			return true;
+		}
+
+		bool GetOptionAsInt(string const& _name, int32* o_value)
+		{
+			map<string, Option>::const_iterator it = m_options.find(_name);
+			if (it == m_options.end() || it->second.m_type != OptionType_Int)
+				return false;
+			*o_value = atoi(it->second.m_value.c_str());
+			return true;
+		}
+
+		bool GetOptionAsString(string const& _name, string* o_value)
+		{
+			map<string, Option>::const_iterator it = m_options.find(_name);
+			if (it == m_options.end() || it->second.m_type != OptionType_String)
+				return false;
+			*o_value = it->second.m_value;
+			return true;
+		}
+
+		OptionType GetOptionType(string const& _name)
+		{
+			map<string, Option>::const_iterator it = m_options.find(_name);
+			return (it == m_options.end()) ? OptionType_Invalid : it->second.m_type;
+		}
+
+		string const& GetConfigPath()const { return m_configPath; }
+		string const& GetUserPath()const { return m_userPath; }
+
+	private:
+		struct Option
+		{
+			OptionType	m_type;
+			string		m_value;
+		};
+
+		Options() : m_locked(false) {}
+
+		bool AddOption(string const& _name, OptionType _type, string const& _value)
+		{
+			if (m_locked)
+				return false;
+			Option option = { _type, _value };
+			m_options[_name] = option;
+			return true;
+		}
+
+		static Options*& s_instance() { static Options* s_options = NULL; return s_options; }
+
+		map<string, Option>	m_options;
+		string				m_configPath;
+		string				m_userPath;
+		bool				m_locked;
+	};
+}
@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------
+//
+//      ValueID.h
+//
+//      Mock of the OpenZWave ValueID class used by the benchmark build.
+//      The packing follows the real library so that ids sort the same way.
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class ValueID
+	{
+	public:
+		enum ValueGenre
+		{
+			ValueGenre_Basic = 0,
+			ValueGenre_User,
+			ValueGenre_Config,
+			ValueGenre_System,
+			ValueGenre_Count
+		};
+
+		enum ValueType
+		{
+			ValueType_Bool = 0,
+			ValueType_Byte,
+			ValueType_Decimal,
+			ValueType_Int,
+			ValueType_List,
+			ValueType_Schedule,
+			ValueType_Short,
+			ValueType_String,
+			ValueType_Button,
+			ValueType_Raw,
+			ValueType_BitSet,
+			ValueType_Max = ValueType_BitSet
+		};
+
+		ValueID
+		(
+			uint32 const _homeId,
+			uint8 const _nodeId,
+			ValueGenre const _genre,
+			uint8 const _commandClassId,
+			uint8 const _instance,
+			uint16 const _valueIndex,
+			ValueType const _type
+		) :
+			m_homeId(_homeId)
+		{
+			m_id = (((uint32)_nodeId) << 24)
+				| (((uint32)_genre) << 22)
+				| (((uint32)_commandClassId) << 14)
+				| (((uint32)(_valueIndex & 0xFF)) << 4)
+				| ((uint32)_type);
+			m_id1 = (((uint32)_instance) << 24) | (((uint32)(_valueIndex & 0xFF00)) << 8);
+		}
+
+		ValueID
+		(
+			uint32 const _homeId,
+			uint64 const _id
+		) :
+			m_homeId(_homeId)
+		{
+			m_id = ((uint32)(_id & 0xFFFFFFFF));
+			m_id1 = (uint32)(_id >> 32);
+		}
+
+		ValueID() : m_id(0), m_id1(0), m_homeId(0) {}
+
+		uint32 GetHomeId()const { return m_homeId; }
+		uint8 GetNodeId()const { return((uint8)((m_id & 0xff000000) >> 24)); }
+		ValueGenre GetGenre()const { return((ValueGenre)((m_id & 0x00c00000) >> 22)); }
+		uint8 GetCommandClassId()const { return((uint8)((m_id & 0x003fc000) >> 14)); }
+		uint8 GetInstance()const { return((uint8)(((m_id1 & 0xff000000)) >> 24)); }
+		uint16 GetIndex()const { return((uint16)(((m_id & 0x00000ff0) >> 4) | ((m_id1 & 0x00ff0000) >> 8))); }
+		ValueType GetType()const { return((ValueType)(m_id & 0x0000000f)); }
+		uint64 GetId()const { return (uint64)(((uint64)m_id1 << 32) | m_id); }
+
+		bool operator == (ValueID const& _other)const { return((m_homeId == _other.m_homeId) && (m_id == _other.m_id) && (m_id1 == _other.m_id1)); }
+		bool operator != (ValueID const& _other)const { return((m_homeId != _other.m_homeId) || (m_id != _other.m_id) || (m_id1 != _other.m_id1)); }
+		bool operator < (ValueID const& _other)const
+		{
+			if (m_homeId == _other.m_homeId)
+			{
+				if (m_id == _other.m_id)
+				{
+					return(m_id1 < _other.m_id1);
+				}
+				return(m_id < _other.m_id);
+			}
+			return(m_homeId < _other.m_homeId);
+		}
+		bool operator > (ValueID const& _other)const
+		{
+			if (m_homeId == _other.m_homeId)
+			{
+				if (m_id == _other.m_id)
+				{
+					return(m_id1 > _other.m_id1);
+				}
+				return(m_id > _other.m_id);
+			}
+			return(m_homeId > _other.m_homeId);
+		}
+
+	private:
+		uint32	m_id;
+		uint32	m_id1;
+		uint32	m_homeId;
+	};
+}
@@ -0,0 +1,12 @@
+//-----------------------------------------------------------------------------
+//
+//      ValueInt.h
+//
+//      Placeholder for the OpenZWave header of the same name, which the
+//      wrapper's pch.h includes.  The benchmark build does not need it.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Defs.h"
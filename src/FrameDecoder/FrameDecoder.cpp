@@ -0,0 +1,245 @@
+//-----------------------------------------------------------------------------
+//
+//      FrameDecoder.cpp
+//
+//      Prints the frames and round trips of a frame capture
+//
+//      Usage: OpenZWaveFrameDecoder <segment file or directory> [--frames] [--csv]
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cwchar>
+#include "FrameCaptureReader.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	char const* FunctionName(uint8 _functionId)
+	{
+		switch (_functionId)
+		{
+			case 0x00: return "-";
+			case 0x02: return "SerialApiGetInitData";
+			case 0x04: return "ApplicationCommandHandler";
+			case 0x05: return "GetControllerCapabilities";
+			case 0x07: return "SerialApiGetCapabilities";
+			case 0x08: return "SerialApiSoftReset";
+			case 0x13: return "SendData";
+			case 0x15: return "GetVersion";
+			case 0x20: return "MemoryGetId";
+			case 0x41: return "GetNodeProtocolInfo";
+			case 0x42: return "SetDefault";
+			case 0x46: return "AssignReturnRoute";
+			case 0x47: return "DeleteReturnRoute";
+			case 0x48: return "RequestNodeNeighborUpdate";
+			case 0x49: return "ApplicationUpdate";
+			case 0x4a: return "AddNodeToNetwork";
+			case 0x4b: return "RemoveNodeFromNetwork";
+			case 0x56: return "GetSucNodeId";
+			case 0x60: return "RequestNodeInfo";
+			case 0x61: return "RemoveFailedNode";
+			case 0x62: return "IsFailedNode";
+			case 0x80: return "GetRoutingInfo";
+		}
+		return "?";
+	}
+
+	char const* KindName(FrameRecordHeader const& _header)
+	{
+		switch (_header.m_kind)
+		{
+			case FrameKind_Ack: return "ACK";
+			case FrameKind_Nak: return "NAK";
+			case FrameKind_Can: return "CAN";
+			case FrameKind_Dropped: return "DROP";
+		}
+		return (_header.m_direction == FrameDirection_Sent) ? "SEND" : "RECV";
+	}
+
+	void PrintTime(int64 _time, bool _csv)
+	{
+		ULARGE_INTEGER time;
+		time.QuadPart = (ULONGLONG)_time;
+		FILETIME utc;
+		utc.dwLowDateTime = time.LowPart;
+		utc.dwHighDateTime = time.HighPart;
+		FILETIME local;
+		SYSTEMTIME when;
+		FileTimeToLocalFileTime(&utc, &local);
+		FileTimeToSystemTime(&local, &when);
+		printf(_csv ? "%04d-%02d-%02d %02d:%02d:%02d.%03d," : "%04d-%02d-%02d %02d:%02d:%02d.%03d  ",
+			when.wYear, when.wMonth, when.wDay, when.wHour, when.wMinute, when.wSecond, when.wMilliseconds);
+	}
+
+	void PrintFrames(FrameCaptureReader const& _reader, bool _csv)
+	{
+		if (_csv)
+		{
+			printf("time,kind,function,node,callback,command_class,attempt,bytes\n");
+		}
+
+		std::vector<CapturedFrame> const& frames = _reader.GetFrames();
+		for (size_t i = 0; i < frames.size(); ++i)
+		{
+			FrameRecordHeader const& header = frames[i].m_header;
+			uint8 const* bytes = _reader.GetBytes(frames[i]);
+
+			PrintTime(header.m_time, _csv);
+			if (_csv)
+			{
+				printf("%s,0x%02x,%u,0x%02x,0x%02x,%u,", KindName(header), frames[i].m_functionId, header.m_nodeId, header.m_callbackId, header.m_commandClassId, header.m_attempt);
+			}
+			else
+			{
+				printf("%-4s %-26s node %3u  cb 0x%02x  cc 0x%02x", KindName(header), FunctionName(frames[i].m_functionId), header.m_nodeId, header.m_callbackId, header.m_commandClassId);
+				if (header.m_attempt > 1)
+				{
+					printf("  attempt %u", header.m_attempt);
+				}
+				printf("  ");
+			}
+			for (uint32 j = 0; j < header.m_length; ++j)
+			{
+				printf(j == 0 ? "%02x" : " %02x", bytes[j]);
+			}
+			printf("\n");
+		}
+	}
+
+	void PrintTrip(FrameRoundTrip const& _trip, bool _csv)
+	{
+		if (_csv)
+		{
+			printf(",%u,%.1f,%.1f,%.1f,%.1f", _trip.m_count, _trip.m_mean, _trip.m_median, _trip.m_p95, _trip.m_max);
+		}
+		else if (_trip.m_count == 0)
+		{
+			printf("  %29s", "-");
+		}
+		else
+		{
+			printf("  %5u %7.1f %7.1f %7.1f", _trip.m_count, _trip.m_median, _trip.m_p95, _trip.m_max);
+		}
+	}
+
+	void PrintSummary(FrameCaptureReader const& _reader, bool _csv)
+	{
+		std::vector<FrameCommandStats> stats;
+		_reader.Analyze(&stats);
+
+		if (_csv)
+		{
+			printf("function,command_class,sent,retries,dropped,rejected,"
+				"response_count,response_mean_ms,response_median_ms,response_p95_ms,response_max_ms,"
+				"callback_count,callback_mean_ms,callback_median_ms,callback_p95_ms,callback_max_ms,"
+				"report_count,report_mean_ms,report_median_ms,report_p95_ms,report_max_ms\n");
+		}
+		else
+		{
+			std::vector<CapturedFrame> const& frames = _reader.GetFrames();
+			printf("%u frames in %u segments", (uint32)frames.size(), _reader.GetSegmentCount());
+			if (_reader.GetIncompleteCount() > 0)
+			{
+				printf(" (%u cut short)", _reader.GetIncompleteCount());
+			}
+			printf("\n");
+			if (!frames.empty())
+			{
+				printf("From ");
+				PrintTime(frames.front().m_header.m_time, false);
+				printf("to ");
+				PrintTime(frames.back().m_header.m_time, false);
+				printf("\n");
+			}
+			printf("\nRound trips in milliseconds: count, median, 95th percentile, max\n\n");
+			printf("%-26s %4s %6s %7s %7s %8s  %29s  %29s  %29s\n", "Function", "CC", "Sent", "Retries", "Dropped", "NAK/CAN", "Response", "Callback", "Node report");
+		}
+
+		for (size_t i = 0; i < stats.size(); ++i)
+		{
+			FrameCommandStats const& entry = stats[i];
+			if (_csv)
+			{
+				printf("0x%02x,0x%02x,%u,%u,%u,%u", entry.m_functionId, entry.m_commandClassId, entry.m_sent, entry.m_retries, entry.m_dropped, entry.m_rejected);
+			}
+			else
+			{
+				printf("%-26s 0x%02x %6u %7u %7u %8u", FunctionName(entry.m_functionId), entry.m_commandClassId, entry.m_sent, entry.m_retries, entry.m_dropped, entry.m_rejected);
+			}
+			PrintTrip(entry.m_response, _csv);
+			PrintTrip(entry.m_callback, _csv);
+			PrintTrip(entry.m_report, _csv);
+			printf("\n");
+		}
+	}
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+	wchar_t const* path = NULL;
+	bool frames = false;
+	bool csv = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (wcscmp(argv[i], L"--frames") == 0)
+		{
+			frames = true;
+		}
+		else if (wcscmp(argv[i], L"--csv") == 0)
+		{
+			csv = true;
+		}
+		else if (path == NULL && argv[i][0] != L'-')
+		{
+			path = argv[i];
+		}
+		else
+		{
+			path = NULL;
+			break;
+		}
+	}
+
+	if (path == NULL)
+	{
+		fprintf(stderr, "Usage: OpenZWaveFrameDecoder <segment file or directory> [--frames] [--csv]\n");
+		return 2;
+	}
+
+	FrameCaptureReader reader(path);
+	if (reader.GetSegmentCount() == 0)
+	{
+		fwprintf(stderr, L"No frame capture segments found at %ls\n", path);
+		return 1;
+	}
+
+	if (frames)
+	{
+		PrintFrames(reader, csv);
+	}
+	else
+	{
+		PrintSummary(reader, csv);
+	}
+	return 0;
+}
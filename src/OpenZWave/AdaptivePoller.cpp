@@ -0,0 +1,473 @@
+//-----------------------------------------------------------------------------
+//
+//      AdaptivePoller.cpp
+//
+//      Per-value polling that adapts to how often each value changes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "AdaptivePoller.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock AdaptivePoller::s_lock;
+std::vector<AdaptivePoller*> AdaptivePoller::s_pollers;
+
+namespace
+{
+	// A poll with no report after this long counts as timed out, and is
+	// charged this much airtime
+	uint32 const c_pollTimeoutMs = 10 * 1000;
+
+	// Round trip assumed before any poll has been answered
+	double const c_initialCostMs = 100.0;
+
+	// How long Step sleeps with nothing due
+	uint32 const c_idleMs = 60 * 1000;
+
+	bool ByValueId(PollCounters const& _a, uint64 _valueId)
+	{
+		return _a.m_valueId < _valueId;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::AdaptivePoller>
+//	Constructor
+//-----------------------------------------------------------------------------
+AdaptivePoller::AdaptivePoller(uint32 _homeId) :
+	m_homeId(_homeId),
+	m_running(false),
+	m_budgetMs(6 * 60 * 1000),
+	m_tokensMs(0.0),
+	m_costMs(c_initialCostMs),
+	m_refilledAt(0)
+{
+	m_tokensMs = m_budgetMs;
+	m_refilledAt = GetTickCount64();
+	m_timer = CreateThreadpoolTimer(OnTimer, this, NULL);
+
+	LockGuard guard(s_lock);
+	s_pollers.push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::~AdaptivePoller>
+//	Destructor
+//-----------------------------------------------------------------------------
+AdaptivePoller::~AdaptivePoller()
+{
+	{
+		LockGuard guard(s_lock);
+		s_pollers.erase(std::remove(s_pollers.begin(), s_pollers.end(), this), s_pollers.end());
+	}
+
+	Stop();
+	if (m_timer != NULL)
+	{
+		SetThreadpoolTimer(m_timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(m_timer, TRUE);
+		CloseThreadpoolTimer(m_timer);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Add>
+//	Poll a value, starting at its shortest interval.  Adding a value that is
+//	already polled changes its bounds.
+//-----------------------------------------------------------------------------
+bool AdaptivePoller::Add(uint64 _valueId, uint32 _minIntervalMs, uint32 _maxIntervalMs)
+{
+	if (_minIntervalMs == 0 || _minIntervalMs > _maxIntervalMs)
+	{
+		return false;
+	}
+
+	LockGuard guard(m_lock);
+	std::vector<Entry>::iterator it = Find(_valueId);
+	if (it == m_entries.end())
+	{
+		Entry entry;
+		memset(&entry, 0, sizeof(entry));
+		entry.m_counters.m_valueId = _valueId;
+		entry.m_counters.m_nodeId = ValueID(m_homeId, _valueId).GetNodeId();
+		entry.m_counters.m_intervalMs = _minIntervalMs;
+		entry.m_dueAt = GetTickCount64();
+		entry.m_plannedAt = entry.m_dueAt;
+		it = m_entries.insert(std::lower_bound(m_entries.begin(), m_entries.end(), _valueId, [](Entry const& _a, uint64 _id) { return ByValueId(_a.m_counters, _id); }), entry);
+	}
+
+	PollCounters& counters = it->m_counters;
+	counters.m_minIntervalMs = _minIntervalMs;
+	counters.m_maxIntervalMs = _maxIntervalMs;
+	counters.m_intervalMs = std::min(std::max(counters.m_intervalMs, _minIntervalMs), _maxIntervalMs);
+
+	if (m_running)
+	{
+		Schedule(0);
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Remove>
+//	Stop polling a value
+//-----------------------------------------------------------------------------
+bool AdaptivePoller::Remove(uint64 _valueId)
+{
+	LockGuard guard(m_lock);
+	std::vector<Entry>::iterator it = Find(_valueId);
+	if (it == m_entries.end())
+	{
+		return false;
+	}
+	m_entries.erase(it);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::SetAirtimeBudget>
+//	Change the controller time polls may use per hour
+//-----------------------------------------------------------------------------
+void AdaptivePoller::SetAirtimeBudget(uint32 _budgetMs)
+{
+	LockGuard guard(m_lock);
+	m_budgetMs = _budgetMs;
+	if (m_tokensMs > m_budgetMs)
+	{
+		m_tokensMs = m_budgetMs;
+	}
+	if (m_running)
+	{
+		Schedule(0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::GetAirtimeBudget>
+//	Controller time polls may use per hour
+//-----------------------------------------------------------------------------
+uint32 AdaptivePoller::GetAirtimeBudget()
+{
+	LockGuard guard(m_lock);
+	return m_budgetMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Start>
+//	Start polling
+//-----------------------------------------------------------------------------
+void AdaptivePoller::Start()
+{
+	LockGuard guard(m_lock);
+	if (!m_running)
+	{
+		m_running = true;
+		Refill();
+		Schedule(0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Stop>
+//	Stop polling.  Polls already sent are still answered and counted.
+//-----------------------------------------------------------------------------
+void AdaptivePoller::Stop()
+{
+	LockGuard guard(m_lock);
+	m_running = false;
+	if (m_timer != NULL)
+	{
+		SetThreadpoolTimer(m_timer, NULL, 0, 0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::IsRunning>
+//	Whether the poller is running
+//-----------------------------------------------------------------------------
+bool AdaptivePoller::IsRunning()
+{
+	LockGuard guard(m_lock);
+	return m_running;
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::GetCounters>
+//	Interval and counters of every polled value, by value ID
+//-----------------------------------------------------------------------------
+void AdaptivePoller::GetCounters(std::vector<PollCounters>* o_counters)
+{
+	LockGuard guard(m_lock);
+	o_counters->resize(m_entries.size());
+	for (size_t i = 0; i < m_entries.size(); ++i)
+	{
+		(*o_counters)[i] = m_entries[i].m_counters;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::OnNotification>
+//	Forward OpenZWave notifications to every live poller
+//-----------------------------------------------------------------------------
+void AdaptivePoller::OnNotification(Notification const* _notification)
+{
+	Notification::NotificationType type = _notification->GetType();
+	if (type != Notification::Type_ValueChanged && type != Notification::Type_ValueRefreshed)
+	{
+		return;
+	}
+
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < s_pollers.size(); ++i)
+	{
+		s_pollers[i]->HandleNotification(_notification);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::HandleNotification>
+//	Settle a poll, or note an unsolicited report.  Polls are only sent from
+//	the timer, so OpenZWave is never called back from its own notification
+//	thread.
+//-----------------------------------------------------------------------------
+void AdaptivePoller::HandleNotification(Notification const* _notification)
+{
+	if (_notification->GetHomeId() != m_homeId)
+	{
+		return;
+	}
+
+	LockGuard guard(m_lock);
+	std::vector<Entry>::iterator it = Find(_notification->GetValueID().GetId());
+	if (it == m_entries.end())
+	{
+		return;
+	}
+
+	Entry& entry = *it;
+	PollCounters& counters = entry.m_counters;
+	uint64 now = GetTickCount64();
+	bool changed = (_notification->GetType() == Notification::Type_ValueChanged);
+	counters.m_lastReportAt = now;
+	if (changed)
+	{
+		++counters.m_changes;
+	}
+
+	if (entry.m_sentAt != 0 && entry.m_requested && now - entry.m_sentAt < c_pollTimeoutMs)
+	{
+		// The answer to our poll
+		uint32 rtt = (uint32)(now - entry.m_sentAt);
+		counters.m_lastPollMs = rtt;
+		m_tokensMs -= rtt - entry.m_chargedMs;
+		m_costMs += (rtt - m_costMs) / 8.0;
+		entry.m_sentAt = 0;
+		entry.m_requested = false;
+
+		if (changed)
+		{
+			counters.m_intervalMs = std::max(counters.m_intervalMs / 2, counters.m_minIntervalMs);
+		}
+		else
+		{
+			counters.m_intervalMs = std::min(counters.m_intervalMs + counters.m_intervalMs / 2, counters.m_maxIntervalMs);
+		}
+		entry.m_dueAt = now + counters.m_intervalMs;
+		entry.m_plannedAt = entry.m_dueAt;
+		return;
+	}
+
+	// The device reported on its own, so the next poll can wait.  A poll
+	// already outstanding is left to be answered or time out.
+	++counters.m_unsolicited;
+	if (entry.m_sentAt != 0)
+	{
+		return;
+	}
+	if (now >= entry.m_plannedAt)
+	{
+		// Earlier reports put off the poll planned for then, and this one
+		// puts it off again, so it is never sent
+		++counters.m_skipped;
+		entry.m_plannedAt = now + counters.m_intervalMs;
+	}
+	entry.m_dueAt = now + counters.m_intervalMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Find>
+//	The entry for a value, or end().  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+std::vector<AdaptivePoller::Entry>::iterator AdaptivePoller::Find(uint64 _valueId)
+{
+	std::vector<Entry>::iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), _valueId, [](Entry const& _a, uint64 _id) { return ByValueId(_a.m_counters, _id); });
+	return (it != m_entries.end() && it->m_counters.m_valueId == _valueId) ? it : m_entries.end();
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK AdaptivePoller::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	static_cast<AdaptivePoller*>(_context)->Step();
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Step>
+//	Time out unanswered polls, then send the due ones, most overdue first,
+//	while the airtime budget allows
+//-----------------------------------------------------------------------------
+void AdaptivePoller::Step()
+{
+	std::vector<uint64> polls;
+	{
+		LockGuard guard(m_lock);
+		if (!m_running)
+		{
+			return;
+		}
+
+		uint64 now = GetTickCount64();
+		Refill();
+
+		std::vector<Entry*> due;
+		for (size_t i = 0; i < m_entries.size(); ++i)
+		{
+			Entry& entry = m_entries[i];
+			if (entry.m_sentAt != 0 && now - entry.m_sentAt >= c_pollTimeoutMs)
+			{
+				PollCounters& counters = entry.m_counters;
+				++counters.m_timeouts;
+				m_tokensMs -= c_pollTimeoutMs - entry.m_chargedMs;
+				counters.m_intervalMs = std::min(counters.m_intervalMs * 2, counters.m_maxIntervalMs);
+				entry.m_sentAt = 0;
+				entry.m_requested = false;
+				entry.m_dueAt = now + counters.m_intervalMs;
+				entry.m_plannedAt = entry.m_dueAt;
+			}
+
+			if (entry.m_sentAt == 0 && entry.m_dueAt <= now)
+			{
+				due.push_back(&entry);
+			}
+		}
+
+		std::sort(due.begin(), due.end(), [](Entry const* _a, Entry const* _b) { return _a->m_dueAt < _b->m_dueAt; });
+
+		bool limited = false;
+		for (size_t i = 0; i < due.size(); ++i)
+		{
+			Entry& entry = *due[i];
+			if (m_budgetMs != 0 && m_tokensMs <= 0.0)
+			{
+				++entry.m_counters.m_deferred;
+				limited = true;
+				continue;
+			}
+
+			// Charge the expected round trip now, and correct it when the answer arrives
+			entry.m_chargedMs = m_costMs;
+			m_tokensMs -= m_costMs;
+			entry.m_sentAt = now;
+			entry.m_requested = false;
+			entry.m_dueAt = now + entry.m_counters.m_intervalMs;
+			entry.m_plannedAt = entry.m_dueAt;
+			entry.m_counters.m_lastPollAt = now;
+			++entry.m_counters.m_polls;
+			polls.push_back(entry.m_counters.m_valueId);
+		}
+
+		uint64 next = now + c_idleMs;
+		for (size_t i = 0; i < m_entries.size(); ++i)
+		{
+			Entry const& entry = m_entries[i];
+			next = std::min(next, (entry.m_sentAt != 0) ? entry.m_sentAt + c_pollTimeoutMs : entry.m_dueAt);
+		}
+		if (limited)
+		{
+			// Wait until the bucket has refilled enough to be positive again
+			double rate = m_budgetMs / 3600000.0;
+			next = std::max(next, now + (uint64)(-m_tokensMs / rate) + 100);
+		}
+		Schedule((uint32)(next > now ? next - now : 0));
+	}
+
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < polls.size(); ++i)
+	{
+		MarkRequested(polls[i]);
+		manager->RefreshValue(ValueID(m_homeId, polls[i]));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::MarkRequested>
+//	Open a poll's window just before RefreshValue queues the request, so
+//	that only reports from then on can answer it
+//-----------------------------------------------------------------------------
+void AdaptivePoller::MarkRequested(uint64 _valueId)
+{
+	LockGuard guard(m_lock);
+	std::vector<Entry>::iterator it = Find(_valueId);
+	if (it != m_entries.end() && it->m_sentAt != 0)
+	{
+		it->m_sentAt = GetTickCount64();
+		it->m_requested = true;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Schedule>
+//	Run Step after a delay.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+void AdaptivePoller::Schedule(uint32 _delayMs)
+{
+	if (m_timer == NULL)
+	{
+		return;
+	}
+
+	// Negative due times are relative, in 100ns units
+	ULARGE_INTEGER due;
+	due.QuadPart = (ULONGLONG)(-((LONGLONG)_delayMs * 10000));
+	FILETIME dueTime;
+	dueTime.dwLowDateTime = due.LowPart;
+	dueTime.dwHighDateTime = due.HighPart;
+	SetThreadpoolTimer(m_timer, &dueTime, 0, 0);
+}
+
+//-----------------------------------------------------------------------------
+//	<AdaptivePoller::Refill>
+//	Top up the airtime budget for the time passed.  Slow answers can overdraw
+//	it, but by no more than an hour's budget.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+void AdaptivePoller::Refill()
+{
+	uint64 now = GetTickCount64();
+	double rate = m_budgetMs / 3600000.0;
+	m_tokensMs = std::min((double)m_budgetMs, m_tokensMs + (now - m_refilledAt) * rate);
+	m_tokensMs = std::max(-(double)m_budgetMs, m_tokensMs);
+	m_refilledAt = now;
+}
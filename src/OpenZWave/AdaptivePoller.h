@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+//
+//      AdaptivePoller.h
+//
+//      Per-value polling that adapts to how often each value changes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct PollCounters
+		{
+			uint64	m_valueId;				// ValueID::GetId
+			uint8	m_nodeId;
+			uint32	m_minIntervalMs;
+			uint32	m_maxIntervalMs;
+			uint32	m_intervalMs;			// Current interval, between the bounds
+			uint32	m_polls;				// RefreshValue calls
+			uint32	m_skipped;				// Planned polls not sent because of unsolicited reports
+			uint32	m_deferred;				// Polls held back by the airtime budget
+			uint32	m_timeouts;				// Polls with no report
+			uint32	m_changes;				// Reports with a new value
+			uint32	m_unsolicited;			// Reports that were not poll responses
+			uint32	m_lastPollMs;			// Round trip of the last answered poll
+			uint64	m_lastPollAt;			// Tick count, 0 if never
+			uint64	m_lastReportAt;			// Tick count, 0 if never
+		};
+
+		// Polls values with RefreshValue, each at its own interval.  A poll
+		// whose answer changed the value halves the interval, one that did
+		// not lengthens it by half, always within the value's bounds.  An
+		// unsolicited report restarts the interval, so values that report on
+		// their own are not polled as well.  Only a report within the poll
+		// timeout of the RefreshValue call answers a poll; any other report
+		// is unsolicited.  Every answered poll is charged
+		// against a token bucket for its round trip time, the time the
+		// controller was busy with it.
+		class AdaptivePoller
+		{
+		public:
+			AdaptivePoller(uint32 _homeId);
+			~AdaptivePoller();
+
+			bool Add(uint64 _valueId, uint32 _minIntervalMs, uint32 _maxIntervalMs);
+			bool Remove(uint64 _valueId);
+
+			// Controller time polls may use per hour; 0 for no limit
+			void SetAirtimeBudget(uint32 _budgetMs);
+			uint32 GetAirtimeBudget();
+
+			void Start();
+			void Stop();
+			bool IsRunning();
+
+			void GetCounters(std::vector<PollCounters>* o_counters);
+
+			// Forward OpenZWave notifications to every live poller
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			AdaptivePoller(AdaptivePoller const&);
+			AdaptivePoller& operator=(AdaptivePoller const&);
+
+			struct Entry
+			{
+				PollCounters	m_counters;
+				uint64			m_dueAt;			// Tick count of the next poll
+				uint64			m_plannedAt;		// When it was due before unsolicited reports put it off
+				uint64			m_sentAt;			// Tick count of the outstanding poll, 0 if none
+				bool			m_requested;		// RefreshValue has been called for it
+				double			m_chargedMs;		// Airtime charged for it up front
+			};
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+
+			void HandleNotification(Notification const* _notification);
+			std::vector<Entry>::iterator Find(uint64 _valueId);
+			void Step();
+			void MarkRequested(uint64 _valueId);
+			void Schedule(uint32 _delayMs);
+			void Refill();
+
+			uint32				m_homeId;
+			PTP_TIMER			m_timer;
+
+			Lock				m_lock;
+			std::vector<Entry>	m_entries;
+			bool				m_running;
+			uint32				m_budgetMs;
+			double				m_tokensMs;			// Remaining airtime budget
+			double				m_costMs;			// Average poll round trip
+			uint64				m_refilledAt;
+
+			static Lock							s_lock;
+			static std::vector<AdaptivePoller*>	s_pollers;
+		};
+	}
+}
@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------------
+//
+//      AssociationGraph.cpp
+//
+//      Snapshot of every association in a network, and minimal bulk edits
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <map>
+#include "AssociationGraph.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	// Node, group and target packed so that the natural order sorts by all three
+	uint32 EdgeKey(uint8 _nodeId, uint8 _groupIdx, uint8 _targetNodeId)
+	{
+		return ((uint32)_nodeId << 16) | ((uint32)_groupIdx << 8) | _targetNodeId;
+	}
+
+	bool CommandOrder(AssociationChange const& _a, AssociationChange const& _b)
+	{
+		if (_a.m_nodeId != _b.m_nodeId)
+			return _a.m_nodeId < _b.m_nodeId;
+		if (_a.m_groupIdx != _b.m_groupIdx)
+			return _a.m_groupIdx < _b.m_groupIdx;
+		if (_a.m_remove != _b.m_remove)
+			return _a.m_remove;
+		return _a.m_targetNodeId < _b.m_targetNodeId;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AssociationGraph::Build>
+//	Read every group of every node
+//-----------------------------------------------------------------------------
+void AssociationGraph::Build(uint32 _homeId)
+{
+	m_groups.clear();
+	m_edges.clear();
+
+	Manager* manager = Manager::Get();
+	for (uint32 nodeId = 1; nodeId <= NUM_NODE_BITFIELD_BYTES * 8; ++nodeId)
+	{
+		uint8 numGroups = manager->GetNumGroups(_homeId, (uint8)nodeId);
+		for (uint32 groupIdx = 1; groupIdx <= numGroups; ++groupIdx)
+		{
+			AssociationGroup group;
+			group.m_nodeId = (uint8)nodeId;
+			group.m_groupIdx = (uint8)groupIdx;
+			group.m_maxAssociations = manager->GetMaxAssociations(_homeId, (uint8)nodeId, (uint8)groupIdx);
+			group.m_multiInstance = manager->IsMultiInstance(_homeId, (uint8)nodeId, (uint8)groupIdx);
+			group.m_label = manager->GetGroupLabel(_homeId, (uint8)nodeId, (uint8)groupIdx);
+			group.m_firstEdge = (uint32)m_edges.size();
+
+			uint8* targets = NULL;
+			uint32 numTargets = manager->GetAssociations(_homeId, (uint8)nodeId, (uint8)groupIdx, &targets);
+			if (numTargets > 0)
+			{
+				std::sort(targets, targets + numTargets);
+				for (uint32 i = 0; i < numTargets; ++i)
+				{
+					AssociationEdge edge = { (uint8)nodeId, (uint8)groupIdx, targets[i] };
+					m_edges.push_back(edge);
+				}
+				delete[] targets;
+			}
+
+			group.m_numEdges = (uint32)m_edges.size() - group.m_firstEdge;
+			m_groups.push_back(group);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AssociationGraph::ComputeCommands>
+//	Reduce the requested changes to the commands that change something
+//-----------------------------------------------------------------------------
+void AssociationGraph::ComputeCommands(uint32 _homeId, std::vector<AssociationChange> const& _changes, std::vector<AssociationChange>* o_commands)
+{
+	o_commands->clear();
+
+	// Last change to each edge wins
+	std::map<uint32, AssociationChange> requested;
+	for (size_t i = 0; i < _changes.size(); ++i)
+	{
+		AssociationChange const& change = _changes[i];
+		requested[EdgeKey(change.m_nodeId, change.m_groupIdx, change.m_targetNodeId)] = change;
+	}
+
+	// The map is ordered by node and group, so each group is read once
+	Manager* manager = Manager::Get();
+	std::map<uint32, AssociationChange>::const_iterator it = requested.begin();
+	while (it != requested.end())
+	{
+		uint8 nodeId = it->second.m_nodeId;
+		uint8 groupIdx = it->second.m_groupIdx;
+
+		uint8* targets = NULL;
+		uint32 numTargets = manager->GetAssociations(_homeId, nodeId, groupIdx, &targets);
+		uint8 maxAssociations = manager->GetMaxAssociations(_homeId, nodeId, groupIdx);
+
+		std::vector<AssociationChange> removals;
+		std::vector<AssociationChange> additions;
+		for (; it != requested.end() && it->second.m_nodeId == nodeId && it->second.m_groupIdx == groupIdx; ++it)
+		{
+			AssociationChange const& change = it->second;
+			bool present = (targets != NULL) && (std::find(targets, targets + numTargets, change.m_targetNodeId) != targets + numTargets);
+			if (change.m_remove && present)
+			{
+				removals.push_back(change);
+			}
+			else if (!change.m_remove && !present)
+			{
+				additions.push_back(change);
+			}
+		}
+		delete[] targets;
+
+		if (maxAssociations != 0)
+		{
+			// Removals are all of present targets, so this cannot underflow
+			size_t remaining = numTargets - removals.size();
+			size_t room = (maxAssociations > remaining) ? maxAssociations - remaining : 0;
+			if (additions.size() > room)
+			{
+				additions.resize(room);
+			}
+		}
+
+		o_commands->insert(o_commands->end(), removals.begin(), removals.end());
+		o_commands->insert(o_commands->end(), additions.begin(), additions.end());
+	}
+
+	std::stable_sort(o_commands->begin(), o_commands->end(), CommandOrder);
+}
+
+//-----------------------------------------------------------------------------
+//	<AssociationGraph::Apply>
+//	Send the commands, one node after another.  OpenZWave holds the commands
+//	for a sleeping node in its wake-up queue, so consecutive commands for the
+//	same node all go out at its next wake-up.
+//-----------------------------------------------------------------------------
+void AssociationGraph::Apply(uint32 _homeId, std::vector<AssociationChange> const& _commands)
+{
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < _commands.size(); ++i)
+	{
+		AssociationChange const& command = _commands[i];
+		if (command.m_remove)
+		{
+			manager->RemoveAssociation(_homeId, command.m_nodeId, command.m_groupIdx, command.m_targetNodeId);
+		}
+		else
+		{
+			manager->AddAssociation(_homeId, command.m_nodeId, command.m_groupIdx, command.m_targetNodeId);
+		}
+	}
+}
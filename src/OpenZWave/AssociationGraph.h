@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------
+//
+//      AssociationGraph.h
+//
+//      Snapshot of every association in a network, and minimal bulk edits
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct AssociationGroup
+		{
+			uint8		m_nodeId;
+			uint8		m_groupIdx;
+			uint8		m_maxAssociations;
+			bool		m_multiInstance;
+			std::string	m_label;
+			uint32		m_firstEdge;		// Index of the group's first edge
+			uint32		m_numEdges;
+		};
+
+		struct AssociationEdge
+		{
+			uint8	m_nodeId;
+			uint8	m_groupIdx;
+			uint8	m_targetNodeId;
+		};
+
+		struct AssociationChange
+		{
+			uint8	m_nodeId;
+			uint8	m_groupIdx;
+			uint8	m_targetNodeId;
+			bool	m_remove;
+		};
+
+		class AssociationGraph
+		{
+		public:
+			// Read every group of every node, sorted by node, group and target
+			void Build(uint32 _homeId);
+
+			std::vector<AssociationGroup> const& GetGroups() const { return m_groups; }
+			std::vector<AssociationEdge> const& GetEdges() const { return m_edges; }
+
+			// Reduce the requested changes to the commands that actually change
+			// something, sorted by node and group with removals first so that
+			// they make room for the additions.  When several changes name the
+			// same edge the last one wins.  Additions that would overflow a group
+			// are dropped.
+			static void ComputeCommands(uint32 _homeId, std::vector<AssociationChange> const& _changes, std::vector<AssociationChange>* o_commands);
+
+			// Send the commands returned by ComputeCommands
+			static void Apply(uint32 _homeId, std::vector<AssociationChange> const& _commands);
+
+		private:
+			std::vector<AssociationGroup>	m_groups;
+			std::vector<AssociationEdge>	m_edges;
+		};
+	}
+}
@@ -0,0 +1,246 @@
+//-----------------------------------------------------------------------------
+//
+//      ChangeLog.cpp
+//
+//      Versioned log of node and value changes, for delta synchronization
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <map>
+#include "ChangeLog.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock ChangeLog::s_lock;
+uint64 ChangeLog::s_version = 0;
+std::vector<ChangeLog::Change> ChangeLog::s_changes;
+uint64 ChangeLog::s_count = 0;
+
+//-----------------------------------------------------------------------------
+//	<ChangeLog::GetVersion>
+//	The version of the latest change
+//-----------------------------------------------------------------------------
+uint64 ChangeLog::GetVersion()
+{
+	LockGuard guard(s_lock);
+	return s_version;
+}
+
+//-----------------------------------------------------------------------------
+//	<ChangeLog::GetChangesSince>
+//	The nodes and values of a network changed after a version, or all of
+//	them if the ring no longer goes back that far
+//-----------------------------------------------------------------------------
+void ChangeLog::GetChangesSince(uint32 _homeId, uint64 _version, ChangeSet* o_changes)
+{
+	o_changes->m_full = false;
+	o_changes->m_nodes.clear();
+	o_changes->m_values.clear();
+	o_changes->m_removedNodes.clear();
+	o_changes->m_removedValues.clear();
+
+	// Walking from the newest change back, the first change seen of a node
+	// or value is its latest.  A value change before its node was removed
+	// is left out, since the removal covers it.
+	std::map<uint8, bool> nodes;				// True if changed, false if removed
+	std::map<uint8, uint64> nodeRemovals;		// The removal of each node whose latest change is one
+	std::map<uint64, bool> values;
+	{
+		LockGuard guard(s_lock);
+		o_changes->m_version = s_version;
+
+		uint64 held = (s_count < c_capacity) ? s_count : c_capacity;
+		if (_version > s_version || _version < s_version - held)
+		{
+			o_changes->m_full = true;
+		}
+		else
+		{
+			uint64 count = s_version - _version;
+			for (uint64 i = 0; i < count; ++i)
+			{
+				Change const& change = s_changes[(size_t)((s_count - 1 - i) % c_capacity)];
+				if (change.m_homeId != _homeId)
+				{
+					continue;
+				}
+
+				if (change.m_kind == ChangeKind_NetworkRemoved)
+				{
+					o_changes->m_full = true;
+					break;
+				}
+				if (change.m_kind == ChangeKind_Node || change.m_kind == ChangeKind_NodeRemoved)
+				{
+					bool removed = (change.m_kind == ChangeKind_NodeRemoved);
+					std::pair<std::map<uint8, bool>::iterator, bool> node = nodes.insert(std::make_pair(change.m_nodeId, !removed));
+					if (removed && node.second)
+					{
+						nodeRemovals.insert(std::make_pair(change.m_nodeId, change.m_version));
+					}
+					else if (removed && node.first->second)
+					{
+						// Added again after the removal.  Only the whole
+						// network replaces the values the old node had.
+						o_changes->m_full = true;
+						break;
+					}
+					continue;
+				}
+
+				std::map<uint8, uint64>::const_iterator removal = nodeRemovals.find(change.m_nodeId);
+				if (removal == nodeRemovals.end() || change.m_version > removal->second)
+				{
+					values.insert(std::make_pair(change.m_valueId, change.m_kind == ChangeKind_Value));
+				}
+			}
+		}
+	}
+
+	// The Manager is only called with no lock held
+	if (o_changes->m_full)
+	{
+		std::vector<uint8> nodeIds;
+		std::vector<uint64> valueIds;
+		NetworkSnapshot::GetNetwork(_homeId, &nodeIds, &valueIds);
+		o_changes->m_nodes.resize(nodeIds.size());
+		for (size_t i = 0; i < nodeIds.size(); ++i)
+		{
+			NetworkSnapshot::ReadNode(_homeId, nodeIds[i], &o_changes->m_nodes[i]);
+		}
+		o_changes->m_values.resize(valueIds.size());
+		for (size_t i = 0; i < valueIds.size(); ++i)
+		{
+			NetworkSnapshot::ReadValue(_homeId, valueIds[i], &o_changes->m_values[i]);
+		}
+		return;
+	}
+
+	for (std::map<uint8, uint64>::const_iterator it = nodeRemovals.begin(); it != nodeRemovals.end(); ++it)
+	{
+		o_changes->m_removedNodes.push_back(it->first);
+	}
+	for (std::map<uint8, bool>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+	{
+		if (it->second)
+		{
+			o_changes->m_nodes.resize(o_changes->m_nodes.size() + 1);
+			NetworkSnapshot::ReadNode(_homeId, it->first, &o_changes->m_nodes.back());
+		}
+	}
+	for (std::map<uint64, bool>::const_iterator it = values.begin(); it != values.end(); ++it)
+	{
+		if (it->second)
+		{
+			o_changes->m_values.resize(o_changes->m_values.size() + 1);
+			NetworkSnapshot::ReadValue(_homeId, it->first, &o_changes->m_values.back());
+		}
+		else
+		{
+			o_changes->m_removedValues.push_back(it->first);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ChangeLog::Shutdown>
+//	Free the ring
+//-----------------------------------------------------------------------------
+void ChangeLog::Shutdown()
+{
+	LockGuard guard(s_lock);
+	std::vector<Change>().swap(s_changes);
+	s_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<ChangeLog::OnNotification>
+//	Log the notifications that change a node or value
+//-----------------------------------------------------------------------------
+void ChangeLog::OnNotification(Notification const* _notification)
+{
+	uint32 homeId = _notification->GetHomeId();
+	switch (_notification->GetType())
+	{
+	case Notification::Type_NodeNew:
+	case Notification::Type_NodeAdded:
+	case Notification::Type_NodeProtocolInfo:
+	case Notification::Type_NodeNaming:
+	case Notification::Type_EssentialNodeQueriesComplete:
+	case Notification::Type_NodeQueriesComplete:
+	{
+		Append(ChangeKind_Node, homeId, _notification->GetNodeId(), 0);
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		Append(ChangeKind_NodeRemoved, homeId, _notification->GetNodeId(), 0);
+		break;
+	}
+	case Notification::Type_ValueAdded:
+	case Notification::Type_ValueChanged:
+	{
+		Append(ChangeKind_Value, homeId, _notification->GetNodeId(), _notification->GetValueID().GetId());
+		break;
+	}
+	case Notification::Type_ValueRemoved:
+	{
+		Append(ChangeKind_ValueRemoved, homeId, _notification->GetNodeId(), _notification->GetValueID().GetId());
+		break;
+	}
+	case Notification::Type_DriverReset:
+	case Notification::Type_DriverRemoved:
+	{
+		Append(ChangeKind_NetworkRemoved, homeId, 0, 0);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ChangeLog::Append>
+//	Give a change the next version and put it in the ring
+//-----------------------------------------------------------------------------
+void ChangeLog::Append(ChangeKind _kind, uint32 _homeId, uint8 _nodeId, uint64 _valueId)
+{
+	LockGuard guard(s_lock);
+	if (s_version == 0)
+	{
+		FILETIME now;
+		GetSystemTimeAsFileTime(&now);
+		s_version = ((uint64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+	}
+	if (s_changes.empty())
+	{
+		s_changes.resize(c_capacity);
+	}
+
+	Change& change = s_changes[(size_t)(s_count % c_capacity)];
+	change.m_version = ++s_version;
+	change.m_valueId = _valueId;
+	change.m_homeId = _homeId;
+	change.m_nodeId = _nodeId;
+	change.m_kind = (uint8)_kind;
+	++s_count;
+}
@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------
+//
+//      ChangeLog.h
+//
+//      Versioned log of node and value changes, for delta synchronization
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include "Lock.h"
+#include "NetworkSnapshot.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// The nodes and values of a network that changed after a version.
+		// A node removed takes its values with it.  A node in m_removedNodes
+		// is never in m_nodes.
+		struct ChangeSet
+		{
+			uint64						m_version;			// Pass to the next GetChangesSince
+			bool						m_full;				// Every node and value, replacing what the caller had
+			std::vector<SnapshotNode>	m_nodes;			// Added or changed
+			std::vector<SnapshotValue>	m_values;			// Added or changed, read when the changes were asked for
+			std::vector<uint8>			m_removedNodes;
+			std::vector<uint64>			m_removedValues;
+		};
+
+		// Every node and value change gets the next version, and goes in a
+		// ring of the latest c_capacity changes, which records only what
+		// changed.  A caller that asks for the changes since a version still
+		// in the ring gets each node and value changed after it once, read
+		// from the Manager as it is now.  A caller further behind, or holding
+		// a version of an earlier run, gets the whole network from the IDs
+		// NetworkSnapshot follows.  So does a caller whose changes include a
+		// node removed and then added again, since the log does not know
+		// which values the old node had.
+		//
+		// Versions start at the UTC file time the first change is logged, so
+		// a version from an earlier run is always behind the ring.
+		class ChangeLog
+		{
+		public:
+			static uint32 const c_capacity = 8192;
+
+			static uint64 GetVersion();
+			static void GetChangesSince(uint32 _homeId, uint64 _version, ChangeSet* o_changes);
+
+			// Free the ring.  The version keeps rising.
+			static void Shutdown();
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			enum ChangeKind
+			{
+				ChangeKind_Node = 0,
+				ChangeKind_NodeRemoved,
+				ChangeKind_Value,
+				ChangeKind_ValueRemoved,
+				ChangeKind_NetworkRemoved
+			};
+
+			struct Change
+			{
+				uint64	m_version;
+				uint64	m_valueId;
+				uint32	m_homeId;
+				uint8	m_nodeId;
+				uint8	m_kind;				// ChangeKind
+			};
+
+			static void Append(ChangeKind _kind, uint32 _homeId, uint8 _nodeId, uint64 _valueId);
+
+			// Under s_lock
+			static Lock					s_lock;
+			static uint64				s_version;
+			static std::vector<Change>	s_changes;		// Change n is at n modulo c_capacity
+			static uint64				s_count;		// Changes logged since the ring was allocated
+		};
+	}
+}
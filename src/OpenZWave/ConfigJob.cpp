@@ -0,0 +1,344 @@
+//-----------------------------------------------------------------------------
+//
+//      ConfigJob.cpp
+//
+//      Applies a configuration profile to a node, one changed parameter at a time
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "ConfigJob.h"
+#include "ConfigTable.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock ConfigJob::s_lock;
+std::vector<ConfigJob*> ConfigJob::s_jobs;
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::ConfigJob>
+//	Constructor.  Works out which parameters of the profile differ.
+//-----------------------------------------------------------------------------
+ConfigJob::ConfigJob(uint32 _homeId, uint8 _nodeId, std::vector<ConfigWrite> const& _profile, pfnOnConfigProgress_t _callback, void* _context) :
+	m_homeId(_homeId),
+	m_nodeId(_nodeId),
+	m_callback(_callback),
+	m_context(_context),
+	m_writes(_profile),
+	m_started(false),
+	m_completed(false),
+	m_total(0),
+	m_sent(0),
+	m_done(0)
+{
+	std::vector<ConfigParameter> parameters;
+	ConfigTable::GetParameters(_homeId, _nodeId, &parameters);
+
+	for (size_t i = 0; i < m_writes.size(); ++i)
+	{
+		ConfigWrite& write = m_writes[i];
+		write.m_valueId = 0;
+		write.m_result = ConfigResult_NotFound;
+		for (size_t j = 0; j < parameters.size(); ++j)
+		{
+			ConfigParameter const& parameter = parameters[j];
+			if (parameter.m_commandClassId == write.m_commandClassId && parameter.m_instance == write.m_instance && parameter.m_index == write.m_index)
+			{
+				if (!parameter.m_readOnly)
+				{
+					write.m_valueId = parameter.m_valueId;
+					write.m_result = (parameter.m_value == write.m_value) ? ConfigResult_Unchanged : ConfigResult_Pending;
+				}
+				break;
+			}
+		}
+	}
+
+	m_timer = CreateThreadpoolTimer(OnTimer, this, NULL);
+
+	LockGuard guard(s_lock);
+	s_jobs.push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::~ConfigJob>
+//	Destructor.  Must not be called from the progress callback.
+//-----------------------------------------------------------------------------
+ConfigJob::~ConfigJob()
+{
+	{
+		LockGuard guard(s_lock);
+		s_jobs.erase(std::remove(s_jobs.begin(), s_jobs.end(), this), s_jobs.end());
+	}
+
+	if (m_timer != NULL)
+	{
+		SetThreadpoolTimer(m_timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(m_timer, TRUE);
+		CloseThreadpoolTimer(m_timer);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::Start>
+//	Send every parameter that differs from the node's cached value
+//-----------------------------------------------------------------------------
+uint32 ConfigJob::Start(uint32 _timeoutMs)
+{
+	std::vector<ConfigWrite> sending;
+	{
+		LockGuard guard(m_lock);
+		if (m_started)
+		{
+			return 0;
+		}
+		m_started = true;
+
+		for (size_t i = 0; i < m_writes.size(); ++i)
+		{
+			if (m_writes[i].m_result == ConfigResult_Pending)
+			{
+				sending.push_back(m_writes[i]);
+				m_order.push_back(i);
+			}
+		}
+		m_total = (uint32)sending.size();
+
+		if (m_total > 0 && _timeoutMs > 0 && m_timer != NULL)
+		{
+			// Negative due times are relative, in 100ns units
+			ULARGE_INTEGER due;
+			due.QuadPart = (ULONGLONG)(-((LONGLONG)_timeoutMs * 10000));
+			FILETIME dueTime;
+			dueTime.dwLowDateTime = due.LowPart;
+			dueTime.dwHighDateTime = due.HighPart;
+			SetThreadpoolTimer(m_timer, &dueTime, 0, 0);
+		}
+	}
+
+	// Confirmations may arrive while the later writes are still being sent
+	std::vector<ConfigWrite> finished;
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < sending.size(); ++i)
+	{
+		bool accepted = manager->SetValue(ValueID(m_homeId, sending[i].m_valueId), sending[i].m_value);
+
+		LockGuard guard(m_lock);
+		ConfigWrite& write = m_writes[m_order[i]];
+		if (!accepted && write.m_result == ConfigResult_Pending)
+		{
+			write.m_result = ConfigResult_Failed;
+			finished.push_back(write);
+		}
+		m_sent = (uint32)(i + 1);
+	}
+
+	Report(finished);
+	return (uint32)sending.size();
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::GetResults>
+//	Every entry of the profile with its result so far
+//-----------------------------------------------------------------------------
+void ConfigJob::GetResults(std::vector<ConfigWrite>* o_results)
+{
+	LockGuard guard(m_lock);
+	*o_results = m_writes;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::IsComplete>
+//	Whether every write sent has a result
+//-----------------------------------------------------------------------------
+bool ConfigJob::IsComplete()
+{
+	LockGuard guard(m_lock);
+	return m_started && m_done == m_total;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::OnNotification>
+//	Forward OpenZWave notifications to every live job
+//-----------------------------------------------------------------------------
+void ConfigJob::OnNotification(Notification const* _notification)
+{
+	Notification::NotificationType type = _notification->GetType();
+	if (type != Notification::Type_ValueChanged && type != Notification::Type_ValueRefreshed && type != Notification::Type_Notification)
+	{
+		return;
+	}
+
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < s_jobs.size(); ++i)
+	{
+		s_jobs[i]->HandleNotification(_notification);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::HandleNotification>
+//	Settle the writes that the notification confirms or fails
+//-----------------------------------------------------------------------------
+void ConfigJob::HandleNotification(Notification const* _notification)
+{
+	if (_notification->GetHomeId() != m_homeId || _notification->GetNodeId() != m_nodeId)
+	{
+		return;
+	}
+
+	bool valueReport = (_notification->GetType() != Notification::Type_Notification);
+	uint8 code = valueReport ? 0 : _notification->GetNotification();
+	if (!valueReport && code != Notification::Code_Timeout && code != Notification::Code_Dead)
+	{
+		return;
+	}
+
+	std::string reported;
+	if (valueReport)
+	{
+		Manager::Get()->GetValueAsString(_notification->GetValueID(), &reported);
+	}
+
+	std::vector<ConfigWrite> finished;
+	{
+		LockGuard guard(m_lock);
+		if (!m_started)
+		{
+			return;
+		}
+
+		if (!valueReport)
+		{
+			// A dead node answers none of the writes.  A timeout names the
+			// value when OpenZWave knows it, and is otherwise for the write
+			// OpenZWave was sending, the oldest one sent and still waiting.
+			ValueID const& valueId = _notification->GetValueID();
+			bool named = (code == Notification::Code_Timeout) && (valueId.GetCommandClassId() != 0);
+			for (uint32 i = 0; i < m_sent; ++i)
+			{
+				ConfigWrite& write = m_writes[m_order[i]];
+				if (write.m_result != ConfigResult_Pending || (named && write.m_valueId != valueId.GetId()))
+				{
+					continue;
+				}
+				write.m_result = ConfigResult_Failed;
+				finished.push_back(write);
+				if (code == Notification::Code_Timeout)
+				{
+					break;
+				}
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < m_writes.size(); ++i)
+			{
+				ConfigWrite& write = m_writes[i];
+				if (write.m_result == ConfigResult_Pending && write.m_valueId == _notification->GetValueID().GetId())
+				{
+					write.m_result = (reported == write.m_value) ? ConfigResult_Succeeded : ConfigResult_Failed;
+					finished.push_back(write);
+					break;
+				}
+			}
+		}
+	}
+
+	if (!finished.empty())
+	{
+		Report(finished);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK ConfigJob::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	static_cast<ConfigJob*>(_context)->Expire();
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::Expire>
+//	Fail every write still waiting for confirmation
+//-----------------------------------------------------------------------------
+void ConfigJob::Expire()
+{
+	std::vector<ConfigWrite> finished;
+	{
+		LockGuard guard(m_lock);
+		for (size_t i = 0; i < m_writes.size(); ++i)
+		{
+			if (m_writes[i].m_result == ConfigResult_Pending)
+			{
+				m_writes[i].m_result = ConfigResult_Failed;
+				finished.push_back(m_writes[i]);
+			}
+		}
+	}
+
+	if (!finished.empty())
+	{
+		Report(finished);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigJob::Report>
+//	Run the callback for writes that now have a result, then once more when
+//	the job first becomes complete.  Start calls it even with no results, so
+//	that a job with nothing to send completes.  Must be called without
+//	m_lock held.
+//-----------------------------------------------------------------------------
+void ConfigJob::Report(std::vector<ConfigWrite> const& _finished)
+{
+	uint32 done;
+	uint32 total;
+	bool complete = false;
+	{
+		LockGuard guard(m_lock);
+		done = m_done;
+		total = m_total;
+		m_done += (uint32)_finished.size();
+		if (m_done == m_total && !m_completed)
+		{
+			m_completed = true;
+			complete = true;
+		}
+	}
+
+	if (m_callback == NULL)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < _finished.size(); ++i)
+	{
+		m_callback(&_finished[i], ++done, total, m_context);
+	}
+	if (complete)
+	{
+		m_callback(NULL, done, total, m_context);
+	}
+}
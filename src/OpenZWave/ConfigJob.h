@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+//
+//      ConfigJob.h
+//
+//      Applies a configuration profile to a node, one changed parameter at a time
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		enum ConfigResult
+		{
+			ConfigResult_Pending = 0,		// Differs from the cached value; not yet confirmed
+			ConfigResult_Unchanged,			// Already at the profile's value; nothing sent
+			ConfigResult_Succeeded,			// The node reported the profile's value
+			ConfigResult_Failed,			// Rejected, reported with another value, or timed out
+			ConfigResult_NotFound			// The node has no such parameter, or it is read only
+		};
+
+		struct ConfigWrite
+		{
+			uint64			m_valueId;		// On this node; 0 if not found
+			uint8			m_commandClassId;
+			uint8			m_instance;
+			uint16			m_index;
+			std::string		m_value;		// As for Manager::SetValue(ValueID, string)
+			ConfigResult	m_result;
+		};
+
+		typedef void(*pfnOnConfigProgress_t)(ConfigWrite const* _write, uint32 _done, uint32 _total, void* _context);
+
+		// Compares a profile with the node's cached configuration values and
+		// writes only the parameters that differ.  A write is confirmed by the
+		// ValueChanged or ValueRefreshed notification for its value, which
+		// OpenZWave raises when the node reports the parameter back.  Only
+		// notifications for the job's node count.  A Dead notification fails
+		// every write sent and still waiting.  A Timeout fails the write of the
+		// value it names, or, as OpenZWave sends the writes one at a time and
+		// usually names no value, the oldest write sent and still waiting.
+		// The callback runs once per write sent, and once more with a NULL
+		// write when every write has a result.
+		class ConfigJob
+		{
+		public:
+			ConfigJob(uint32 _homeId, uint8 _nodeId, std::vector<ConfigWrite> const& _profile, pfnOnConfigProgress_t _callback, void* _context);
+			~ConfigJob();
+
+			// Send the differing parameters.  Writes not confirmed within the
+			// timeout fail; 0 waits indefinitely, for sleeping nodes.
+			// Returns the number sent.
+			uint32 Start(uint32 _timeoutMs);
+
+			// Every entry of the profile, in profile order
+			void GetResults(std::vector<ConfigWrite>* o_results);
+			bool IsComplete();
+
+			// Forward OpenZWave notifications to every live job
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			ConfigJob(ConfigJob const&);
+			ConfigJob& operator=(ConfigJob const&);
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+
+			void HandleNotification(Notification const* _notification);
+			void Expire();
+			void Report(std::vector<ConfigWrite> const& _finished);
+
+			uint32						m_homeId;
+			uint8						m_nodeId;
+			pfnOnConfigProgress_t		m_callback;
+			void*						m_context;
+			PTP_TIMER					m_timer;
+
+			Lock						m_lock;
+			std::vector<ConfigWrite>	m_writes;
+			std::vector<size_t>			m_order;		// Indices into m_writes of the writes sent, in order
+			bool						m_started;
+			bool						m_completed;	// The NULL callback has run
+			uint32						m_total;		// Writes sent
+			uint32						m_sent;			// Writes handed to OpenZWave so far
+			uint32						m_done;			// Sent writes with a result
+
+			static Lock						s_lock;
+			static std::vector<ConfigJob*>	s_jobs;
+		};
+	}
+}
@@ -0,0 +1,146 @@
+//-----------------------------------------------------------------------------
+//
+//      ConfigTable.cpp
+//
+//      Index of every configuration value, by node
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "ConfigTable.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock ConfigTable::s_lock;
+ConfigTable::NodeMap ConfigTable::s_values;
+
+namespace
+{
+	bool ParameterOrder(ConfigParameter const& _a, ConfigParameter const& _b)
+	{
+		if (_a.m_commandClassId != _b.m_commandClassId)
+			return _a.m_commandClassId < _b.m_commandClassId;
+		if (_a.m_instance != _b.m_instance)
+			return _a.m_instance < _b.m_instance;
+		return _a.m_index < _b.m_index;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigTable::OnNotification>
+//	Track the configuration values of every node
+//-----------------------------------------------------------------------------
+void ConfigTable::OnNotification(Notification const* _notification)
+{
+	switch (_notification->GetType())
+	{
+	case Notification::Type_ValueAdded:
+	case Notification::Type_ValueRemoved:
+	{
+		ValueID const& valueId = _notification->GetValueID();
+		if (valueId.GetGenre() != ValueID::ValueGenre_Config)
+		{
+			return;
+		}
+
+		LockGuard guard(s_lock);
+		std::vector<uint64>& values = s_values[NodeKey(valueId.GetHomeId(), valueId.GetNodeId())];
+		std::vector<uint64>::iterator it = std::find(values.begin(), values.end(), valueId.GetId());
+		if (_notification->GetType() == Notification::Type_ValueAdded)
+		{
+			if (it == values.end())
+			{
+				values.push_back(valueId.GetId());
+			}
+		}
+		else if (it != values.end())
+		{
+			values.erase(it);
+		}
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		LockGuard guard(s_lock);
+		s_values.erase(NodeKey(_notification->GetHomeId(), _notification->GetNodeId()));
+		break;
+	}
+	case Notification::Type_DriverReset:
+	case Notification::Type_DriverRemoved:
+	{
+		LockGuard guard(s_lock);
+		uint64 first = NodeKey(_notification->GetHomeId(), 0);
+		s_values.erase(s_values.lower_bound(first), s_values.lower_bound(first + 0x100));
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigTable::Shutdown>
+//	Forget every network
+//-----------------------------------------------------------------------------
+void ConfigTable::Shutdown()
+{
+	LockGuard guard(s_lock);
+	s_values.clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigTable::GetParameters>
+//	Read every configuration value of a node from OpenZWave's cache
+//-----------------------------------------------------------------------------
+void ConfigTable::GetParameters(uint32 _homeId, uint8 _nodeId, std::vector<ConfigParameter>* o_parameters)
+{
+	o_parameters->clear();
+
+	std::vector<uint64> ids;
+	{
+		SharedLockGuard guard(s_lock);
+		NodeMap::const_iterator it = s_values.find(NodeKey(_homeId, _nodeId));
+		if (it != s_values.end())
+		{
+			ids = it->second;
+		}
+	}
+
+	Manager* manager = Manager::Get();
+	o_parameters->reserve(ids.size());
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		ValueID valueId(_homeId, ids[i]);
+		ConfigParameter parameter;
+		parameter.m_valueId = ids[i];
+		parameter.m_commandClassId = valueId.GetCommandClassId();
+		parameter.m_instance = valueId.GetInstance();
+		parameter.m_index = valueId.GetIndex();
+		parameter.m_type = (uint8)valueId.GetType();
+		parameter.m_readOnly = manager->IsValueReadOnly(valueId);
+		parameter.m_label = manager->GetValueLabel(valueId);
+		manager->GetValueAsString(valueId, &parameter.m_value);
+		o_parameters->push_back(parameter);
+	}
+
+	std::sort(o_parameters->begin(), o_parameters->end(), ParameterOrder);
+}
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+//
+//      ConfigTable.h
+//
+//      Index of every configuration value, by node
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct ConfigParameter
+		{
+			uint64		m_valueId;			// ValueID::GetId
+			uint8		m_commandClassId;
+			uint8		m_instance;
+			uint16		m_index;
+			uint8		m_type;				// ValueID::ValueType
+			bool		m_readOnly;
+			std::string	m_label;
+			std::string	m_value;			// Manager::GetValueAsString
+		};
+
+		// OpenZWave cannot list a node's values, so the table follows the
+		// ValueAdded and ValueRemoved notifications for the Config genre.
+		class ConfigTable
+		{
+		public:
+			static void OnNotification(Notification const* _notification);
+
+			// The node's configuration values with their cached state, sorted
+			// by command class, instance and index
+			static void GetParameters(uint32 _homeId, uint8 _nodeId, std::vector<ConfigParameter>* o_parameters);
+
+			// Forget every network
+			static void Shutdown();
+
+		private:
+			typedef std::map<uint64, std::vector<uint64> > NodeMap;
+
+			static uint64 NodeKey(uint32 _homeId, uint8 _nodeId) { return ((uint64)_homeId << 8) | _nodeId; }
+
+			static Lock		s_lock;
+			static NodeMap	s_values;		// Value IDs by home and node
+		};
+	}
+}
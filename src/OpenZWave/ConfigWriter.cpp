@@ -0,0 +1,455 @@
+//-----------------------------------------------------------------------------
+//
+//      ConfigWriter.cpp
+//
+//      Debounced background writes of the network configuration file
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstring>
+#include <vector>
+#include "FileMapping.h"
+#include "ConfigWriter.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock ConfigWriter::s_lock;
+Lock ConfigWriter::s_writeLock;
+uint32 ConfigWriter::s_delayMs = 2000;
+uint32 ConfigWriter::s_maxDelayMs = 30000;
+ConfigWriter::HomeMap ConfigWriter::s_homes;
+
+namespace
+{
+	char const c_configEnd[] = "</Driver>";
+	wchar_t const c_backupSuffix[] = L".bak";
+
+	std::wstring ConfigPath(std::wstring const& _userPath, uint32 _homeId)
+	{
+		wchar_t name[32];
+		swprintf(name, sizeof(name) / sizeof(name[0]), L"zwcfg_0x%08x.xml", _homeId);
+		return _userPath + name;
+	}
+
+	// A file OpenZWave finished writing ends with the closing Driver element
+	bool IsComplete(std::wstring const& _path, uint64* o_size)
+	{
+		*o_size = 0;
+		HANDLE file = OpenFileHandle(_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		bool complete = false;
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(file, &size))
+		{
+			*o_size = (uint64)size.QuadPart;
+
+			char tail[64];
+			LARGE_INTEGER start;
+			start.QuadPart = size.QuadPart > (LONGLONG)sizeof(tail) ? size.QuadPart - (LONGLONG)sizeof(tail) : 0;
+			DWORD read = 0;
+			if (SetFilePointerEx(file, start, NULL, FILE_BEGIN) && ReadFile(file, tail, sizeof(tail), &read, NULL))
+			{
+				// Only whitespace may follow it
+				DWORD end = read;
+				while (end > 0 && (tail[end - 1] == '\n' || tail[end - 1] == '\r' || tail[end - 1] == ' ' || tail[end - 1] == '\t'))
+				{
+					--end;
+				}
+				size_t length = sizeof(c_configEnd) - 1;
+				complete = end >= length && memcmp(tail + end - length, c_configEnd, length) == 0;
+			}
+		}
+		CloseHandle(file);
+		return complete;
+	}
+
+	void SetDueTime(PTP_TIMER _timer, uint32 _delayMs)
+	{
+		// Negative due times are relative, in 100ns units
+		ULARGE_INTEGER due;
+		due.QuadPart = (ULONGLONG)(-((LONGLONG)(_delayMs > 0 ? _delayMs : 1) * 10000));
+		FILETIME dueTime;
+		dueTime.dwLowDateTime = due.LowPart;
+		dueTime.dwHighDateTime = due.HighPart;
+		SetThreadpoolTimer(_timer, &dueTime, 0, 0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::GetDelay>
+//	Milliseconds without a request before a write starts
+//-----------------------------------------------------------------------------
+uint32 ConfigWriter::GetDelay()
+{
+	SharedLockGuard guard(s_lock);
+	return s_delayMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::SetDelay>
+//	Change the debounce delay of later requests
+//-----------------------------------------------------------------------------
+void ConfigWriter::SetDelay(uint32 _delayMs)
+{
+	LockGuard guard(s_lock);
+	s_delayMs = _delayMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::GetMaxDelay>
+//	Longest a request waits while others keep arriving
+//-----------------------------------------------------------------------------
+uint32 ConfigWriter::GetMaxDelay()
+{
+	SharedLockGuard guard(s_lock);
+	return s_maxDelayMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::SetMaxDelay>
+//	Change the longest wait of later requests
+//-----------------------------------------------------------------------------
+void ConfigWriter::SetMaxDelay(uint32 _maxDelayMs)
+{
+	LockGuard guard(s_lock);
+	s_maxDelayMs = _maxDelayMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::SetAutoWrite>
+//	Request writes from the notifications of a network
+//-----------------------------------------------------------------------------
+void ConfigWriter::SetAutoWrite(uint32 _homeId, bool _enabled)
+{
+	LockGuard guard(s_lock);
+	GetHome(_homeId).m_autoWrite = _enabled;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::GetAutoWrite>
+//	Whether notifications of a network request writes
+//-----------------------------------------------------------------------------
+bool ConfigWriter::GetAutoWrite(uint32 _homeId)
+{
+	SharedLockGuard guard(s_lock);
+	HomeMap::const_iterator it = s_homes.find(_homeId);
+	return it != s_homes.end() && it->second.m_autoWrite;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::Request>
+//	Schedule a write, merging it with any write already pending
+//-----------------------------------------------------------------------------
+void ConfigWriter::Request(uint32 _homeId)
+{
+	uint64 now = GetTickCount64();
+
+	LockGuard guard(s_lock);
+	Home& home = GetHome(_homeId);
+	++home.m_stats.m_requests;
+	if (!home.m_stats.m_pending)
+	{
+		home.m_stats.m_pending = true;
+		home.m_firstRequest = now;
+	}
+
+	// Each request pushes the write back, but never past the maximum delay
+	uint64 deadline = home.m_firstRequest + s_maxDelayMs;
+	uint32 delay = s_delayMs;
+	if (now + delay > deadline)
+	{
+		delay = (deadline > now) ? (uint32)(deadline - now) : 0;
+	}
+	if (home.m_timer == NULL)
+	{
+		home.m_timer = CreateThreadpoolTimer(OnTimer, (PVOID)(uintptr_t)_homeId, NULL);
+	}
+	if (home.m_timer != NULL)
+	{
+		SetDueTime(home.m_timer, delay);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::Flush>
+//	Do the pending write of a network now
+//-----------------------------------------------------------------------------
+bool ConfigWriter::Flush(uint32 _homeId)
+{
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator it = s_homes.find(_homeId);
+		if (it == s_homes.end() || !it->second.m_stats.m_pending)
+		{
+			return true;
+		}
+	}
+	return Write(_homeId);
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::Write>
+//	Set the current file aside, have OpenZWave write a new one, and check it
+//-----------------------------------------------------------------------------
+bool ConfigWriter::Write(uint32 _homeId)
+{
+	Manager* manager = Manager::Get();
+	if (manager == NULL)
+	{
+		return false;
+	}
+
+	LockGuard writeGuard(s_writeLock);
+
+	// Requests from here on need another write
+	{
+		LockGuard guard(s_lock);
+		GetHome(_homeId).m_stats.m_pending = false;
+	}
+
+	std::wstring path = ConfigPath(GetUserPath(), _homeId);
+	std::wstring backup = path + c_backupSuffix;
+
+	// A file that is already cut short must not replace a good backup
+	uint64 size = 0;
+	bool setAside = IsComplete(path, &size) && MoveFileExW(path.c_str(), backup.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+	uint64 start = GetTickCount64();
+	manager->WriteConfig(_homeId);
+	uint32 duration = (uint32)(GetTickCount64() - start);
+
+	bool written = IsComplete(path, &size);
+	if (!written && setAside)
+	{
+		MoveFileExW(backup.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+
+	LockGuard guard(s_lock);
+	ConfigWriteStats& stats = GetHome(_homeId).m_stats;
+	if (written)
+	{
+		++stats.m_writes;
+		stats.m_lastDurationMs = duration;
+		stats.m_lastBytes = size;
+		stats.m_totalBytes += size;
+		stats.m_lastWrittenAt = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+	}
+	else
+	{
+		++stats.m_failures;
+	}
+	return written;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::GetStats>
+//	Counters and the result of the last write of a network
+//-----------------------------------------------------------------------------
+void ConfigWriter::GetStats(uint32 _homeId, ConfigWriteStats* o_stats)
+{
+	SharedLockGuard guard(s_lock);
+	HomeMap::const_iterator it = s_homes.find(_homeId);
+	if (it != s_homes.end())
+	{
+		*o_stats = it->second.m_stats;
+	}
+	else
+	{
+		memset(o_stats, 0, sizeof(*o_stats));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::Recover>
+//	Put back the backups of configuration files that were not written fully
+//-----------------------------------------------------------------------------
+uint32 ConfigWriter::Recover()
+{
+	LockGuard writeGuard(s_writeLock);
+
+	std::wstring userPath = GetUserPath();
+	std::vector<std::wstring> backups;
+	WIN32_FIND_DATAW data;
+	HANDLE find = FindFirstFileExW((userPath + L"zwcfg_0x*.xml" + c_backupSuffix).c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, NULL, 0);
+	if (find != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			backups.push_back(userPath + data.cFileName);
+		}
+		while (FindNextFileW(find, &data));
+		FindClose(find);
+	}
+
+	uint32 restored = 0;
+	size_t suffix = sizeof(c_backupSuffix) / sizeof(c_backupSuffix[0]) - 1;
+	for (size_t i = 0; i < backups.size(); ++i)
+	{
+		std::wstring path = backups[i].substr(0, backups[i].size() - suffix);
+		uint64 size = 0;
+		if (!IsComplete(path, &size) && IsComplete(backups[i], &size) && MoveFileExW(backups[i].c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		{
+			++restored;
+		}
+	}
+	return restored;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::Shutdown>
+//	Stop the timers and do the writes they were waiting for
+//-----------------------------------------------------------------------------
+void ConfigWriter::Shutdown()
+{
+	std::vector<PTP_TIMER> timers;
+	std::vector<uint32> pending;
+	{
+		LockGuard guard(s_lock);
+		for (HomeMap::iterator it = s_homes.begin(); it != s_homes.end(); ++it)
+		{
+			if (it->second.m_timer != NULL)
+			{
+				timers.push_back(it->second.m_timer);
+				it->second.m_timer = NULL;
+			}
+			if (it->second.m_stats.m_pending)
+			{
+				pending.push_back(it->first);
+			}
+		}
+	}
+
+	// The callback takes s_lock, so wait for it outside
+	for (size_t i = 0; i < timers.size(); ++i)
+	{
+		SetThreadpoolTimer(timers[i], NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(timers[i], TRUE);
+		CloseThreadpoolTimer(timers[i]);
+	}
+
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		Flush(pending[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::OnNotification>
+//	Request a write after changes that are saved in the configuration file
+//-----------------------------------------------------------------------------
+void ConfigWriter::OnNotification(Notification const* _notification)
+{
+	switch (_notification->GetType())
+	{
+		case Notification::Type_NodeAdded:
+		case Notification::Type_NodeRemoved:
+		case Notification::Type_NodeNaming:
+		case Notification::Type_Group:
+		{
+			break;
+		}
+		case Notification::Type_ValueChanged:
+		{
+			if (_notification->GetValueID().GetGenre() != ValueID::ValueGenre_Config)
+			{
+				return;
+			}
+			break;
+		}
+		case Notification::Type_DriverRemoved:
+		{
+			// OpenZWave writes the file itself as the driver is removed
+			LockGuard guard(s_lock);
+			HomeMap::iterator it = s_homes.find(_notification->GetHomeId());
+			if (it != s_homes.end())
+			{
+				it->second.m_stats.m_pending = false;
+				if (it->second.m_timer != NULL)
+				{
+					SetThreadpoolTimer(it->second.m_timer, NULL, 0, 0);
+				}
+			}
+			return;
+		}
+		default:
+		{
+			return;
+		}
+	}
+
+	if (GetAutoWrite(_notification->GetHomeId()))
+	{
+		Request(_notification->GetHomeId());
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::OnTimer>
+//	Write a network once its requests have settled
+//-----------------------------------------------------------------------------
+VOID CALLBACK ConfigWriter::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	Flush((uint32)(uintptr_t)_context);
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::GetHome>
+//	The state of a network, created on first use.  Needs s_lock.
+//-----------------------------------------------------------------------------
+ConfigWriter::Home& ConfigWriter::GetHome(uint32 _homeId)
+{
+	HomeMap::iterator it = s_homes.find(_homeId);
+	if (it == s_homes.end())
+	{
+		Home home;
+		home.m_timer = NULL;
+		home.m_autoWrite = false;
+		home.m_firstRequest = 0;
+		memset(&home.m_stats, 0, sizeof(home.m_stats));
+		it = s_homes.insert(HomeMap::value_type(_homeId, home)).first;
+	}
+	return it->second;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConfigWriter::GetUserPath>
+//	The folder OpenZWave writes its configuration files to
+//-----------------------------------------------------------------------------
+std::wstring ConfigWriter::GetUserPath()
+{
+	std::string userPath;
+	Options* options = Options::Get();
+	if (options == NULL || !options->GetOptionAsString("UserPath", &userPath) || userPath.empty())
+	{
+		return std::wstring();
+	}
+
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> convert;
+	return convert.from_bytes(userPath);
+}
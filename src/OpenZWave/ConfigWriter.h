@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+//
+//      ConfigWriter.h
+//
+//      Debounced background writes of the network configuration file
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <string>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct ConfigWriteStats
+		{
+			uint32	m_requests;			// Requests, including those merged into a later write
+			uint32	m_writes;
+			uint32	m_failures;
+			uint32	m_lastDurationMs;
+			uint64	m_lastBytes;
+			uint64	m_totalBytes;
+			int64	m_lastWrittenAt;	// UTC file time, 0 if never written
+			bool	m_pending;
+		};
+
+		// Manager::WriteConfig rewrites the whole zwcfg_0x<home>.xml in place,
+		// on the calling thread.  Requests are debounced: a write starts once no
+		// request has arrived for the delay, or once the oldest request has
+		// waited the maximum delay, on a threadpool thread.  OpenZWave only
+		// writes in place, so before each write the current file is renamed to
+		// a .bak file; a write that does not complete is rolled back from it,
+		// and Recover restores files cut short by a crash.
+		class ConfigWriter
+		{
+		public:
+			static uint32 GetDelay();
+			static void SetDelay(uint32 _delayMs);
+			static uint32 GetMaxDelay();
+			static void SetMaxDelay(uint32 _maxDelayMs);
+
+			// Request a write after changes that OpenZWave saves in the file
+			static void SetAutoWrite(uint32 _homeId, bool _enabled);
+			static bool GetAutoWrite(uint32 _homeId);
+
+			static void Request(uint32 _homeId);
+
+			// Write now if a write is pending
+			static bool Flush(uint32 _homeId);
+
+			// Write now, on the calling thread
+			static bool Write(uint32 _homeId);
+
+			static void GetStats(uint32 _homeId, ConfigWriteStats* o_stats);
+
+			// Restore, from their backups, the files that are missing or cut
+			// short.  Returns the number restored.  Call before AddDriver.
+			static uint32 Recover();
+
+			// Write what is pending and stop the timers, before the manager is destroyed
+			static void Shutdown();
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			struct Home
+			{
+				PTP_TIMER			m_timer;
+				bool				m_autoWrite;
+				uint64				m_firstRequest;		// Tick count of the oldest pending request
+				ConfigWriteStats	m_stats;
+			};
+
+			typedef std::map<uint32, Home> HomeMap;
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+			static Home& GetHome(uint32 _homeId);
+			static std::wstring GetUserPath();
+
+			static Lock			s_lock;
+			static Lock			s_writeLock;		// One write at a time
+			static uint32		s_delayMs;
+			static uint32		s_maxDelayMs;
+			static HomeMap		s_homes;
+		};
+	}
+}
@@ -0,0 +1,562 @@
+//-----------------------------------------------------------------------------
+//
+//      ControllerHost.cpp
+//
+//      Shares the network of this process with client processes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstring>
+#include <vector>
+#include <bcrypt.h>
+#include "ControllerHost.h"
+#include "FileMapping.h"
+#include "LocalSocket.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool ControllerHost::s_running = false;
+Lock ControllerHost::s_lock;
+HANDLE ControllerHost::s_mapping = NULL;
+HostSection* ControllerHost::s_section = NULL;
+SOCKET ControllerHost::s_listen = INVALID_SOCKET;
+PTP_WORK ControllerHost::s_work = NULL;
+std::wstring ControllerHost::s_socketPath;
+LONG64 ControllerHost::s_published = 0;
+std::string ControllerHost::s_commandString;
+uint8 ControllerHost::s_token[c_hostTokenSize];
+
+namespace
+{
+	// How often the serving callback looks for Stop between commands
+	long const c_pollMs = 250;
+
+	// A client that stops part way through a command cannot hold up the rest
+	DWORD const c_receiveTimeoutMs = 2000;
+
+	// select takes at most FD_SETSIZE sockets, one of them the listener
+	size_t const c_maxClients = FD_SETSIZE - 1;
+
+	// Probes stay short while a quarter of the table is free
+	LONG const c_maxValues = c_hostValueCapacity - c_hostValueCapacity / 4;
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::Start>
+//	Create the shared section and start serving commands
+//-----------------------------------------------------------------------------
+bool ControllerHost::Start(std::wstring const& _name, uint16 _port, std::wstring const& _socketPath)
+{
+	Stop();
+
+	if (_socketPath.size() >= c_hostPathSize)
+	{
+		return false;
+	}
+
+	HANDLE mapping;
+	bool existed;
+	HostSection* section = (HostSection*)CreateSharedMemory(GetHostSectionName(_name), sizeof(HostSection), &mapping, &existed);
+	if (section == NULL || (existed && IsHostAlive(section->m_header)))
+	{
+		if (section != NULL)
+		{
+			UnmapViewOfFile(section);
+		}
+		if (mapping != NULL)
+		{
+			CloseHandle(mapping);
+		}
+		return false;
+	}
+
+	uint8 token[c_hostTokenSize];
+	if (!BCRYPT_SUCCESS(BCryptGenRandom(NULL, token, sizeof(token), BCRYPT_USE_SYSTEM_PREFERRED_RNG)))
+	{
+		UnmapViewOfFile(section);
+		CloseHandle(mapping);
+		return false;
+	}
+
+	SOCKET listener = ListenLocal(_port, _socketPath);
+	PTP_WORK work = (listener != INVALID_SOCKET) ? CreateThreadpoolWork(OnWork, (PVOID)listener, NULL) : NULL;
+	if (work == NULL)
+	{
+		if (listener != INVALID_SOCKET)
+		{
+			CloseLocalSocket(listener);
+		}
+		UnmapViewOfFile(section);
+		CloseHandle(mapping);
+		return false;
+	}
+
+	// Clients of an earlier host may still have the section open, and see
+	// the new start time
+	memset(section, 0, sizeof(HostSection));
+	HostHeader& header = section->m_header;
+	header.m_version = c_hostVersion;
+	header.m_ringCapacity = c_hostRingCapacity;
+	header.m_valueCapacity = c_hostValueCapacity;
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	header.m_started = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+	header.m_port = _socketPath.empty() ? GetLocalPort(listener) : 0;
+	memcpy(header.m_socketPath, _socketPath.c_str(), _socketPath.size() * sizeof(wchar_t));
+	memcpy(header.m_token, token, sizeof(token));
+	MemoryBarrier();
+	header.m_magic = c_hostMagic;
+
+	{
+		LockGuard guard(s_lock);
+		s_mapping = mapping;
+		s_section = section;
+		s_listen = listener;
+		s_work = work;
+		s_socketPath = _socketPath;
+		s_published = 0;
+		memcpy(s_token, token, sizeof(token));
+		InterlockedExchange(&header.m_running, 1);
+		s_running = true;
+	}
+	SubmitThreadpoolWork(work);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::IsHostAlive>
+//	Whether the header of a section that was already there belongs to a host
+//	in another process that still answers on its socket.  One that ended
+//	without Stop leaves m_running set for as long as its clients keep the
+//	section open.
+//-----------------------------------------------------------------------------
+bool ControllerHost::IsHostAlive(HostHeader const& _header)
+{
+	if (_header.m_magic != c_hostMagic || _header.m_running == 0)
+	{
+		return false;
+	}
+
+	wchar_t path[c_hostPathSize];
+	memcpy(path, _header.m_socketPath, sizeof(path));
+	path[c_hostPathSize - 1] = 0;
+	SOCKET probe = ConnectLocal(_header.m_port, std::wstring(path));
+	if (probe == INVALID_SOCKET)
+	{
+		return false;
+	}
+	CloseLocalSocket(probe);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::Stop>
+//	Tell clients the host has gone, stop serving and unmap the section
+//-----------------------------------------------------------------------------
+void ControllerHost::Stop()
+{
+	HANDLE mapping;
+	HostSection* section;
+	SOCKET listener;
+	PTP_WORK work;
+	std::wstring path;
+	{
+		LockGuard guard(s_lock);
+		if (!s_running)
+		{
+			return;
+		}
+		s_running = false;
+		InterlockedExchange(&s_section->m_header.m_running, 0);
+		mapping = s_mapping;
+		s_mapping = NULL;
+		section = s_section;
+		s_section = NULL;
+		listener = s_listen;
+		s_listen = INVALID_SOCKET;
+		work = s_work;
+		s_work = NULL;
+		path.swap(s_socketPath);
+	}
+
+	CloseLocalSocket(listener);
+	WaitForThreadpoolWorkCallbacks(work, FALSE);
+	CloseThreadpoolWork(work);
+	if (!path.empty())
+	{
+		DeleteFileW(path.c_str());
+	}
+	UnmapViewOfFile(section);
+	CloseHandle(mapping);
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::OnWork>
+//	Serve the commands of every connected client until stopped
+//-----------------------------------------------------------------------------
+VOID CALLBACK ControllerHost::OnWork(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_WORK _work)
+{
+	CallbackMayRunLong(_instance);
+
+	SOCKET listener = (SOCKET)_context;
+	std::vector<SOCKET> clients;
+	while (s_running)
+	{
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(listener, &readable);
+		for (size_t i = 0; i < clients.size(); ++i)
+		{
+			FD_SET(clients[i], &readable);
+		}
+
+		timeval timeout;
+		timeout.tv_sec = 0;
+		timeout.tv_usec = c_pollMs * 1000;
+		int ready = select(0, &readable, NULL, NULL, &timeout);
+		if (ready == SOCKET_ERROR)
+		{
+			// The listening socket was closed by Stop
+			break;
+		}
+		if (ready == 0)
+		{
+			continue;
+		}
+
+		if (FD_ISSET(listener, &readable))
+		{
+			SOCKET client = accept(listener, NULL, NULL);
+			if (client != INVALID_SOCKET)
+			{
+				if (clients.size() < c_maxClients)
+				{
+					DWORD timeout = c_receiveTimeoutMs;
+					setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (char const*)&timeout, sizeof(timeout));
+					clients.push_back(client);
+				}
+				else
+				{
+					closesocket(client);
+				}
+			}
+		}
+
+		for (size_t i = clients.size(); i-- > 0; )
+		{
+			if (FD_ISSET(clients[i], &readable) && !Serve(clients[i]))
+			{
+				closesocket(clients[i]);
+				clients.erase(clients.begin() + i);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < clients.size(); ++i)
+	{
+		closesocket(clients[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::Serve>
+//	Read one command from a client and answer it.  False once the client
+//	has gone or sent something that is not a command.
+//-----------------------------------------------------------------------------
+bool ControllerHost::Serve(SOCKET _client)
+{
+	HostCommand command;
+	if (!ReceiveAll(_client, (char*)&command, sizeof(command)) || command.m_stringLength > c_hostMaxCommandString
+		|| memcmp(command.m_token, s_token, sizeof(s_token)) != 0)
+	{
+		return false;
+	}
+
+	s_commandString.resize(command.m_stringLength);
+	if (command.m_stringLength > 0 && !ReceiveAll(_client, &s_commandString[0], (int)command.m_stringLength))
+	{
+		return false;
+	}
+
+	HostReply reply;
+	reply.m_result = Execute(command, s_commandString) ? 1 : 0;
+	return SendAll(_client, (char const*)&reply, sizeof(reply));
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::Execute>
+//	Pass a command to OpenZWave
+//-----------------------------------------------------------------------------
+bool ControllerHost::Execute(HostCommand const& _command, std::string const& _string)
+{
+	Manager* manager = Manager::Get();
+	ValueID valueId(_command.m_homeId, _command.m_valueId);
+	switch (_command.m_command)
+	{
+	case HostCommand_SetBool:			return manager->SetValue(valueId, _command.m_int != 0);
+	case HostCommand_SetByte:			return manager->SetValue(valueId, (uint8)_command.m_int);
+	case HostCommand_SetShort:			return manager->SetValue(valueId, (int16)_command.m_int);
+	case HostCommand_SetInt:			return manager->SetValue(valueId, (int32)_command.m_int);
+	case HostCommand_SetFloat:			return manager->SetValue(valueId, _command.m_float);
+	case HostCommand_SetString:			return manager->SetValue(valueId, _string);
+	case HostCommand_SetListSelection:	return manager->SetValueListSelection(valueId, _string);
+	case HostCommand_RefreshValue:		return manager->RefreshValue(valueId);
+	case HostCommand_RequestNodeState:	return manager->RequestNodeState(_command.m_homeId, (uint8)_command.m_valueId);
+	default:							return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::OnNotification>
+//	Publish a notification, and the value it is about
+//-----------------------------------------------------------------------------
+void ControllerHost::OnNotification(Notification const* _notification)
+{
+	if (!s_running)
+	{
+		return;
+	}
+
+	// OpenZWave is read before the lock is taken
+	Notification::NotificationType type = _notification->GetType();
+	bool staged = (type == Notification::Type_ValueAdded || type == Notification::Type_ValueChanged || type == Notification::Type_ValueRefreshed);
+	HostValue value;
+	if (staged)
+	{
+		Stage(_notification->GetValueID(), &value);
+	}
+
+	SharedLockGuard guard(s_lock);
+	if (s_section == NULL)
+	{
+		return;
+	}
+
+	// The value first, so a client that sees the notification finds it
+	if (staged)
+	{
+		PublishValue(value);
+	}
+	else if (type == Notification::Type_ValueRemoved)
+	{
+		RemoveValues(_notification->GetHomeId(), 0, _notification->GetValueID().GetId());
+	}
+	else if (type == Notification::Type_NodeRemoved)
+	{
+		RemoveValues(_notification->GetHomeId(), _notification->GetNodeId(), 0);
+	}
+	else if (type == Notification::Type_DriverRemoved)
+	{
+		RemoveValues(_notification->GetHomeId(), 0, 0);
+	}
+	Publish(_notification);
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::Publish>
+//	Put a notification in the ring
+//-----------------------------------------------------------------------------
+void ControllerHost::Publish(Notification const* _notification)
+{
+	Notification::NotificationType type = _notification->GetType();
+	HostNotification& record = s_section->m_ring[s_published & (c_hostRingCapacity - 1)];
+
+	InterlockedExchange64(&record.m_stamp, s_published * 2 + 1);
+	record.m_valueId = _notification->GetValueID().GetId();
+	record.m_homeId = _notification->GetHomeId();
+	record.m_type = (uint8)type;
+	record.m_byte = _notification->GetByte();
+	record.m_event = (type == Notification::Type_NodeEvent || type == Notification::Type_ControllerCommand) ? _notification->GetEvent() : 0;
+	InterlockedExchange64(&record.m_stamp, s_published * 2 + 2);
+
+	++s_published;
+	InterlockedExchange64(&s_section->m_header.m_published, s_published);
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::Stage>
+//	Read a value from OpenZWave
+//-----------------------------------------------------------------------------
+void ControllerHost::Stage(ValueID const& _valueId, HostValue* o_value)
+{
+	Manager* manager = Manager::Get();
+	o_value->m_homeId = _valueId.GetHomeId();
+	o_value->m_valueId = _valueId.GetId();
+	o_value->m_int = 0;
+	o_value->m_float = 0;
+	o_value->m_flags = HostValueFlag_Present;
+
+	switch (_valueId.GetType())
+	{
+	case ValueID::ValueType_Bool:
+		{
+			bool value;
+			if (manager->GetValueAsBool(_valueId, &value))
+			{
+				o_value->m_int = value ? 1 : 0;
+			}
+			break;
+		}
+	case ValueID::ValueType_Byte:
+		{
+			uint8 value;
+			if (manager->GetValueAsByte(_valueId, &value))
+			{
+				o_value->m_int = value;
+			}
+			break;
+		}
+	case ValueID::ValueType_Short:
+		{
+			int16 value;
+			if (manager->GetValueAsShort(_valueId, &value))
+			{
+				o_value->m_int = value;
+			}
+			break;
+		}
+	case ValueID::ValueType_Int:
+		{
+			manager->GetValueAsInt(_valueId, &o_value->m_int);
+			break;
+		}
+	case ValueID::ValueType_Decimal:
+		{
+			manager->GetValueAsFloat(_valueId, &o_value->m_float);
+			break;
+		}
+	case ValueID::ValueType_List:
+		{
+			manager->GetValueListSelection(_valueId, &o_value->m_int);
+			break;
+		}
+	default:
+		{
+			break;
+		}
+	}
+
+	std::string text;
+	manager->GetValueAsString(_valueId, &text);
+	size_t length = text.size();
+	if (length > c_hostStringSize)
+	{
+		length = c_hostStringSize;
+		o_value->m_flags |= HostValueFlag_Truncated;
+	}
+	memcpy(o_value->m_string, text.data(), length);
+	o_value->m_stringLength = (uint16)length;
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::PublishValue>
+//	Write a staged value to its slot
+//-----------------------------------------------------------------------------
+void ControllerHost::PublishValue(HostValue const& _value)
+{
+	HostValue* slot = FindSlot(_value.m_homeId, _value.m_valueId, true);
+	if (slot == NULL)
+	{
+		InterlockedIncrement(&s_section->m_header.m_valuesDropped);
+		return;
+	}
+
+	InterlockedIncrement(&slot->m_sequence);
+	slot->m_int = _value.m_int;
+	slot->m_float = _value.m_float;
+	slot->m_flags = _value.m_flags;
+	slot->m_stringLength = _value.m_stringLength;
+	memcpy(slot->m_string, _value.m_string, _value.m_stringLength);
+	InterlockedIncrement(&slot->m_sequence);
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::ClearValue>
+//	Mark a slot's value removed
+//-----------------------------------------------------------------------------
+void ControllerHost::ClearValue(HostValue* _slot)
+{
+	InterlockedIncrement(&_slot->m_sequence);
+	_slot->m_flags = 0;
+	_slot->m_stringLength = 0;
+	InterlockedIncrement(&_slot->m_sequence);
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::RemoveValues>
+//	Mark one value, the values of a node, or those of a network removed
+//-----------------------------------------------------------------------------
+void ControllerHost::RemoveValues(uint32 _homeId, uint8 _nodeId, uint64 _valueId)
+{
+	if (_valueId != 0)
+	{
+		HostValue* slot = FindSlot(_homeId, _valueId, false);
+		if (slot != NULL)
+		{
+			ClearValue(slot);
+		}
+		return;
+	}
+
+	for (uint32 i = 0; i < c_hostValueCapacity; ++i)
+	{
+		HostValue& slot = s_section->m_values[i];
+		if (slot.m_homeId == _homeId && (slot.m_flags & HostValueFlag_Present) != 0
+			&& (_nodeId == 0 || ValueID(_homeId, slot.m_valueId).GetNodeId() == _nodeId))
+		{
+			ClearValue(&slot);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ControllerHost::FindSlot>
+//	Find the slot of a value, taking a free one for it if asked
+//-----------------------------------------------------------------------------
+HostValue* ControllerHost::FindSlot(uint32 _homeId, uint64 _valueId, bool _add)
+{
+	HostHeader& header = s_section->m_header;
+	uint32 index = HostValueHash(_homeId, _valueId);
+	for (uint32 probe = 0; probe < c_hostValueCapacity; ++probe)
+	{
+		HostValue& slot = s_section->m_values[(index + probe) & (c_hostValueCapacity - 1)];
+		if (slot.m_homeId == 0)
+		{
+			if (!_add || header.m_valueCount >= c_maxValues)
+			{
+				return NULL;
+			}
+
+			// Readers only compare the Value ID once the Home ID is set
+			slot.m_valueId = _valueId;
+			MemoryBarrier();
+			slot.m_homeId = _homeId;
+			InterlockedIncrement(&header.m_valueCount);
+			return &slot;
+		}
+		if (slot.m_homeId == _homeId && slot.m_valueId == _valueId)
+		{
+			return &slot;
+		}
+	}
+	return NULL;
+}
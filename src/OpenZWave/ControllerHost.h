@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+//
+//      ControllerHost.h
+//
+//      Shares the network of this process with client processes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include "HostFormat.h"
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Only one process can own the controller, so the host lets others
+		// use its network without a serial port of their own.  Each
+		// notification is copied into a ring in shared memory, and each
+		// value's current state into a table beside it, where any number of
+		// HostClient readers find them without a call to this process.  The
+		// few writes go over a local socket, served one command at a time by
+		// a thread pool callback.
+		//
+		// Values are published as they are added, so start the host before
+		// the first driver is added.
+		class ControllerHost
+		{
+		public:
+			// Create the section named _name and listen for commands on
+			// 127.0.0.1 at the port, or on the Unix domain socket at the path if
+			// it is not empty.  Stops this process's host if it is running,
+			// and fails if another process's host still answers under _name.
+			static bool Start(std::wstring const& _name, uint16 _port, std::wstring const& _socketPath);
+			static void Stop();
+			static bool IsRunning() { return s_running; }
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			static VOID CALLBACK OnWork(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_WORK _work);
+			static bool IsHostAlive(HostHeader const& _header);
+			static bool Serve(SOCKET _client);
+			static bool Execute(HostCommand const& _command, std::string const& _string);
+			static void Publish(Notification const* _notification);
+			static void Stage(ValueID const& _valueId, HostValue* o_value);
+			static void PublishValue(HostValue const& _value);
+			static void ClearValue(HostValue* _slot);
+			static void RemoveValues(uint32 _homeId, uint8 _nodeId, uint64 _valueId);
+			static HostValue* FindSlot(uint32 _homeId, uint64 _valueId, bool _add);
+
+			static volatile bool	s_running;
+
+			// Under s_lock.  OnNotification holds it shared while it writes the
+			// section, so Stop cannot unmap it underneath.
+			static Lock				s_lock;
+			static HANDLE			s_mapping;
+			static HostSection*		s_section;
+			static SOCKET			s_listen;
+			static PTP_WORK			s_work;
+			static std::wstring		s_socketPath;
+
+			// Used only from OnNotification.  OpenZWave's Manager delivers
+			// notifications to its watchers one at a time, under its
+			// notification mutex, even with several drivers.
+			static LONG64			s_published;
+
+			// Used only by the serving callback
+			static std::string		s_commandString;
+
+			// Set by Start before the serving callback is submitted
+			static uint8			s_token[c_hostTokenSize];
+		};
+	}
+}
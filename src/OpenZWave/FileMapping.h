@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------
+//
+//      FileMapping.h
+//
+//      File and read-only mapping helpers for desktop and UWP builds
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// CreateFileW and the file mapping functions are desktop only
+		inline HANDLE OpenFileHandle(std::wstring const& _path, DWORD _access, DWORD _share, DWORD _disposition)
+		{
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			return CreateFileW(_path.c_str(), _access, _share, NULL, _disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+			return CreateFile2(_path.c_str(), _access, _share, _disposition, NULL);
+#endif
+		}
+
+		// Maps a whole file, which must not be empty.  Release with
+		// UnmapViewOfFile and CloseHandle(*o_mapping).
+		inline uint8 const* MapFileReadOnly(HANDLE _file, HANDLE* o_mapping)
+		{
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			*o_mapping = CreateFileMappingW(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+			return (*o_mapping != NULL) ? (uint8 const*)MapViewOfFile(*o_mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+#else
+			*o_mapping = CreateFileMappingFromApp(_file, NULL, PAGE_READONLY, 0, NULL);
+			return (*o_mapping != NULL) ? (uint8 const*)MapViewOfFileFromApp(*o_mapping, FILE_MAP_READ, 0, 0) : NULL;
+#endif
+		}
+
+		// A section of the paging file that other processes open by name.
+		// *o_existed is set if another handle already had the section open,
+		// in which case its contents are kept.  Release with UnmapViewOfFile
+		// and CloseHandle(*o_mapping).
+		inline uint8* CreateSharedMemory(std::wstring const& _name, uint32 _size, HANDLE* o_mapping, bool* o_existed)
+		{
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			*o_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, _size, _name.c_str());
+			*o_existed = (*o_mapping != NULL) && (GetLastError() == ERROR_ALREADY_EXISTS);
+			return (*o_mapping != NULL) ? (uint8*)MapViewOfFile(*o_mapping, FILE_MAP_WRITE, 0, 0, 0) : NULL;
+#else
+			*o_mapping = CreateFileMappingFromApp(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, _size, _name.c_str());
+			*o_existed = (*o_mapping != NULL) && (GetLastError() == ERROR_ALREADY_EXISTS);
+			return (*o_mapping != NULL) ? (uint8*)MapViewOfFileFromApp(*o_mapping, FILE_MAP_WRITE, 0, 0) : NULL;
+#endif
+		}
+
+		// Maps a section made by CreateSharedMemory in another process
+		inline uint8 const* OpenSharedMemory(std::wstring const& _name, HANDLE* o_mapping)
+		{
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			*o_mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, _name.c_str());
+			return (*o_mapping != NULL) ? (uint8 const*)MapViewOfFile(*o_mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+#else
+			*o_mapping = OpenFileMappingFromApp(FILE_MAP_READ, FALSE, _name.c_str());
+			return (*o_mapping != NULL) ? (uint8 const*)MapViewOfFileFromApp(*o_mapping, FILE_MAP_READ, 0, 0) : NULL;
+#endif
+		}
+
+		// The file of a numbered segment, "<prefix>-<8 digit sequence>.<extension>"
+		inline std::wstring SegmentPath(std::wstring const& _directory, wchar_t const* _prefix, wchar_t const* _extension, uint32 _sequence)
+		{
+			wchar_t name[32];
+			swprintf(name, 32, L"-%08u.", _sequence);
+			return _directory + L"\\" + _prefix + name + _extension;
+		}
+
+		// The sequence numbers of the segments in a directory, oldest first
+		inline void ListSegments(std::wstring const& _directory, wchar_t const* _prefix, wchar_t const* _extension, std::vector<uint32>* o_sequences)
+		{
+			o_sequences->clear();
+			WIN32_FIND_DATAW data;
+			HANDLE find = FindFirstFileExW((_directory + L"\\" + _prefix + L"-*." + _extension).c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, NULL, 0);
+			if (find == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+			std::wstring format = std::wstring(_prefix) + L"-%u." + _extension;
+			do
+			{
+				uint32 sequence;
+				if (swscanf(data.cFileName, format.c_str(), &sequence) == 1)
+				{
+					o_sequences->push_back(sequence);
+				}
+			} while (FindNextFileW(find, &data));
+			FindClose(find);
+			std::sort(o_sequences->begin(), o_sequences->end());
+		}
+	}
+}
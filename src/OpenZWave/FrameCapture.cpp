@@ -0,0 +1,559 @@
+//-----------------------------------------------------------------------------
+//
+//      FrameCapture.cpp
+//
+//      Binary capture of the Serial API frames exchanged with the controller
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include "FileMapping.h"
+#include "LogSink.h"
+#include "FrameCapture.h"
+#include "TrafficCounters.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool FrameCapture::s_running = false;
+Lock FrameCapture::s_lock;
+std::vector<uint8> FrameCapture::s_pending;
+PTP_TIMER FrameCapture::s_timer = NULL;
+uint8 FrameCapture::s_lastNodeId = 0;
+uint8 FrameCapture::s_lastCallbackId = 0;
+uint8 FrameCapture::s_lastCommandClassId = 0;
+uint64 FrameCapture::s_frames = 0;
+uint64 FrameCapture::s_dropped = 0;
+Lock FrameCapture::s_ioLock;
+std::wstring FrameCapture::s_directory;
+uint32 FrameCapture::s_segmentSize = FrameCapture::c_defaultSegmentSize;
+uint32 FrameCapture::s_maxSegments = FrameCapture::c_defaultMaxSegments;
+uint32 FrameCapture::s_sequence = 0;
+uint32 FrameCapture::s_segments = 0;
+HANDLE FrameCapture::s_file = INVALID_HANDLE_VALUE;
+uint64 FrameCapture::s_fileSize = 0;
+uint64 FrameCapture::s_bytesWritten = 0;
+
+namespace
+{
+	uint32 const c_writeIntervalMs = 500;
+
+	// Records beyond this wait for the disk are dropped
+	size_t const c_maxPending = 4 * 1024 * 1024;
+
+	// Long enough for the hex of the largest frame
+	size_t const c_maxMessage = 2048;
+	uint32 const c_maxFrame = 258;
+
+	uint8 const c_ack = 0x06;
+	uint8 const c_nak = 0x15;
+	uint8 const c_can = 0x18;
+
+	// Functions whose requests from the controller start with the callback ID
+	bool HasCallback(uint8 _functionId)
+	{
+		switch (_functionId)
+		{
+			case 0x13:		// SendData
+			case 0x42:		// SetDefault
+			case 0x46:		// AssignReturnRoute
+			case 0x47:		// DeleteReturnRoute
+			case 0x48:		// RequestNodeNeighborUpdate
+			case 0x4a:		// AddNodeToNetwork
+			case 0x4b:		// RemoveNodeFromNetwork
+			case 0x4c:		// CreateNewPrimary
+			case 0x4d:		// ControllerChange
+			case 0x50:		// SetLearnMode
+			case 0x53:		// RequestNetworkUpdate
+			case 0x61:		// RemoveFailedNode
+			case 0x63:		// ReplaceFailedNode
+				return true;
+		}
+		return false;
+	}
+
+	uint8 HexDigit(char _c)
+	{
+		if (_c >= '0' && _c <= '9') return (uint8)(_c - '0');
+		if (_c >= 'a' && _c <= 'f') return (uint8)(_c - 'a' + 10);
+		if (_c >= 'A' && _c <= 'F') return (uint8)(_c - 'A' + 10);
+		return 0xff;
+	}
+
+	// Parses "0x01, 0x09, 0x00, ..." as the driver prints frames
+	uint32 ParseBytes(char const* _text, uint8* o_bytes, uint32 _max)
+	{
+		uint32 count = 0;
+		char const* cursor = _text;
+		while (count < _max)
+		{
+			while (*cursor == ' ' || *cursor == ',')
+			{
+				++cursor;
+			}
+			if (cursor[0] != '0' || (cursor[1] != 'x' && cursor[1] != 'X'))
+			{
+				break;
+			}
+			cursor += 2;
+
+			uint8 value = 0;
+			uint32 digits = 0;
+			for (uint8 digit; digits < 2 && (digit = HexDigit(*cursor)) != 0xff; ++digits, ++cursor)
+			{
+				value = (uint8)((value << 4) | digit);
+			}
+			if (digits == 0)
+			{
+				break;
+			}
+			o_bytes[count++] = value;
+		}
+		return count;
+	}
+
+	// The hex number after a label such as "Callback ID=0x", or 0
+	uint8 ParseHexAfter(char const* _text, char const* _label)
+	{
+		char const* found = strstr(_text, _label);
+		return (found != NULL) ? (uint8)strtoul(found + strlen(_label), NULL, 16) : 0;
+	}
+
+	void SetDueTime(PTP_TIMER _timer, uint32 _delayMs, uint32 _periodMs)
+	{
+		// Negative due times are relative, in 100ns units
+		ULARGE_INTEGER due;
+		due.QuadPart = (ULONGLONG)(-((LONGLONG)_delayMs * 10000));
+		FILETIME dueTime;
+		dueTime.dwLowDateTime = due.LowPart;
+		dueTime.dwHighDateTime = due.HighPart;
+		SetThreadpoolTimer(_timer, &dueTime, _periodMs, 0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::Start>
+//	Start capturing into a directory of segment files
+//-----------------------------------------------------------------------------
+bool FrameCapture::Start(std::wstring const& _directory, uint32 _segmentSize, uint32 _maxSegments)
+{
+	Stop();
+
+	{
+		LockGuard ioGuard(s_ioLock);
+		s_directory = _directory;
+		s_segmentSize = (_segmentSize > 0) ? _segmentSize : c_defaultSegmentSize;
+		s_maxSegments = (_maxSegments > 0) ? _maxSegments : c_defaultMaxSegments;
+		s_sequence = 0;
+		if (!OpenSegment())
+		{
+			return false;
+		}
+		Prune();
+	}
+
+	{
+		LockGuard guard(s_lock);
+		s_pending.clear();
+		s_lastNodeId = 0;
+		s_lastCallbackId = 0;
+		s_lastCommandClassId = 0;
+		s_timer = CreateThreadpoolTimer(OnTimer, NULL, NULL);
+		if (s_timer != NULL)
+		{
+			SetDueTime(s_timer, c_writeIntervalMs, c_writeIntervalMs);
+		}
+		s_running = true;
+	}
+
+	LogSink::Install();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::Stop>
+//	Stop capturing, write what is buffered and close the segment
+//-----------------------------------------------------------------------------
+void FrameCapture::Stop()
+{
+	PTP_TIMER timer;
+	{
+		LockGuard guard(s_lock);
+		s_running = false;
+		timer = s_timer;
+		s_timer = NULL;
+	}
+
+	if (timer != NULL)
+	{
+		SetThreadpoolTimer(timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(timer, TRUE);
+		CloseThreadpoolTimer(timer);
+	}
+
+	LockGuard ioGuard(s_ioLock);
+	Write();
+	if (s_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(s_file);
+		s_file = INVALID_HANDLE_VALUE;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::Flush>
+//	Write the buffered records on the calling thread
+//-----------------------------------------------------------------------------
+void FrameCapture::Flush()
+{
+	LockGuard ioGuard(s_ioLock);
+	Write();
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::GetStats>
+//	Counters of the capture
+//-----------------------------------------------------------------------------
+void FrameCapture::GetStats(FrameCaptureStats* o_stats)
+{
+	{
+		SharedLockGuard guard(s_lock);
+		o_stats->m_frames = s_frames;
+		o_stats->m_dropped = s_dropped;
+		o_stats->m_running = s_running;
+	}
+
+	SharedLockGuard ioGuard(s_ioLock);
+	o_stats->m_bytesWritten = s_bytesWritten;
+	o_stats->m_segments = s_segments;
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::OnLog>
+//	Turn a message of the driver about a frame back into the frame.  Other
+//	messages are recognised from their format and never formatted.
+//-----------------------------------------------------------------------------
+void FrameCapture::OnLog(uint8 _nodeId, char const* _format, va_list _args)
+{
+	if (!s_running && !TrafficCounters::IsEnabled())
+	{
+		return;
+	}
+
+	char const* format = _format;
+	while (*format == ' ')
+	{
+		++format;
+	}
+
+	FrameRecordHeader header;
+	memset(&header, 0, sizeof(header));
+	header.m_nodeId = _nodeId;
+	if (strncmp(format, "Received: ", 10) == 0)
+	{
+		header.m_direction = FrameDirection_Received;
+		header.m_kind = FrameKind_Data;
+	}
+	else if (strncmp(format, "Sending (", 9) == 0)
+	{
+		header.m_direction = FrameDirection_Sent;
+		header.m_kind = FrameKind_Data;
+	}
+	else
+	{
+		char const* received = strstr(format, " received");
+		if (received == NULL)
+		{
+			return;
+		}
+
+		header.m_direction = FrameDirection_Received;
+		if (received - format >= 3 && strncmp(received - 3, "ACK", 3) == 0)
+		{
+			header.m_kind = FrameKind_Ack;
+		}
+		else if (received - format >= 3 && strncmp(received - 3, "NAK", 3) == 0)
+		{
+			header.m_kind = FrameKind_Nak;
+		}
+		else if (received - format >= 3 && strncmp(received - 3, "CAN", 3) == 0)
+		{
+			header.m_kind = FrameKind_Can;
+		}
+		else if (strstr(format, "Dropping command") != NULL)
+		{
+			header.m_direction = FrameDirection_Sent;
+			header.m_kind = FrameKind_Dropped;
+		}
+		else
+		{
+			return;
+		}
+	}
+
+	char message[c_maxMessage];
+	vsnprintf(message, sizeof(message), _format, _args);
+	message[sizeof(message) - 1] = 0;
+
+	uint8 frame[c_maxFrame];
+	uint32 length = 0;
+	switch (header.m_kind)
+	{
+		case FrameKind_Data:
+		{
+			char const* bytes;
+			if (header.m_direction == FrameDirection_Received)
+			{
+				bytes = strstr(message, "Received: ") + 10;
+			}
+			else
+			{
+				// "Sending (<queue>) message (Attempt <n>, Callback ID=0x<id>, Expected Reply=0x<func>) - <label> (Node=<id>): <bytes>"
+				bytes = NULL;
+				for (char const* found = strstr(message, ": 0x"); found != NULL; found = strstr(found + 1, ": 0x"))
+				{
+					bytes = found + 2;
+				}
+				if (bytes == NULL)
+				{
+					return;
+				}
+
+				char const* attempt = strstr(message, "Attempt ");
+				header.m_attempt = (attempt != NULL) ? (uint8)atoi(attempt + 8) : 1;
+				header.m_callbackId = ParseHexAfter(message, "Callback ID=0x");
+			}
+
+			length = ParseBytes(bytes, frame, c_maxFrame);
+			if (length < 4 || frame[0] != c_frameSof)
+			{
+				return;
+			}
+
+			uint8 functionId = frame[3];
+			bool request = (frame[2] == c_frameRequest);
+			if (header.m_direction == FrameDirection_Sent)
+			{
+				// SOF, length, type, SendData, node, command length, command class, ...
+				if (functionId == c_frameFuncSendData && request && length > 6)
+				{
+					header.m_nodeId = frame[4];
+					header.m_commandClassId = (frame[5] > 0) ? frame[6] : 0;
+				}
+			}
+			else if (request)
+			{
+				if (functionId == c_frameFuncApplicationCommand && length > 7)
+				{
+					// SOF, length, type, ApplicationCommandHandler, status, node, command length, command class, ...
+					header.m_nodeId = frame[5];
+					header.m_commandClassId = (frame[6] > 0) ? frame[7] : 0;
+				}
+				else if (HasCallback(functionId) && length > 4)
+				{
+					header.m_callbackId = frame[4];
+				}
+			}
+			break;
+		}
+		case FrameKind_Ack:
+		{
+			frame[length++] = c_ack;
+			header.m_callbackId = ParseHexAfter(message, "CallbackId 0x");
+			break;
+		}
+		case FrameKind_Nak:
+		{
+			frame[length++] = c_nak;
+			break;
+		}
+		case FrameKind_Can:
+		{
+			frame[length++] = c_can;
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	header.m_length = (uint16)length;
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	header.m_time = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+	Append(header, frame);
+
+	if (TrafficCounters::IsEnabled())
+	{
+		TrafficCounters::OnFrame(header, frame);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::Append>
+//	Fill in what a control frame leaves out from the last data frame sent,
+//	and buffer the record while capturing
+//-----------------------------------------------------------------------------
+void FrameCapture::Append(FrameRecordHeader& _header, uint8 const* _frame)
+{
+	LockGuard guard(s_lock);
+	if (_header.m_kind == FrameKind_Data)
+	{
+		if (_header.m_direction == FrameDirection_Sent)
+		{
+			s_lastNodeId = _header.m_nodeId;
+			s_lastCallbackId = _header.m_callbackId;
+			s_lastCommandClassId = _header.m_commandClassId;
+		}
+	}
+	else if (_header.m_kind != FrameKind_Can)
+	{
+		// ACK, NAK and drops answer the last frame sent
+		_header.m_nodeId = s_lastNodeId;
+		_header.m_commandClassId = s_lastCommandClassId;
+		if (_header.m_callbackId == 0)
+		{
+			_header.m_callbackId = s_lastCallbackId;
+		}
+	}
+
+	if (!s_running)
+	{
+		return;
+	}
+	if (s_pending.size() + sizeof(_header) + _header.m_length > c_maxPending)
+	{
+		++s_dropped;
+		return;
+	}
+	s_pending.insert(s_pending.end(), (uint8 const*)&_header, (uint8 const*)&_header + sizeof(_header));
+	s_pending.insert(s_pending.end(), _frame, _frame + _header.m_length);
+	++s_frames;
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK FrameCapture::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	Flush();
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::Write>
+//	Append the buffered records to the segment, starting a new one if it is
+//	full.  Must be called with s_ioLock held.
+//-----------------------------------------------------------------------------
+void FrameCapture::Write()
+{
+	std::vector<uint8> records;
+	{
+		LockGuard guard(s_lock);
+		records.swap(s_pending);
+	}
+	if (records.empty())
+	{
+		return;
+	}
+
+	if (s_file != INVALID_HANDLE_VALUE && s_fileSize > sizeof(FrameSegmentHeader) && s_fileSize + records.size() > s_segmentSize)
+	{
+		CloseHandle(s_file);
+		s_file = INVALID_HANDLE_VALUE;
+	}
+	if (s_file == INVALID_HANDLE_VALUE)
+	{
+		if (s_directory.empty() || !OpenSegment())
+		{
+			return;
+		}
+		Prune();
+	}
+
+	DWORD written = 0;
+	if (!WriteFile(s_file, &records[0], (DWORD)records.size(), &written, NULL) || written != records.size())
+	{
+		// A reader stops at the last complete record
+		CloseHandle(s_file);
+		s_file = INVALID_HANDLE_VALUE;
+		return;
+	}
+	s_fileSize += records.size();
+	s_bytesWritten += records.size();
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::OpenSegment>
+//	Create the next segment file.  Must be called with s_ioLock held.
+//-----------------------------------------------------------------------------
+bool FrameCapture::OpenSegment()
+{
+	CreateDirectoryW(s_directory.c_str(), NULL);
+
+	std::vector<uint32> sequences;
+	FrameListSegments(s_directory, &sequences);
+	s_sequence = std::max(s_sequence, sequences.empty() ? 0 : sequences.back()) + 1;
+
+	s_file = OpenFileHandle(FrameSegmentPath(s_directory, s_sequence), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, CREATE_NEW);
+	if (s_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	FrameSegmentHeader header;
+	header.m_magic = c_frameSegmentMagic;
+	header.m_version = c_frameVersion;
+	header.m_created = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+
+	DWORD written = 0;
+	if (!WriteFile(s_file, &header, sizeof(header), &written, NULL) || written != sizeof(header))
+	{
+		CloseHandle(s_file);
+		s_file = INVALID_HANDLE_VALUE;
+		return false;
+	}
+
+	s_fileSize = sizeof(header);
+	s_bytesWritten += sizeof(header);
+	++s_segments;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCapture::Prune>
+//	Delete the oldest segments beyond the segment count.  Must be called
+//	with s_ioLock held.
+//-----------------------------------------------------------------------------
+void FrameCapture::Prune()
+{
+	std::vector<uint32> sequences;
+	FrameListSegments(s_directory, &sequences);
+	for (size_t i = 0; i + s_maxSegments < sequences.size(); ++i)
+	{
+		DeleteFileW(FrameSegmentPath(s_directory, sequences[i]).c_str());
+	}
+}
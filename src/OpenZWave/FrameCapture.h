@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+//
+//      FrameCapture.h
+//
+//      Binary capture of the Serial API frames exchanged with the controller
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FrameFormat.h"
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct FrameCaptureStats
+		{
+			uint64	m_frames;			// Records captured
+			uint64	m_dropped;			// Records lost because the disk fell behind
+			uint64	m_bytesWritten;
+			uint32	m_segments;			// Segment files started
+			bool	m_running;
+		};
+
+		// OpenZWave does not let the wrapper see the serial port, but its
+		// driver logs every frame it sends and receives, and every ACK, NAK
+		// and CAN, whatever the log level.  While running, the capture takes
+		// those messages from the log sink's logger, before the level is
+		// applied, parses the bytes back out of them once, and appends a
+		// fixed size record and the raw frame to a buffer.  A threadpool
+		// timer writes the buffer to numbered segment files in a directory,
+		// starting a new one at the segment size and deleting the oldest
+		// beyond the segment count.  Read them with FrameCaptureReader.
+		// The parsed frames also feed TrafficCounters while it is enabled,
+		// whether or not the capture is running.
+		class FrameCapture
+		{
+		public:
+			static uint32 const c_defaultSegmentSize = 4 * 1024 * 1024;
+			static uint32 const c_defaultMaxSegments = 8;
+
+			static bool Start(std::wstring const& _directory, uint32 _segmentSize, uint32 _maxSegments);
+			static void Stop();
+			static bool IsRunning() { return s_running; }
+
+			// Write what is buffered now
+			static void Flush();
+
+			static void GetStats(FrameCaptureStats* o_stats);
+
+			// Called by the log sink's logger with every message OpenZWave logs,
+			// while the capture runs or TrafficCounters is enabled
+			static void OnLog(uint8 _nodeId, char const* _format, va_list _args);
+
+		private:
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+			static void Append(FrameRecordHeader& _header, uint8 const* _frame);
+			static void Write();
+			static bool OpenSegment();
+			static void Prune();
+
+			static volatile bool		s_running;
+
+			// The buffer, under s_lock
+			static Lock					s_lock;
+			static std::vector<uint8>	s_pending;
+			static PTP_TIMER			s_timer;
+			static uint8				s_lastNodeId;			// Of the last data frame sent, for ACKs and drops
+			static uint8				s_lastCallbackId;
+			static uint8				s_lastCommandClassId;
+			static uint64				s_frames;
+			static uint64				s_dropped;
+
+			// The files, under s_ioLock
+			static Lock					s_ioLock;
+			static std::wstring			s_directory;
+			static uint32				s_segmentSize;
+			static uint32				s_maxSegments;
+			static uint32				s_sequence;
+			static uint32				s_segments;
+			static HANDLE				s_file;
+			static uint64				s_fileSize;
+			static uint64				s_bytesWritten;
+		};
+	}
+}
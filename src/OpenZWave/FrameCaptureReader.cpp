@@ -0,0 +1,313 @@
+//-----------------------------------------------------------------------------
+//
+//      FrameCaptureReader.cpp
+//
+//      Reads frame capture segments and measures round trips
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include "FileMapping.h"
+#include "FrameCaptureReader.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	typedef std::pair<uint8, uint8> CommandKey;		// Function, command class
+
+	struct CommandSamples
+	{
+		FrameCommandStats		m_stats;
+		std::vector<double>		m_response;
+		std::vector<double>		m_callback;
+		std::vector<double>		m_report;
+	};
+
+	// A frame sent and not answered yet
+	struct Outstanding
+	{
+		CommandKey	m_key;
+		int64		m_time;
+	};
+
+	typedef std::map<CommandKey, CommandSamples> SampleMap;
+
+	double ToMilliseconds(int64 _from, int64 _to)
+	{
+		return (double)(_to - _from) / 10000.0;
+	}
+
+	void Summarize(std::vector<double>& _samples, FrameRoundTrip* o_trip)
+	{
+		memset(o_trip, 0, sizeof(*o_trip));
+		if (_samples.empty())
+		{
+			return;
+		}
+
+		std::sort(_samples.begin(), _samples.end());
+		double sum = 0.0;
+		for (size_t i = 0; i < _samples.size(); ++i)
+		{
+			sum += _samples[i];
+		}
+		o_trip->m_count = (uint32)_samples.size();
+		o_trip->m_min = _samples.front();
+		o_trip->m_max = _samples.back();
+		o_trip->m_mean = sum / _samples.size();
+		o_trip->m_median = _samples[(_samples.size() - 1) / 2];
+		o_trip->m_p95 = _samples[(_samples.size() - 1) * 95 / 100];
+	}
+
+	bool ByMostSent(FrameCommandStats const& _a, FrameCommandStats const& _b)
+	{
+		if (_a.m_sent != _b.m_sent)
+			return _a.m_sent > _b.m_sent;
+		if (_a.m_functionId != _b.m_functionId)
+			return _a.m_functionId < _b.m_functionId;
+		return _a.m_commandClassId < _b.m_commandClassId;
+	}
+
+	CommandSamples& GetSamples(SampleMap& _samples, CommandKey const& _key)
+	{
+		SampleMap::iterator it = _samples.find(_key);
+		if (it == _samples.end())
+		{
+			it = _samples.insert(SampleMap::value_type(_key, CommandSamples())).first;
+			memset(&it->second.m_stats, 0, sizeof(it->second.m_stats));
+			it->second.m_stats.m_functionId = _key.first;
+			it->second.m_stats.m_commandClassId = _key.second;
+		}
+		return it->second;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCaptureReader::FrameCaptureReader>
+//	Load a segment, or every segment of a directory
+//-----------------------------------------------------------------------------
+FrameCaptureReader::FrameCaptureReader(std::wstring const& _path) :
+	m_segmentCount(0),
+	m_incompleteCount(0)
+{
+	std::vector<uint32> sequences;
+	FrameListSegments(_path, &sequences);
+	if (sequences.empty())
+	{
+		ReadSegment(_path);
+		return;
+	}
+
+	for (size_t i = 0; i < sequences.size(); ++i)
+	{
+		ReadSegment(FrameSegmentPath(_path, sequences[i]));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCaptureReader::ReadSegment>
+//	Append the complete records of a segment
+//-----------------------------------------------------------------------------
+void FrameCaptureReader::ReadSegment(std::wstring const& _path)
+{
+	HANDLE file = OpenFileHandle(_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, OPEN_EXISTING);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(FrameSegmentHeader))
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE mapping = NULL;
+	uint8 const* data = MapFileReadOnly(file, &mapping);
+	if (data != NULL)
+	{
+		FrameSegmentHeader header;
+		memcpy(&header, data, sizeof(header));
+		if (header.m_magic == c_frameSegmentMagic && header.m_version == c_frameVersion)
+		{
+			++m_segmentCount;
+
+			uint64 end = (uint64)size.QuadPart;
+			uint64 offset = sizeof(header);
+			while (offset + sizeof(FrameRecordHeader) <= end)
+			{
+				CapturedFrame frame;
+				memcpy(&frame.m_header, data + offset, sizeof(frame.m_header));
+				uint64 next = offset + sizeof(frame.m_header) + frame.m_header.m_length;
+				if (next > end)
+				{
+					break;
+				}
+
+				uint8 const* bytes = data + offset + sizeof(frame.m_header);
+				frame.m_functionId = FrameFunctionId(bytes, frame.m_header.m_length);
+				frame.m_offset = m_bytes.size();
+				m_bytes.insert(m_bytes.end(), bytes, bytes + frame.m_header.m_length);
+				m_frames.push_back(frame);
+				offset = next;
+			}
+
+			if (offset != end)
+			{
+				++m_incompleteCount;
+			}
+		}
+		UnmapViewOfFile(data);
+	}
+	if (mapping != NULL)
+	{
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+}
+
+//-----------------------------------------------------------------------------
+//	<FrameCaptureReader::Analyze>
+//	Count attempts and match each frame sent with its response, its
+//	callback and the node's reply
+//-----------------------------------------------------------------------------
+void FrameCaptureReader::Analyze(std::vector<FrameCommandStats>* o_stats) const
+{
+	o_stats->clear();
+
+	SampleMap samples;
+	bool haveLast = false;
+	Outstanding last;						// The last data frame sent
+	bool awaitingResponse = false;
+	std::map<uint8, Outstanding> callbacks;			// By callback ID
+	std::map<CommandKey, Outstanding> reports;		// By node and command class
+
+	for (size_t i = 0; i < m_frames.size(); ++i)
+	{
+		CapturedFrame const& frame = m_frames[i];
+		FrameRecordHeader const& header = frame.m_header;
+		uint8 const* bytes = GetBytes(frame);
+
+		if (header.m_direction == FrameDirection_Sent)
+		{
+			if (header.m_kind == FrameKind_Dropped)
+			{
+				if (haveLast)
+				{
+					++GetSamples(samples, last.m_key).m_stats.m_dropped;
+					callbacks.erase(header.m_callbackId);
+				}
+				awaitingResponse = false;
+				continue;
+			}
+			if (header.m_kind != FrameKind_Data)
+			{
+				continue;
+			}
+
+			last.m_key = CommandKey(frame.m_functionId, header.m_commandClassId);
+			last.m_time = header.m_time;
+			haveLast = true;
+			awaitingResponse = true;
+
+			FrameCommandStats& stats = GetSamples(samples, last.m_key).m_stats;
+			++stats.m_sent;
+			if (header.m_attempt > 1)
+			{
+				++stats.m_retries;
+			}
+			if (header.m_callbackId != 0)
+			{
+				callbacks[header.m_callbackId] = last;
+			}
+			if (header.m_commandClassId != 0)
+			{
+				reports[CommandKey(header.m_nodeId, header.m_commandClassId)] = last;
+			}
+			continue;
+		}
+
+		switch (header.m_kind)
+		{
+			case FrameKind_Nak:
+			case FrameKind_Can:
+			{
+				if (haveLast && awaitingResponse)
+				{
+					++GetSamples(samples, last.m_key).m_stats.m_rejected;
+				}
+				break;
+			}
+			case FrameKind_Data:
+			{
+				if (!FrameIsRequest(bytes, header.m_length))
+				{
+					// The controller's response to the frame just sent
+					if (haveLast && awaitingResponse && frame.m_functionId == last.m_key.first)
+					{
+						GetSamples(samples, last.m_key).m_response.push_back(ToMilliseconds(last.m_time, header.m_time));
+						awaitingResponse = false;
+					}
+					break;
+				}
+
+				if (header.m_callbackId != 0)
+				{
+					std::map<uint8, Outstanding>::iterator it = callbacks.find(header.m_callbackId);
+					if (it != callbacks.end() && it->second.m_key.first == frame.m_functionId)
+					{
+						GetSamples(samples, it->second.m_key).m_callback.push_back(ToMilliseconds(it->second.m_time, header.m_time));
+						callbacks.erase(it);
+					}
+				}
+				if (header.m_commandClassId != 0)
+				{
+					std::map<CommandKey, Outstanding>::iterator it = reports.find(CommandKey(header.m_nodeId, header.m_commandClassId));
+					if (it != reports.end())
+					{
+						GetSamples(samples, it->second.m_key).m_report.push_back(ToMilliseconds(it->second.m_time, header.m_time));
+						reports.erase(it);
+					}
+				}
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+	}
+
+	for (SampleMap::iterator it = samples.begin(); it != samples.end(); ++it)
+	{
+		CommandSamples& entry = it->second;
+		Summarize(entry.m_response, &entry.m_stats.m_response);
+		Summarize(entry.m_callback, &entry.m_stats.m_callback);
+		Summarize(entry.m_report, &entry.m_stats.m_report);
+		o_stats->push_back(entry.m_stats);
+	}
+	std::sort(o_stats->begin(), o_stats->end(), ByMostSent);
+}
@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+//
+//      FrameCaptureReader.h
+//
+//      Reads frame capture segments and measures round trips
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FrameFormat.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct CapturedFrame
+		{
+			FrameRecordHeader	m_header;
+			uint8				m_functionId;		// 0 for control frames
+			size_t				m_offset;			// Of the bytes, in FrameCaptureReader::GetBytes
+		};
+
+		// Milliseconds
+		struct FrameRoundTrip
+		{
+			uint32	m_count;
+			double	m_min;
+			double	m_mean;
+			double	m_median;
+			double	m_p95;
+			double	m_max;
+		};
+
+		// The frames sent with one Serial API function and, for SendData,
+		// one command class
+		struct FrameCommandStats
+		{
+			uint8			m_functionId;
+			uint8			m_commandClassId;
+			uint32			m_sent;				// Every attempt
+			uint32			m_retries;			// Attempts after the first
+			uint32			m_dropped;			// Given up after the last attempt
+			uint32			m_rejected;			// Answered with NAK or CAN
+			FrameRoundTrip	m_response;			// To the controller's response
+			FrameRoundTrip	m_callback;			// To the callback with the same ID
+			FrameRoundTrip	m_report;			// To the next command of the class from the node
+		};
+
+		// Loads a segment file, or every segment of a FrameCapture directory,
+		// oldest first.  A segment cut short ends at its last complete record.
+		class FrameCaptureReader
+		{
+		public:
+			FrameCaptureReader(std::wstring const& _path);
+
+			uint32 GetSegmentCount() const { return m_segmentCount; }
+			uint32 GetIncompleteCount() const { return m_incompleteCount; }
+
+			std::vector<CapturedFrame> const& GetFrames() const { return m_frames; }
+			uint8 const* GetBytes(CapturedFrame const& _frame) const { return m_bytes.empty() ? NULL : &m_bytes[_frame.m_offset]; }
+
+			// One entry per function and command class, most frames sent first
+			void Analyze(std::vector<FrameCommandStats>* o_stats) const;
+
+		private:
+			void ReadSegment(std::wstring const& _path);
+
+			std::vector<CapturedFrame>	m_frames;
+			std::vector<uint8>			m_bytes;
+			uint32						m_segmentCount;
+			uint32						m_incompleteCount;
+		};
+	}
+}
@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+//
+//      FrameFormat.h
+//
+//      Layout of frame capture segment files
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FileMapping.h"
+
+// A segment file is a FrameSegmentHeader, then records, each a
+// FrameRecordHeader followed by m_length bytes of the Serial API frame as
+// it went over the wire, from the SOF byte to the checksum.  ACK, NAK and
+// CAN are single byte frames.  A segment cut short by a crash ends at the
+// last complete record.
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		uint32 const c_frameSegmentMagic = 0x46435A4F;		// "OZCF"
+		uint32 const c_frameVersion = 1;
+
+		enum FrameDirection
+		{
+			FrameDirection_Sent = 0,
+			FrameDirection_Received
+		};
+
+		enum FrameKind
+		{
+			FrameKind_Data = 0,
+			FrameKind_Ack,
+			FrameKind_Nak,
+			FrameKind_Can,
+			FrameKind_Dropped			// The driver gave up on the last frame sent; no bytes
+		};
+
+		uint8 const c_frameSof = 0x01;
+		uint8 const c_frameRequest = 0x00;
+		uint8 const c_frameResponse = 0x01;
+		uint8 const c_frameFuncApplicationCommand = 0x04;
+		uint8 const c_frameFuncSendData = 0x13;
+
+		struct FrameSegmentHeader
+		{
+			uint32	m_magic;
+			uint32	m_version;
+			int64	m_created;			// UTC file time
+		};
+
+		struct FrameRecordHeader
+		{
+			int64	m_time;				// UTC file time
+			uint16	m_length;
+			uint8	m_direction;		// FrameDirection
+			uint8	m_kind;				// FrameKind
+			uint8	m_nodeId;			// 0 if the frame is not about a node
+			uint8	m_callbackId;		// 0 if the frame has none
+			uint8	m_commandClassId;	// 0 if the frame carries no command
+			uint8	m_attempt;			// Send attempt, from 1, for data frames sent
+		};
+
+		// The Serial API function of a data frame, or 0
+		inline uint8 FrameFunctionId(uint8 const* _frame, uint32 _length)
+		{
+			return (_length > 3 && _frame[0] == c_frameSof) ? _frame[3] : 0;
+		}
+
+		inline bool FrameIsRequest(uint8 const* _frame, uint32 _length)
+		{
+			return _length > 3 && _frame[0] == c_frameSof && _frame[2] == c_frameRequest;
+		}
+
+		// The segment file for a sequence number
+		inline std::wstring FrameSegmentPath(std::wstring const& _directory, uint32 _sequence)
+		{
+			return SegmentPath(_directory, L"frames", L"ozf", _sequence);
+		}
+
+		// The sequence numbers of the segments in a directory, oldest first
+		inline void FrameListSegments(std::wstring const& _directory, std::vector<uint32>* o_sequences)
+		{
+			ListSegments(_directory, L"frames", L"ozf", o_sequences);
+		}
+	}
+}
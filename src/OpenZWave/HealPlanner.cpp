@@ -0,0 +1,543 @@
+//-----------------------------------------------------------------------------
+//
+//      HealPlanner.cpp
+//
+//      Ranks nodes by route health and heals only the degraded ones
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "HealPlanner.h"
+#include "Topology.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock HealPlanner::s_lock;
+std::vector<HealPlanner*> HealPlanner::s_planners;
+
+namespace
+{
+	size_t const c_none = (size_t)-1;
+
+	// Below this many sends since the last plan the rates are too noisy to use
+	uint32 const c_minSamples = 5;
+
+	// Four repeaters between the controller and the node
+	uint8 const c_maxHops = 5;
+
+	struct Progress
+	{
+		HealCandidate	m_candidate;
+		uint32			m_done;
+		uint32			m_total;
+	};
+
+	bool ByScore(HealCandidate const& _a, HealCandidate const& _b)
+	{
+		return _a.m_score > _b.m_score;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::HealPlanner>
+//	Constructor
+//-----------------------------------------------------------------------------
+HealPlanner::HealPlanner(uint32 _homeId, pfnOnHealProgress_t _callback, void* _context) :
+	m_homeId(_homeId),
+	m_callback(_callback),
+	m_context(_context),
+	m_running(false),
+	m_current(c_none),
+	m_startedAt(0),
+	m_outcome(Outcome_None),
+	m_tokensMs(0.0),
+	m_refilledAt(0)
+{
+	memset(m_samples, 0, sizeof(m_samples));
+	m_tokensMs = m_settings.m_airtimeBudgetMs;
+	m_refilledAt = GetTickCount64();
+	m_timer = CreateThreadpoolTimer(OnTimer, this, NULL);
+
+	LockGuard guard(s_lock);
+	s_planners.push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::~HealPlanner>
+//	Destructor.  Must not be called from the progress callback.
+//-----------------------------------------------------------------------------
+HealPlanner::~HealPlanner()
+{
+	{
+		LockGuard guard(s_lock);
+		s_planners.erase(std::remove(s_planners.begin(), s_planners.end(), this), s_planners.end());
+	}
+
+	Stop();
+	if (m_timer != NULL)
+	{
+		SetThreadpoolTimer(m_timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(m_timer, TRUE);
+		CloseThreadpoolTimer(m_timer);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::SetSettings>
+//	Change the budget, quiet hours and thresholds
+//-----------------------------------------------------------------------------
+void HealPlanner::SetSettings(HealSettings const& _settings)
+{
+	LockGuard guard(m_lock);
+	m_settings = _settings;
+	if (m_tokensMs > m_settings.m_airtimeBudgetMs)
+	{
+		m_tokensMs = m_settings.m_airtimeBudgetMs;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::GetSettings>
+//	Current budget, quiet hours and thresholds
+//-----------------------------------------------------------------------------
+HealSettings HealPlanner::GetSettings()
+{
+	LockGuard guard(m_lock);
+	return m_settings;
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::Plan>
+//	Rank every node and schedule the degraded ones.  A node scores for:
+//	  - failed sends and retries since the last plan (delivery problems)
+//	  - a slow average round trip (delivery problems)
+//	  - no route from the controller within the four repeaters Z-Wave allows,
+//	    a route through several repeaters, or fewer than two neighbors
+//	    (route problems)
+//	Delivery problems get new return routes, route problems get a neighbor
+//	update, and nodes with both get a full heal.
+//-----------------------------------------------------------------------------
+uint32 HealPlanner::Plan()
+{
+	Stop();
+
+	Manager* manager = Manager::Get();
+	Topology* topology = new Topology();
+	topology->Build(m_homeId);
+
+	uint8 controllerId = manager->GetControllerNodeId(m_homeId);
+	uint8 hops[Topology::MaxNodes];
+	topology->GetHopCounts(controllerId, hops);
+
+	// Query OpenZWave without holding m_lock, as its notification thread takes it
+	std::vector<HealCandidate> candidates;
+	std::vector<Sample> samples;
+	for (uint32 nodeId = 1; nodeId <= Topology::MaxNodes; ++nodeId)
+	{
+		if (nodeId == controllerId || manager->GetNodeBasic(m_homeId, (uint8)nodeId) == 0)
+		{
+			continue;
+		}
+
+		Node::NodeData data;
+		manager->GetNodeStatistics(m_homeId, (uint8)nodeId, &data);
+
+		HealCandidate candidate;
+		memset(&candidate, 0, sizeof(candidate));
+		candidate.m_nodeId = (uint8)nodeId;
+		candidate.m_averageRtt = data.m_averageRequestRTT;
+		candidate.m_degree = (uint8)topology->GetDegree((uint8)nodeId);
+		candidate.m_hops = hops[nodeId - 1];
+		candidate.m_failed = manager->IsNodeFailed(m_homeId, (uint8)nodeId);
+		candidate.m_listening = manager->IsNodeListeningDevice(m_homeId, (uint8)nodeId) || manager->IsNodeFrequentListeningDevice(m_homeId, (uint8)nodeId);
+		candidates.push_back(candidate);
+
+		Sample sample = { data.m_sentCnt, data.m_sentFailed, data.m_retries };
+		samples.push_back(sample);
+	}
+	delete topology;
+
+	LockGuard guard(m_lock);
+	uint32 scheduled = 0;
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		HealCandidate& candidate = candidates[i];
+		Sample& previous = m_samples[candidate.m_nodeId - 1];
+		Sample const& current = samples[i];
+
+		// Counters only go backwards when the driver restarts
+		Sample delta = current;
+		if (current.m_sent >= previous.m_sent && current.m_failed >= previous.m_failed && current.m_retries >= previous.m_retries)
+		{
+			delta.m_sent = current.m_sent - previous.m_sent;
+			delta.m_failed = current.m_failed - previous.m_failed;
+			delta.m_retries = current.m_retries - previous.m_retries;
+		}
+		previous = current;
+
+		if (delta.m_sent >= c_minSamples)
+		{
+			candidate.m_failureRate = (float)delta.m_failed / delta.m_sent;
+			candidate.m_retryRate = (float)delta.m_retries / delta.m_sent;
+		}
+
+		bool unreachable = (candidate.m_hops > c_maxHops);
+		bool routeProblem = unreachable || candidate.m_degree < 2;
+		bool deliveryProblem = candidate.m_failureRate >= 0.1f || candidate.m_retryRate >= 0.5f || candidate.m_averageRtt >= 1000;
+
+		candidate.m_score = 4.0f * candidate.m_failureRate
+			+ std::min(candidate.m_retryRate, 2.0f)
+			+ 0.5f * std::min(candidate.m_averageRtt / 1000.0f, 2.0f)
+			+ (unreachable ? 2.0f : 0.25f * std::max((int32)candidate.m_hops - 2, 0))
+			+ (candidate.m_degree < 2 ? 1.0f : 0.0f);
+
+		if (candidate.m_failed)
+		{
+			// Nothing can be healed until the node answers again; rank it first so it is seen
+			candidate.m_score = std::max(candidate.m_score, 100.0f);
+			candidate.m_state = HealState_Skipped;
+			continue;
+		}
+		if (candidate.m_score < m_settings.m_threshold)
+		{
+			candidate.m_state = HealState_Healthy;
+			continue;
+		}
+
+		candidate.m_action = (routeProblem && deliveryProblem) ? HealAction_Heal : (routeProblem ? HealAction_NeighborUpdate : HealAction_ReturnRoute);
+		if (!candidate.m_listening)
+		{
+			// Sleeping nodes do not take part in controller commands
+			candidate.m_state = HealState_Skipped;
+			continue;
+		}
+		candidate.m_state = HealState_Pending;
+		++scheduled;
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), ByScore);
+	m_plan.swap(candidates);
+	m_current = c_none;
+	m_outcome = Outcome_None;
+	return scheduled;
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::GetPlan>
+//	Copy out the ranked nodes
+//-----------------------------------------------------------------------------
+void HealPlanner::GetPlan(std::vector<HealCandidate>* o_plan)
+{
+	LockGuard guard(m_lock);
+	*o_plan = m_plan;
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::Start>
+//	Start working through the plan
+//-----------------------------------------------------------------------------
+void HealPlanner::Start()
+{
+	LockGuard guard(m_lock);
+	if (!m_running)
+	{
+		m_running = true;
+		Schedule(0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::Stop>
+//	Stop, cancelling the running command.  Its node goes back to pending.
+//-----------------------------------------------------------------------------
+void HealPlanner::Stop()
+{
+	bool cancel = false;
+	{
+		LockGuard guard(m_lock);
+		m_running = false;
+		if (m_current != c_none)
+		{
+			m_plan[m_current].m_state = HealState_Pending;
+			m_current = c_none;
+			m_outcome = Outcome_None;
+			cancel = true;
+		}
+		if (m_timer != NULL)
+		{
+			SetThreadpoolTimer(m_timer, NULL, 0, 0);
+		}
+	}
+	if (cancel)
+	{
+		Manager::Get()->CancelControllerCommand(m_homeId);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::IsRunning>
+//	Whether commands are still to be sent
+//-----------------------------------------------------------------------------
+bool HealPlanner::IsRunning()
+{
+	LockGuard guard(m_lock);
+	return m_running;
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::OnNotification>
+//	Forward OpenZWave notifications to every live planner
+//-----------------------------------------------------------------------------
+void HealPlanner::OnNotification(Notification const* _notification)
+{
+	if (_notification->GetType() != Notification::Type_ControllerCommand)
+	{
+		return;
+	}
+
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < s_planners.size(); ++i)
+	{
+		s_planners[i]->HandleNotification(_notification);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::HandleNotification>
+//	Record the result of the running command.  The planner moves on from its
+//	timer, so OpenZWave is never called back from its own notification thread.
+//-----------------------------------------------------------------------------
+void HealPlanner::HandleNotification(Notification const* _notification)
+{
+	if (_notification->GetHomeId() != m_homeId)
+	{
+		return;
+	}
+
+	LockGuard guard(m_lock);
+	if (m_current == c_none || m_plan[m_current].m_nodeId != _notification->GetNodeId())
+	{
+		return;
+	}
+
+	switch (_notification->GetEvent())
+	{
+	case Driver::ControllerState_Completed:
+	case Driver::ControllerState_NodeOK:
+		m_outcome = Outcome_Succeeded;
+		break;
+	case Driver::ControllerState_Cancel:
+	case Driver::ControllerState_Error:
+	case Driver::ControllerState_Failed:
+	case Driver::ControllerState_NodeFailed:
+		m_outcome = Outcome_Failed;
+		break;
+	default:
+		return;
+	}
+	Schedule(0);
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK HealPlanner::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	static_cast<HealPlanner*>(_context)->Step();
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::Step>
+//	Settle the running command, then start the next one if the quiet hours
+//	and the airtime budget allow it
+//-----------------------------------------------------------------------------
+void HealPlanner::Step()
+{
+	std::vector<Progress> progress;
+	HealCandidate next;
+	memset(&next, 0, sizeof(next));
+	{
+		LockGuard guard(m_lock);
+		if (!m_running)
+		{
+			return;
+		}
+
+		uint64 now = GetTickCount64();
+		Refill();
+
+		uint32 total = 0;
+		uint32 done = 0;
+		for (size_t i = 0; i < m_plan.size(); ++i)
+		{
+			HealState state = m_plan[i].m_state;
+			total += (state == HealState_Pending || state == HealState_Running || state == HealState_Succeeded || state == HealState_Failed) ? 1 : 0;
+			done += (state == HealState_Succeeded || state == HealState_Failed) ? 1 : 0;
+		}
+
+		if (m_current != c_none)
+		{
+			uint64 elapsed = now - m_startedAt;
+			if (m_outcome == Outcome_None && elapsed < m_settings.m_timeoutMs)
+			{
+				Schedule((uint32)(m_settings.m_timeoutMs - elapsed));
+				return;
+			}
+
+			HealCandidate& candidate = m_plan[m_current];
+			candidate.m_state = (m_outcome == Outcome_Succeeded) ? HealState_Succeeded : HealState_Failed;
+			m_tokensMs -= (double)std::min(elapsed, (uint64)m_settings.m_timeoutMs);
+			m_current = c_none;
+			m_outcome = Outcome_None;
+
+			Progress report = { candidate, ++done, total };
+			progress.push_back(report);
+		}
+
+		size_t index = c_none;
+		for (size_t i = 0; i < m_plan.size() && index == c_none; ++i)
+		{
+			if (m_plan[i].m_state == HealState_Pending)
+			{
+				index = i;
+			}
+		}
+
+		if (index == c_none)
+		{
+			m_running = false;
+		}
+		else if (!InQuietHours())
+		{
+			Schedule(60 * 1000);
+		}
+		else if (m_settings.m_airtimeBudgetMs != 0 && m_tokensMs <= 0.0)
+		{
+			// Wait until the bucket has refilled enough to be positive again
+			double rate = m_settings.m_airtimeBudgetMs / 3600000.0;
+			Schedule((uint32)(-m_tokensMs / rate) + 1000);
+		}
+		else
+		{
+			m_current = index;
+			m_startedAt = now;
+			m_plan[index].m_state = HealState_Running;
+			next = m_plan[index];
+			Schedule(m_settings.m_timeoutMs);
+
+			Progress report = { next, done, total };
+			progress.push_back(report);
+		}
+	}
+
+	if (next.m_nodeId != 0)
+	{
+		bool sent = true;
+		Manager* manager = Manager::Get();
+		switch (next.m_action)
+		{
+		case HealAction_ReturnRoute:
+			sent = manager->AssignReturnRoute(m_homeId, next.m_nodeId);
+			break;
+		case HealAction_NeighborUpdate:
+			sent = manager->RequestNodeNeighborUpdate(m_homeId, next.m_nodeId);
+			break;
+		case HealAction_Heal:
+			// Only the neighbor update reports back; the return routes that
+			// follow are queued behind it by OpenZWave.
+			manager->HealNetworkNode(m_homeId, next.m_nodeId, true);
+			break;
+		default:
+			break;
+		}
+
+		if (!sent)
+		{
+			LockGuard guard(m_lock);
+			if (m_current != c_none && m_plan[m_current].m_nodeId == next.m_nodeId)
+			{
+				m_outcome = Outcome_Failed;
+				Schedule(0);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < progress.size(); ++i)
+	{
+		m_callback(&progress[i].m_candidate, progress[i].m_done, progress[i].m_total, m_context);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::Schedule>
+//	Run Step after a delay.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+void HealPlanner::Schedule(uint32 _delayMs)
+{
+	if (m_timer == NULL)
+	{
+		return;
+	}
+
+	// Negative due times are relative, in 100ns units
+	ULARGE_INTEGER due;
+	due.QuadPart = (ULONGLONG)(-((LONGLONG)_delayMs * 10000));
+	FILETIME dueTime;
+	dueTime.dwLowDateTime = due.LowPart;
+	dueTime.dwHighDateTime = due.HighPart;
+	SetThreadpoolTimer(m_timer, &dueTime, 0, 0);
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::InQuietHours>
+//	Whether the local time is inside the quiet hours.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+bool HealPlanner::InQuietHours()
+{
+	uint8 start = m_settings.m_quietHoursStart;
+	uint8 end = m_settings.m_quietHoursEnd;
+	if (start == end)
+	{
+		return true;
+	}
+
+	SYSTEMTIME now;
+	GetLocalTime(&now);
+	if (start < end)
+	{
+		return now.wHour >= start && now.wHour < end;
+	}
+	return now.wHour >= start || now.wHour < end;
+}
+
+//-----------------------------------------------------------------------------
+//	<HealPlanner::Refill>
+//	Top up the airtime budget for the time passed.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+void HealPlanner::Refill()
+{
+	uint64 now = GetTickCount64();
+	double rate = m_settings.m_airtimeBudgetMs / 3600000.0;
+	m_tokensMs = std::min((double)m_settings.m_airtimeBudgetMs, m_tokensMs + (now - m_refilledAt) * rate);
+	m_refilledAt = now;
+}
@@ -0,0 +1,160 @@
+//-----------------------------------------------------------------------------
+//
+//      HealPlanner.h
+//
+//      Ranks nodes by route health and heals only the degraded ones
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		enum HealAction
+		{
+			HealAction_None = 0,
+			HealAction_ReturnRoute,			// AssignReturnRoute
+			HealAction_NeighborUpdate,		// RequestNodeNeighborUpdate
+			HealAction_Heal					// HealNetworkNode with return routes
+		};
+
+		enum HealState
+		{
+			HealState_Healthy = 0,			// Not scheduled
+			HealState_Pending,
+			HealState_Running,
+			HealState_Succeeded,
+			HealState_Failed,
+			HealState_Skipped				// Degraded but cannot be healed now (failed or sleeping node)
+		};
+
+		struct HealCandidate
+		{
+			uint8		m_nodeId;
+			HealAction	m_action;
+			HealState	m_state;
+			float		m_score;			// Higher is worse
+			float		m_failureRate;		// Failed sends / sends since the last plan
+			float		m_retryRate;		// Retries / sends since the last plan
+			uint32		m_averageRtt;		// Milliseconds
+			uint8		m_degree;
+			uint8		m_hops;				// From the controller, 0xff if unreachable
+			bool		m_failed;			// IsNodeFailed
+			bool		m_listening;
+		};
+
+		struct HealSettings
+		{
+			HealSettings() :
+				m_airtimeBudgetMs(5 * 60 * 1000),
+				m_quietHoursStart(1),
+				m_quietHoursEnd(5),
+				m_threshold(1.0f),
+				m_timeoutMs(60 * 1000)
+			{
+			}
+
+			uint32	m_airtimeBudgetMs;		// Controller time the planner may use per hour
+			uint8	m_quietHoursStart;		// Local hour operations may start from
+			uint8	m_quietHoursEnd;		// Local hour operations stop starting at; equal to start for any time
+			float	m_threshold;			// Nodes scoring at or above this are scheduled
+			uint32	m_timeoutMs;			// An operation with no result after this long counts as failed
+		};
+
+		typedef void(*pfnOnHealProgress_t)(HealCandidate const* _candidate, uint32 _done, uint32 _total, void* _context);
+
+		// Works through the degraded nodes one controller command at a time.
+		// Each command is charged against a token bucket for the time the
+		// controller was busy with it, so a bad mesh cannot monopolise the radio.
+		// Commands are only started during the quiet hours.  The planner moves on
+		// when the ControllerCommand notification for the node reports a result,
+		// or when the command times out.
+		class HealPlanner
+		{
+		public:
+			HealPlanner(uint32 _homeId, pfnOnHealProgress_t _callback, void* _context);
+			~HealPlanner();
+
+			void SetSettings(HealSettings const& _settings);
+			HealSettings GetSettings();
+
+			// Rank every node and schedule the degraded ones.  Returns the number scheduled.
+			uint32 Plan();
+			void GetPlan(std::vector<HealCandidate>* o_plan);
+
+			void Start();
+			void Stop();
+			bool IsRunning();
+
+			// Forward OpenZWave notifications to every live planner
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			HealPlanner(HealPlanner const&);
+			HealPlanner& operator=(HealPlanner const&);
+
+			enum Outcome
+			{
+				Outcome_None = 0,
+				Outcome_Succeeded,
+				Outcome_Failed
+			};
+
+			struct Sample
+			{
+				uint32	m_sent;
+				uint32	m_failed;
+				uint32	m_retries;
+			};
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+
+			void HandleNotification(Notification const* _notification);
+			void Step();
+			void Schedule(uint32 _delayMs);
+			bool InQuietHours();
+			void Refill();
+
+			uint32						m_homeId;
+			pfnOnHealProgress_t			m_callback;
+			void*						m_context;
+			PTP_TIMER					m_timer;
+
+			Lock						m_lock;
+			HealSettings				m_settings;
+			std::vector<HealCandidate>	m_plan;
+			Sample						m_samples[NUM_NODE_BITFIELD_BYTES * 8];
+			bool						m_running;
+			size_t						m_current;			// Index into m_plan of the running command
+			uint64						m_startedAt;		// Tick count when the running command started
+			Outcome						m_outcome;			// Result reported for the running command
+			double						m_tokensMs;			// Remaining airtime budget
+			uint64						m_refilledAt;
+
+			static Lock						s_lock;
+			static std::vector<HealPlanner*>	s_planners;
+		};
+	}
+}
@@ -0,0 +1,158 @@
+//-----------------------------------------------------------------------------
+//
+//      HistoryFormat.h
+//
+//      Layout and sample encoding of history log segment files
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FileMapping.h"
+
+// A segment file is a HistorySegmentHeader, then blocks, each a
+// HistoryBlockHeader and its encoded samples, then, once the segment is
+// closed, an index of the blocks sorted by value and time, and a
+// HistorySegmentTrailer.  A segment that was never closed (the process
+// stopped) has no index, and readers find its blocks by walking the headers
+// up to the first one that is incomplete.
+//
+// A block holds consecutive samples of one value.  Times are milliseconds
+// since 1601 (a file time / 10000).  The first sample's time is in the block
+// header and its value is stored as 8 raw bytes.  Each later sample stores
+// the change in the time delta as a zigzag varint, then its value XORed
+// with the previous value: a 0 byte if they are equal, otherwise a byte
+// holding one more than the number of trailing zero bits of the XOR, then
+// the XOR shifted right by that many bits as a varint.  Readings that change
+// slowly share their sign, exponent and top mantissa bits, so most samples
+// take 2 to 5 bytes.
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		uint32 const c_historySegmentMagic = 0x4C485A4F;	// "OZHL"
+		uint32 const c_historyBlockMagic = 0x42485A4F;		// "OZHB"
+		uint32 const c_historyIndexMagic = 0x49485A4F;		// "OZHI"
+		uint32 const c_historyVersion = 1;
+
+		struct HistorySegmentHeader
+		{
+			uint32	m_magic;
+			uint32	m_version;
+			int64	m_created;			// Milliseconds since 1601
+		};
+
+		struct HistoryBlockHeader
+		{
+			uint32	m_magic;
+			uint32	m_homeId;
+			uint64	m_valueId;
+			int64	m_firstTime;
+			int64	m_lastTime;
+			uint32	m_count;
+			uint32	m_size;				// Bytes of encoded samples after the header
+		};
+
+		struct HistoryIndexEntry
+		{
+			uint32	m_homeId;
+			uint32	m_count;
+			uint64	m_valueId;
+			int64	m_firstTime;
+			int64	m_lastTime;
+			uint64	m_offset;			// Of the block header
+		};
+
+		struct HistorySegmentTrailer
+		{
+			uint32	m_magic;
+			uint32	m_entries;
+			uint64	m_indexOffset;
+			int64	m_firstTime;
+			int64	m_lastTime;
+		};
+
+		// Orders index entries by value, then time
+		inline bool HistoryIndexOrder(HistoryIndexEntry const& _a, HistoryIndexEntry const& _b)
+		{
+			if (_a.m_homeId != _b.m_homeId)
+				return _a.m_homeId < _b.m_homeId;
+			if (_a.m_valueId != _b.m_valueId)
+				return _a.m_valueId < _b.m_valueId;
+			return _a.m_firstTime < _b.m_firstTime;
+		}
+
+		inline void HistoryPutVarint(std::vector<uint8>* io_bytes, uint64 _value)
+		{
+			while (_value >= 0x80)
+			{
+				io_bytes->push_back((uint8)(_value | 0x80));
+				_value >>= 7;
+			}
+			io_bytes->push_back((uint8)_value);
+		}
+
+		// False if the varint runs past _end
+		inline bool HistoryGetVarint(uint8 const** io_cursor, uint8 const* _end, uint64* o_value)
+		{
+			uint64 value = 0;
+			for (uint32 shift = 0; shift < 64 && *io_cursor < _end; shift += 7)
+			{
+				uint8 byte = *(*io_cursor)++;
+				value |= (uint64)(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					*o_value = value;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		inline uint64 HistoryZigZag(int64 _value) { return ((uint64)_value << 1) ^ (uint64)(_value >> 63); }
+		inline int64 HistoryUnZigZag(uint64 _value) { return (int64)(_value >> 1) ^ -(int64)(_value & 1); }
+
+		inline uint32 HistoryTrailingZeros(uint64 _value)
+		{
+			uint32 count = 0;
+			while ((_value & 1) == 0)
+			{
+				_value >>= 1;
+				++count;
+			}
+			return count;
+		}
+
+		// The segment file for a sequence number
+		inline std::wstring HistorySegmentPath(std::wstring const& _directory, uint32 _sequence)
+		{
+			return SegmentPath(_directory, L"history", L"ozh", _sequence);
+		}
+
+		// The sequence numbers of the segments in a directory, oldest first
+		inline void HistoryListSegments(std::wstring const& _directory, std::vector<uint32>* o_sequences)
+		{
+			ListSegments(_directory, L"history", L"ozh", o_sequences);
+		}
+	}
+}
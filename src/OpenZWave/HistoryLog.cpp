@@ -0,0 +1,575 @@
+//-----------------------------------------------------------------------------
+//
+//      HistoryLog.cpp
+//
+//      Appends value changes to compressed segment files
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "HistoryLog.h"
+#include "ValueHistory.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock HistoryLog::s_lock;
+std::vector<HistoryLog*> HistoryLog::s_logs;
+
+namespace
+{
+	// A block is sealed at whichever limit comes first
+	uint32 const c_blockSamples = 1024;
+	uint32 const c_blockBytes = 4096;
+
+	// Sealed blocks are written early once this much is waiting
+	uint32 const c_writeBytes = 64 * 1024;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::HistoryLog>
+//	Constructor.  Starts a new segment after any already in the directory.
+//-----------------------------------------------------------------------------
+HistoryLog::HistoryLog(std::wstring const& _directory) :
+	m_directory(_directory),
+	m_timer(NULL),
+	m_flushIntervalMs(10 * 60 * 1000),
+	m_segmentSize(4 * 1024 * 1024),
+	m_maxTotalSize(256 * 1024 * 1024),
+	m_samples(0),
+	m_file(INVALID_HANDLE_VALUE),
+	m_sequence(0),
+	m_fileSize(0),
+	m_segmentFirst(0),
+	m_segmentLast(0),
+	m_bytesWritten(0)
+{
+	{
+		LockGuard guard(m_ioLock);
+		OpenSegment();
+	}
+
+	m_timer = CreateThreadpoolTimer(OnTimer, this, NULL);
+	{
+		// Step re-arms the timer from then on, so even a value that changes
+		// too rarely to fill a block is written within the flush interval
+		LockGuard guard(m_lock);
+		Schedule(m_flushIntervalMs);
+	}
+
+	LockGuard guard(s_lock);
+	s_logs.push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::~HistoryLog>
+//	Destructor.  Writes what is still in memory and closes the segment.
+//-----------------------------------------------------------------------------
+HistoryLog::~HistoryLog()
+{
+	{
+		LockGuard guard(s_lock);
+		s_logs.erase(std::remove(s_logs.begin(), s_logs.end(), this), s_logs.end());
+	}
+
+	if (m_timer != NULL)
+	{
+		SetThreadpoolTimer(m_timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(m_timer, TRUE);
+		CloseThreadpoolTimer(m_timer);
+		m_timer = NULL;
+	}
+
+	Step(true);
+
+	LockGuard guard(m_ioLock);
+	CloseSegment();
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::IsOpen>
+//	Whether a segment is open for writing
+//-----------------------------------------------------------------------------
+bool HistoryLog::IsOpen()
+{
+	LockGuard guard(m_ioLock);
+	return m_file != INVALID_HANDLE_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::GetFlushInterval>
+//	Longest time a sample stays in memory
+//-----------------------------------------------------------------------------
+uint32 HistoryLog::GetFlushInterval()
+{
+	LockGuard guard(m_lock);
+	return m_flushIntervalMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::SetFlushInterval>
+//	Change the longest time a sample stays in memory
+//-----------------------------------------------------------------------------
+void HistoryLog::SetFlushInterval(uint32 _intervalMs)
+{
+	if (_intervalMs == 0)
+	{
+		return;
+	}
+
+	LockGuard guard(m_lock);
+	m_flushIntervalMs = _intervalMs;
+	Schedule(0);
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::GetSegmentSize>
+//	Size at which a segment is closed
+//-----------------------------------------------------------------------------
+uint32 HistoryLog::GetSegmentSize()
+{
+	LockGuard guard(m_lock);
+	return m_segmentSize;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::SetSegmentSize>
+//	Change the size at which a segment is closed
+//-----------------------------------------------------------------------------
+void HistoryLog::SetSegmentSize(uint32 _bytes)
+{
+	LockGuard guard(m_lock);
+	m_segmentSize = _bytes;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::GetMaxTotalSize>
+//	Size of the directory above which the oldest segments are deleted
+//-----------------------------------------------------------------------------
+uint64 HistoryLog::GetMaxTotalSize()
+{
+	LockGuard guard(m_lock);
+	return m_maxTotalSize;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::SetMaxTotalSize>
+//	Change the size of the directory above which the oldest segments are
+//	deleted.  0 keeps every segment.
+//-----------------------------------------------------------------------------
+void HistoryLog::SetMaxTotalSize(uint64 _bytes)
+{
+	LockGuard guard(m_lock);
+	m_maxTotalSize = _bytes;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Record>
+//	Encode a sample into the open block of its value
+//-----------------------------------------------------------------------------
+void HistoryLog::Record(ValueID const& _valueId, int64 _time, double _value)
+{
+	int64 time = _time / 10000;
+	uint64 bits;
+	memcpy(&bits, &_value, sizeof(bits));
+
+	LockGuard guard(m_lock);
+	++m_samples;
+
+	SeriesKey key(_valueId.GetHomeId(), _valueId.GetId());
+	SeriesMap::iterator it = m_series.find(key);
+	if (it == m_series.end())
+	{
+		Series& series = m_series[key];
+		series.m_firstTime = time;
+		series.m_lastTime = time;
+		series.m_lastDelta = 0;
+		series.m_lastBits = bits;
+		series.m_count = 1;
+		series.m_openedAt = GetTickCount64();
+		series.m_samples.resize(sizeof(bits));
+		memcpy(&series.m_samples[0], &bits, sizeof(bits));
+		return;
+	}
+
+	Series& series = it->second;
+	time = std::max(time, series.m_lastTime);
+	int64 delta = time - series.m_lastTime;
+	HistoryPutVarint(&series.m_samples, HistoryZigZag(delta - series.m_lastDelta));
+
+	uint64 difference = bits ^ series.m_lastBits;
+	if (difference == 0)
+	{
+		series.m_samples.push_back(0);
+	}
+	else
+	{
+		uint32 zeros = HistoryTrailingZeros(difference);
+		series.m_samples.push_back((uint8)(zeros + 1));
+		HistoryPutVarint(&series.m_samples, difference >> zeros);
+	}
+
+	series.m_lastTime = time;
+	series.m_lastDelta = delta;
+	series.m_lastBits = bits;
+	++series.m_count;
+
+	if (series.m_count >= c_blockSamples || series.m_samples.size() >= c_blockBytes)
+	{
+		Seal(key, series);
+		m_series.erase(it);
+		if (m_pending.size() >= c_writeBytes)
+		{
+			Schedule(0);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Flush>
+//	Seal every open block and write it
+//-----------------------------------------------------------------------------
+void HistoryLog::Flush()
+{
+	Step(true);
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::GetSamplesRecorded>
+//	Samples recorded since the log was created
+//-----------------------------------------------------------------------------
+uint64 HistoryLog::GetSamplesRecorded()
+{
+	LockGuard guard(m_lock);
+	return m_samples;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::GetBytesWritten>
+//	Bytes of blocks written since the log was created
+//-----------------------------------------------------------------------------
+uint64 HistoryLog::GetBytesWritten()
+{
+	LockGuard guard(m_ioLock);
+	return m_bytesWritten;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::OnNotification>
+//	Record a value change in every live log
+//-----------------------------------------------------------------------------
+void HistoryLog::OnNotification(Notification const* _notification)
+{
+	if (_notification->GetType() != Notification::Type_ValueChanged)
+	{
+		return;
+	}
+
+	{
+		SharedLockGuard guard(s_lock);
+		if (s_logs.empty())
+		{
+			return;
+		}
+	}
+
+	// Read the value before taking the lock, as the registry never calls
+	// into OpenZWave while it is held
+	ValueID const& valueId = _notification->GetValueID();
+	double value;
+	if (!ValueHistory::ReadValue(valueId, &value))
+	{
+		return;
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	int64 time = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < s_logs.size(); ++i)
+	{
+		s_logs[i]->Record(valueId, time, value);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK HistoryLog::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	static_cast<HistoryLog*>(_context)->Step(false);
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Seal>
+//	Append a finished block to the pending writes.  Must be called with
+//	m_lock held.
+//-----------------------------------------------------------------------------
+void HistoryLog::Seal(SeriesKey const& _key, Series const& _series)
+{
+	HistoryBlockHeader header;
+	header.m_magic = c_historyBlockMagic;
+	header.m_homeId = _key.first;
+	header.m_valueId = _key.second;
+	header.m_firstTime = _series.m_firstTime;
+	header.m_lastTime = _series.m_lastTime;
+	header.m_count = _series.m_count;
+	header.m_size = (uint32)_series.m_samples.size();
+
+	HistoryIndexEntry entry;
+	entry.m_homeId = header.m_homeId;
+	entry.m_count = header.m_count;
+	entry.m_valueId = header.m_valueId;
+	entry.m_firstTime = header.m_firstTime;
+	entry.m_lastTime = header.m_lastTime;
+	entry.m_offset = m_pending.size();
+	m_pendingIndex.push_back(entry);
+
+	uint8 const* bytes = (uint8 const*)&header;
+	m_pending.insert(m_pending.end(), bytes, bytes + sizeof(header));
+	m_pending.insert(m_pending.end(), _series.m_samples.begin(), _series.m_samples.end());
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Step>
+//	Seal the blocks that are full of age (or all of them), write every
+//	sealed block, and wake up again when the next block comes of age
+//-----------------------------------------------------------------------------
+void HistoryLog::Step(bool _all)
+{
+	LockGuard ioGuard(m_ioLock);
+
+	std::vector<uint8> blocks;
+	std::vector<HistoryIndexEntry> entries;
+	uint32 segmentSize;
+	uint64 maxTotalSize;
+	{
+		LockGuard guard(m_lock);
+		uint64 now = GetTickCount64();
+		uint64 next = now + m_flushIntervalMs;
+		for (SeriesMap::iterator it = m_series.begin(); it != m_series.end(); )
+		{
+			if (_all || now - it->second.m_openedAt >= m_flushIntervalMs)
+			{
+				Seal(it->first, it->second);
+				m_series.erase(it++);
+			}
+			else
+			{
+				next = std::min(next, it->second.m_openedAt + m_flushIntervalMs);
+				++it;
+			}
+		}
+
+		blocks.swap(m_pending);
+		entries.swap(m_pendingIndex);
+		segmentSize = m_segmentSize;
+		maxTotalSize = m_maxTotalSize;
+		Schedule((uint32)(next - now));
+	}
+
+	if (!blocks.empty())
+	{
+		Write(blocks, entries, segmentSize, maxTotalSize);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Write>
+//	Append sealed blocks to the segment, starting a new one if it is full.
+//	Must be called with m_ioLock held.
+//-----------------------------------------------------------------------------
+void HistoryLog::Write(std::vector<uint8> const& _blocks, std::vector<HistoryIndexEntry> const& _entries, uint32 _segmentSize, uint64 _maxTotalSize)
+{
+	if (m_file != INVALID_HANDLE_VALUE && !m_index.empty() && m_fileSize + _blocks.size() > _segmentSize)
+	{
+		CloseSegment();
+		Prune(_maxTotalSize);
+	}
+	if (m_file == INVALID_HANDLE_VALUE && !OpenSegment())
+	{
+		return;
+	}
+
+	DWORD written = 0;
+	if (!WriteFile(m_file, &_blocks[0], (DWORD)_blocks.size(), &written, NULL) || written != _blocks.size())
+	{
+		// Leave the segment as the reader would find it after a crash
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+		return;
+	}
+
+	for (size_t i = 0; i < _entries.size(); ++i)
+	{
+		HistoryIndexEntry entry = _entries[i];
+		entry.m_offset += m_fileSize;
+		if (m_index.empty() || entry.m_firstTime < m_segmentFirst)
+		{
+			m_segmentFirst = entry.m_firstTime;
+		}
+		if (m_index.empty() || entry.m_lastTime > m_segmentLast)
+		{
+			m_segmentLast = entry.m_lastTime;
+		}
+		m_index.push_back(entry);
+	}
+	m_fileSize += _blocks.size();
+	m_bytesWritten += _blocks.size();
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::OpenSegment>
+//	Create the next segment file.  Must be called with m_ioLock held.
+//-----------------------------------------------------------------------------
+bool HistoryLog::OpenSegment()
+{
+	CreateDirectoryW(m_directory.c_str(), NULL);
+
+	std::vector<uint32> sequences;
+	HistoryListSegments(m_directory, &sequences);
+	m_sequence = std::max(m_sequence, sequences.empty() ? 0 : sequences.back()) + 1;
+
+	m_file = OpenFileHandle(HistorySegmentPath(m_directory, m_sequence), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, CREATE_NEW);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	HistorySegmentHeader header;
+	header.m_magic = c_historySegmentMagic;
+	header.m_version = c_historyVersion;
+	header.m_created = ((((int64)now.dwHighDateTime << 32) | now.dwLowDateTime)) / 10000;
+
+	DWORD written = 0;
+	if (!WriteFile(m_file, &header, sizeof(header), &written, NULL) || written != sizeof(header))
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+		return false;
+	}
+
+	m_fileSize = sizeof(header);
+	m_index.clear();
+	m_segmentFirst = 0;
+	m_segmentLast = 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::CloseSegment>
+//	Append the index and trailer, and close the segment.  A segment with no
+//	blocks is deleted.  Must be called with m_ioLock held.
+//-----------------------------------------------------------------------------
+void HistoryLog::CloseSegment()
+{
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	if (m_index.empty())
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+		DeleteFileW(HistorySegmentPath(m_directory, m_sequence).c_str());
+		return;
+	}
+
+	std::sort(m_index.begin(), m_index.end(), HistoryIndexOrder);
+
+	HistorySegmentTrailer trailer;
+	trailer.m_magic = c_historyIndexMagic;
+	trailer.m_entries = (uint32)m_index.size();
+	trailer.m_indexOffset = m_fileSize;
+	trailer.m_firstTime = m_segmentFirst;
+	trailer.m_lastTime = m_segmentLast;
+
+	std::vector<uint8> footer((uint8 const*)&m_index[0], (uint8 const*)&m_index[0] + m_index.size() * sizeof(HistoryIndexEntry));
+	footer.insert(footer.end(), (uint8 const*)&trailer, (uint8 const*)&trailer + sizeof(trailer));
+
+	DWORD written = 0;
+	WriteFile(m_file, &footer[0], (DWORD)footer.size(), &written, NULL);
+	CloseHandle(m_file);
+	m_file = INVALID_HANDLE_VALUE;
+	m_index.clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Prune>
+//	Delete the oldest segments until the directory fits in the total size.
+//	Must be called with m_ioLock held and no segment open.
+//-----------------------------------------------------------------------------
+void HistoryLog::Prune(uint64 _maxTotalSize)
+{
+	if (_maxTotalSize == 0)
+	{
+		return;
+	}
+
+	std::vector<uint32> sequences;
+	HistoryListSegments(m_directory, &sequences);
+
+	std::vector<uint64> sizes(sequences.size());
+	uint64 total = 0;
+	for (size_t i = 0; i < sequences.size(); ++i)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (GetFileAttributesExW(HistorySegmentPath(m_directory, sequences[i]).c_str(), GetFileExInfoStandard, &data))
+		{
+			sizes[i] = ((uint64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+			total += sizes[i];
+		}
+	}
+
+	// Always keep the newest segment
+	for (size_t i = 0; i + 1 < sequences.size() && total > _maxTotalSize; ++i)
+	{
+		if (DeleteFileW(HistorySegmentPath(m_directory, sequences[i]).c_str()))
+		{
+			total -= sizes[i];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLog::Schedule>
+//	Run Step after a delay.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+void HistoryLog::Schedule(uint32 _delayMs)
+{
+	if (m_timer == NULL)
+	{
+		return;
+	}
+
+	// Negative due times are relative, in 100ns units
+	ULARGE_INTEGER due;
+	due.QuadPart = (ULONGLONG)(-((LONGLONG)_delayMs * 10000));
+	FILETIME dueTime;
+	dueTime.dwLowDateTime = due.LowPart;
+	dueTime.dwHighDateTime = due.HighPart;
+	SetThreadpoolTimer(m_timer, &dueTime, 0, 0);
+}
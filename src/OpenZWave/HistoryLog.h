@@ -0,0 +1,129 @@
+//-----------------------------------------------------------------------------
+//
+//      HistoryLog.h
+//
+//      Appends value changes to compressed segment files
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "HistoryFormat.h"
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Records every numeric ValueChanged into the segment files of a
+		// directory (see HistoryFormat.h).  Samples are encoded as they arrive
+		// into an open block per value.  A block is sealed when it is full, or
+		// when its first sample is older than the flush interval, and sealed
+		// blocks are written from the thread pool, so the notification thread
+		// never waits for the disk.  Segments are closed with an index once
+		// they reach the segment size, and the oldest are deleted once the
+		// directory holds more than the total size.
+		class HistoryLog
+		{
+		public:
+			HistoryLog(std::wstring const& _directory);
+			~HistoryLog();
+
+			// False if the directory or the first segment could not be created
+			bool IsOpen();
+
+			uint32 GetFlushInterval();
+			void SetFlushInterval(uint32 _intervalMs);
+			uint32 GetSegmentSize();
+			void SetSegmentSize(uint32 _bytes);
+			uint64 GetMaxTotalSize();
+			void SetMaxTotalSize(uint64 _bytes);
+
+			// Add a sample; _time is a UTC file time
+			void Record(ValueID const& _valueId, int64 _time, double _value);
+
+			// Seal every open block and write it before returning
+			void Flush();
+
+			uint64 GetSamplesRecorded();
+			uint64 GetBytesWritten();
+
+			// Forward OpenZWave notifications to every live log
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			HistoryLog(HistoryLog const&);
+			HistoryLog& operator=(HistoryLog const&);
+
+			struct Series
+			{
+				int64				m_firstTime;	// Milliseconds
+				int64				m_lastTime;
+				int64				m_lastDelta;
+				uint64				m_lastBits;
+				uint32				m_count;
+				uint64				m_openedAt;		// Tick count
+				std::vector<uint8>	m_samples;
+			};
+
+			typedef std::pair<uint32, uint64> SeriesKey;
+			typedef std::map<SeriesKey, Series> SeriesMap;
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+
+			void Seal(SeriesKey const& _key, Series const& _series);
+			void Step(bool _all);
+			void Write(std::vector<uint8> const& _blocks, std::vector<HistoryIndexEntry> const& _entries, uint32 _segmentSize, uint64 _maxTotalSize);
+			bool OpenSegment();
+			void CloseSegment();
+			void Prune(uint64 _maxTotalSize);
+			void Schedule(uint32 _delayMs);
+
+			std::wstring					m_directory;
+			PTP_TIMER						m_timer;
+
+			// Encoding state, held only briefly by the notification thread
+			Lock							m_lock;
+			SeriesMap						m_series;
+			std::vector<uint8>				m_pending;			// Sealed blocks not written yet
+			std::vector<HistoryIndexEntry>	m_pendingIndex;		// Their offsets, within m_pending
+			uint32							m_flushIntervalMs;
+			uint32							m_segmentSize;
+			uint64							m_maxTotalSize;
+			uint64							m_samples;
+
+			// File state, held while writing, and taken before m_lock
+			Lock							m_ioLock;
+			HANDLE							m_file;
+			uint32							m_sequence;
+			uint64							m_fileSize;
+			std::vector<HistoryIndexEntry>	m_index;
+			int64							m_segmentFirst;
+			int64							m_segmentLast;
+			uint64							m_bytesWritten;
+
+			static Lock						s_lock;
+			static std::vector<HistoryLog*>	s_logs;
+		};
+	}
+}
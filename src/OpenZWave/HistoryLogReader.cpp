@@ -0,0 +1,357 @@
+//-----------------------------------------------------------------------------
+//
+//      HistoryLogReader.cpp
+//
+//      Queries the segment files written by HistoryLog
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <limits>
+#include "HistoryLogReader.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	// The first millisecond whose file time is at or after _time
+	int64 ToMilliseconds(int64 _time)
+	{
+		return (_time <= 0) ? 0 : (_time + 9999) / 10000;
+	}
+
+	struct SampleContext
+	{
+		std::vector<int64>*	m_times;
+		std::vector<double>*	m_values;
+	};
+
+	struct WindowContext
+	{
+		std::vector<HistoryAggregate>*	m_aggregates;
+		std::vector<int64>				m_lastTimes;
+	};
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::HistoryLogReader>
+//	Constructor
+//-----------------------------------------------------------------------------
+HistoryLogReader::HistoryLogReader(std::wstring const& _directory) :
+	m_directory(_directory)
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::GetSamples>
+//	Copy out the samples in a time range, oldest first
+//-----------------------------------------------------------------------------
+void HistoryLogReader::GetSamples(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, std::vector<int64>* o_times, std::vector<double>* o_values)
+{
+	o_times->clear();
+	o_values->clear();
+	if (_from >= _to)
+	{
+		return;
+	}
+
+	SampleContext context;
+	context.m_times = o_times;
+	context.m_values = o_values;
+	Scan(_homeId, _valueId, ToMilliseconds(_from), ToMilliseconds(_to), AddSample, &context);
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::Aggregate>
+//	Min, max, average and last value of each window of a time range
+//-----------------------------------------------------------------------------
+void HistoryLogReader::Aggregate(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, uint32 _windows, std::vector<HistoryAggregate>* o_aggregates)
+{
+	ValueHistory::SplitRange(_from, _to, _windows, o_aggregates);
+	if (o_aggregates->empty())
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < o_aggregates->size(); ++i)
+	{
+		HistoryAggregate& aggregate = (*o_aggregates)[i];
+		aggregate.m_min = std::numeric_limits<double>::infinity();
+		aggregate.m_max = -std::numeric_limits<double>::infinity();
+	}
+
+	WindowContext context;
+	context.m_aggregates = o_aggregates;
+	context.m_lastTimes.resize(o_aggregates->size(), std::numeric_limits<int64>::min());
+	Scan(_homeId, _valueId, ToMilliseconds(_from), ToMilliseconds(_to), AddToWindow, &context);
+
+	for (size_t i = 0; i < o_aggregates->size(); ++i)
+	{
+		HistoryAggregate& aggregate = (*o_aggregates)[i];
+		if (aggregate.m_count == 0)
+		{
+			aggregate.m_min = 0.0;
+			aggregate.m_max = 0.0;
+		}
+		else
+		{
+			// m_average holds the sum until now
+			aggregate.m_average /= aggregate.m_count;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::Scan>
+//	Visit the samples of a value in every segment, oldest segment first
+//-----------------------------------------------------------------------------
+void HistoryLogReader::Scan(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, Visitor _visitor, void* _context)
+{
+	std::vector<uint32> sequences;
+	HistoryListSegments(m_directory, &sequences);
+
+	for (size_t i = 0; i < sequences.size(); ++i)
+	{
+		// The log may be appending to the segment, or deleting it
+		HANDLE file = OpenFileHandle(HistorySegmentPath(m_directory, sequences[i]), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, OPEN_EXISTING);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			continue;
+		}
+
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(file, &size) && (uint64)size.QuadPart > sizeof(HistorySegmentHeader))
+		{
+			HANDLE mapping = NULL;
+			uint8 const* data = MapFileReadOnly(file, &mapping);
+			if (data != NULL)
+			{
+				HistorySegmentHeader header;
+				memcpy(&header, data, sizeof(header));
+				if (header.m_magic == c_historySegmentMagic && header.m_version == c_historyVersion)
+				{
+					ScanSegment(data, (uint64)size.QuadPart, _homeId, _valueId, _from, _to, _visitor, _context);
+				}
+				UnmapViewOfFile(data);
+			}
+			if (mapping != NULL)
+			{
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::ScanSegment>
+//	Visit the samples of a value in one mapped segment
+//-----------------------------------------------------------------------------
+void HistoryLogReader::ScanSegment(uint8 const* _data, uint64 _size, uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, Visitor _visitor, void* _context)
+{
+	HistorySegmentTrailer trailer;
+	bool closed = false;
+	if (_size >= sizeof(HistorySegmentHeader) + sizeof(trailer))
+	{
+		memcpy(&trailer, _data + _size - sizeof(trailer), sizeof(trailer));
+		closed = trailer.m_magic == c_historyIndexMagic
+			&& trailer.m_indexOffset <= _size - sizeof(trailer)
+			&& (uint64)trailer.m_entries * sizeof(HistoryIndexEntry) == _size - sizeof(trailer) - trailer.m_indexOffset;
+	}
+
+	if (closed)
+	{
+		if (trailer.m_lastTime < _from || trailer.m_firstTime >= _to)
+		{
+			return;
+		}
+
+		// The index is sorted by value, then time, so the value's blocks are
+		// one run that starts at the lower bound
+		uint8 const* index = _data + trailer.m_indexOffset;
+		uint32 lo = 0;
+		uint32 hi = trailer.m_entries;
+		HistoryIndexEntry entry;
+		while (lo < hi)
+		{
+			uint32 mid = lo + (hi - lo) / 2;
+			memcpy(&entry, index + (uint64)mid * sizeof(entry), sizeof(entry));
+			if (entry.m_homeId < _homeId || (entry.m_homeId == _homeId && entry.m_valueId < _valueId))
+			{
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+
+		for (uint32 i = lo; i < trailer.m_entries; ++i)
+		{
+			memcpy(&entry, index + (uint64)i * sizeof(entry), sizeof(entry));
+			if (entry.m_homeId != _homeId || entry.m_valueId != _valueId || entry.m_firstTime >= _to)
+			{
+				break;
+			}
+			if (entry.m_lastTime >= _from && !Decode(_data, trailer.m_indexOffset, entry.m_offset, _from, _to, _visitor, _context))
+			{
+				break;
+			}
+		}
+		return;
+	}
+
+	// No index: the segment is being written, or its writer stopped.  Walk
+	// the blocks up to the first one that was not written completely.
+	uint64 offset = sizeof(HistorySegmentHeader);
+	while (offset + sizeof(HistoryBlockHeader) <= _size)
+	{
+		HistoryBlockHeader header;
+		memcpy(&header, _data + offset, sizeof(header));
+		uint64 end = offset + sizeof(header) + header.m_size;
+		if (header.m_magic != c_historyBlockMagic || end > _size)
+		{
+			break;
+		}
+		if (header.m_homeId == _homeId && header.m_valueId == _valueId && header.m_lastTime >= _from && header.m_firstTime < _to)
+		{
+			Decode(_data, _size, offset, _from, _to, _visitor, _context);
+		}
+		offset = end;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::Decode>
+//	Visit the samples of one block that are in [_from, _to).  False if the
+//	block is damaged.
+//-----------------------------------------------------------------------------
+bool HistoryLogReader::Decode(uint8 const* _data, uint64 _size, uint64 _offset, int64 _from, int64 _to, Visitor _visitor, void* _context)
+{
+	HistoryBlockHeader header;
+	if (_offset + sizeof(header) > _size)
+	{
+		return false;
+	}
+	memcpy(&header, _data + _offset, sizeof(header));
+	if (header.m_magic != c_historyBlockMagic || header.m_count == 0 || header.m_size < sizeof(uint64) || _offset + sizeof(header) + header.m_size > _size)
+	{
+		return false;
+	}
+
+	uint8 const* cursor = _data + _offset + sizeof(header);
+	uint8 const* end = cursor + header.m_size;
+
+	uint64 bits;
+	memcpy(&bits, cursor, sizeof(bits));
+	cursor += sizeof(bits);
+	int64 time = header.m_firstTime;
+	int64 delta = 0;
+
+	uint32 i = 0;
+	while (time < _to)
+	{
+		if (time >= _from)
+		{
+			double value;
+			memcpy(&value, &bits, sizeof(value));
+			_visitor(_context, time, value);
+		}
+
+		if (++i == header.m_count)
+		{
+			break;
+		}
+
+		uint64 encoded;
+		if (!HistoryGetVarint(&cursor, end, &encoded) || cursor >= end)
+		{
+			return false;
+		}
+		delta += HistoryUnZigZag(encoded);
+		time += delta;
+
+		uint8 marker = *cursor++;
+		if (marker != 0)
+		{
+			if (marker > 64 || !HistoryGetVarint(&cursor, end, &encoded))
+			{
+				return false;
+			}
+			bits ^= encoded << (marker - 1);
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::AddSample>
+//	Visitor for GetSamples
+//-----------------------------------------------------------------------------
+void HistoryLogReader::AddSample(void* _context, int64 _time, double _value)
+{
+	SampleContext* context = static_cast<SampleContext*>(_context);
+	context->m_times->push_back(_time * 10000);
+	context->m_values->push_back(_value);
+}
+
+//-----------------------------------------------------------------------------
+//	<HistoryLogReader::AddToWindow>
+//	Visitor for Aggregate
+//-----------------------------------------------------------------------------
+void HistoryLogReader::AddToWindow(void* _context, int64 _time, double _value)
+{
+	WindowContext* context = static_cast<WindowContext*>(_context);
+	std::vector<HistoryAggregate>& aggregates = *context->m_aggregates;
+
+	// The window is the first whose end is after the sample
+	int64 time = _time * 10000;
+	uint32 lo = 0;
+	uint32 hi = (uint32)aggregates.size();
+	while (lo < hi)
+	{
+		uint32 mid = lo + (hi - lo) / 2;
+		if (aggregates[mid].m_end <= time)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	if (lo == aggregates.size() || time < aggregates[lo].m_start)
+	{
+		return;
+	}
+
+	HistoryAggregate& aggregate = aggregates[lo];
+	++aggregate.m_count;
+	aggregate.m_min = std::min(aggregate.m_min, _value);
+	aggregate.m_max = std::max(aggregate.m_max, _value);
+	aggregate.m_average += _value;
+	if (_time >= context->m_lastTimes[lo])
+	{
+		context->m_lastTimes[lo] = _time;
+		aggregate.m_last = _value;
+	}
+}
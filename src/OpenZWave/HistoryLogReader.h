@@ -0,0 +1,70 @@
+//-----------------------------------------------------------------------------
+//
+//      HistoryLogReader.h
+//
+//      Queries the segment files written by HistoryLog
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "HistoryFormat.h"
+#include "ValueHistory.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Reads the history of one value from a HistoryLog directory, which may
+		// be in use by a log in this or another process.  Each segment is
+		// mapped read-only, the blocks of the value that overlap the range are
+		// found from the index (or, for the segment still being written, by
+		// walking the block headers), and only those blocks are decoded.
+		// Samples still in memory in a live log are not seen until it writes
+		// them.
+		class HistoryLogReader
+		{
+		public:
+			HistoryLogReader(std::wstring const& _directory);
+
+			// The samples in [_from, _to), as UTC file times, oldest first
+			void GetSamples(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, std::vector<int64>* o_times, std::vector<double>* o_values);
+
+			// [_from, _to) split into _windows equal windows, clamped as for
+			// ValueHistory::Aggregate
+			void Aggregate(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, uint32 _windows, std::vector<HistoryAggregate>* o_aggregates);
+
+		private:
+			// Called for each sample in range, with its time in milliseconds
+			typedef void (*Visitor)(void* _context, int64 _time, double _value);
+
+			void Scan(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, Visitor _visitor, void* _context);
+			static void ScanSegment(uint8 const* _data, uint64 _size, uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, Visitor _visitor, void* _context);
+			static bool Decode(uint8 const* _data, uint64 _size, uint64 _offset, int64 _from, int64 _to, Visitor _visitor, void* _context);
+
+			static void AddSample(void* _context, int64 _time, double _value);
+			static void AddToWindow(void* _context, int64 _time, double _value);
+
+			std::wstring	m_directory;
+		};
+	}
+}
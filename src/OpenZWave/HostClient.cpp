@@ -0,0 +1,276 @@
+//-----------------------------------------------------------------------------
+//
+//      HostClient.cpp
+//
+//      Uses the network of a controller host in another process
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstring>
+#include "FileMapping.h"
+#include "HostClient.h"
+#include "LocalSocket.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	// The host holds a slot odd for a few copies, so a slot still odd after
+	// this many tries belongs to a host that died while writing it
+	uint32 const c_maxSlotAttempts = 1000;
+
+	// OpenZWave queues commands rather than waiting for the network
+	DWORD const c_replyTimeoutMs = 5000;
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::HostClient>
+//	Constructor
+//-----------------------------------------------------------------------------
+HostClient::HostClient() :
+	m_mapping(NULL),
+	m_section(NULL),
+	m_started(0),
+	m_cursor(0),
+	m_lost(0),
+	m_socket(INVALID_SOCKET)
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::~HostClient>
+//	Destructor.  Disconnects and unmaps the section.
+//-----------------------------------------------------------------------------
+HostClient::~HostClient()
+{
+	if (m_socket != INVALID_SOCKET)
+	{
+		CloseLocalSocket(m_socket);
+	}
+	if (m_section != NULL)
+	{
+		UnmapViewOfFile(m_section);
+	}
+	if (m_mapping != NULL)
+	{
+		CloseHandle(m_mapping);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::Open>
+//	Map a host's section and check its layout
+//-----------------------------------------------------------------------------
+HostClient* HostClient::Open(std::wstring const& _name)
+{
+	HostClient* client = new HostClient();
+	client->m_section = (HostSection const*)OpenSharedMemory(GetHostSectionName(_name), &client->m_mapping);
+	if (client->m_section == NULL)
+	{
+		delete client;
+		return NULL;
+	}
+
+	HostHeader const& header = client->m_section->m_header;
+	if (header.m_magic != c_hostMagic || header.m_version != c_hostVersion
+		|| header.m_ringCapacity != c_hostRingCapacity || header.m_valueCapacity != c_hostValueCapacity)
+	{
+		delete client;
+		return NULL;
+	}
+
+	client->m_started = header.m_started;
+	client->m_cursor = header.m_published;
+	return client;
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::IsHostRunning>
+//	Whether the host has not stopped
+//-----------------------------------------------------------------------------
+bool HostClient::IsHostRunning() const
+{
+	return m_section->m_header.m_running != 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::Read>
+//	Copy the notifications published since the last call
+//-----------------------------------------------------------------------------
+uint32 HostClient::Read(HostNotification* o_notifications, uint32 _max)
+{
+	LockGuard guard(m_readLock);
+	HostHeader const& header = m_section->m_header;
+	if (header.m_started != m_started)
+	{
+		// A new host numbers its notifications from 0
+		m_started = header.m_started;
+		m_cursor = 0;
+	}
+
+	uint32 count = 0;
+	LONG64 published = header.m_published;
+	while (m_cursor < published && count < _max)
+	{
+		if (published - m_cursor > c_hostRingCapacity)
+		{
+			m_lost += (uint64)(published - c_hostRingCapacity - m_cursor);
+			m_cursor = published - c_hostRingCapacity;
+		}
+
+		HostNotification const& record = m_section->m_ring[m_cursor & (c_hostRingCapacity - 1)];
+		LONG64 expected = m_cursor * 2 + 2;
+		LONG64 before = record.m_stamp;
+		MemoryBarrier();
+		memcpy(&o_notifications[count], (void const*)&record, sizeof(HostNotification));
+		MemoryBarrier();
+		LONG64 after = record.m_stamp;
+		++m_cursor;
+		if (before != expected || after != expected)
+		{
+			// The host wrote over it while it was read; skip to what is there now
+			++m_lost;
+			published = header.m_published;
+			continue;
+		}
+		++count;
+	}
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::GetValue>
+//	Find a value's slot and copy it
+//-----------------------------------------------------------------------------
+bool HostClient::GetValue(uint32 _homeId, uint64 _valueId, HostValue* o_value) const
+{
+	uint32 index = HostValueHash(_homeId, _valueId);
+	for (uint32 probe = 0; probe < c_hostValueCapacity; ++probe)
+	{
+		HostValue const& slot = m_section->m_values[(index + probe) & (c_hostValueCapacity - 1)];
+		uint32 homeId = *(uint32 const volatile*)&slot.m_homeId;
+		if (homeId == 0)
+		{
+			return false;
+		}
+		MemoryBarrier();
+		if (homeId == _homeId && slot.m_valueId == _valueId)
+		{
+			return ReadSlot(slot, o_value) && (o_value->m_flags & HostValueFlag_Present) != 0;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::GetValues>
+//	Copy every value present
+//-----------------------------------------------------------------------------
+void HostClient::GetValues(std::vector<HostValue>* o_values) const
+{
+	o_values->clear();
+	HostValue value;
+	for (uint32 i = 0; i < c_hostValueCapacity; ++i)
+	{
+		HostValue const& slot = m_section->m_values[i];
+		if (*(uint32 const volatile*)&slot.m_homeId != 0 && ReadSlot(slot, &value) && (value.m_flags & HostValueFlag_Present) != 0)
+		{
+			o_values->push_back(value);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::ReadSlot>
+//	Copy a slot the host is not writing
+//-----------------------------------------------------------------------------
+bool HostClient::ReadSlot(HostValue const& _slot, HostValue* o_value)
+{
+	for (uint32 attempt = 0; attempt < c_maxSlotAttempts; ++attempt)
+	{
+		LONG before = _slot.m_sequence;
+		if ((before & 1) != 0)
+		{
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		memcpy(o_value, (void const*)&_slot, sizeof(HostValue));
+		MemoryBarrier();
+		if (_slot.m_sequence == before)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//	<HostClient::Send>
+//	Send a command to the host and wait for the answer
+//-----------------------------------------------------------------------------
+bool HostClient::Send(HostCommand _command, std::string const& _string)
+{
+	if (_string.size() > c_hostMaxCommandString)
+	{
+		return false;
+	}
+	_command.m_stringLength = (uint32)_string.size();
+	_command.m_reserved = 0;
+
+	LockGuard guard(m_sendLock);
+
+	// A host started again since the last command has a new socket, so a
+	// failed connection is opened again once
+	for (uint32 attempt = 0; attempt < 2; ++attempt)
+	{
+		if (m_socket == INVALID_SOCKET)
+		{
+			HostHeader const& header = m_section->m_header;
+			if (header.m_running == 0)
+			{
+				return false;
+			}
+			m_socket = ConnectLocal(header.m_port, std::wstring(header.m_socketPath));
+			if (m_socket == INVALID_SOCKET)
+			{
+				return false;
+			}
+			memcpy(m_token, header.m_token, sizeof(m_token));
+			DWORD timeout = c_replyTimeoutMs;
+			setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (char const*)&timeout, sizeof(timeout));
+		}
+
+		HostReply reply;
+		memcpy(_command.m_token, m_token, sizeof(m_token));
+		if (SendAll(m_socket, (char const*)&_command, sizeof(_command))
+			&& (_string.empty() || SendAll(m_socket, _string.data(), (int)_string.size()))
+			&& ReceiveAll(m_socket, (char*)&reply, sizeof(reply)))
+		{
+			return reply.m_result != 0;
+		}
+
+		CloseLocalSocket(m_socket);
+		m_socket = INVALID_SOCKET;
+	}
+	return false;
+}
@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+//
+//      HostClient.h
+//
+//      Uses the network of a controller host in another process
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "HostFormat.h"
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// The other side of ControllerHost.  Notifications and values are
+		// read straight from the host's section, so any number of clients
+		// can read without slowing the host or each other.  Commands go over
+		// one connection to the host, opened when the first is sent.
+		class HostClient
+		{
+		public:
+			// Map the section of the host started with _name.  NULL if there
+			// is none, or it was built from another version of the layout.
+			static HostClient* Open(std::wstring const& _name);
+			~HostClient();
+
+			// False once the host has stopped.  A host started again under the
+			// same name is followed from its first notification.
+			bool IsHostRunning() const;
+
+			// Copy up to _max of the notifications published since the last
+			// call, or since Open.  Those the host overwrote before they were
+			// read are added to the lost count.
+			uint32 Read(HostNotification* o_notifications, uint32 _max);
+			uint64 GetLostCount() const { return m_lost; }
+
+			// Copy a value.  False if the host has not published it, or it
+			// has been removed.
+			bool GetValue(uint32 _homeId, uint64 _valueId, HostValue* o_value) const;
+
+			// Copy every value the host has published and not removed
+			void GetValues(std::vector<HostValue>* o_values) const;
+
+			// Send a command and wait for the host's answer.  False if the
+			// host could not be reached or OpenZWave refused the command.
+			bool Send(HostCommand _command, std::string const& _string);
+
+		private:
+			HostClient();
+			static bool ReadSlot(HostValue const& _slot, HostValue* o_value);
+
+			HANDLE				m_mapping;
+			HostSection const*	m_section;
+
+			// Under m_readLock
+			Lock				m_readLock;
+			int64				m_started;			// The host the cursor belongs to
+			LONG64				m_cursor;
+			uint64				m_lost;
+
+			// Under m_sendLock
+			Lock				m_sendLock;
+			SOCKET				m_socket;
+			uint8				m_token[c_hostTokenSize];	// That of the host m_socket is connected to
+		};
+	}
+}
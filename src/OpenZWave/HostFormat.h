@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------
+//
+//      HostFormat.h
+//
+//      Shared memory layout and command protocol of the controller host
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+
+// The host publishes into a named section of shared memory, a HostSection,
+// that only it writes.
+//
+// Notification n goes in ring record n modulo the capacity.  Its stamp is
+// 2n+1 while the record is written and 2n+2 once it is complete, and the
+// header's count is raised after that.  A reader that finds another stamp,
+// before or after copying the record, was lapped by the host.
+//
+// Each value slot is a seqlock: its sequence is odd while the host writes
+// it, so a reader copies the slot and keeps the copy only if the sequence
+// was even and unchanged.  Slots are found by linear probing from
+// HostValueHash.  The key of a slot is written once, Home ID last, and
+// slots are never freed, so a Home ID of 0 ends a probe.
+//
+// Commands go over the host's local socket as a HostCommand followed by
+// m_stringLength bytes of UTF-8.  The host answers each with a HostReply.
+// Each start of a host puts new random bytes in the header's token, and a
+// command must carry them: the loopback port can be reached by any process
+// on the machine, but only those in the host's session can open the section.
+// The host drops the connection of a client that sends another token.
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		uint32 const c_hostMagic = 0x48575A4F;			// "OZWH"
+		uint32 const c_hostVersion = 2;
+		uint32 const c_hostRingCapacity = 4096;			// Powers of two
+		uint32 const c_hostValueCapacity = 8192;
+		uint32 const c_hostStringSize = 96;
+		uint32 const c_hostPathSize = 128;
+		uint32 const c_hostMaxCommandString = 1024;
+		uint32 const c_hostTokenSize = 16;
+
+		enum HostValueFlag
+		{
+			HostValueFlag_Present	= 0x01,			// Cleared when the value is removed
+			HostValueFlag_Truncated	= 0x02			// The string did not fit
+		};
+
+		enum HostCommandType
+		{
+			HostCommand_SetBool = 1,
+			HostCommand_SetByte,
+			HostCommand_SetShort,
+			HostCommand_SetInt,
+			HostCommand_SetFloat,
+			HostCommand_SetString,
+			HostCommand_SetListSelection,
+			HostCommand_RefreshValue,
+			HostCommand_RequestNodeState
+		};
+
+		struct HostHeader
+		{
+			uint32			m_magic;
+			uint32			m_version;
+			uint32			m_ringCapacity;
+			uint32			m_valueCapacity;
+			int64			m_started;			// UTC file time, new each time a host starts
+			volatile LONG	m_running;
+			uint16			m_port;				// The command socket, if m_socketPath is empty
+			uint16			m_reserved;
+			wchar_t			m_socketPath[c_hostPathSize];
+			uint8			m_token[c_hostTokenSize];	// Sent with every command
+			volatile LONG64	m_published;		// Notifications put in the ring
+			volatile LONG	m_valueCount;		// Slots in use
+			volatile LONG	m_valuesDropped;	// Values left out because the table was full
+		};
+
+		struct HostNotification
+		{
+			volatile LONG64	m_stamp;
+			uint64			m_valueId;			// ValueID::GetId, which holds the node ID
+			uint32			m_homeId;
+			uint8			m_type;				// Notification::NotificationType
+			uint8			m_byte;
+			uint8			m_event;			// NodeEvent and ControllerCommand only
+			uint8			m_reserved;
+		};
+
+		struct HostValue
+		{
+			volatile LONG	m_sequence;
+			uint32			m_homeId;
+			uint64			m_valueId;
+			int32			m_int;				// Bool, Byte, Short, Int, and the value of a List's selected item
+			float			m_float;			// Decimal
+			uint8			m_flags;			// HostValueFlag
+			uint8			m_reserved;
+			uint16			m_stringLength;
+			char			m_string[c_hostStringSize];	// Manager::GetValueAsString, not terminated
+		};
+
+		struct HostSection
+		{
+			HostHeader			m_header;
+			HostNotification	m_ring[c_hostRingCapacity];
+			HostValue			m_values[c_hostValueCapacity];
+		};
+
+		struct HostCommand
+		{
+			uint32	m_command;					// HostCommandType
+			uint32	m_homeId;
+			uint64	m_valueId;					// The node ID for RequestNodeState
+			int32	m_int;
+			float	m_float;
+			uint32	m_stringLength;				// At most c_hostMaxCommandString
+			uint32	m_reserved;
+			uint8	m_token[c_hostTokenSize];	// HostHeader::m_token
+		};
+
+		struct HostReply
+		{
+			uint32	m_result;					// 1 if OpenZWave accepted the command
+		};
+
+		inline uint32 HostValueHash(uint32 _homeId, uint64 _valueId)
+		{
+			uint64 key = (_valueId ^ ((uint64)_homeId << 32) ^ _homeId) * 0x9E3779B97F4A7C15ULL;
+			return (uint32)(key >> 32) & (c_hostValueCapacity - 1);
+		}
+
+		inline std::wstring GetHostSectionName(std::wstring const& _name)
+		{
+			return L"Local\\OpenZWaveHost." + _name;
+		}
+	}
+}
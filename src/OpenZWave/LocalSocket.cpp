@@ -0,0 +1,207 @@
+//-----------------------------------------------------------------------------
+//
+//      LocalSocket.cpp
+//
+//      Sockets reachable only from the same machine
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstring>
+#include "LocalSocket.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	// afunix.h is only in Windows SDKs from 10.0.17063, so its address is
+	// declared here.  The family and layout are the same on every version.
+	ADDRESS_FAMILY const c_afUnix = 1;
+
+	struct UnixAddress
+	{
+		ADDRESS_FAMILY	sun_family;
+		char			sun_path[108];
+	};
+
+	// Create a socket and fill in the address it is bound or connected to
+	SOCKET Open(uint16 _port, std::wstring const& _path, sockaddr_in* o_inet, UnixAddress* o_unix, int* o_length)
+	{
+		WSADATA data;
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		{
+			return INVALID_SOCKET;
+		}
+
+		SOCKET result = INVALID_SOCKET;
+		if (_path.empty())
+		{
+			memset(o_inet, 0, sizeof(*o_inet));
+			o_inet->sin_family = AF_INET;
+			o_inet->sin_port = htons(_port);
+			o_inet->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			*o_length = sizeof(*o_inet);
+			result = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		}
+		else
+		{
+			memset(o_unix, 0, sizeof(*o_unix));
+			o_unix->sun_family = c_afUnix;
+			*o_length = sizeof(*o_unix);
+			if (WideCharToMultiByte(CP_UTF8, 0, _path.c_str(), (int)_path.size(), o_unix->sun_path, sizeof(o_unix->sun_path) - 1, NULL, NULL) > 0)
+			{
+				result = socket(c_afUnix, SOCK_STREAM, 0);
+			}
+		}
+
+		if (result == INVALID_SOCKET)
+		{
+			WSACleanup();
+		}
+		return result;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ListenLocal>
+//	Bind a socket to a loopback port or a socket file and listen on it
+//-----------------------------------------------------------------------------
+SOCKET OpenZWave::Native::ListenLocal(uint16 _port, std::wstring const& _path)
+{
+	sockaddr_in inet;
+	UnixAddress file;
+	int length;
+	SOCKET listener = Open(_port, _path, &inet, &file, &length);
+	if (listener == INVALID_SOCKET)
+	{
+		return INVALID_SOCKET;
+	}
+
+	if (!_path.empty())
+	{
+		// A socket file outlives its socket, so one left by an earlier run
+		// would make bind fail.  One that still accepts a connection belongs
+		// to a live listener, and is left alone.
+		SOCKET probe = ConnectLocal(0, _path);
+		if (probe != INVALID_SOCKET)
+		{
+			CloseLocalSocket(probe);
+			CloseLocalSocket(listener);
+			return INVALID_SOCKET;
+		}
+		DeleteFileW(_path.c_str());
+	}
+
+	sockaddr const* address = _path.empty() ? (sockaddr const*)&inet : (sockaddr const*)&file;
+	if (bind(listener, address, length) == SOCKET_ERROR || listen(listener, SOMAXCONN) == SOCKET_ERROR)
+	{
+		CloseLocalSocket(listener);
+		return INVALID_SOCKET;
+	}
+	return listener;
+}
+
+//-----------------------------------------------------------------------------
+//	<ConnectLocal>
+//	Connect to a loopback port or a socket file
+//-----------------------------------------------------------------------------
+SOCKET OpenZWave::Native::ConnectLocal(uint16 _port, std::wstring const& _path)
+{
+	sockaddr_in inet;
+	UnixAddress file;
+	int length;
+	SOCKET connection = Open(_port, _path, &inet, &file, &length);
+	if (connection == INVALID_SOCKET)
+	{
+		return INVALID_SOCKET;
+	}
+
+	sockaddr const* address = _path.empty() ? (sockaddr const*)&inet : (sockaddr const*)&file;
+	if (connect(connection, address, length) == SOCKET_ERROR)
+	{
+		CloseLocalSocket(connection);
+		return INVALID_SOCKET;
+	}
+	return connection;
+}
+
+//-----------------------------------------------------------------------------
+//	<CloseLocalSocket>
+//	Close a socket from ListenLocal or ConnectLocal
+//-----------------------------------------------------------------------------
+void OpenZWave::Native::CloseLocalSocket(SOCKET _socket)
+{
+	closesocket(_socket);
+	WSACleanup();
+}
+
+//-----------------------------------------------------------------------------
+//	<GetLocalPort>
+//	The port of a loopback socket, or 0 for a Unix domain socket
+//-----------------------------------------------------------------------------
+uint16 OpenZWave::Native::GetLocalPort(SOCKET _socket)
+{
+	sockaddr_in address;
+	int length = sizeof(address);
+	if (getsockname(_socket, (sockaddr*)&address, &length) == SOCKET_ERROR || address.sin_family != AF_INET)
+	{
+		return 0;
+	}
+	return ntohs(address.sin_port);
+}
+
+//-----------------------------------------------------------------------------
+//	<SendAll>
+//	Send a whole buffer
+//-----------------------------------------------------------------------------
+bool OpenZWave::Native::SendAll(SOCKET _socket, char const* _data, int _length)
+{
+	while (_length > 0)
+	{
+		int sent = send(_socket, _data, _length, 0);
+		if (sent <= 0)
+		{
+			return false;
+		}
+		_data += sent;
+		_length -= sent;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ReceiveAll>
+//	Fill a whole buffer
+//-----------------------------------------------------------------------------
+bool OpenZWave::Native::ReceiveAll(SOCKET _socket, char* _data, int _length)
+{
+	while (_length > 0)
+	{
+		int received = recv(_socket, _data, _length, 0);
+		if (received <= 0)
+		{
+			return false;
+		}
+		_data += received;
+		_length -= received;
+	}
+	return true;
+}
@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+//
+//      LocalSocket.h
+//
+//      Sockets reachable only from the same machine
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// A stream socket on 127.0.0.1 at the port, or on the Unix domain
+		// socket at the path if it is not empty, so nothing off the machine
+		// can reach it.  Both functions call WSAStartup; close the socket
+		// they return with CloseLocalSocket, which balances it.  Unix domain
+		// sockets need Windows 10 version 1803 or later.  ListenLocal
+		// replaces a socket file left by an earlier run, but fails if a
+		// listener still answers on it.
+		SOCKET ListenLocal(uint16 _port, std::wstring const& _path);
+		SOCKET ConnectLocal(uint16 _port, std::wstring const& _path);
+		void CloseLocalSocket(SOCKET _socket);
+
+		// The port a loopback socket was bound to, which the system picks
+		// when ListenLocal is given port 0
+		uint16 GetLocalPort(SOCKET _socket);
+
+		// Loop until every byte has gone or arrived.  False if the
+		// connection closed or failed, or a receive timed out.
+		bool SendAll(SOCKET _socket, char const* _data, int _length);
+		bool ReceiveAll(SOCKET _socket, char* _data, int _length);
+	}
+}
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+//
+//      Lock.h
+//
+//      Lightweight locks for the wrapper's native state
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// A Win32 slim reader/writer lock.  <mutex> cannot be included from /clr
+		// code, so the native helpers use this instead.
+		class Lock
+		{
+		public:
+			Lock() { InitializeSRWLock(&m_lock); }
+
+			void Enter() { AcquireSRWLockExclusive(&m_lock); }
+			void Leave() { ReleaseSRWLockExclusive(&m_lock); }
+			void EnterShared() { AcquireSRWLockShared(&m_lock); }
+			void LeaveShared() { ReleaseSRWLockShared(&m_lock); }
+
+		private:
+			Lock(Lock const&);
+			Lock& operator=(Lock const&);
+
+			SRWLOCK	m_lock;
+		};
+
+		class LockGuard
+		{
+		public:
+			LockGuard(Lock& _lock) : m_lock(_lock) { m_lock.Enter(); }
+			~LockGuard() { m_lock.Leave(); }
+
+		private:
+			LockGuard(LockGuard const&);
+			LockGuard& operator=(LockGuard const&);
+
+			Lock&	m_lock;
+		};
+
+		class SharedLockGuard
+		{
+		public:
+			SharedLockGuard(Lock& _lock) : m_lock(_lock) { m_lock.EnterShared(); }
+			~SharedLockGuard() { m_lock.LeaveShared(); }
+
+		private:
+			SharedLockGuard(SharedLockGuard const&);
+			SharedLockGuard& operator=(SharedLockGuard const&);
+
+			Lock&	m_lock;
+		};
+	}
+}
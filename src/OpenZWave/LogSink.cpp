@@ -0,0 +1,537 @@
+//-----------------------------------------------------------------------------
+//
+//      LogSink.cpp
+//
+//      Asynchronous capture of OpenZWave's log into a lock-free ring
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include "FileMapping.h"
+#include "FrameCapture.h"
+#include "LogSink.h"
+#include "TrafficCounters.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile LogLevel LogSink::s_level = LogLevel_None;
+LogSink::Slot* LogSink::s_slots = NULL;
+uint32 LogSink::s_mask = 0;
+volatile LONG64 LogSink::s_enqueue = 0;
+volatile LONG64 LogSink::s_dropped = 0;
+volatile LONG64 LogSink::s_truncated = 0;
+volatile uint32 LogSink::s_homeId = 0;
+volatile uint32 LogSink::s_capacity = 0;
+Lock LogSink::s_lock;
+PTP_TIMER LogSink::s_timer = NULL;
+uint32 LogSink::s_intervalMs = 250;
+LogSink::pfnOnRecords_t LogSink::s_callback = NULL;
+void* LogSink::s_context = NULL;
+bool LogSink::s_installed = false;
+std::vector<uint32> LogSink::s_homes;
+Lock LogSink::s_drainLock;
+volatile LONG64 LogSink::s_dequeue = 0;
+std::vector<LogRecord> LogSink::s_batch;
+HANDLE LogSink::s_file = INVALID_HANDLE_VALUE;
+volatile LONG64 LogSink::s_delivered = 0;
+volatile LONG64 LogSink::s_batches = 0;
+
+namespace
+{
+	// Bounds the array handed to the callback at once
+	uint32 const c_maxBatch = 1024;
+	uint32 const c_maxCapacity = 1 << 20;
+
+	char const* const c_levelNames[] =
+	{
+		"", "", "Always", "Fatal", "Error", "Warning", "Alert", "Info", "Detail", "Debug", "StreamDetail", "Internal"
+	};
+
+	// Handed to OpenZWave, which deletes it with the manager.  The state
+	// lives in LogSink so that it outlives the logger.
+	class LogSinkLogger : public i_LogImpl
+	{
+	public:
+		virtual void Write(LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args)
+		{
+			if (FrameCapture::IsRunning() || TrafficCounters::IsEnabled())
+			{
+				va_list args;
+				va_copy(args, _args);
+				FrameCapture::OnLog(_nodeId, _format, args);
+				va_end(args);
+			}
+			LogSink::Write(_level, _nodeId, _format, _args);
+		}
+
+		virtual void QueueDump() {}
+		virtual void QueueClear() {}
+		virtual void SetLoggingState(LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger) {}
+		virtual void SetLogFileName(const string& _filename) {}
+	};
+
+	// In the format of OpenZWave's own log file, in local time
+	void AppendLine(std::string& _text, LogRecord const& _record)
+	{
+		ULARGE_INTEGER time;
+		time.QuadPart = (ULONGLONG)_record.m_time;
+		FILETIME utc;
+		utc.dwLowDateTime = time.LowPart;
+		utc.dwHighDateTime = time.HighPart;
+		FILETIME local;
+		SYSTEMTIME when;
+		FileTimeToLocalFileTime(&utc, &local);
+		FileTimeToSystemTime(&local, &when);
+
+		char prefix[64];
+		uint32 level = (uint32)_record.m_level;
+		int length = snprintf(prefix, sizeof(prefix), "%04d-%02d-%02d %02d:%02d:%02d.%03d %s, ",
+			when.wYear, when.wMonth, when.wDay, when.wHour, when.wMinute, when.wSecond, when.wMilliseconds,
+			level < sizeof(c_levelNames) / sizeof(c_levelNames[0]) ? c_levelNames[level] : "");
+		_text.append(prefix, length);
+		if (_record.m_nodeId != 0)
+		{
+			length = snprintf(prefix, sizeof(prefix), "Node%03d, ", _record.m_nodeId);
+			_text.append(prefix, length);
+		}
+		_text.append(_record.m_message, _record.m_length);
+		_text.append("\r\n", 2);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Start>
+//	Replace OpenZWave's logger and start draining the ring
+//-----------------------------------------------------------------------------
+bool LogSink::Start(LogLevel _level, uint32 _capacity, std::wstring const& _path)
+{
+	HANDLE file = INVALID_HANDLE_VALUE;
+	if (!_path.empty())
+	{
+		file = OpenFileHandle(_path, FILE_APPEND_DATA, FILE_SHARE_READ, OPEN_ALWAYS);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+	}
+
+	{
+		LockGuard drainGuard(s_drainLock);
+		if (s_file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(s_file);
+		}
+		s_file = file;
+
+		if (s_slots == NULL)
+		{
+			uint32 requested = std::min(_capacity > 0 ? _capacity : c_defaultCapacity, c_maxCapacity);
+			uint32 capacity = 1;
+			while (capacity < requested)
+			{
+				capacity <<= 1;
+			}
+
+			s_slots = new Slot[capacity];
+			for (uint32 i = 0; i < capacity; ++i)
+			{
+				s_slots[i].m_sequence = i;
+			}
+			s_mask = capacity - 1;
+			s_enqueue = 0;
+			s_dequeue = 0;
+			s_capacity = capacity;
+		}
+	}
+
+	{
+		LockGuard guard(s_lock);
+		if (s_timer == NULL)
+		{
+			s_timer = CreateThreadpoolTimer(OnTimer, NULL, NULL);
+			Schedule();
+		}
+	}
+
+	Install();
+
+	LockGuard guard(s_lock);
+	s_level = _level;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Install>
+//	Replace OpenZWave's logger, once per manager
+//-----------------------------------------------------------------------------
+void LogSink::Install()
+{
+	bool install = false;
+	{
+		LockGuard guard(s_lock);
+		if (!s_installed)
+		{
+			s_installed = true;
+			install = true;
+		}
+	}
+
+	if (install)
+	{
+		// OpenZWave owns the logger from here on
+		Log::SetLoggingClass(new LogSinkLogger());
+	}
+
+	// The logger is only called while logging is on
+	Log::SetLoggingState(true);
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Stop>
+//	Stop capturing, deliver what is in the ring and close the file
+//-----------------------------------------------------------------------------
+void LogSink::Stop()
+{
+	PTP_TIMER timer;
+	{
+		LockGuard guard(s_lock);
+		s_level = LogLevel_None;
+		timer = s_timer;
+		s_timer = NULL;
+	}
+
+	if (timer != NULL)
+	{
+		SetThreadpoolTimer(timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(timer, TRUE);
+		CloseThreadpoolTimer(timer);
+	}
+
+	Drain();
+
+	LockGuard drainGuard(s_drainLock);
+	if (s_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(s_file);
+		s_file = INVALID_HANDLE_VALUE;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::SetLevel>
+//	Change the most detailed level captured
+//-----------------------------------------------------------------------------
+void LogSink::SetLevel(LogLevel _level)
+{
+	LockGuard guard(s_lock);
+	if (s_installed)
+	{
+		s_level = _level;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::GetInterval>
+//	Milliseconds between drains of the ring
+//-----------------------------------------------------------------------------
+uint32 LogSink::GetInterval()
+{
+	SharedLockGuard guard(s_lock);
+	return s_intervalMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::SetInterval>
+//	Change the time between drains of the ring
+//-----------------------------------------------------------------------------
+void LogSink::SetInterval(uint32 _intervalMs)
+{
+	LockGuard guard(s_lock);
+	s_intervalMs = _intervalMs > 0 ? _intervalMs : 1;
+	Schedule();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::SetCallback>
+//	Set the function the batches are passed to
+//-----------------------------------------------------------------------------
+void LogSink::SetCallback(pfnOnRecords_t _callback, void* _context)
+{
+	LockGuard guard(s_lock);
+	s_callback = _callback;
+	s_context = _context;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Flush>
+//	Drain the ring on the calling thread
+//-----------------------------------------------------------------------------
+void LogSink::Flush()
+{
+	Drain();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::GetStats>
+//	Counters of the ring
+//-----------------------------------------------------------------------------
+void LogSink::GetStats(LogSinkStats* o_stats)
+{
+	// Each counter is read atomically, but not all at one instant.  The
+	// dequeue position is read before the enqueue position, so pending is
+	// never negative.
+	LONG64 dequeue = InterlockedCompareExchange64(&s_dequeue, 0, 0);
+	o_stats->m_written = (uint64)InterlockedCompareExchange64(&s_enqueue, 0, 0);
+	o_stats->m_dropped = (uint64)InterlockedCompareExchange64(&s_dropped, 0, 0);
+	o_stats->m_truncated = (uint64)InterlockedCompareExchange64(&s_truncated, 0, 0);
+	o_stats->m_delivered = (uint64)InterlockedCompareExchange64(&s_delivered, 0, 0);
+	o_stats->m_batches = (uint64)InterlockedCompareExchange64(&s_batches, 0, 0);
+	o_stats->m_capacity = s_capacity;
+	o_stats->m_pending = (uint32)(o_stats->m_written - (uint64)dequeue);
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Shutdown>
+//	Called once the manager, and with it the logger, is destroyed
+//-----------------------------------------------------------------------------
+void LogSink::Shutdown()
+{
+	Stop();
+
+	{
+		LockGuard guard(s_lock);
+		s_installed = false;
+		s_homes.clear();
+		s_homeId = 0;
+	}
+
+	LockGuard drainGuard(s_drainLock);
+	delete [] s_slots;
+	s_slots = NULL;
+	s_mask = 0;
+	s_capacity = 0;
+	s_enqueue = 0;
+	s_dequeue = 0;
+	std::vector<LogRecord>().swap(s_batch);
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Write>
+//	Format a message into the next free slot, or count it as dropped
+//-----------------------------------------------------------------------------
+void LogSink::Write(LogLevel _level, uint8 _nodeId, char const* _format, va_list _args)
+{
+	if (_level > s_level || s_slots == NULL)
+	{
+		return;
+	}
+
+	// A slot is free for position p when its sequence is p, and holds a
+	// record for the drain when it is p + 1
+	LONG64 position = s_enqueue;
+	Slot* slot;
+	for (;;)
+	{
+		slot = &s_slots[position & s_mask];
+		LONG64 sequence = slot->m_sequence;
+		MemoryBarrier();
+		if (sequence == position)
+		{
+			if (InterlockedCompareExchange64(&s_enqueue, position + 1, position) == position)
+			{
+				break;
+			}
+		}
+		else if (sequence < position)
+		{
+			// The drain has not freed the slot since the last lap
+			InterlockedIncrement64(&s_dropped);
+			return;
+		}
+		position = s_enqueue;
+	}
+
+	LogRecord& record = slot->m_record;
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	record.m_time = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+	record.m_homeId = s_homeId;
+	record.m_nodeId = _nodeId;
+	record.m_level = _level;
+
+	int result = vsnprintf(record.m_message, c_logMessageSize, _format, _args);
+	record.m_message[c_logMessageSize - 1] = 0;
+	if (result < 0 || (uint32)result >= c_logMessageSize)
+	{
+		InterlockedIncrement64(&s_truncated);
+	}
+	size_t length = strlen(record.m_message);
+	while (length > 0 && (record.m_message[length - 1] == '\n' || record.m_message[length - 1] == '\r'))
+	{
+		--length;
+	}
+	record.m_message[length] = 0;
+	record.m_length = (uint32)length;
+
+	InterlockedExchange64(&slot->m_sequence, position + 1);
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::OnNotification>
+//	Track the ready drivers, to stamp records with the Home ID
+//-----------------------------------------------------------------------------
+void LogSink::OnNotification(Notification const* _notification)
+{
+	Notification::NotificationType type = _notification->GetType();
+	if (type != Notification::Type_DriverReady && type != Notification::Type_DriverRemoved && type != Notification::Type_DriverFailed)
+	{
+		return;
+	}
+
+	uint32 homeId = _notification->GetHomeId();
+	LockGuard guard(s_lock);
+	std::vector<uint32>::iterator it = std::find(s_homes.begin(), s_homes.end(), homeId);
+	if (type == Notification::Type_DriverReady)
+	{
+		if (it == s_homes.end())
+		{
+			s_homes.push_back(homeId);
+		}
+	}
+	else if (it != s_homes.end())
+	{
+		s_homes.erase(it);
+	}
+
+	// OpenZWave does not say which driver a message is from
+	s_homeId = (s_homes.size() == 1) ? s_homes[0] : 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK LogSink::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	Drain();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Drain>
+//	Take every published record out of the ring, in batches
+//-----------------------------------------------------------------------------
+void LogSink::Drain()
+{
+	pfnOnRecords_t callback;
+	void* context;
+	{
+		SharedLockGuard guard(s_lock);
+		callback = s_callback;
+		context = s_context;
+	}
+
+	LockGuard drainGuard(s_drainLock);
+	if (s_slots == NULL)
+	{
+		return;
+	}
+
+	for (;;)
+	{
+		s_batch.clear();
+		while (s_batch.size() < c_maxBatch)
+		{
+			Slot& slot = s_slots[s_dequeue & s_mask];
+			LONG64 sequence = slot.m_sequence;
+			MemoryBarrier();
+			if (sequence != s_dequeue + 1)
+			{
+				// Empty, or a logger has claimed the slot and not filled it yet
+				break;
+			}
+
+			s_batch.push_back(slot.m_record);
+			InterlockedExchange64(&slot.m_sequence, s_dequeue + s_mask + 1);
+			InterlockedIncrement64(&s_dequeue);
+		}
+
+		if (s_batch.empty())
+		{
+			break;
+		}
+		Deliver(callback, context);
+		if (s_batch.size() < c_maxBatch)
+		{
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Deliver>
+//	Append the batch to the file and pass it to the callback.  Must be
+//	called with s_drainLock held.
+//-----------------------------------------------------------------------------
+void LogSink::Deliver(pfnOnRecords_t _callback, void* _context)
+{
+	if (s_file != INVALID_HANDLE_VALUE)
+	{
+		std::string text;
+		text.reserve(s_batch.size() * 128);
+		for (size_t i = 0; i < s_batch.size(); ++i)
+		{
+			AppendLine(text, s_batch[i]);
+		}
+		DWORD written = 0;
+		WriteFile(s_file, text.data(), (DWORD)text.size(), &written, NULL);
+	}
+
+	if (_callback != NULL)
+	{
+		_callback(&s_batch[0], (uint32)s_batch.size(), _context);
+	}
+
+	InterlockedExchangeAdd64(&s_delivered, (LONG64)s_batch.size());
+	InterlockedIncrement64(&s_batches);
+}
+
+//-----------------------------------------------------------------------------
+//	<LogSink::Schedule>
+//	Start the periodic timer.  Must be called with s_lock held.
+//-----------------------------------------------------------------------------
+void LogSink::Schedule()
+{
+	if (s_timer == NULL)
+	{
+		return;
+	}
+
+	// Negative due times are relative, in 100ns units
+	ULARGE_INTEGER due;
+	due.QuadPart = (ULONGLONG)(-((LONGLONG)s_intervalMs * 10000));
+	FILETIME dueTime;
+	dueTime.dwLowDateTime = due.LowPart;
+	dueTime.dwHighDateTime = due.HighPart;
+	SetThreadpoolTimer(s_timer, &dueTime, s_intervalMs, 0);
+}
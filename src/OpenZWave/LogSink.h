@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------
+//
+//      LogSink.h
+//
+//      Asynchronous capture of OpenZWave's log into a lock-free ring
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Longer messages are cut short
+		uint32 const c_logMessageSize = 472;
+
+		struct LogRecord
+		{
+			int64		m_time;				// UTC file time
+			uint32		m_homeId;			// 0 while more or less than one driver is ready
+			uint8		m_nodeId;			// 0 for messages about no node
+			LogLevel	m_level;
+			uint32		m_length;
+			char		m_message[c_logMessageSize];
+		};
+
+		struct LogSinkStats
+		{
+			uint64	m_written;			// Records put in the ring
+			uint64	m_dropped;			// Records lost because the ring was full
+			uint64	m_truncated;
+			uint64	m_delivered;		// Records taken out of the ring
+			uint64	m_batches;
+			uint32	m_capacity;
+			uint32	m_pending;
+		};
+
+		// OpenZWave's own logger formats and writes each message to its file on
+		// the thread that logs it, which is usually the driver thread.  The sink
+		// replaces it: a message is formatted straight into a slot of a bounded
+		// ring that is claimed with one compare-and-swap, so logging never
+		// blocks and never allocates.  A threadpool timer drains the ring,
+		// appends the batch to a file in one write, and passes it to a callback.
+		// A full ring drops new messages and counts them.
+		//
+		// OpenZWave deletes the logger it is given when the manager is destroyed,
+		// so the sink must be started again after each Initialize.
+		class LogSink
+		{
+		public:
+			typedef void (*pfnOnRecords_t)(LogRecord const* _records, uint32 _count, void* _context);
+
+			static uint32 const c_defaultCapacity = 4096;
+
+			// The capacity is rounded up to a power of two, and only the first
+			// start after Initialize allocates the ring.  An empty path writes
+			// no file.
+			static bool Start(LogLevel _level, uint32 _capacity, std::wstring const& _path);
+
+			// Hand OpenZWave the logger, which also feeds FrameCapture, and turn
+			// logging on.  Start calls it.
+			static void Install();
+			static void Stop();
+			static bool IsRunning() { return s_level > LogLevel_None; }
+
+			// The Home ID records are stamped with: 0 unless exactly one driver is ready
+			static uint32 GetHomeId() { return s_homeId; }
+
+			static LogLevel GetLevel() { return s_level; }
+			static void SetLevel(LogLevel _level);
+			static uint32 GetInterval();
+			static void SetInterval(uint32 _intervalMs);
+
+			static void SetCallback(pfnOnRecords_t _callback, void* _context);
+
+			// Drain the ring now, on the calling thread.  Not from the callback.
+			static void Flush();
+
+			// Reads the counters without taking either lock, so it can be
+			// called from the callback, and does not wait for a slow one
+			static void GetStats(LogSinkStats* o_stats);
+
+			// Drain and free the ring once the manager is destroyed
+			static void Shutdown();
+
+			static void Write(LogLevel _level, uint8 _nodeId, char const* _format, va_list _args);
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			struct Slot
+			{
+				volatile LONG64	m_sequence;
+				LogRecord		m_record;
+			};
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+			static void Drain();
+			static void Deliver(pfnOnRecords_t _callback, void* _context);
+			static void Schedule();
+
+			// Written by the loggers
+			static volatile LogLevel	s_level;
+			static Slot*				s_slots;
+			static uint32				s_mask;
+			static volatile LONG64		s_enqueue;
+			static volatile LONG64		s_dropped;
+			static volatile LONG64		s_truncated;
+			static volatile uint32		s_homeId;
+			static volatile uint32		s_capacity;			// 0 until the ring is allocated
+
+			// Under s_lock
+			static Lock					s_lock;
+			static PTP_TIMER			s_timer;
+			static uint32				s_intervalMs;
+			static pfnOnRecords_t		s_callback;
+			static void*				s_context;
+			static bool					s_installed;
+			static std::vector<uint32>	s_homes;
+
+			// The drain side, under s_drainLock, which is held while a batch is
+			// delivered so that batches arrive in order.  The counters are also
+			// read by GetStats without the lock.
+			static Lock					s_drainLock;
+			static volatile LONG64		s_dequeue;
+			static std::vector<LogRecord>	s_batch;
+			static HANDLE				s_file;
+			static volatile LONG64		s_delivered;
+			static volatile LONG64		s_batches;
+		};
+	}
+}
@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------
+//
+//      MemoryTracker.cpp
+//
+//      Counts live wrapper objects and native memory owned by the wrapper
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "MemoryTracker.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool MemoryTracker::s_enabled = false;
+Lock MemoryTracker::s_lock;
+std::map<uint64, MemoryUsage> MemoryTracker::s_usage;
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::SetEnabled>
+//	Turn instrumentation on or off
+//-----------------------------------------------------------------------------
+void MemoryTracker::SetEnabled(bool _enabled)
+{
+	LockGuard guard(s_lock);
+	s_enabled = _enabled;
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::OnCreated>
+//	Count a new wrapper object
+//-----------------------------------------------------------------------------
+void MemoryTracker::OnCreated(TrackedObject _type, uint32 _homeId, uint8 _nodeId, size_t _nativeBytes)
+{
+	LockGuard guard(s_lock);
+	MemoryUsage& usage = Usage(_homeId, _nodeId);
+	++usage.m_live[_type];
+	usage.m_nativeBytes += _nativeBytes;
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::OnDestroyed>
+//	Forget a wrapper object that was counted by OnCreated
+//-----------------------------------------------------------------------------
+void MemoryTracker::OnDestroyed(TrackedObject _type, uint32 _homeId, uint8 _nodeId, size_t _nativeBytes)
+{
+	LockGuard guard(s_lock);
+	MemoryUsage& usage = Usage(_homeId, _nodeId);
+	--usage.m_live[_type];
+	usage.m_nativeBytes -= _nativeBytes;
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::AddNativeBytes>
+//	Account for native memory held by a wrapper store
+//-----------------------------------------------------------------------------
+void MemoryTracker::AddNativeBytes(uint32 _homeId, uint8 _nodeId, int64 _delta)
+{
+	LockGuard guard(s_lock);
+	Usage(_homeId, _nodeId).m_nativeBytes += _delta;
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::OnNotification>
+//	Track how many values OpenZWave holds for each node
+//-----------------------------------------------------------------------------
+void MemoryTracker::OnNotification(Notification const* _notification)
+{
+	uint32 homeId = _notification->GetHomeId();
+	uint8 nodeId = _notification->GetNodeId();
+
+	LockGuard guard(s_lock);
+	switch (_notification->GetType())
+	{
+	case Notification::Type_ValueAdded:
+		++Usage(homeId, nodeId).m_valueCount;
+		break;
+	case Notification::Type_ValueRemoved:
+		--Usage(homeId, nodeId).m_valueCount;
+		break;
+	case Notification::Type_NodeRemoved:
+	case Notification::Type_NodeReset:
+		Usage(homeId, nodeId).m_valueCount = 0;
+		break;
+	case Notification::Type_DriverRemoved:
+	case Notification::Type_DriverReset:
+		for (std::map<uint64, MemoryUsage>::iterator it = s_usage.lower_bound((uint64)homeId << 8); it != s_usage.end() && it->second.m_homeId == homeId; ++it)
+		{
+			it->second.m_valueCount = 0;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::GetUsage>
+//	Copy out the per-node usage, dropping nodes that no longer hold anything
+//-----------------------------------------------------------------------------
+void MemoryTracker::GetUsage(std::vector<MemoryUsage>* o_usage)
+{
+	LockGuard guard(s_lock);
+	o_usage->clear();
+	o_usage->reserve(s_usage.size());
+	std::map<uint64, MemoryUsage>::iterator it = s_usage.begin();
+	while (it != s_usage.end())
+	{
+		MemoryUsage const& usage = it->second;
+		bool empty = (usage.m_nativeBytes == 0) && (usage.m_valueCount == 0);
+		for (int32 i = 0; i < TrackedObject_Count; ++i)
+		{
+			empty = empty && (usage.m_live[i] == 0);
+		}
+		if (empty)
+		{
+			it = s_usage.erase(it);
+			continue;
+		}
+		o_usage->push_back(usage);
+		++it;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::Shutdown>
+//	Zero the value counts of every node
+//-----------------------------------------------------------------------------
+void MemoryTracker::Shutdown()
+{
+	LockGuard guard(s_lock);
+	for (std::map<uint64, MemoryUsage>::iterator it = s_usage.begin(); it != s_usage.end(); ++it)
+	{
+		it->second.m_valueCount = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryTracker::Usage>
+//	Find or create the entry for a node.  Must be called with s_lock held.
+//-----------------------------------------------------------------------------
+MemoryUsage& MemoryTracker::Usage(uint32 _homeId, uint8 _nodeId)
+{
+	uint64 key = ((uint64)_homeId << 8) | _nodeId;
+	std::map<uint64, MemoryUsage>::iterator it = s_usage.find(key);
+	if (it != s_usage.end())
+	{
+		return it->second;
+	}
+
+	MemoryUsage usage;
+	memset(&usage, 0, sizeof(usage));
+	usage.m_homeId = _homeId;
+	usage.m_nodeId = _nodeId;
+	return s_usage.insert(std::make_pair(key, usage)).first->second;
+}
@@ -0,0 +1,87 @@
+//-----------------------------------------------------------------------------
+//
+//      MemoryTracker.h
+//
+//      Counts live wrapper objects and native memory owned by the wrapper
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		enum TrackedObject
+		{
+			TrackedObject_ValueId = 0,
+			TrackedObject_Notification,
+			TrackedObject_EventArgs,
+			TrackedObject_Count
+		};
+
+		struct MemoryUsage
+		{
+			uint32	m_homeId;
+			uint8	m_nodeId;
+			int32	m_live[TrackedObject_Count];
+			int64	m_nativeBytes;
+			int32	m_valueCount;		// Values OpenZWave holds for the node (ValueAdded - ValueRemoved)
+		};
+
+		// Instrumentation for the memory report.  All counting is skipped while
+		// tracking is disabled, so the only cost in normal use is one flag test.
+		// Objects remember whether they were counted, so enabling or disabling
+		// tracking at runtime never makes the live counts go negative.
+		class MemoryTracker
+		{
+		public:
+			static bool IsEnabled() { return s_enabled; }
+			static void SetEnabled(bool _enabled);
+
+			static void OnCreated(TrackedObject _type, uint32 _homeId, uint8 _nodeId, size_t _nativeBytes);
+			static void OnDestroyed(TrackedObject _type, uint32 _homeId, uint8 _nodeId, size_t _nativeBytes);
+
+			// For native stores owned by the wrapper (caches, history buffers...)
+			static void AddNativeBytes(uint32 _homeId, uint8 _nodeId, int64 _delta);
+
+			// Keeps the per-node value counts in step with OpenZWave
+			static void OnNotification(Notification const* _notification);
+
+			// Snapshot of the per-node usage, sorted by home and node
+			static void GetUsage(std::vector<MemoryUsage>* o_usage);
+
+			// OpenZWave holds no values once it is destroyed.  Wrapper objects
+			// still alive keep their counts, since they are released later.
+			static void Shutdown();
+
+		private:
+			static MemoryUsage& Usage(uint32 _homeId, uint8 _nodeId);
+
+			static volatile bool						s_enabled;
+			static Lock									s_lock;
+			static std::map<uint64, MemoryUsage>		s_usage;
+		};
+	}
+}
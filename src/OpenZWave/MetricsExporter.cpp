@@ -0,0 +1,528 @@
+//-----------------------------------------------------------------------------
+//
+//      MetricsExporter.cpp
+//
+//      Serves wrapper and driver metrics in the OpenMetrics text format
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include "FrameCapture.h"
+#include "LocalSocket.h"
+#include "LogSink.h"
+#include "MetricsExporter.h"
+#include "NodeRegistry.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool MetricsExporter::s_running = false;
+volatile LONG64 MetricsExporter::s_notifications[MetricsExporter::c_notificationTypes + 1];
+volatile LONG64 MetricsExporter::s_scrapes = 0;
+Lock MetricsExporter::s_lock;
+std::vector<uint32> MetricsExporter::s_homes;
+SOCKET MetricsExporter::s_listen = INVALID_SOCKET;
+PTP_WORK MetricsExporter::s_work = NULL;
+std::wstring MetricsExporter::s_socketPath;
+Lock MetricsExporter::s_renderLock;
+std::vector<MetricsExporter::DriverSample> MetricsExporter::s_drivers;
+std::vector<MetricsExporter::NodeSample> MetricsExporter::s_nodes;
+std::vector<uint32> MetricsExporter::s_homeIds;
+std::vector<uint8> MetricsExporter::s_nodeIds;
+std::vector<TrafficCounter> MetricsExporter::s_counters;
+Node::NodeData MetricsExporter::s_nodeData;
+std::vector<char> MetricsExporter::s_buffer;
+
+namespace
+{
+	// Enough for a few dozen nodes without growing
+	size_t const c_initialBufferSize = 64 * 1024;
+
+	// A scrape request is one short line and a few headers
+	int const c_maxRequestSize = 2048;
+	DWORD const c_socketTimeoutMs = 2000;
+
+	// In the order of Notification::NotificationType
+	char const* const c_notificationNames[MetricsExporter::c_notificationTypes + 1] =
+	{
+		"ValueAdded", "ValueRemoved", "ValueChanged", "ValueRefreshed", "Group",
+		"NodeNew", "NodeAdded", "NodeRemoved", "NodeProtocolInfo", "NodeNaming", "NodeEvent",
+		"PollingDisabled", "PollingEnabled", "SceneEvent", "CreateButton", "DeleteButton",
+		"ButtonOn", "ButtonOff", "DriverReady", "DriverFailed", "DriverReset",
+		"EssentialNodeQueriesComplete", "NodeQueriesComplete", "AwakeNodesQueried",
+		"AllNodesQueriedSomeDead", "AllNodesQueried", "Notification", "DriverRemoved",
+		"ControllerCommand", "NodeReset", "UserAlerts", "ManufacturerSpecificDBReady",
+		"Other"
+	};
+
+	struct DriverCounter
+	{
+		char const*						m_name;
+		char const*						m_help;
+		uint32 Driver::DriverData::*	m_field;
+	};
+
+	DriverCounter const c_driverCounters[] =
+	{
+		{ "ozw_driver_frames_read", "Frames read from the controller.", &Driver::DriverData::m_readCnt },
+		{ "ozw_driver_frames_written", "Frames written to the controller.", &Driver::DriverData::m_writeCnt },
+		{ "ozw_driver_acks", "ACKs received from the controller.", &Driver::DriverData::m_ACKCnt },
+		{ "ozw_driver_naks", "NAKs received from the controller.", &Driver::DriverData::m_NAKCnt },
+		{ "ozw_driver_cans", "CANs received from the controller.", &Driver::DriverData::m_CANCnt },
+		{ "ozw_driver_bad_checksums", "Frames read with a bad checksum.", &Driver::DriverData::m_badChecksum },
+		{ "ozw_driver_read_aborts", "Frames abandoned part way through.", &Driver::DriverData::m_readAborts },
+		{ "ozw_driver_out_of_frame", "Bytes read outside a frame.", &Driver::DriverData::m_OOFCnt },
+		{ "ozw_driver_dropped", "Messages dropped after their retries.", &Driver::DriverData::m_dropped },
+		{ "ozw_driver_retries", "Messages sent again.", &Driver::DriverData::m_retries },
+		{ "ozw_driver_callbacks", "Unexpected callbacks.", &Driver::DriverData::m_callbacks },
+		{ "ozw_driver_bad_routes", "Messages that failed on a bad route.", &Driver::DriverData::m_badroutes },
+		{ "ozw_driver_no_acks", "Messages the node did not acknowledge.", &Driver::DriverData::m_noack },
+		{ "ozw_driver_network_busy", "Messages refused because the network was busy.", &Driver::DriverData::m_netbusy }
+	};
+
+	bool IsScrape(char const* _request)
+	{
+		char const* path;
+		if (strncmp(_request, "GET /metrics", 12) == 0)
+		{
+			path = _request + 12;
+		}
+		else if (strncmp(_request, "GET /", 5) == 0)
+		{
+			path = _request + 5;
+		}
+		else
+		{
+			return false;
+		}
+		return *path == ' ' || *path == '?';
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::Writer>
+//	Formats into the scrape buffer, doubling it only when a scrape does
+//	not fit
+//-----------------------------------------------------------------------------
+class MetricsExporter::Writer
+{
+public:
+	Writer(std::vector<char>* _buffer) : m_buffer(_buffer), m_length(0)
+	{
+		if (m_buffer->size() < c_initialBufferSize)
+		{
+			m_buffer->resize(c_initialBufferSize);
+		}
+	}
+
+	void Append(char const* _format, ...)
+	{
+		for (;;)
+		{
+			size_t room = m_buffer->size() - m_length;
+			va_list args;
+			va_start(args, _format);
+			int written = vsnprintf(&(*m_buffer)[m_length], room, _format, args);
+			va_end(args);
+			if (written < 0)
+			{
+				return;
+			}
+			if ((size_t)written < room)
+			{
+				m_length += written;
+				return;
+			}
+			m_buffer->resize(m_buffer->size() * 2 + written);
+		}
+	}
+
+	uint32 GetLength() const { return (uint32)m_length; }
+
+private:
+	std::vector<char>*	m_buffer;
+	size_t				m_length;
+};
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::Start>
+//	Bind the listening socket and start serving on the thread pool
+//-----------------------------------------------------------------------------
+bool MetricsExporter::Start(uint16 _port, std::wstring const& _socketPath)
+{
+	Stop();
+
+	SOCKET listener = ListenLocal(_port, _socketPath);
+	if (listener == INVALID_SOCKET)
+	{
+		return false;
+	}
+
+	PTP_WORK work = CreateThreadpoolWork(OnWork, (PVOID)listener, NULL);
+	if (work == NULL)
+	{
+		CloseLocalSocket(listener);
+		return false;
+	}
+
+	{
+		LockGuard guard(s_renderLock);
+		if (s_buffer.size() < c_initialBufferSize)
+		{
+			s_buffer.resize(c_initialBufferSize);
+		}
+	}
+
+	{
+		LockGuard guard(s_lock);
+		s_listen = listener;
+		s_work = work;
+		s_socketPath = _socketPath;
+		s_running = true;
+	}
+	SubmitThreadpoolWork(work);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::Stop>
+//	Close the listening socket and wait for the scrape being served
+//-----------------------------------------------------------------------------
+void MetricsExporter::Stop()
+{
+	SOCKET listener;
+	PTP_WORK work;
+	std::wstring path;
+	{
+		LockGuard guard(s_lock);
+		if (!s_running)
+		{
+			return;
+		}
+		s_running = false;
+		listener = s_listen;
+		s_listen = INVALID_SOCKET;
+		work = s_work;
+		s_work = NULL;
+		path.swap(s_socketPath);
+	}
+
+	// Ends the accept the callback is waiting in
+	CloseLocalSocket(listener);
+	WaitForThreadpoolWorkCallbacks(work, FALSE);
+	CloseThreadpoolWork(work);
+	if (!path.empty())
+	{
+		DeleteFileW(path.c_str());
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::OnWork>
+//	Accept and answer scrapes until the listening socket is closed
+//-----------------------------------------------------------------------------
+VOID CALLBACK MetricsExporter::OnWork(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_WORK _work)
+{
+	CallbackMayRunLong(_instance);
+
+	SOCKET listener = (SOCKET)_context;
+	for (;;)
+	{
+		SOCKET client = accept(listener, NULL, NULL);
+		if (client == INVALID_SOCKET)
+		{
+			// A client that gave up before it was accepted is no reason to stop
+			if (s_running && WSAGetLastError() == WSAECONNRESET)
+			{
+				continue;
+			}
+			break;
+		}
+		Serve(client);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::Serve>
+//	Answer one HTTP request and close the connection
+//-----------------------------------------------------------------------------
+void MetricsExporter::Serve(SOCKET _client)
+{
+	// A client that never finishes its request, or never reads the answer,
+	// cannot hold up the next
+	DWORD timeout = c_socketTimeoutMs;
+	setsockopt(_client, SOL_SOCKET, SO_RCVTIMEO, (char const*)&timeout, sizeof(timeout));
+	setsockopt(_client, SOL_SOCKET, SO_SNDTIMEO, (char const*)&timeout, sizeof(timeout));
+
+	char request[c_maxRequestSize];
+	int length = 0;
+	request[0] = 0;
+	while (length < c_maxRequestSize - 1)
+	{
+		int received = recv(_client, request + length, c_maxRequestSize - 1 - length, 0);
+		if (received <= 0)
+		{
+			break;
+		}
+		length += received;
+		request[length] = 0;
+		if (strstr(request, "\r\n\r\n") != NULL)
+		{
+			break;
+		}
+	}
+
+	char header[256];
+	if (IsScrape(request))
+	{
+		uint32 bodyLength = Render(&s_buffer);
+		int headerLength = snprintf(header, sizeof(header),
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+			"Content-Length: %u\r\n"
+			"Connection: close\r\n\r\n", bodyLength);
+		if (SendAll(_client, header, headerLength))
+		{
+			SendAll(_client, &s_buffer[0], (int)bodyLength);
+		}
+	}
+	else
+	{
+		int headerLength = snprintf(header, sizeof(header),
+			"HTTP/1.1 404 Not Found\r\n"
+			"Content-Length: 0\r\n"
+			"Connection: close\r\n\r\n");
+		SendAll(_client, header, headerLength);
+	}
+
+	shutdown(_client, SD_SEND);
+	closesocket(_client);
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::Sample>
+//	Read the statistics of every ready driver and its nodes
+//-----------------------------------------------------------------------------
+void MetricsExporter::Sample()
+{
+	s_drivers.clear();
+	s_nodes.clear();
+
+	{
+		SharedLockGuard guard(s_lock);
+		for (size_t i = 0; i < s_homes.size(); ++i)
+		{
+			DriverSample sample;
+			sample.m_homeId = s_homes[i];
+			s_drivers.push_back(sample);
+		}
+	}
+
+	// OpenZWave is only called outside s_lock, which notifications take
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < s_drivers.size(); ++i)
+	{
+		DriverSample& driver = s_drivers[i];
+		driver.m_queued = manager->GetSendQueueCount(driver.m_homeId);
+		manager->GetDriverStatistics(driver.m_homeId, &driver.m_data);
+
+		// Only the nodes the registry knows, rather than asking OpenZWave
+		// about every possible node ID
+		NodeRegistry::GetNodeIds(driver.m_homeId, &s_nodeIds);
+		for (size_t j = 0; j < s_nodeIds.size(); ++j)
+		{
+			manager->GetNodeStatistics(driver.m_homeId, s_nodeIds[j], &s_nodeData);
+
+			NodeSample node;
+			node.m_homeId = driver.m_homeId;
+			node.m_nodeId = s_nodeIds[j];
+			node.m_sent = s_nodeData.m_sentCnt;
+			node.m_sentFailed = s_nodeData.m_sentFailed;
+			node.m_retries = s_nodeData.m_retries;
+			node.m_received = s_nodeData.m_receivedCnt;
+			node.m_averageRequestRtt = s_nodeData.m_averageRequestRTT;
+			node.m_averageResponseRtt = s_nodeData.m_averageResponseRTT;
+			s_nodes.push_back(node);
+		}
+	}
+
+	// GetCounters would read every node's statistics again, for each driver
+	s_counters.clear();
+	if (TrafficCounters::IsEnabled())
+	{
+		s_homeIds.clear();
+		for (size_t i = 0; i < s_drivers.size(); ++i)
+		{
+			s_homeIds.push_back(s_drivers[i].m_homeId);
+		}
+		TrafficCounters::GetLastCounters(s_homeIds, &s_counters);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::Render>
+//	Write every metric family.  OpenMetrics wants each family's samples
+//	together, so everything is sampled first.
+//-----------------------------------------------------------------------------
+uint32 MetricsExporter::Render(std::vector<char>* io_buffer)
+{
+	LockGuard guard(s_renderLock);
+	LONG64 scrapes = InterlockedIncrement64(&s_scrapes);
+	Sample();
+
+	Writer writer(io_buffer);
+
+	writer.Append("# TYPE ozw_notifications counter\n# HELP ozw_notifications Notifications from OpenZWave while the exporter runs.\n");
+	for (uint32 i = 0; i <= c_notificationTypes; ++i)
+	{
+		writer.Append("ozw_notifications_total{type=\"%s\"} %lld\n", c_notificationNames[i], (long long)s_notifications[i]);
+	}
+
+	writer.Append("# TYPE ozw_send_queue_depth gauge\n# HELP ozw_send_queue_depth Messages waiting to be sent.\n");
+	for (size_t i = 0; i < s_drivers.size(); ++i)
+	{
+		writer.Append("ozw_send_queue_depth{home=\"0x%08x\"} %d\n", s_drivers[i].m_homeId, s_drivers[i].m_queued);
+	}
+
+	for (size_t c = 0; c < sizeof(c_driverCounters) / sizeof(c_driverCounters[0]); ++c)
+	{
+		DriverCounter const& counter = c_driverCounters[c];
+		writer.Append("# TYPE %s counter\n# HELP %s %s\n", counter.m_name, counter.m_name, counter.m_help);
+		for (size_t i = 0; i < s_drivers.size(); ++i)
+		{
+			writer.Append("%s_total{home=\"0x%08x\"} %u\n", counter.m_name, s_drivers[i].m_homeId, s_drivers[i].m_data.*counter.m_field);
+		}
+	}
+
+	writer.Append("# TYPE ozw_node_messages_sent counter\n# HELP ozw_node_messages_sent Messages sent to the node.\n");
+	for (size_t i = 0; i < s_nodes.size(); ++i)
+	{
+		writer.Append("ozw_node_messages_sent_total{home=\"0x%08x\",node=\"%u\"} %u\n", s_nodes[i].m_homeId, s_nodes[i].m_nodeId, s_nodes[i].m_sent);
+	}
+	writer.Append("# TYPE ozw_node_send_failures counter\n# HELP ozw_node_send_failures Messages to the node that failed.\n");
+	for (size_t i = 0; i < s_nodes.size(); ++i)
+	{
+		writer.Append("ozw_node_send_failures_total{home=\"0x%08x\",node=\"%u\"} %u\n", s_nodes[i].m_homeId, s_nodes[i].m_nodeId, s_nodes[i].m_sentFailed);
+	}
+	writer.Append("# TYPE ozw_node_retries counter\n# HELP ozw_node_retries Messages to the node sent again.\n");
+	for (size_t i = 0; i < s_nodes.size(); ++i)
+	{
+		writer.Append("ozw_node_retries_total{home=\"0x%08x\",node=\"%u\"} %u\n", s_nodes[i].m_homeId, s_nodes[i].m_nodeId, s_nodes[i].m_retries);
+	}
+	writer.Append("# TYPE ozw_node_messages_received counter\n# HELP ozw_node_messages_received Messages received from the node.\n");
+	for (size_t i = 0; i < s_nodes.size(); ++i)
+	{
+		writer.Append("ozw_node_messages_received_total{home=\"0x%08x\",node=\"%u\"} %u\n", s_nodes[i].m_homeId, s_nodes[i].m_nodeId, s_nodes[i].m_received);
+	}
+	writer.Append("# TYPE ozw_node_request_rtt_seconds gauge\n# UNIT ozw_node_request_rtt_seconds seconds\n# HELP ozw_node_request_rtt_seconds Average time for the node to acknowledge a request.\n");
+	for (size_t i = 0; i < s_nodes.size(); ++i)
+	{
+		writer.Append("ozw_node_request_rtt_seconds{home=\"0x%08x\",node=\"%u\"} %.3f\n", s_nodes[i].m_homeId, s_nodes[i].m_nodeId, s_nodes[i].m_averageRequestRtt / 1000.0);
+	}
+	writer.Append("# TYPE ozw_node_response_rtt_seconds gauge\n# UNIT ozw_node_response_rtt_seconds seconds\n# HELP ozw_node_response_rtt_seconds Average time for the node to answer a request.\n");
+	for (size_t i = 0; i < s_nodes.size(); ++i)
+	{
+		writer.Append("ozw_node_response_rtt_seconds{home=\"0x%08x\",node=\"%u\"} %.3f\n", s_nodes[i].m_homeId, s_nodes[i].m_nodeId, s_nodes[i].m_averageResponseRtt / 1000.0);
+	}
+
+	LogSinkStats logStats;
+	LogSink::GetStats(&logStats);
+	writer.Append("# TYPE ozw_log_records counter\n# HELP ozw_log_records Log records put in the sink's ring.\nozw_log_records_total %llu\n", (unsigned long long)logStats.m_written);
+	writer.Append("# TYPE ozw_log_dropped counter\n# HELP ozw_log_dropped Log records lost because the ring was full.\nozw_log_dropped_total %llu\n", (unsigned long long)logStats.m_dropped);
+	writer.Append("# TYPE ozw_log_pending gauge\n# HELP ozw_log_pending Log records waiting in the ring.\nozw_log_pending %u\n", logStats.m_pending);
+
+	FrameCaptureStats captureStats;
+	FrameCapture::GetStats(&captureStats);
+	writer.Append("# TYPE ozw_capture_frames counter\n# HELP ozw_capture_frames Frames captured.\nozw_capture_frames_total %llu\n", (unsigned long long)captureStats.m_frames);
+	writer.Append("# TYPE ozw_capture_dropped counter\n# HELP ozw_capture_dropped Frames lost because the disk fell behind.\nozw_capture_dropped_total %llu\n", (unsigned long long)captureStats.m_dropped);
+
+	if (!s_counters.empty())
+	{
+		WriteHistograms(writer, "ozw_transmit_latency_seconds", "Time from SendData to its callback.", false);
+		WriteHistograms(writer, "ozw_response_latency_seconds", "Time from SendData to the node's answer.", true);
+	}
+
+	writer.Append("# TYPE ozw_metrics_scrapes counter\n# HELP ozw_metrics_scrapes Scrapes rendered, this one included.\nozw_metrics_scrapes_total %lld\n", (long long)scrapes);
+	writer.Append("# EOF\n");
+	return writer.GetLength();
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::WriteHistograms>
+//	Write one family of TrafficCounters histograms, skipping those that
+//	timed nothing
+//-----------------------------------------------------------------------------
+void MetricsExporter::WriteHistograms(Writer& _writer, char const* _name, char const* _help, bool _response)
+{
+	_writer.Append("# TYPE %s histogram\n# UNIT %s seconds\n# HELP %s %s\n", _name, _name, _name, _help);
+	for (size_t i = 0; i < s_counters.size(); ++i)
+	{
+		TrafficCounter const& counter = s_counters[i];
+		LatencyHistogram const& histogram = _response ? counter.m_response : counter.m_transmit;
+		if (histogram.m_count == 0)
+		{
+			continue;
+		}
+
+		// OpenMetrics buckets count everything up to their bound
+		uint32 cumulative = 0;
+		for (uint32 b = 0; b < c_latencyBucketCount - 1; ++b)
+		{
+			cumulative += histogram.m_buckets[b];
+			_writer.Append("%s_bucket{home=\"0x%08x\",node=\"%u\",cc=\"0x%02x\",le=\"%g\"} %u\n", _name, counter.m_homeId, counter.m_nodeId, counter.m_commandClassId, TrafficCounters::c_latencyBounds[b] / 1000.0, cumulative);
+		}
+		_writer.Append("%s_bucket{home=\"0x%08x\",node=\"%u\",cc=\"0x%02x\",le=\"+Inf\"} %u\n", _name, counter.m_homeId, counter.m_nodeId, counter.m_commandClassId, histogram.m_count);
+		_writer.Append("%s_count{home=\"0x%08x\",node=\"%u\",cc=\"0x%02x\"} %u\n", _name, counter.m_homeId, counter.m_nodeId, counter.m_commandClassId, histogram.m_count);
+		_writer.Append("%s_sum{home=\"0x%08x\",node=\"%u\",cc=\"0x%02x\"} %.3f\n", _name, counter.m_homeId, counter.m_nodeId, counter.m_commandClassId, histogram.m_totalMs / 1000.0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<MetricsExporter::OnNotification>
+//	Track ready drivers, and count notifications while running
+//-----------------------------------------------------------------------------
+void MetricsExporter::OnNotification(Notification const* _notification)
+{
+	Notification::NotificationType type = _notification->GetType();
+	if (s_running)
+	{
+		uint32 index = ((uint32)type < c_notificationTypes) ? (uint32)type : c_notificationTypes;
+		InterlockedIncrement64(&s_notifications[index]);
+	}
+
+	if (type == Notification::Type_DriverReady)
+	{
+		uint32 homeId = _notification->GetHomeId();
+		LockGuard guard(s_lock);
+		if (std::find(s_homes.begin(), s_homes.end(), homeId) == s_homes.end())
+		{
+			s_homes.push_back(homeId);
+		}
+	}
+	else if (type == Notification::Type_DriverRemoved || type == Notification::Type_DriverFailed)
+	{
+		uint32 homeId = _notification->GetHomeId();
+		LockGuard guard(s_lock);
+		s_homes.erase(std::remove(s_homes.begin(), s_homes.end(), homeId), s_homes.end());
+	}
+}
@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+//
+//      MetricsExporter.h
+//
+//      Serves wrapper and driver metrics in the OpenMetrics text format
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Lock.h"
+#include "TrafficCounters.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// An HTTP endpoint for Prometheus style scrapes, on a loopback port or
+		// a Unix domain socket.  One thread pool callback accepts and answers
+		// the scrapes one at a time, rendering into buffers kept between
+		// scrapes.  A scrape is not free: for each ready driver it calls
+		// GetNodeStatistics for each node NodeRegistry knows, and each call
+		// fills a list of command class counts, so it allocates.  The
+		// TrafficCounters histograms are taken as of their timer's last read,
+		// which adds no Manager calls.
+		//
+		// The metrics are notifications by type, the send queue and driver
+		// counters of each ready driver, the message counts and round trips of
+		// each node, the log sink and frame capture counters, and, while
+		// TrafficCounters is enabled, its round trip histograms.
+		class MetricsExporter
+		{
+		public:
+			static uint32 const c_notificationTypes = 32;
+
+			// Listens on 127.0.0.1 at the port, or on the Unix domain socket at
+			// the path if it is not empty.  Stops an exporter already running.
+			static bool Start(uint16 _port, std::wstring const& _socketPath);
+			static void Stop();
+			static bool IsRunning() { return s_running; }
+
+			// Write a scrape into a buffer, growing it if needed, and return
+			// the length of the text
+			static uint32 Render(std::vector<char>* io_buffer);
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			class Writer;
+
+			struct DriverSample
+			{
+				uint32				m_homeId;
+				int32				m_queued;
+				Driver::DriverData	m_data;
+			};
+
+			struct NodeSample
+			{
+				uint32	m_homeId;
+				uint8	m_nodeId;
+				uint32	m_sent;
+				uint32	m_sentFailed;
+				uint32	m_retries;
+				uint32	m_received;
+				uint32	m_averageRequestRtt;
+				uint32	m_averageResponseRtt;
+			};
+
+			static VOID CALLBACK OnWork(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_WORK _work);
+			static void Serve(SOCKET _client);
+			static void Sample();
+			static void WriteHistograms(Writer& _writer, char const* _name, char const* _help, bool _response);
+
+			static volatile bool		s_running;
+			static volatile LONG64		s_notifications[c_notificationTypes + 1];	// The last counts types this wrapper does not know
+			static volatile LONG64		s_scrapes;
+
+			// Under s_lock
+			static Lock					s_lock;
+			static std::vector<uint32>	s_homes;				// Ready drivers
+			static SOCKET				s_listen;
+			static PTP_WORK				s_work;
+			static std::wstring			s_socketPath;
+
+			// Under s_renderLock, and kept between scrapes so their storage is reused
+			static Lock							s_renderLock;
+			static std::vector<DriverSample>	s_drivers;
+			static std::vector<NodeSample>		s_nodes;
+			static std::vector<uint32>			s_homeIds;
+			static std::vector<uint8>			s_nodeIds;
+			static std::vector<TrafficCounter>	s_counters;
+			static Node::NodeData				s_nodeData;
+
+			// Used only by the serving callback
+			static std::vector<char>	s_buffer;
+		};
+	}
+}
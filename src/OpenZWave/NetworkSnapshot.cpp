@@ -0,0 +1,782 @@
+//-----------------------------------------------------------------------------
+//
+//      NetworkSnapshot.cpp
+//
+//      Saves the nodes and values of a network for a fast warm start
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <cstddef>
+#include "FileMapping.h"
+#include "NetworkSnapshot.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock NetworkSnapshot::s_lock;
+Lock NetworkSnapshot::s_saveLock;
+NetworkSnapshot::NetworkMap NetworkSnapshot::s_networks;
+NetworkSnapshot::AutoSaveMap NetworkSnapshot::s_autoSaves;
+std::vector<NetworkSnapshot*> NetworkSnapshot::s_snapshots;
+
+namespace
+{
+	uint32 const c_snapshotMagic = 0x534E5A4F;		// "OZNS"
+	uint32 const c_snapshotVersion = 1;
+
+	struct SnapshotHeader
+	{
+		uint32	m_magic;
+		uint32	m_version;
+		uint32	m_homeId;
+		uint32	m_nodeCount;
+		uint32	m_valueCount;
+		uint32	m_reserved;
+		int64	m_savedAt;
+		uint64	m_stringsSize;
+	};
+
+	// A string in the table, which follows the value records
+	struct StringRef
+	{
+		uint32	m_offset;
+		uint32	m_length;
+	};
+
+	enum
+	{
+		NodeString_Type = 0,
+		NodeString_ManufacturerName,
+		NodeString_ProductName,
+		NodeString_Name,
+		NodeString_Location,
+		NodeString_ManufacturerId,
+		NodeString_ProductType,
+		NodeString_ProductId,
+		NodeString_Count
+	};
+
+	enum
+	{
+		ValueString_Label = 0,
+		ValueString_Units,
+		ValueString_Help,
+		ValueString_Value,
+		ValueString_Count
+	};
+
+	struct NodeRecord
+	{
+		uint8		m_nodeId;
+		uint8		m_basic;
+		uint8		m_generic;
+		uint8		m_specific;
+		uint8		m_version;
+		uint8		m_security;
+		uint8		m_flags;
+		uint8		m_reserved;
+		uint32		m_maxBaudRate;
+		StringRef	m_strings[NodeString_Count];
+	};
+
+	struct ValueRecord
+	{
+		uint64		m_valueId;
+		uint8		m_nodeId;
+		uint8		m_genre;
+		uint8		m_commandClassId;
+		uint8		m_instance;
+		uint16		m_index;
+		uint8		m_type;
+		uint8		m_flags;
+		StringRef	m_strings[ValueString_Count];
+	};
+
+	// Builds the string table, storing each distinct string once
+	class StringTable
+	{
+	public:
+		StringRef Add(std::string const& _value)
+		{
+			std::map<std::string, StringRef>::const_iterator it = m_refs.find(_value);
+			if (it != m_refs.end())
+			{
+				return it->second;
+			}
+
+			StringRef ref;
+			ref.m_offset = (uint32)m_bytes.size();
+			ref.m_length = (uint32)_value.size();
+			m_bytes.insert(m_bytes.end(), _value.begin(), _value.end());
+			m_refs[_value] = ref;
+			return ref;
+		}
+
+		std::vector<uint8> const& GetBytes() const { return m_bytes; }
+
+	private:
+		std::vector<uint8>					m_bytes;
+		std::map<std::string, StringRef>	m_refs;
+	};
+
+	template <typename T>
+	void Append(std::vector<uint8>* io_bytes, T const& _item)
+	{
+		uint8 const* bytes = (uint8 const*)&_item;
+		io_bytes->insert(io_bytes->end(), bytes, bytes + sizeof(T));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::Save>
+//	Read a network from the Manager and write it to a snapshot file
+//-----------------------------------------------------------------------------
+bool NetworkSnapshot::Save(uint32 _homeId, std::wstring const& _path)
+{
+	std::vector<uint8> nodeIds;
+	std::vector<uint64> valueIds;
+	if (!GetNetwork(_homeId, &nodeIds, &valueIds))
+	{
+		return false;
+	}
+
+	// The Manager is only called with no lock held
+	StringTable strings;
+	std::vector<uint8> records;
+	records.reserve(sizeof(SnapshotHeader) + nodeIds.size() * sizeof(NodeRecord) + valueIds.size() * sizeof(ValueRecord));
+	records.resize(sizeof(SnapshotHeader));
+
+	SnapshotNode current;
+	for (size_t i = 0; i < nodeIds.size(); ++i)
+	{
+		ReadNode(_homeId, nodeIds[i], &current);
+		NodeRecord node;
+		memset(&node, 0, sizeof(node));
+		node.m_nodeId = current.m_nodeId;
+		node.m_basic = current.m_basic;
+		node.m_generic = current.m_generic;
+		node.m_specific = current.m_specific;
+		node.m_version = current.m_version;
+		node.m_security = current.m_security;
+		node.m_maxBaudRate = current.m_maxBaudRate;
+		node.m_flags = current.m_flags;
+		node.m_strings[NodeString_Type] = strings.Add(current.m_type);
+		node.m_strings[NodeString_ManufacturerName] = strings.Add(current.m_manufacturerName);
+		node.m_strings[NodeString_ProductName] = strings.Add(current.m_productName);
+		node.m_strings[NodeString_Name] = strings.Add(current.m_name);
+		node.m_strings[NodeString_Location] = strings.Add(current.m_location);
+		node.m_strings[NodeString_ManufacturerId] = strings.Add(current.m_manufacturerId);
+		node.m_strings[NodeString_ProductType] = strings.Add(current.m_productType);
+		node.m_strings[NodeString_ProductId] = strings.Add(current.m_productId);
+		Append(&records, node);
+	}
+
+	SnapshotValue currentValue;
+	for (size_t i = 0; i < valueIds.size(); ++i)
+	{
+		ReadValue(_homeId, valueIds[i], &currentValue);
+		ValueRecord value;
+		memset(&value, 0, sizeof(value));
+		value.m_valueId = currentValue.m_valueId;
+		value.m_nodeId = currentValue.m_nodeId;
+		value.m_genre = currentValue.m_genre;
+		value.m_commandClassId = currentValue.m_commandClassId;
+		value.m_instance = currentValue.m_instance;
+		value.m_index = currentValue.m_index;
+		value.m_type = currentValue.m_type;
+		value.m_flags = currentValue.m_flags;
+		value.m_strings[ValueString_Label] = strings.Add(currentValue.m_label);
+		value.m_strings[ValueString_Units] = strings.Add(currentValue.m_units);
+		value.m_strings[ValueString_Help] = strings.Add(currentValue.m_help);
+		value.m_strings[ValueString_Value] = strings.Add(currentValue.m_value);
+		Append(&records, value);
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	header.m_magic = c_snapshotMagic;
+	header.m_version = c_snapshotVersion;
+	header.m_homeId = _homeId;
+	header.m_nodeCount = (uint32)nodeIds.size();
+	header.m_valueCount = (uint32)valueIds.size();
+	header.m_savedAt = ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime;
+	header.m_stringsSize = strings.GetBytes().size();
+	memcpy(&records[0], &header, sizeof(header));
+	records.insert(records.end(), strings.GetBytes().begin(), strings.GetBytes().end());
+
+	// Write a temporary file and move it over the old one, so that a crash
+	// while saving leaves the previous snapshot in place
+	LockGuard guard(s_saveLock);
+	std::wstring temporary = _path + L".tmp";
+	HANDLE file = OpenFileHandle(temporary, GENERIC_WRITE, 0, CREATE_ALWAYS);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	DWORD written = 0;
+	bool saved = WriteFile(file, &records[0], (DWORD)records.size(), &written, NULL) && written == records.size() && FlushFileBuffers(file);
+	CloseHandle(file);
+	if (!saved || !MoveFileExW(temporary.c_str(), _path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFileW(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::SetAutoSave>
+//	Start, change or stop saving a network periodically
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::SetAutoSave(uint32 _homeId, std::wstring const& _path, uint32 _intervalMs)
+{
+	PTP_TIMER stopped = NULL;
+	{
+		LockGuard guard(s_lock);
+		AutoSaveMap::iterator it = s_autoSaves.find(_homeId);
+		if (_intervalMs == 0)
+		{
+			if (it != s_autoSaves.end())
+			{
+				stopped = it->second.m_timer;
+				s_autoSaves.erase(it);
+			}
+		}
+		else
+		{
+			if (it == s_autoSaves.end())
+			{
+				it = s_autoSaves.insert(AutoSaveMap::value_type(_homeId, AutoSave())).first;
+				it->second.m_timer = CreateThreadpoolTimer(OnTimer, (PVOID)(uintptr_t)_homeId, NULL);
+			}
+			it->second.m_path = _path;
+
+			if (it->second.m_timer != NULL)
+			{
+				// Negative due times are relative, in 100ns units
+				ULARGE_INTEGER due;
+				due.QuadPart = (ULONGLONG)(-((LONGLONG)_intervalMs * 10000));
+				FILETIME dueTime;
+				dueTime.dwLowDateTime = due.LowPart;
+				dueTime.dwHighDateTime = due.HighPart;
+				SetThreadpoolTimer(it->second.m_timer, &dueTime, _intervalMs, 0);
+			}
+		}
+	}
+
+	// The callback takes s_lock, so wait for it outside
+	if (stopped != NULL)
+	{
+		SetThreadpoolTimer(stopped, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(stopped, TRUE);
+		CloseThreadpoolTimer(stopped);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::Shutdown>
+//	Save every network that has auto save one last time
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::Shutdown()
+{
+	AutoSaveMap autoSaves;
+	{
+		LockGuard guard(s_lock);
+		autoSaves.swap(s_autoSaves);
+	}
+
+	for (AutoSaveMap::iterator it = autoSaves.begin(); it != autoSaves.end(); ++it)
+	{
+		if (it->second.m_timer != NULL)
+		{
+			SetThreadpoolTimer(it->second.m_timer, NULL, 0, 0);
+			WaitForThreadpoolTimerCallbacks(it->second.m_timer, TRUE);
+			CloseThreadpoolTimer(it->second.m_timer);
+		}
+		Save(it->first, it->second.m_path);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::GetNetwork>
+//	Copy the node and value IDs of a network
+//-----------------------------------------------------------------------------
+bool NetworkSnapshot::GetNetwork(uint32 _homeId, std::vector<uint8>* o_nodeIds, std::vector<uint64>* o_valueIds)
+{
+	LockGuard guard(s_lock);
+	NetworkMap::const_iterator it = s_networks.find(_homeId);
+	if (it == s_networks.end())
+	{
+		o_nodeIds->clear();
+		o_valueIds->clear();
+		return false;
+	}
+	o_nodeIds->assign(it->second.m_nodes.begin(), it->second.m_nodes.end());
+	o_valueIds->assign(it->second.m_values.begin(), it->second.m_values.end());
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::ReadNode>
+//	Read a node's attributes from the Manager
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::ReadNode(uint32 _homeId, uint8 _nodeId, SnapshotNode* o_node)
+{
+	Manager* manager = Manager::Get();
+	o_node->m_nodeId = _nodeId;
+	o_node->m_basic = manager->GetNodeBasic(_homeId, _nodeId);
+	o_node->m_generic = manager->GetNodeGeneric(_homeId, _nodeId);
+	o_node->m_specific = manager->GetNodeSpecific(_homeId, _nodeId);
+	o_node->m_version = manager->GetNodeVersion(_homeId, _nodeId);
+	o_node->m_security = manager->GetNodeSecurity(_homeId, _nodeId);
+	o_node->m_maxBaudRate = manager->GetNodeMaxBaudRate(_homeId, _nodeId);
+	o_node->m_flags = (manager->IsNodeListeningDevice(_homeId, _nodeId) ? SnapshotNodeFlag_Listening : 0)
+		| (manager->IsNodeFrequentListeningDevice(_homeId, _nodeId) ? SnapshotNodeFlag_FrequentListening : 0)
+		| (manager->IsNodeBeamingDevice(_homeId, _nodeId) ? SnapshotNodeFlag_Beaming : 0)
+		| (manager->IsNodeRoutingDevice(_homeId, _nodeId) ? SnapshotNodeFlag_Routing : 0)
+		| (manager->IsNodeSecurityDevice(_homeId, _nodeId) ? SnapshotNodeFlag_Security : 0)
+		| (manager->IsNodeZWavePlus(_homeId, _nodeId) ? SnapshotNodeFlag_ZWavePlus : 0);
+	o_node->m_type = manager->GetNodeType(_homeId, _nodeId);
+	o_node->m_manufacturerName = manager->GetNodeManufacturerName(_homeId, _nodeId);
+	o_node->m_productName = manager->GetNodeProductName(_homeId, _nodeId);
+	o_node->m_name = manager->GetNodeName(_homeId, _nodeId);
+	o_node->m_location = manager->GetNodeLocation(_homeId, _nodeId);
+	o_node->m_manufacturerId = manager->GetNodeManufacturerId(_homeId, _nodeId);
+	o_node->m_productType = manager->GetNodeProductType(_homeId, _nodeId);
+	o_node->m_productId = manager->GetNodeProductId(_homeId, _nodeId);
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::ReadValue>
+//	Read a value, with its metadata, from the Manager
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::ReadValue(uint32 _homeId, uint64 _valueId, SnapshotValue* o_value)
+{
+	Manager* manager = Manager::Get();
+	ValueID valueId(_homeId, _valueId);
+	o_value->m_valueId = _valueId;
+	o_value->m_nodeId = valueId.GetNodeId();
+	o_value->m_genre = (uint8)valueId.GetGenre();
+	o_value->m_commandClassId = valueId.GetCommandClassId();
+	o_value->m_instance = valueId.GetInstance();
+	o_value->m_index = valueId.GetIndex();
+	o_value->m_type = (uint8)valueId.GetType();
+	o_value->m_flags = (manager->IsValueReadOnly(valueId) ? SnapshotValueFlag_ReadOnly : 0)
+		| (manager->IsValueSet(valueId) ? SnapshotValueFlag_Set : 0)
+		| (manager->IsValuePolled(valueId) ? SnapshotValueFlag_Polled : 0);
+	o_value->m_label = manager->GetValueLabel(valueId);
+	o_value->m_units = manager->GetValueUnits(valueId);
+	o_value->m_help = manager->GetValueHelp(valueId);
+	o_value->m_value.clear();
+	manager->GetValueAsString(valueId, &o_value->m_value);
+	o_value->m_state = SnapshotValueState_Current;
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::Load>
+//	Map a snapshot file and check its layout
+//-----------------------------------------------------------------------------
+NetworkSnapshot* NetworkSnapshot::Load(std::wstring const& _path)
+{
+	HANDLE file = OpenFileHandle(_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, OPEN_EXISTING);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+
+	NetworkSnapshot* snapshot = new NetworkSnapshot();
+	snapshot->m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || (uint64)size.QuadPart < sizeof(SnapshotHeader))
+	{
+		delete snapshot;
+		return NULL;
+	}
+	snapshot->m_size = (uint64)size.QuadPart;
+	snapshot->m_data = MapFileReadOnly(file, &snapshot->m_mapping);
+	if (snapshot->m_data == NULL)
+	{
+		delete snapshot;
+		return NULL;
+	}
+
+	SnapshotHeader header;
+	memcpy(&header, snapshot->m_data, sizeof(header));
+	if (header.m_magic != c_snapshotMagic || header.m_version != c_snapshotVersion)
+	{
+		delete snapshot;
+		return NULL;
+	}
+
+	// Each section must fit in what is left of the file.  Adding the sizes
+	// first would let a large m_stringsSize wrap the sum around.
+	uint64 remaining = snapshot->m_size - sizeof(header);
+	uint64 nodesSize = (uint64)header.m_nodeCount * sizeof(NodeRecord);
+	uint64 valuesSize = (uint64)header.m_valueCount * sizeof(ValueRecord);
+	if (nodesSize > remaining || valuesSize > remaining - nodesSize
+		|| header.m_stringsSize != remaining - nodesSize - valuesSize)
+	{
+		delete snapshot;
+		return NULL;
+	}
+
+	snapshot->m_homeId = header.m_homeId;
+	snapshot->m_savedAt = header.m_savedAt;
+	snapshot->m_nodeCount = header.m_nodeCount;
+	snapshot->m_valueCount = header.m_valueCount;
+	snapshot->m_nodes = snapshot->m_data + sizeof(header);
+	snapshot->m_values = snapshot->m_nodes + nodesSize;
+	snapshot->m_strings = snapshot->m_values + valuesSize;
+	snapshot->m_stringsSize = header.m_stringsSize;
+	snapshot->m_states.resize(header.m_valueCount, SnapshotValueState_Stale);
+
+	LockGuard guard(s_lock);
+	s_snapshots.push_back(snapshot);
+	return snapshot;
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::NetworkSnapshot>
+//	Constructor
+//-----------------------------------------------------------------------------
+NetworkSnapshot::NetworkSnapshot() :
+	m_file(INVALID_HANDLE_VALUE),
+	m_mapping(NULL),
+	m_data(NULL),
+	m_size(0),
+	m_homeId(0),
+	m_savedAt(0),
+	m_nodeCount(0),
+	m_valueCount(0),
+	m_nodes(NULL),
+	m_values(NULL),
+	m_strings(NULL),
+	m_stringsSize(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::~NetworkSnapshot>
+//	Destructor.  Unmaps the file.
+//-----------------------------------------------------------------------------
+NetworkSnapshot::~NetworkSnapshot()
+{
+	{
+		LockGuard guard(s_lock);
+		s_snapshots.erase(std::remove(s_snapshots.begin(), s_snapshots.end(), this), s_snapshots.end());
+	}
+
+	if (m_data != NULL)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping != NULL)
+	{
+		CloseHandle(m_mapping);
+	}
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::GetNode>
+//	Read a node record
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::GetNode(uint32 _index, SnapshotNode* o_node)
+{
+	NodeRecord node;
+	memcpy(&node, m_nodes + (uint64)_index * sizeof(node), sizeof(node));
+	o_node->m_nodeId = node.m_nodeId;
+	o_node->m_basic = node.m_basic;
+	o_node->m_generic = node.m_generic;
+	o_node->m_specific = node.m_specific;
+	o_node->m_version = node.m_version;
+	o_node->m_security = node.m_security;
+	o_node->m_flags = node.m_flags;
+	o_node->m_maxBaudRate = node.m_maxBaudRate;
+	o_node->m_type = GetString(node.m_strings[NodeString_Type].m_offset, node.m_strings[NodeString_Type].m_length);
+	o_node->m_manufacturerName = GetString(node.m_strings[NodeString_ManufacturerName].m_offset, node.m_strings[NodeString_ManufacturerName].m_length);
+	o_node->m_productName = GetString(node.m_strings[NodeString_ProductName].m_offset, node.m_strings[NodeString_ProductName].m_length);
+	o_node->m_name = GetString(node.m_strings[NodeString_Name].m_offset, node.m_strings[NodeString_Name].m_length);
+	o_node->m_location = GetString(node.m_strings[NodeString_Location].m_offset, node.m_strings[NodeString_Location].m_length);
+	o_node->m_manufacturerId = GetString(node.m_strings[NodeString_ManufacturerId].m_offset, node.m_strings[NodeString_ManufacturerId].m_length);
+	o_node->m_productType = GetString(node.m_strings[NodeString_ProductType].m_offset, node.m_strings[NodeString_ProductType].m_length);
+	o_node->m_productId = GetString(node.m_strings[NodeString_ProductId].m_offset, node.m_strings[NodeString_ProductId].m_length);
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::GetValue>
+//	Read a value record and its state
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::GetValue(uint32 _index, SnapshotValue* o_value)
+{
+	ValueRecord value;
+	memcpy(&value, m_values + (uint64)_index * sizeof(value), sizeof(value));
+	o_value->m_valueId = value.m_valueId;
+	o_value->m_nodeId = value.m_nodeId;
+	o_value->m_genre = value.m_genre;
+	o_value->m_commandClassId = value.m_commandClassId;
+	o_value->m_instance = value.m_instance;
+	o_value->m_index = value.m_index;
+	o_value->m_type = value.m_type;
+	o_value->m_flags = value.m_flags;
+	o_value->m_label = GetString(value.m_strings[ValueString_Label].m_offset, value.m_strings[ValueString_Label].m_length);
+	o_value->m_units = GetString(value.m_strings[ValueString_Units].m_offset, value.m_strings[ValueString_Units].m_length);
+	o_value->m_help = GetString(value.m_strings[ValueString_Help].m_offset, value.m_strings[ValueString_Help].m_length);
+	o_value->m_value = GetString(value.m_strings[ValueString_Value].m_offset, value.m_strings[ValueString_Value].m_length);
+
+	LockGuard guard(m_lock);
+	o_value->m_state = m_states[_index];
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::GetState>
+//	Whether a value has been reported since the snapshot was loaded
+//-----------------------------------------------------------------------------
+SnapshotValueState NetworkSnapshot::GetState(uint64 _valueId)
+{
+	int32 index = Find(_valueId);
+	if (index < 0)
+	{
+		return SnapshotValueState_Removed;
+	}
+
+	LockGuard guard(m_lock);
+	return (SnapshotValueState)m_states[index];
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::GetStaleCount>
+//	Number of values not reported since the snapshot was loaded
+//-----------------------------------------------------------------------------
+uint32 NetworkSnapshot::GetStaleCount()
+{
+	LockGuard guard(m_lock);
+	return (uint32)std::count(m_states.begin(), m_states.end(), (uint8)SnapshotValueState_Stale);
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::OnNotification>
+//	Follow the nodes and values of every network, and reconcile the loaded
+//	snapshots
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::OnNotification(Notification const* _notification)
+{
+	Track(_notification);
+
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < s_snapshots.size(); ++i)
+	{
+		if (s_snapshots[i]->m_homeId == _notification->GetHomeId())
+		{
+			s_snapshots[i]->Reconcile(_notification);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::OnTimer>
+//	Thread pool callback for auto save
+//-----------------------------------------------------------------------------
+VOID CALLBACK NetworkSnapshot::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	uint32 homeId = (uint32)(uintptr_t)_context;
+	std::wstring path;
+	{
+		LockGuard guard(s_lock);
+		AutoSaveMap::const_iterator it = s_autoSaves.find(homeId);
+		if (it == s_autoSaves.end())
+		{
+			return;
+		}
+		path = it->second.m_path;
+	}
+	Save(homeId, path);
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::Track>
+//	Keep the node and value IDs of every network
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::Track(Notification const* _notification)
+{
+	uint32 homeId = _notification->GetHomeId();
+	switch (_notification->GetType())
+	{
+	case Notification::Type_NodeNew:
+	case Notification::Type_NodeAdded:
+	{
+		LockGuard guard(s_lock);
+		s_networks[homeId].m_nodes.insert(_notification->GetNodeId());
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		LockGuard guard(s_lock);
+		NetworkMap::iterator it = s_networks.find(homeId);
+		if (it != s_networks.end())
+		{
+			uint8 nodeId = _notification->GetNodeId();
+			it->second.m_nodes.erase(nodeId);
+			for (std::set<uint64>::iterator value = it->second.m_values.begin(); value != it->second.m_values.end(); )
+			{
+				if (ValueID(homeId, *value).GetNodeId() == nodeId)
+				{
+					it->second.m_values.erase(value++);
+				}
+				else
+				{
+					++value;
+				}
+			}
+		}
+		break;
+	}
+	case Notification::Type_ValueAdded:
+	{
+		LockGuard guard(s_lock);
+		s_networks[homeId].m_values.insert(_notification->GetValueID().GetId());
+		break;
+	}
+	case Notification::Type_ValueRemoved:
+	{
+		LockGuard guard(s_lock);
+		NetworkMap::iterator it = s_networks.find(homeId);
+		if (it != s_networks.end())
+		{
+			it->second.m_values.erase(_notification->GetValueID().GetId());
+		}
+		break;
+	}
+	case Notification::Type_DriverReset:
+	case Notification::Type_DriverRemoved:
+	{
+		LockGuard guard(s_lock);
+		s_networks.erase(homeId);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::Reconcile>
+//	Mark the values that the network has reported or removed
+//-----------------------------------------------------------------------------
+void NetworkSnapshot::Reconcile(Notification const* _notification)
+{
+	switch (_notification->GetType())
+	{
+	case Notification::Type_ValueAdded:
+	{
+		// OpenZWave adds values from its own cache before the node is
+		// queried, so an added value is no fresher than the snapshot.  One
+		// that was removed exists again, but is still unconfirmed.
+		int32 index = Find(_notification->GetValueID().GetId());
+		if (index >= 0)
+		{
+			LockGuard guard(m_lock);
+			if (m_states[index] == SnapshotValueState_Removed)
+			{
+				m_states[index] = SnapshotValueState_Stale;
+			}
+		}
+		break;
+	}
+	case Notification::Type_ValueChanged:
+	case Notification::Type_ValueRefreshed:
+	case Notification::Type_ValueRemoved:
+	{
+		int32 index = Find(_notification->GetValueID().GetId());
+		if (index >= 0)
+		{
+			LockGuard guard(m_lock);
+			m_states[index] = (_notification->GetType() == Notification::Type_ValueRemoved) ? SnapshotValueState_Removed : SnapshotValueState_Current;
+		}
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		uint8 nodeId = _notification->GetNodeId();
+		LockGuard guard(m_lock);
+		for (uint32 i = 0; i < m_valueCount; ++i)
+		{
+			if (m_values[(uint64)i * sizeof(ValueRecord) + offsetof(ValueRecord, m_nodeId)] == nodeId)
+			{
+				m_states[i] = SnapshotValueState_Removed;
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::Find>
+//	Binary search of the value records, which are sorted by ID
+//-----------------------------------------------------------------------------
+int32 NetworkSnapshot::Find(uint64 _valueId) const
+{
+	uint32 lo = 0;
+	uint32 hi = m_valueCount;
+	while (lo < hi)
+	{
+		uint32 mid = lo + (hi - lo) / 2;
+		uint64 valueId;
+		memcpy(&valueId, m_values + (uint64)mid * sizeof(ValueRecord) + offsetof(ValueRecord, m_valueId), sizeof(valueId));
+		if (valueId < _valueId)
+		{
+			lo = mid + 1;
+		}
+		else if (valueId > _valueId)
+		{
+			hi = mid;
+		}
+		else
+		{
+			return (int32)mid;
+		}
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+//	<NetworkSnapshot::GetString>
+//	A string from the table, or an empty one if it is out of bounds
+//-----------------------------------------------------------------------------
+std::string NetworkSnapshot::GetString(uint32 _offset, uint32 _length) const
+{
+	if ((uint64)_offset + _length > m_stringsSize)
+	{
+		return std::string();
+	}
+	return std::string((char const*)m_strings + _offset, _length);
+}
@@ -0,0 +1,197 @@
+//-----------------------------------------------------------------------------
+//
+//      NetworkSnapshot.h
+//
+//      Saves the nodes and values of a network for a fast warm start
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		enum SnapshotNodeFlag
+		{
+			SnapshotNodeFlag_Listening			= 0x01,
+			SnapshotNodeFlag_FrequentListening	= 0x02,
+			SnapshotNodeFlag_Beaming			= 0x04,
+			SnapshotNodeFlag_Routing			= 0x08,
+			SnapshotNodeFlag_Security			= 0x10,
+			SnapshotNodeFlag_ZWavePlus			= 0x20
+		};
+
+		enum SnapshotValueFlag
+		{
+			SnapshotValueFlag_ReadOnly			= 0x01,
+			SnapshotValueFlag_Set				= 0x02,
+			SnapshotValueFlag_Polled			= 0x04
+		};
+
+		enum SnapshotValueState
+		{
+			SnapshotValueState_Stale = 0,		// Not reported since the snapshot was loaded
+			SnapshotValueState_Current,
+			SnapshotValueState_Removed
+		};
+
+		struct SnapshotNode
+		{
+			uint8		m_nodeId;
+			uint8		m_basic;
+			uint8		m_generic;
+			uint8		m_specific;
+			uint8		m_version;
+			uint8		m_security;
+			uint8		m_flags;				// SnapshotNodeFlag
+			uint32		m_maxBaudRate;
+			std::string	m_type;
+			std::string	m_manufacturerName;
+			std::string	m_productName;
+			std::string	m_name;
+			std::string	m_location;
+			std::string	m_manufacturerId;
+			std::string	m_productType;
+			std::string	m_productId;
+		};
+
+		struct SnapshotValue
+		{
+			uint64		m_valueId;				// ValueID::GetId
+			uint8		m_nodeId;
+			uint8		m_genre;				// ValueID::ValueGenre
+			uint8		m_commandClassId;
+			uint8		m_instance;
+			uint16		m_index;
+			uint8		m_type;					// ValueID::ValueType
+			uint8		m_flags;				// SnapshotValueFlag
+			std::string	m_label;
+			std::string	m_units;
+			std::string	m_help;
+			std::string	m_value;				// Manager::GetValueAsString
+			uint8		m_state;				// SnapshotValueState
+		};
+
+		// OpenZWave cannot list a network's nodes or values, so the snapshot
+		// follows the NodeAdded and ValueAdded notifications of every network,
+		// and reads the rest from the Manager when it saves.  A snapshot file is
+		// a header, fixed size node and value records sorted by ID, and a table
+		// of the strings they refer to.  A loaded snapshot keeps the file
+		// mapped and reads records from it as they are asked for, so loading
+		// costs one mapping however big the network is.  Live notifications
+		// mark each value of a loaded snapshot as current or removed; the rest
+		// are stale.
+		class NetworkSnapshot
+		{
+		public:
+			// Write a snapshot of a network, replacing the file only once the
+			// new one is complete
+			static bool Save(uint32 _homeId, std::wstring const& _path);
+
+			// Save a network every _intervalMs, and when the manager is
+			// destroyed.  An interval of 0 stops saving it.
+			static void SetAutoSave(uint32 _homeId, std::wstring const& _path, uint32 _intervalMs);
+
+			// Save every network that has auto save, and stop the timers
+			static void Shutdown();
+
+			// The IDs of the nodes and values of a network.  False if no node
+			// or value of it has been added.
+			static bool GetNetwork(uint32 _homeId, std::vector<uint8>* o_nodeIds, std::vector<uint64>* o_valueIds);
+
+			// Read a node, or a value with the state Current, from the Manager
+			static void ReadNode(uint32 _homeId, uint8 _nodeId, SnapshotNode* o_node);
+			static void ReadValue(uint32 _homeId, uint64 _valueId, SnapshotValue* o_value);
+
+			// Map a snapshot file.  NULL if it is missing or not a snapshot.
+			static NetworkSnapshot* Load(std::wstring const& _path);
+			~NetworkSnapshot();
+
+			uint32 GetHomeId() const { return m_homeId; }
+			int64 GetSavedAt() const { return m_savedAt; }		// UTC file time
+			uint32 GetNodeCount() const { return m_nodeCount; }
+			uint32 GetValueCount() const { return m_valueCount; }
+			void GetNode(uint32 _index, SnapshotNode* o_node);
+			void GetValue(uint32 _index, SnapshotValue* o_value);
+
+			// The state of a value, Removed if it is not in the snapshot
+			SnapshotValueState GetState(uint64 _valueId);
+			uint32 GetStaleCount();
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			NetworkSnapshot();
+			NetworkSnapshot(NetworkSnapshot const&);
+			NetworkSnapshot& operator=(NetworkSnapshot const&);
+
+			struct Network
+			{
+				std::set<uint8>		m_nodes;
+				std::set<uint64>	m_values;
+			};
+
+			struct AutoSave
+			{
+				std::wstring	m_path;
+				PTP_TIMER		m_timer;
+			};
+
+			typedef std::map<uint32, Network> NetworkMap;
+			typedef std::map<uint32, AutoSave> AutoSaveMap;
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+			static void Track(Notification const* _notification);
+			void Reconcile(Notification const* _notification);
+
+			int32 Find(uint64 _valueId) const;
+			std::string GetString(uint32 _offset, uint32 _length) const;
+
+			HANDLE			m_file;
+			HANDLE			m_mapping;
+			uint8 const*	m_data;
+			uint64			m_size;
+			uint32			m_homeId;
+			int64			m_savedAt;
+			uint32			m_nodeCount;
+			uint32			m_valueCount;
+			uint8 const*	m_nodes;
+			uint8 const*	m_values;
+			uint8 const*	m_strings;
+			uint64			m_stringsSize;
+
+			Lock						m_lock;
+			std::vector<uint8>			m_states;			// SnapshotValueState, by value record
+
+			static Lock							s_lock;
+			static Lock							s_saveLock;		// One save writes at a time
+			static NetworkMap					s_networks;
+			static AutoSaveMap					s_autoSaves;
+			static std::vector<NetworkSnapshot*>	s_snapshots;
+		};
+	}
+}
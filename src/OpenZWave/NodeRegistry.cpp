@@ -0,0 +1,274 @@
+//-----------------------------------------------------------------------------
+//
+//      NodeRegistry.cpp
+//
+//      Cached static attributes of every node, indexed by home and node ID
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "NodeRegistry.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock NodeRegistry::s_lock;
+NodeRegistry::HomeMap NodeRegistry::s_homes;
+uint32 NodeRegistry::s_stamp = 0;
+uint32 NodeRegistry::s_lastHomeId = 0;
+NodeRegistry::Home* NodeRegistry::s_lastHome = NULL;
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::GetNode>
+//	Copy a node's attributes out of its slot
+//-----------------------------------------------------------------------------
+bool NodeRegistry::GetNode(uint32 _homeId, uint8 _nodeId, SnapshotNode* o_node)
+{
+	if (_nodeId == 0 || _nodeId > c_maxNodes)
+	{
+		return false;
+	}
+
+	LockGuard guard(s_lock);
+	Home* home = FindHome(_homeId);
+	if (home == NULL || home->m_slots[_nodeId - 1].m_stamp == 0)
+	{
+		return false;
+	}
+	*o_node = home->m_slots[_nodeId - 1].m_node;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::GetNodeIfChanged>
+//	Copy a node's attributes only if its slot has been filled since _stamp
+//-----------------------------------------------------------------------------
+uint32 NodeRegistry::GetNodeIfChanged(uint32 _homeId, uint8 _nodeId, uint32 _stamp, SnapshotNode* o_node)
+{
+	if (_nodeId == 0 || _nodeId > c_maxNodes)
+	{
+		return 0;
+	}
+
+	LockGuard guard(s_lock);
+	Home* home = FindHome(_homeId);
+	if (home == NULL)
+	{
+		return 0;
+	}
+	Slot const& slot = home->m_slots[_nodeId - 1];
+	if (slot.m_stamp != 0 && slot.m_stamp != _stamp)
+	{
+		*o_node = slot.m_node;
+	}
+	return slot.m_stamp;
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::GetNodes>
+//	Copy every filled slot of a network
+//-----------------------------------------------------------------------------
+void NodeRegistry::GetNodes(uint32 _homeId, std::vector<SnapshotNode>* o_nodes)
+{
+	o_nodes->clear();
+
+	LockGuard guard(s_lock);
+	Home* home = FindHome(_homeId);
+	if (home == NULL)
+	{
+		return;
+	}
+	for (uint32 i = 0; i < c_maxNodes; ++i)
+	{
+		if (home->m_slots[i].m_stamp != 0)
+		{
+			o_nodes->push_back(home->m_slots[i].m_node);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::GetNodeIds>
+//	The IDs of every filled slot of a network
+//-----------------------------------------------------------------------------
+void NodeRegistry::GetNodeIds(uint32 _homeId, std::vector<uint8>* o_nodeIds)
+{
+	o_nodeIds->clear();
+
+	LockGuard guard(s_lock);
+	Home* home = FindHome(_homeId);
+	if (home == NULL)
+	{
+		return;
+	}
+	for (uint32 i = 0; i < c_maxNodes; ++i)
+	{
+		if (home->m_slots[i].m_stamp != 0)
+		{
+			o_nodeIds->push_back((uint8)(i + 1));
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::Shutdown>
+//	Free every network
+//-----------------------------------------------------------------------------
+void NodeRegistry::Shutdown()
+{
+	LockGuard guard(s_lock);
+	for (HomeMap::iterator it = s_homes.begin(); it != s_homes.end(); ++it)
+	{
+		delete it->second;
+	}
+	s_homes.clear();
+	s_lastHomeId = 0;
+	s_lastHome = NULL;
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::OnNotification>
+//	Fill, refresh and empty slots as nodes are added, queried and removed
+//-----------------------------------------------------------------------------
+void NodeRegistry::OnNotification(Notification const* _notification)
+{
+	uint32 homeId = _notification->GetHomeId();
+	switch (_notification->GetType())
+	{
+	case Notification::Type_NodeNew:
+	case Notification::Type_NodeAdded:
+	case Notification::Type_NodeProtocolInfo:
+	case Notification::Type_NodeNaming:
+	case Notification::Type_EssentialNodeQueriesComplete:
+	{
+		Update(homeId, _notification->GetNodeId());
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		Remove(homeId, _notification->GetNodeId());
+		break;
+	}
+	case Notification::Type_DriverReset:
+	case Notification::Type_DriverRemoved:
+	{
+		RemoveHome(homeId);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::Update>
+//	Read a node from the Manager into its slot
+//-----------------------------------------------------------------------------
+void NodeRegistry::Update(uint32 _homeId, uint8 _nodeId)
+{
+	if (_nodeId == 0 || _nodeId > c_maxNodes)
+	{
+		return;
+	}
+
+	// The Manager is only called with no lock held
+	SnapshotNode node;
+	NetworkSnapshot::ReadNode(_homeId, _nodeId, &node);
+
+	LockGuard guard(s_lock);
+	Home* home = FindHome(_homeId);
+	if (home == NULL)
+	{
+		home = new Home();
+		s_homes[_homeId] = home;
+		s_lastHomeId = _homeId;
+		s_lastHome = home;
+	}
+	Slot& slot = home->m_slots[_nodeId - 1];
+	slot.m_node = node;
+	if (++s_stamp == 0)
+	{
+		++s_stamp;
+	}
+	slot.m_stamp = s_stamp;
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::Remove>
+//	Empty a node's slot
+//-----------------------------------------------------------------------------
+void NodeRegistry::Remove(uint32 _homeId, uint8 _nodeId)
+{
+	if (_nodeId == 0 || _nodeId > c_maxNodes)
+	{
+		return;
+	}
+
+	LockGuard guard(s_lock);
+	Home* home = FindHome(_homeId);
+	if (home != NULL)
+	{
+		Slot& slot = home->m_slots[_nodeId - 1];
+		slot.m_stamp = 0;
+		slot.m_node = SnapshotNode();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::RemoveHome>
+//	Free a network's slots
+//-----------------------------------------------------------------------------
+void NodeRegistry::RemoveHome(uint32 _homeId)
+{
+	LockGuard guard(s_lock);
+	HomeMap::iterator it = s_homes.find(_homeId);
+	if (it == s_homes.end())
+	{
+		return;
+	}
+	delete it->second;
+	s_homes.erase(it);
+	if (s_lastHomeId == _homeId)
+	{
+		s_lastHomeId = 0;
+		s_lastHome = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NodeRegistry::FindHome>
+//	The slots of a network, or NULL.  Called under s_lock.
+//-----------------------------------------------------------------------------
+NodeRegistry::Home* NodeRegistry::FindHome(uint32 _homeId)
+{
+	if (s_lastHome != NULL && s_lastHomeId == _homeId)
+	{
+		return s_lastHome;
+	}
+
+	HomeMap::const_iterator it = s_homes.find(_homeId);
+	if (it == s_homes.end())
+	{
+		return NULL;
+	}
+	s_lastHomeId = it->first;
+	s_lastHome = it->second;
+	return it->second;
+}
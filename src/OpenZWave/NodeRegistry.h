@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+//
+//      NodeRegistry.h
+//
+//      Cached static attributes of every node, indexed by home and node ID
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "Lock.h"
+#include "NetworkSnapshot.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Keeps the static attributes of every node of every network, so that
+		// resolving the node of a notification is an array index rather than a
+		// dozen Manager calls.  Each network has a dense array of a slot per
+		// possible node ID.  A node's slot is filled from the Manager when it
+		// is added, and read again on NodeProtocolInfo, NodeNaming and
+		// EssentialNodeQueriesComplete, the only notifications after which
+		// these attributes change.  The slot is emptied when the node is
+		// removed, and the array freed with the driver.
+		//
+		// Each fill gives the slot a new stamp, so a caller holding a copy made
+		// from the slot knows it is still current while the stamp is the same.
+		class NodeRegistry
+		{
+		public:
+			static uint32 const c_maxNodes = 232;
+
+			// The node's attributes.  False if the node is not known.
+			static bool GetNode(uint32 _homeId, uint8 _nodeId, SnapshotNode* o_node);
+
+			// The stamp of the node's slot, and a copy of it if it is not
+			// _stamp.  0 if the node is not known.
+			static uint32 GetNodeIfChanged(uint32 _homeId, uint8 _nodeId, uint32 _stamp, SnapshotNode* o_node);
+
+			// Every known node of a network, sorted by ID
+			static void GetNodes(uint32 _homeId, std::vector<SnapshotNode>* o_nodes);
+
+			// The IDs of every known node of a network, sorted
+			static void GetNodeIds(uint32 _homeId, std::vector<uint8>* o_nodeIds);
+
+			static void Shutdown();
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			struct Slot
+			{
+				uint32			m_stamp;				// 0 if the slot is empty
+				SnapshotNode	m_node;
+			};
+
+			struct Home
+			{
+				Slot	m_slots[c_maxNodes];		// Indexed by node ID - 1
+			};
+
+			typedef std::map<uint32, Home*> HomeMap;
+
+			static void Update(uint32 _homeId, uint8 _nodeId);
+			static void Remove(uint32 _homeId, uint8 _nodeId);
+			static void RemoveHome(uint32 _homeId);
+			static Home* FindHome(uint32 _homeId);
+
+			// Under s_lock
+			static Lock		s_lock;
+			static HomeMap	s_homes;
+			static uint32	s_stamp;				// The stamp of the latest fill
+			static uint32	s_lastHomeId;			// The home FindHome found last, which is
+			static Home*	s_lastHome;				// nearly always the one asked for next
+		};
+	}
+}
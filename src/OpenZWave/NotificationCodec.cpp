@@ -0,0 +1,414 @@
+//-----------------------------------------------------------------------------
+//
+//      NotificationCodec.cpp
+//
+//      Compact binary encoding of notifications and their values
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstring>
+#include "NotificationCodec.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	// c_notificationMaxBody needs no more than this many bytes as a varint
+	uint32 const c_maxLengthBytes = 3;
+
+	// A uint64 needs no more than this many
+	uint32 const c_maxVarintBytes = 10;
+
+	uint32 const c_fixedBodySize = 3;		// Version, type and flags
+
+	uint32 ZigZag(int32 _value)
+	{
+		return ((uint32)_value << 1) ^ (uint32)(_value >> 31);
+	}
+
+	int32 UnZigZag(uint64 _value)
+	{
+		uint32 value = (uint32)_value;
+		return (int32)(value >> 1) ^ -(int32)(value & 1);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::Capture>
+//	Fill a record from a notification and the value it is about
+//-----------------------------------------------------------------------------
+void NotificationCodec::Capture(uint8 _type, uint8 _byte, uint8 _event, ValueID const& _valueId, std::string* io_string, NotificationRecord* o_record)
+{
+	o_record->m_type = _type;
+	o_record->m_flags = 0;
+	o_record->m_byte = _byte;
+	o_record->m_event = _event;
+	o_record->m_homeId = _valueId.GetHomeId();
+	o_record->m_valueId = _valueId.GetId();
+	o_record->m_valueType = 0;
+	o_record->m_int = 0;
+	o_record->m_string = NULL;
+	o_record->m_stringLength = 0;
+
+	if (_byte != 0)
+	{
+		o_record->m_flags |= NotificationRecordFlag_Byte;
+	}
+	if (_event != 0)
+	{
+		o_record->m_flags |= NotificationRecordFlag_Event;
+	}
+
+	if (_type != Notification::Type_ValueAdded && _type != Notification::Type_ValueChanged && _type != Notification::Type_ValueRefreshed)
+	{
+		return;
+	}
+
+	Manager* manager = Manager::Get();
+	ValueID::ValueType valueType = _valueId.GetType();
+	o_record->m_flags |= NotificationRecordFlag_Value;
+	o_record->m_valueType = (uint8)valueType;
+
+	switch (valueType)
+	{
+	case ValueID::ValueType_Bool:
+	case ValueID::ValueType_Button:
+		{
+			bool value;
+			if (manager->GetValueAsBool(_valueId, &value))
+			{
+				o_record->m_int = value ? 1 : 0;
+			}
+			return;
+		}
+	case ValueID::ValueType_Byte:
+		{
+			uint8 value;
+			if (manager->GetValueAsByte(_valueId, &value))
+			{
+				o_record->m_int = value;
+			}
+			return;
+		}
+	case ValueID::ValueType_Short:
+		{
+			int16 value;
+			if (manager->GetValueAsShort(_valueId, &value))
+			{
+				o_record->m_int = value;
+			}
+			return;
+		}
+	case ValueID::ValueType_Int:
+		{
+			manager->GetValueAsInt(_valueId, &o_record->m_int);
+			return;
+		}
+	case ValueID::ValueType_List:
+		{
+			io_string->clear();
+			manager->GetValueListSelection(_valueId, &o_record->m_int);
+			manager->GetValueListSelection(_valueId, io_string);
+			break;
+		}
+	default:
+		{
+			io_string->clear();
+			manager->GetValueAsString(_valueId, io_string);
+			break;
+		}
+	}
+
+	o_record->m_string = io_string->data();
+	o_record->m_stringLength = (uint32)io_string->size();
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::Encode>
+//	Write a record, if it fits
+//-----------------------------------------------------------------------------
+uint32 NotificationCodec::Encode(NotificationRecord const& _record, uint8* o_buffer, uint32 _capacity)
+{
+	uint8 flags = _record.m_flags & (NotificationRecordFlag_Byte | NotificationRecordFlag_Event | NotificationRecordFlag_Value | NotificationRecordFlag_Truncated);
+	uint32 stringLength = 0;
+	if ((flags & NotificationRecordFlag_Value) != 0 && HasString(_record.m_valueType))
+	{
+		stringLength = _record.m_stringLength;
+		if (stringLength > c_notificationMaxString)
+		{
+			stringLength = c_notificationMaxString;
+			flags |= NotificationRecordFlag_Truncated;
+		}
+	}
+
+	// Sized first, so the length goes in front without moving the body
+	uint32 bodySize = c_fixedBodySize + GetVarintSize(_record.m_homeId) + GetVarintSize(_record.m_valueId);
+	if ((flags & NotificationRecordFlag_Byte) != 0)
+	{
+		++bodySize;
+	}
+	if ((flags & NotificationRecordFlag_Event) != 0)
+	{
+		++bodySize;
+	}
+	if ((flags & NotificationRecordFlag_Value) != 0)
+	{
+		++bodySize;
+		if (HasInt(_record.m_valueType))
+		{
+			bodySize += GetVarintSize(ZigZag(_record.m_int));
+		}
+		if (HasString(_record.m_valueType))
+		{
+			bodySize += GetVarintSize(stringLength) + stringLength;
+		}
+	}
+
+	uint32 size = GetVarintSize(bodySize) + bodySize;
+	if (size > _capacity)
+	{
+		return 0;
+	}
+
+	uint8* out = PutVarint(bodySize, o_buffer);
+	*out++ = c_notificationCodecVersion;
+	*out++ = _record.m_type;
+	*out++ = flags;
+	out = PutVarint(_record.m_homeId, out);
+	out = PutVarint(_record.m_valueId, out);
+	if ((flags & NotificationRecordFlag_Byte) != 0)
+	{
+		*out++ = _record.m_byte;
+	}
+	if ((flags & NotificationRecordFlag_Event) != 0)
+	{
+		*out++ = _record.m_event;
+	}
+	if ((flags & NotificationRecordFlag_Value) != 0)
+	{
+		*out++ = _record.m_valueType;
+		if (HasInt(_record.m_valueType))
+		{
+			out = PutVarint(ZigZag(_record.m_int), out);
+		}
+		if (HasString(_record.m_valueType))
+		{
+			out = PutVarint(stringLength, out);
+			if (stringLength > 0)
+			{
+				memcpy(out, _record.m_string, stringLength);
+				out += stringLength;
+			}
+		}
+	}
+	return size;
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::Decode>
+//	Read the record at the start of a buffer
+//-----------------------------------------------------------------------------
+NotificationDecodeResult NotificationCodec::Decode(uint8 const* _buffer, uint32 _length, NotificationRecord* o_record, uint32* o_consumed)
+{
+	// The length, which a partial buffer may cut short
+	uint32 bodySize = 0;
+	uint32 prefix = 0;
+	for (;;)
+	{
+		if (prefix == _length)
+		{
+			return NotificationDecode_Incomplete;
+		}
+		if (prefix == c_maxLengthBytes)
+		{
+			return NotificationDecode_Invalid;
+		}
+		uint8 b = _buffer[prefix];
+		bodySize |= (uint32)(b & 0x7f) << (prefix * 7);
+		++prefix;
+		if ((b & 0x80) == 0)
+		{
+			break;
+		}
+	}
+	if (bodySize < c_fixedBodySize || bodySize > c_notificationMaxBody)
+	{
+		return NotificationDecode_Invalid;
+	}
+	if (_length - prefix < bodySize)
+	{
+		return NotificationDecode_Incomplete;
+	}
+	*o_consumed = prefix + bodySize;
+
+	uint8 const* in = _buffer + prefix;
+	uint8 const* end = in + bodySize;
+	if (*in++ != c_notificationCodecVersion)
+	{
+		return NotificationDecode_Skipped;
+	}
+
+	memset(o_record, 0, sizeof(NotificationRecord));
+	o_record->m_type = *in++;
+	o_record->m_flags = *in++;
+
+	uint64 value;
+	if (!GetVarint(&in, end, &value) || value > 0xffffffff)
+	{
+		return NotificationDecode_Invalid;
+	}
+	o_record->m_homeId = (uint32)value;
+	if (!GetVarint(&in, end, &o_record->m_valueId))
+	{
+		return NotificationDecode_Invalid;
+	}
+
+	if ((o_record->m_flags & NotificationRecordFlag_Byte) != 0)
+	{
+		if (in == end)
+		{
+			return NotificationDecode_Invalid;
+		}
+		o_record->m_byte = *in++;
+	}
+	if ((o_record->m_flags & NotificationRecordFlag_Event) != 0)
+	{
+		if (in == end)
+		{
+			return NotificationDecode_Invalid;
+		}
+		o_record->m_event = *in++;
+	}
+	if ((o_record->m_flags & NotificationRecordFlag_Value) == 0)
+	{
+		return NotificationDecode_Record;
+	}
+
+	if (in == end)
+	{
+		return NotificationDecode_Invalid;
+	}
+	o_record->m_valueType = *in++;
+	if (HasInt(o_record->m_valueType))
+	{
+		if (!GetVarint(&in, end, &value) || value > 0xffffffff)
+		{
+			return NotificationDecode_Invalid;
+		}
+		o_record->m_int = UnZigZag(value);
+	}
+	if (HasString(o_record->m_valueType))
+	{
+		if (!GetVarint(&in, end, &value) || value > (uint64)(end - in))
+		{
+			return NotificationDecode_Invalid;
+		}
+		o_record->m_string = (char const*)in;
+		o_record->m_stringLength = (uint32)value;
+	}
+	return NotificationDecode_Record;
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::HasInt>
+//	Whether a value of the type is written as an integer
+//-----------------------------------------------------------------------------
+bool NotificationCodec::HasInt(uint8 _valueType)
+{
+	switch (_valueType)
+	{
+	case ValueID::ValueType_Bool:
+	case ValueID::ValueType_Byte:
+	case ValueID::ValueType_Short:
+	case ValueID::ValueType_Int:
+	case ValueID::ValueType_Button:
+	case ValueID::ValueType_List:
+		{
+			return true;
+		}
+	default:
+		{
+			return false;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::HasString>
+//	Whether a value of the type is written with a string
+//-----------------------------------------------------------------------------
+bool NotificationCodec::HasString(uint8 _valueType)
+{
+	return _valueType == ValueID::ValueType_List || !HasInt(_valueType);
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::GetVarintSize>
+//	The bytes a value takes as a varint
+//-----------------------------------------------------------------------------
+uint32 NotificationCodec::GetVarintSize(uint64 _value)
+{
+	uint32 size = 1;
+	while (_value >= 0x80)
+	{
+		_value >>= 7;
+		++size;
+	}
+	return size;
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::PutVarint>
+//	Write a varint and return the byte after it
+//-----------------------------------------------------------------------------
+uint8* NotificationCodec::PutVarint(uint64 _value, uint8* o_buffer)
+{
+	while (_value >= 0x80)
+	{
+		*o_buffer++ = (uint8)(_value | 0x80);
+		_value >>= 7;
+	}
+	*o_buffer++ = (uint8)_value;
+	return o_buffer;
+}
+
+//-----------------------------------------------------------------------------
+//	<NotificationCodec::GetVarint>
+//	Read a varint, moving past it.  False if it runs past _end.
+//-----------------------------------------------------------------------------
+bool NotificationCodec::GetVarint(uint8 const** io_buffer, uint8 const* _end, uint64* o_value)
+{
+	uint8 const* in = *io_buffer;
+	uint64 value = 0;
+	for (uint32 i = 0; i < c_maxVarintBytes && in != _end; ++i)
+	{
+		uint8 b = *in++;
+		value |= (uint64)(b & 0x7f) << (i * 7);
+		if ((b & 0x80) == 0)
+		{
+			*io_buffer = in;
+			*o_value = value;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+//
+//      NotificationCodec.h
+//
+//      Compact binary encoding of notifications and their values
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+
+// Each record is the length of its body as a varint, then the body:
+//
+//	uint8	version					c_notificationCodecVersion
+//	uint8	type					Notification::NotificationType
+//	uint8	flags					NotificationRecordFlag
+//	varint	Home ID
+//	varint	Value ID				ValueID::GetId
+//	uint8	byte					If NotificationRecordFlag_Byte
+//	uint8	event					If NotificationRecordFlag_Event
+//	uint8	value type				If NotificationRecordFlag_Value, then
+//	...		value					by the value type:
+//
+//	Bool, Byte, Short, Int, Button	zigzag varint
+//	List							zigzag varint of the selection, then string of its label
+//	Any other						string, as Manager::GetValueAsString, so a Decimal
+//									keeps the precision the device reported
+//
+// A varint is 7 bits a byte, least significant first, with the high bit set
+// on every byte but the last.  A string is its length as a varint, then that
+// many bytes of UTF-8.  Fields added later go after these, so a decoder
+// ignores the rest of a body, and skips a body of a version it does not know.
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		uint8 const c_notificationCodecVersion = 1;
+		uint32 const c_notificationMaxString = 32768;			// Longer strings are cut short
+		uint32 const c_notificationMaxBody = c_notificationMaxString + 64;
+
+		enum NotificationRecordFlag
+		{
+			NotificationRecordFlag_Byte = 0x01,
+			NotificationRecordFlag_Event = 0x02,
+			NotificationRecordFlag_Value = 0x04,
+			NotificationRecordFlag_Truncated = 0x08				// The string was cut short
+		};
+
+		struct NotificationRecord
+		{
+			uint8			m_type;
+			uint8			m_flags;
+			uint8			m_byte;
+			uint8			m_event;
+			uint32			m_homeId;
+			uint64			m_valueId;
+			uint8			m_valueType;				// ValueID::ValueType
+			int32			m_int;
+			char const*		m_string;					// Not terminated
+			uint32			m_stringLength;
+		};
+
+		enum NotificationDecodeResult
+		{
+			NotificationDecode_Record,					// A record was decoded
+			NotificationDecode_Skipped,					// A record of another version was skipped
+			NotificationDecode_Incomplete,				// More bytes are needed
+			NotificationDecode_Invalid					// The bytes are not a record
+		};
+
+		class NotificationCodec
+		{
+		public:
+			// Fill a record from a notification, reading the value of value
+			// notifications from OpenZWave.  The record's string is kept in
+			// io_string, which is reused between calls.
+			static void Capture(uint8 _type, uint8 _byte, uint8 _event, ValueID const& _valueId, std::string* io_string, NotificationRecord* o_record);
+
+			// Write a record at o_buffer.  Returns the bytes written, or 0 if
+			// the record does not fit in _capacity.
+			static uint32 Encode(NotificationRecord const& _record, uint8* o_buffer, uint32 _capacity);
+
+			// Read the record at _buffer.  o_consumed is set for a record
+			// decoded or skipped.  The record's string points into _buffer.
+			static NotificationDecodeResult Decode(uint8 const* _buffer, uint32 _length, NotificationRecord* o_record, uint32* o_consumed);
+
+		private:
+			static bool HasInt(uint8 _valueType);
+			static bool HasString(uint8 _valueType);
+			static uint32 GetVarintSize(uint64 _value);
+			static uint8* PutVarint(uint64 _value, uint8* o_buffer);
+			static bool GetVarint(uint8 const** io_buffer, uint8 const* _end, uint64* o_value);
+		};
+	}
+}
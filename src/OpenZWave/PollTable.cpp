@@ -0,0 +1,228 @@
+//-----------------------------------------------------------------------------
+//
+//      PollTable.cpp
+//
+//      Index of every value OpenZWave polls, with report statistics
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "PollTable.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock PollTable::s_lock;
+PollTable::HomeMap PollTable::s_homes;
+
+//-----------------------------------------------------------------------------
+//	<PollTable::OnNotification>
+//	Track the polled values of every network, and their reports
+//-----------------------------------------------------------------------------
+void PollTable::OnNotification(Notification const* _notification)
+{
+	switch (_notification->GetType())
+	{
+	case Notification::Type_PollingEnabled:
+	{
+		Add(_notification->GetHomeId(), _notification->GetValueID().GetId());
+		break;
+	}
+	case Notification::Type_PollingDisabled:
+	case Notification::Type_ValueRemoved:
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator home = s_homes.find(_notification->GetHomeId());
+		if (home != s_homes.end())
+		{
+			home->second.erase(_notification->GetValueID().GetId());
+		}
+		break;
+	}
+	case Notification::Type_ValueChanged:
+	case Notification::Type_ValueRefreshed:
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator home = s_homes.find(_notification->GetHomeId());
+		if (home == s_homes.end())
+		{
+			return;
+		}
+		ValueMap::iterator value = home->second.find(_notification->GetValueID().GetId());
+		if (value == home->second.end())
+		{
+			return;
+		}
+
+		Statistics& statistics = value->second;
+		uint64 now = GetTickCount64();
+		if (statistics.m_lastReportAt != 0)
+		{
+			statistics.m_reportIntervalMs = (uint32)(now - statistics.m_lastReportAt);
+		}
+		statistics.m_lastReportAt = now;
+		++statistics.m_reports;
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator home = s_homes.find(_notification->GetHomeId());
+		if (home == s_homes.end())
+		{
+			return;
+		}
+		ValueMap& values = home->second;
+		for (ValueMap::iterator it = values.begin(); it != values.end(); )
+		{
+			if (ValueID(home->first, it->first).GetNodeId() == _notification->GetNodeId())
+			{
+				values.erase(it++);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		break;
+	}
+	case Notification::Type_DriverReset:
+	case Notification::Type_DriverRemoved:
+	{
+		// A reset controller forgets its nodes, and so every polled value
+		LockGuard guard(s_lock);
+		s_homes.erase(_notification->GetHomeId());
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<PollTable::EnablePoll>
+//	Enable polling of many values
+//-----------------------------------------------------------------------------
+uint32 PollTable::EnablePoll(std::vector<ValueID> const& _valueIds, uint8 _intensity)
+{
+	uint32 enabled = 0;
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < _valueIds.size(); ++i)
+	{
+		// The PollingEnabled notification comes later, from the notification thread
+		if (manager->EnablePoll(_valueIds[i], _intensity))
+		{
+			Add(_valueIds[i].GetHomeId(), _valueIds[i].GetId());
+			++enabled;
+		}
+	}
+	return enabled;
+}
+
+//-----------------------------------------------------------------------------
+//	<PollTable::DisablePoll>
+//	Disable polling of many values
+//-----------------------------------------------------------------------------
+uint32 PollTable::DisablePoll(std::vector<ValueID> const& _valueIds)
+{
+	uint32 disabled = 0;
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < _valueIds.size(); ++i)
+	{
+		if (manager->DisablePoll(_valueIds[i]))
+		{
+			LockGuard guard(s_lock);
+			HomeMap::iterator home = s_homes.find(_valueIds[i].GetHomeId());
+			if (home != s_homes.end())
+			{
+				home->second.erase(_valueIds[i].GetId());
+			}
+			++disabled;
+		}
+	}
+	return disabled;
+}
+
+//-----------------------------------------------------------------------------
+//	<PollTable::GetPolledValues>
+//	Every polled value of a network, with its intensity and statistics
+//-----------------------------------------------------------------------------
+void PollTable::GetPolledValues(uint32 _homeId, std::vector<PolledValue>* o_values)
+{
+	o_values->clear();
+	{
+		SharedLockGuard guard(s_lock);
+		HomeMap::const_iterator home = s_homes.find(_homeId);
+		if (home == s_homes.end())
+		{
+			return;
+		}
+
+		o_values->reserve(home->second.size());
+		for (ValueMap::const_iterator it = home->second.begin(); it != home->second.end(); ++it)
+		{
+			PolledValue value;
+			value.m_valueId = it->first;
+			value.m_nodeId = ValueID(_homeId, it->first).GetNodeId();
+			value.m_intensity = 0;
+			value.m_reports = it->second.m_reports;
+			value.m_lastReportAt = it->second.m_lastReportAt;
+			value.m_reportIntervalMs = it->second.m_reportIntervalMs;
+			o_values->push_back(value);
+		}
+	}
+
+	// OpenZWave is not called with s_lock held, as it may be sending a
+	// notification that is waiting for the lock
+	Manager* manager = Manager::Get();
+	for (size_t i = 0; i < o_values->size(); ++i)
+	{
+		PolledValue& value = (*o_values)[i];
+		value.m_intensity = manager->GetPollIntensity(ValueID(_homeId, value.m_valueId));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<PollTable::Shutdown>
+//	Forget every network
+//-----------------------------------------------------------------------------
+void PollTable::Shutdown()
+{
+	LockGuard guard(s_lock);
+	s_homes.clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<PollTable::Add>
+//	Start tracking a polled value, keeping its statistics if it is already
+//	tracked
+//-----------------------------------------------------------------------------
+void PollTable::Add(uint32 _homeId, uint64 _valueId)
+{
+	LockGuard guard(s_lock);
+	ValueMap& values = s_homes[_homeId];
+	if (values.find(_valueId) == values.end())
+	{
+		Statistics& statistics = values[_valueId];
+		statistics.m_reports = 0;
+		statistics.m_lastReportAt = 0;
+		statistics.m_reportIntervalMs = 0;
+	}
+}
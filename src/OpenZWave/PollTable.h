@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+//
+//      PollTable.h
+//
+//      Index of every value OpenZWave polls, with report statistics
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct PolledValue
+		{
+			uint64	m_valueId;				// ValueID::GetId
+			uint8	m_nodeId;
+			uint8	m_intensity;			// Manager::GetPollIntensity
+			uint32	m_reports;				// Reports since polling was enabled
+			uint64	m_lastReportAt;			// Tick count, 0 if none
+			uint32	m_reportIntervalMs;		// Between the last two reports, 0 until there are two
+		};
+
+		// OpenZWave cannot list the values it polls, so the table follows the
+		// PollingEnabled and PollingDisabled notifications, and the bulk calls
+		// below.  Answers to polls arrive as ordinary value reports, so the
+		// time since the last report, and between the last two, stand in for
+		// the time and period of the last poll.
+		class PollTable
+		{
+		public:
+			static void OnNotification(Notification const* _notification);
+
+			// Enable or disable polling of many values.  Returns the number
+			// OpenZWave accepted.
+			static uint32 EnablePoll(std::vector<ValueID> const& _valueIds, uint8 _intensity);
+			static uint32 DisablePoll(std::vector<ValueID> const& _valueIds);
+
+			// Every polled value of the network, by value ID
+			static void GetPolledValues(uint32 _homeId, std::vector<PolledValue>* o_values);
+
+			// Forget every network
+			static void Shutdown();
+
+		private:
+			struct Statistics
+			{
+				uint32	m_reports;
+				uint64	m_lastReportAt;
+				uint32	m_reportIntervalMs;
+			};
+
+			typedef std::map<uint64, Statistics> ValueMap;
+			typedef std::map<uint32, ValueMap> HomeMap;
+
+			static void Add(uint32 _homeId, uint64 _valueId);
+
+			static Lock		s_lock;
+			static HomeMap	s_homes;		// Polled values by home
+		};
+	}
+}
@@ -0,0 +1,635 @@
+//-----------------------------------------------------------------------------
+//
+//      StartupProfiler.cpp
+//
+//      Timeline of the query stages each node goes through at startup
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "StartupProfiler.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool StartupProfiler::s_enabled = false;
+Lock StartupProfiler::s_lock;
+StartupProfiler::HomeMap StartupProfiler::s_homes;
+PTP_TIMER StartupProfiler::s_timer = NULL;
+bool StartupProfiler::s_sampling = false;
+
+namespace
+{
+	uint32 const c_samplePeriodMs = 250;
+	size_t const c_noSpan = (size_t)-1;
+
+	char const* const c_stageNames[] =
+	{
+		"ProtocolInfo",
+		"Probe",
+		"WakeUp",
+		"ManufacturerSpecific1",
+		"NodeInfo",
+		"NodePlusInfo",
+		"SecurityReport",
+		"ManufacturerSpecific2",
+		"Versions",
+		"Instances",
+		"Static",
+		"CacheLoad",
+		"Probe1",
+		"Associations",
+		"Neighbors",
+		"Session",
+		"Dynamic",
+		"Configuration",
+		"Complete",
+		"None"
+	};
+
+	bool BySpanNode(QueryStageSpan const& _a, QueryStageSpan const& _b)
+	{
+		return _a.m_nodeId < _b.m_nodeId;
+	}
+
+	bool ByNodeTime(NodeStartup const& _a, NodeStartup const& _b)
+	{
+		return _a.m_time > _b.m_time;
+	}
+
+	bool ByStageTime(StageStartup const& _a, StageStartup const& _b)
+	{
+		return _a.m_time > _b.m_time;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::SetEnabled>
+//	Turn profiling on or off.  Profiles already recorded are kept.
+//-----------------------------------------------------------------------------
+void StartupProfiler::SetEnabled(bool _enabled)
+{
+	{
+		LockGuard guard(s_lock);
+		s_enabled = _enabled;
+	}
+	if (!_enabled)
+	{
+		Shutdown();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::Shutdown>
+//	Stop sampling stages from the timer
+//-----------------------------------------------------------------------------
+void StartupProfiler::Shutdown()
+{
+	PTP_TIMER timer = NULL;
+	{
+		LockGuard guard(s_lock);
+		timer = s_timer;
+		s_timer = NULL;
+		s_sampling = false;
+	}
+
+	// The callback takes s_lock, so wait for it outside
+	if (timer != NULL)
+	{
+		SetThreadpoolTimer(timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(timer, TRUE);
+		CloseThreadpoolTimer(timer);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::GetProfile>
+//	Copy a network's timeline and summarise it per node and per stage
+//-----------------------------------------------------------------------------
+bool StartupProfiler::GetProfile(uint32 _homeId, StartupProfile* o_profile)
+{
+	std::map<uint8, NodeStartup> nodes;
+	{
+		SharedLockGuard guard(s_lock);
+		HomeMap::const_iterator it = s_homes.find(_homeId);
+		if (it == s_homes.end())
+		{
+			return false;
+		}
+
+		Home const& home = it->second;
+		uint64 now = home.m_done ? home.m_allNodesQueried : GetTickCount64() - home.m_start;
+		o_profile->m_homeId = _homeId;
+		o_profile->m_elapsed = now;
+		o_profile->m_awakeNodesQueried = home.m_awakeNodesQueried;
+		o_profile->m_allNodesQueried = home.m_allNodesQueried;
+		o_profile->m_someDead = home.m_someDead;
+		o_profile->m_spans = home.m_spans;
+
+		for (std::map<uint8, Node>::const_iterator nit = home.m_nodes.begin(); nit != home.m_nodes.end(); ++nit)
+		{
+			NodeStartup& node = nodes[nit->first];
+			node.m_nodeId = nit->first;
+			node.m_complete = nit->second.m_complete;
+			node.m_time = node.m_complete ? nit->second.m_completedAt : now;
+
+			// Filled in from the node's spans below
+			node.m_slowestStage = QueryStage_None;
+			node.m_slowestTime = 0;
+			node.m_retries = 0;
+		}
+
+		// Spans still open run until now
+		for (size_t i = 0; i < o_profile->m_spans.size(); ++i)
+		{
+			if (o_profile->m_spans[i].m_open)
+			{
+				o_profile->m_spans[i].m_exit = now;
+			}
+		}
+	}
+
+	// Spans were recorded in time order, so this keeps each node's in order
+	std::stable_sort(o_profile->m_spans.begin(), o_profile->m_spans.end(), BySpanNode);
+
+	StageStartup stages[QueryStage_Count];
+	for (uint32 i = 0; i < QueryStage_Count; ++i)
+	{
+		stages[i].m_stage = (QueryStage)i;
+		stages[i].m_time = 0;
+		stages[i].m_nodeCount = 0;
+		stages[i].m_retries = 0;
+		stages[i].m_slowestNodeId = 0;
+		stages[i].m_slowestTime = 0;
+	}
+
+	size_t first = 0;
+	while (first < o_profile->m_spans.size())
+	{
+		uint8 nodeId = o_profile->m_spans[first].m_nodeId;
+		size_t last = first;
+		uint64 times[QueryStage_Count] = { 0 };
+		uint32 retries[QueryStage_Count] = { 0 };
+		while (last < o_profile->m_spans.size() && o_profile->m_spans[last].m_nodeId == nodeId)
+		{
+			QueryStageSpan const& span = o_profile->m_spans[last];
+			times[span.m_stage] += span.m_exit - span.m_enter;
+			retries[span.m_stage] += span.m_retries;
+			++last;
+		}
+
+		// A node removed during startup has spans but no longer has a state
+		std::map<uint8, NodeStartup>::iterator nit = nodes.find(nodeId);
+		if (nit == nodes.end())
+		{
+			nit = nodes.insert(std::map<uint8, NodeStartup>::value_type(nodeId, NodeStartup())).first;
+			nit->second.m_nodeId = nodeId;
+			nit->second.m_complete = false;
+			nit->second.m_time = o_profile->m_spans[last - 1].m_exit;
+			nit->second.m_slowestStage = QueryStage_None;
+			nit->second.m_slowestTime = 0;
+			nit->second.m_retries = 0;
+		}
+		NodeStartup& node = nit->second;
+
+		for (uint32 i = 0; i < QueryStage_Count; ++i)
+		{
+			if (times[i] == 0 && retries[i] == 0)
+			{
+				continue;
+			}
+			if (times[i] > node.m_slowestTime)
+			{
+				node.m_slowestStage = (QueryStage)i;
+				node.m_slowestTime = times[i];
+			}
+			node.m_retries += retries[i];
+
+			StageStartup& stage = stages[i];
+			stage.m_time += times[i];
+			stage.m_nodeCount += 1;
+			stage.m_retries += retries[i];
+			if (times[i] > stage.m_slowestTime)
+			{
+				stage.m_slowestNodeId = nodeId;
+				stage.m_slowestTime = times[i];
+			}
+		}
+		first = last;
+	}
+
+	o_profile->m_nodes.clear();
+	for (std::map<uint8, NodeStartup>::iterator it = nodes.begin(); it != nodes.end(); ++it)
+	{
+		o_profile->m_nodes.push_back(it->second);
+	}
+	std::stable_sort(o_profile->m_nodes.begin(), o_profile->m_nodes.end(), ByNodeTime);
+
+	o_profile->m_stages.clear();
+	for (uint32 i = 0; i < QueryStage_Count; ++i)
+	{
+		if (stages[i].m_nodeCount != 0)
+		{
+			o_profile->m_stages.push_back(stages[i]);
+		}
+	}
+	std::stable_sort(o_profile->m_stages.begin(), o_profile->m_stages.end(), ByStageTime);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::ParseStage>
+//	The stage named by GetNodeQueryStage
+//-----------------------------------------------------------------------------
+QueryStage StartupProfiler::ParseStage(std::string const& _name)
+{
+	for (uint32 i = 0; i < sizeof(c_stageNames) / sizeof(c_stageNames[0]); ++i)
+	{
+		if (_name == c_stageNames[i])
+		{
+			return (QueryStage)i;
+		}
+	}
+	return QueryStage_Unknown;
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::OnNotification>
+//	Start, sample and finish the profile of a network
+//-----------------------------------------------------------------------------
+void StartupProfiler::OnNotification(Notification const* _notification)
+{
+	uint32 homeId = _notification->GetHomeId();
+	uint8 nodeId = _notification->GetNodeId();
+	uint64 now = GetTickCount64();
+
+	switch (_notification->GetType())
+	{
+		case Notification::Type_DriverReady:
+		case Notification::Type_DriverReset:
+		{
+			// The network is queried again from the start
+			{
+				LockGuard guard(s_lock);
+				s_homes.erase(homeId);
+				GetHome(homeId, now);
+			}
+			StartTimer();
+			return;
+		}
+		case Notification::Type_DriverRemoved:
+		{
+			LockGuard guard(s_lock);
+			HomeMap::iterator it = s_homes.find(homeId);
+			if (it != s_homes.end() && !it->second.m_done)
+			{
+				Home& home = it->second;
+				home.m_done = true;
+				home.m_allNodesQueried = now - home.m_start;
+				for (size_t i = 0; i < home.m_spans.size(); ++i)
+				{
+					if (home.m_spans[i].m_open)
+					{
+						home.m_spans[i].m_exit = home.m_allNodesQueried;
+						home.m_spans[i].m_open = false;
+					}
+				}
+			}
+			StopTimerIfDone();
+			return;
+		}
+		case Notification::Type_NodeRemoved:
+		{
+			LockGuard guard(s_lock);
+			HomeMap::iterator it = s_homes.find(homeId);
+			if (it != s_homes.end())
+			{
+				Home& home = it->second;
+				std::map<uint8, Node>::iterator nit = home.m_nodes.find(nodeId);
+				if (nit != home.m_nodes.end())
+				{
+					if (nit->second.m_span != c_noSpan)
+					{
+						home.m_spans[nit->second.m_span].m_exit = now - home.m_start;
+						home.m_spans[nit->second.m_span].m_open = false;
+					}
+					home.m_nodes.erase(nit);
+				}
+			}
+			return;
+		}
+		case Notification::Type_AwakeNodesQueried:
+		{
+			LockGuard guard(s_lock);
+			Home& home = GetHome(homeId, now);
+			if (home.m_awakeNodesQueried == 0)
+			{
+				home.m_awakeNodesQueried = now - home.m_start;
+			}
+			return;
+		}
+		case Notification::Type_AllNodesQueried:
+		case Notification::Type_AllNodesQueriedSomeDead:
+		{
+			// Read the final stages before the profile is closed
+			std::vector<uint8> pending;
+			{
+				SharedLockGuard guard(s_lock);
+				HomeMap::const_iterator it = s_homes.find(homeId);
+				if (it != s_homes.end())
+				{
+					for (std::map<uint8, Node>::const_iterator nit = it->second.m_nodes.begin(); nit != it->second.m_nodes.end(); ++nit)
+					{
+						if (!nit->second.m_complete)
+						{
+							pending.push_back(nit->first);
+						}
+					}
+				}
+			}
+			for (size_t i = 0; i < pending.size(); ++i)
+			{
+				Sample(homeId, pending[i]);
+			}
+
+			LockGuard guard(s_lock);
+			Home& home = GetHome(homeId, now);
+			if (home.m_done)
+			{
+				return;
+			}
+			home.m_done = true;
+			home.m_allNodesQueried = now - home.m_start;
+			home.m_someDead = _notification->GetType() == Notification::Type_AllNodesQueriedSomeDead;
+			for (size_t i = 0; i < home.m_spans.size(); ++i)
+			{
+				if (home.m_spans[i].m_open)
+				{
+					home.m_spans[i].m_exit = home.m_allNodesQueried;
+					home.m_spans[i].m_open = false;
+				}
+			}
+			StopTimerIfDone();
+			return;
+		}
+		case Notification::Type_Notification:
+		{
+			if (_notification->GetNotification() == Notification::Code_Timeout)
+			{
+				LockGuard guard(s_lock);
+				HomeMap::iterator it = s_homes.find(homeId);
+				if (it != s_homes.end() && !it->second.m_done)
+				{
+					std::map<uint8, Node>::iterator nit = it->second.m_nodes.find(nodeId);
+					if (nit != it->second.m_nodes.end() && nit->second.m_span != c_noSpan)
+					{
+						++it->second.m_spans[nit->second.m_span].m_retries;
+					}
+				}
+			}
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	if (nodeId == 0 || nodeId == 0xff)
+	{
+		return;
+	}
+
+	bool known = false;
+	{
+		SharedLockGuard guard(s_lock);
+		HomeMap::const_iterator it = s_homes.find(homeId);
+		if (it != s_homes.end() && it->second.m_done)
+		{
+			return;
+		}
+		known = it != s_homes.end();
+	}
+	if (!known)
+	{
+		// Profiling was enabled after the driver was ready
+		{
+			LockGuard guard(s_lock);
+			GetHome(homeId, now);
+		}
+		StartTimer();
+	}
+	Sample(homeId, nodeId);
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::OnTimer>
+//	Sample every node still being queried
+//-----------------------------------------------------------------------------
+VOID CALLBACK StartupProfiler::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	std::vector<std::pair<uint32, uint8> > pending;
+	{
+		SharedLockGuard guard(s_lock);
+		for (HomeMap::const_iterator it = s_homes.begin(); it != s_homes.end(); ++it)
+		{
+			if (it->second.m_done)
+			{
+				continue;
+			}
+			for (std::map<uint8, Node>::const_iterator nit = it->second.m_nodes.begin(); nit != it->second.m_nodes.end(); ++nit)
+			{
+				if (!nit->second.m_complete)
+				{
+					pending.push_back(std::make_pair(it->first, nit->first));
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		Sample(pending[i].first, pending[i].second);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::Sample>
+//	Read a node's stage from the Manager and record it
+//-----------------------------------------------------------------------------
+void StartupProfiler::Sample(uint32 _homeId, uint8 _nodeId)
+{
+	Manager* manager = Manager::Get();
+	if (manager == NULL)
+	{
+		return;
+	}
+
+	// The Manager is never called with s_lock held
+	QueryStage stage = ParseStage(manager->GetNodeQueryStage(_homeId, _nodeId));
+	uint64 now = GetTickCount64();
+
+	LockGuard guard(s_lock);
+	HomeMap::iterator it = s_homes.find(_homeId);
+	if (it != s_homes.end() && !it->second.m_done)
+	{
+		Record(it->second, _nodeId, stage, now);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::Record>
+//	Extend the node's open span, or close it and open one for a new stage
+//-----------------------------------------------------------------------------
+void StartupProfiler::Record(Home& _home, uint8 _nodeId, QueryStage _stage, uint64 _now)
+{
+	// A node the Manager does not know yet has no stage to record
+	std::map<uint8, Node>::iterator it = _home.m_nodes.find(_nodeId);
+	if (it == _home.m_nodes.end())
+	{
+		if (_stage == QueryStage_Unknown)
+		{
+			return;
+		}
+		Node empty;
+		empty.m_stage = QueryStage_Count;
+		empty.m_span = c_noSpan;
+		empty.m_completedAt = 0;
+		empty.m_complete = false;
+		std::fill(empty.m_seen, empty.m_seen + QueryStage_Count, false);
+		it = _home.m_nodes.insert(std::map<uint8, Node>::value_type(_nodeId, empty)).first;
+	}
+
+	Node& node = it->second;
+	uint64 time = _now > _home.m_start ? _now - _home.m_start : 0;
+	if (node.m_span != c_noSpan)
+	{
+		_home.m_spans[node.m_span].m_exit = time;
+	}
+	if (_stage == node.m_stage)
+	{
+		return;
+	}
+
+	if (node.m_span != c_noSpan)
+	{
+		_home.m_spans[node.m_span].m_open = false;
+		node.m_span = c_noSpan;
+	}
+	node.m_stage = _stage;
+
+	// Complete, None and Unknown are not stages the node spends time in
+	if (_stage == QueryStage_Complete)
+	{
+		node.m_complete = true;
+		node.m_completedAt = time;
+		return;
+	}
+	node.m_complete = false;
+	if (_stage == QueryStage_None || _stage == QueryStage_Unknown)
+	{
+		return;
+	}
+
+	QueryStageSpan span;
+	span.m_nodeId = _nodeId;
+	span.m_stage = _stage;
+	span.m_enter = time;
+	span.m_exit = time;
+	span.m_retries = node.m_seen[_stage] ? 1 : 0;
+	span.m_open = true;
+	node.m_seen[_stage] = true;
+	node.m_span = _home.m_spans.size();
+	_home.m_spans.push_back(span);
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::GetHome>
+//	The profile of a network, started now if there is none.  Needs s_lock.
+//-----------------------------------------------------------------------------
+StartupProfiler::Home& StartupProfiler::GetHome(uint32 _homeId, uint64 _now)
+{
+	HomeMap::iterator it = s_homes.find(_homeId);
+	if (it == s_homes.end())
+	{
+		Home home;
+		home.m_start = _now;
+		home.m_awakeNodesQueried = 0;
+		home.m_allNodesQueried = 0;
+		home.m_someDead = false;
+		home.m_done = false;
+		it = s_homes.insert(HomeMap::value_type(_homeId, home)).first;
+	}
+	return it->second;
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::StartTimer>
+//	Start sampling stages periodically, if it is not running already
+//-----------------------------------------------------------------------------
+void StartupProfiler::StartTimer()
+{
+	LockGuard guard(s_lock);
+	if (s_sampling || !s_enabled)
+	{
+		return;
+	}
+
+	if (s_timer == NULL)
+	{
+		s_timer = CreateThreadpoolTimer(OnTimer, NULL, NULL);
+	}
+	if (s_timer != NULL)
+	{
+		// Negative due times are relative, in 100ns units
+		ULARGE_INTEGER due;
+		due.QuadPart = (ULONGLONG)(-((LONGLONG)c_samplePeriodMs * 10000));
+		FILETIME dueTime;
+		dueTime.dwLowDateTime = due.LowPart;
+		dueTime.dwHighDateTime = due.HighPart;
+		SetThreadpoolTimer(s_timer, &dueTime, c_samplePeriodMs, 0);
+		s_sampling = true;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<StartupProfiler::StopTimerIfDone>
+//	Stop sampling once every network has been queried.  Called with s_lock
+//	held, so the timer is only cancelled, not waited for: a callback already
+//	running finds nothing left to sample.
+//-----------------------------------------------------------------------------
+void StartupProfiler::StopTimerIfDone()
+{
+	if (!s_sampling)
+	{
+		return;
+	}
+	for (HomeMap::const_iterator it = s_homes.begin(); it != s_homes.end(); ++it)
+	{
+		if (!it->second.m_done)
+		{
+			return;
+		}
+	}
+
+	SetThreadpoolTimer(s_timer, NULL, 0, 0);
+	s_sampling = false;
+}
@@ -0,0 +1,165 @@
+//-----------------------------------------------------------------------------
+//
+//      StartupProfiler.h
+//
+//      Timeline of the query stages each node goes through at startup
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// The stages of Node::QueryStage, named as GetNodeQueryStage returns them
+		enum QueryStage
+		{
+			QueryStage_ProtocolInfo = 0,
+			QueryStage_Probe,
+			QueryStage_WakeUp,
+			QueryStage_ManufacturerSpecific1,
+			QueryStage_NodeInfo,
+			QueryStage_NodePlusInfo,
+			QueryStage_SecurityReport,
+			QueryStage_ManufacturerSpecific2,
+			QueryStage_Versions,
+			QueryStage_Instances,
+			QueryStage_Static,
+			QueryStage_CacheLoad,
+			QueryStage_Probe1,
+			QueryStage_Associations,
+			QueryStage_Neighbors,
+			QueryStage_Session,
+			QueryStage_Dynamic,
+			QueryStage_Configuration,
+			QueryStage_Complete,
+			QueryStage_None,
+			QueryStage_Unknown,			// A name this wrapper does not know
+			QueryStage_Count
+		};
+
+		// Times are milliseconds since the profile started (DriverReady)
+		struct QueryStageSpan
+		{
+			uint8		m_nodeId;
+			QueryStage	m_stage;
+			uint64		m_enter;
+			uint64		m_exit;				// Last time seen in the stage while m_open
+			uint32		m_retries;			// Timeouts in the stage, and returns to it after leaving
+			bool		m_open;
+		};
+
+		struct NodeStartup
+		{
+			uint8		m_nodeId;
+			uint64		m_time;				// Until Complete, or until now
+			bool		m_complete;
+			QueryStage	m_slowestStage;
+			uint64		m_slowestTime;
+			uint32		m_retries;
+		};
+
+		struct StageStartup
+		{
+			QueryStage	m_stage;
+			uint64		m_time;				// Summed over every node
+			uint32		m_nodeCount;
+			uint32		m_retries;
+			uint8		m_slowestNodeId;
+			uint64		m_slowestTime;
+		};
+
+		struct StartupProfile
+		{
+			uint32						m_homeId;
+			uint64						m_elapsed;			// Until AllNodesQueried, or until now
+			uint64						m_awakeNodesQueried;	// 0 until reported
+			uint64						m_allNodesQueried;		// 0 until reported
+			bool						m_someDead;
+			std::vector<QueryStageSpan>	m_spans;			// By node, then by time
+			std::vector<NodeStartup>	m_nodes;			// Slowest first
+			std::vector<StageStartup>	m_stages;			// Most time first
+		};
+
+		// OpenZWave only reports a node's query stage as a string, and has no
+		// notification for stage changes.  While enabled, the profiler reads
+		// the stage of a node whenever a notification arrives for it, and of
+		// every node on a short timer until AllNodesQueried, and records each
+		// change as a span.  The timeline's resolution is the timer period.
+		// The timer stops once every network is done, and starts again when a
+		// driver is ready or reset.
+		class StartupProfiler
+		{
+		public:
+			static bool IsEnabled() { return s_enabled; }
+			static void SetEnabled(bool _enabled);
+
+			// Stop the timer before the manager is destroyed
+			static void Shutdown();
+
+			static bool GetProfile(uint32 _homeId, StartupProfile* o_profile);
+			static QueryStage ParseStage(std::string const& _name);
+
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			struct Node
+			{
+				QueryStage	m_stage;
+				size_t		m_span;				// Index of the open span, or npos
+				uint64		m_completedAt;
+				bool		m_complete;
+				bool		m_seen[QueryStage_Count];
+			};
+
+			struct Home
+			{
+				uint64					m_start;			// Tick count
+				uint64					m_awakeNodesQueried;
+				uint64					m_allNodesQueried;
+				bool					m_someDead;
+				bool					m_done;
+				std::map<uint8, Node>	m_nodes;
+				std::vector<QueryStageSpan>	m_spans;
+			};
+
+			typedef std::map<uint32, Home> HomeMap;
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+			static void Sample(uint32 _homeId, uint8 _nodeId);
+			static void Record(Home& _home, uint8 _nodeId, QueryStage _stage, uint64 _now);
+			static Home& GetHome(uint32 _homeId, uint64 _now);
+			static void StartTimer();
+			static void StopTimerIfDone();
+
+			static volatile bool	s_enabled;
+			static Lock				s_lock;
+			static HomeMap			s_homes;
+			static PTP_TIMER		s_timer;
+			static bool				s_sampling;			// s_timer is set to fire
+		};
+	}
+}
@@ -0,0 +1,247 @@
+//-----------------------------------------------------------------------------
+//
+//      Topology.cpp
+//
+//      Neighbor bitset matrix for a whole Z-Wave network
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "Topology.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+namespace
+{
+	uint32 CountBits(uint32 _word)
+	{
+		_word = _word - ((_word >> 1) & 0x55555555);
+		_word = (_word & 0x33333333) + ((_word >> 2) & 0x33333333);
+		return (((_word + (_word >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::Topology>
+//	Constructor
+//-----------------------------------------------------------------------------
+Topology::Topology() :
+	m_homeId(0)
+{
+	memset(m_rows, 0, sizeof(m_rows));
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::Build>
+//	Fill the matrix from OpenZWave's neighbor lists for every node
+//-----------------------------------------------------------------------------
+void Topology::Build(uint32 _homeId)
+{
+	m_homeId = _homeId;
+	memset(m_rows, 0, sizeof(m_rows));
+
+	Manager* manager = Manager::Get();
+	for (uint32 nodeId = 1; nodeId <= MaxNodes; ++nodeId)
+	{
+		uint8* neighbors = NULL;
+		uint32 numNeighbors = manager->GetNodeNeighbors(_homeId, (uint8)nodeId, &neighbors);
+		if (numNeighbors == 0)
+		{
+			continue;
+		}
+
+		uint32* row = m_rows[nodeId - 1];
+		for (uint32 i = 0; i < numNeighbors; ++i)
+		{
+			if (IsValid(neighbors[i]))
+			{
+				uint32 bit = neighbors[i] - 1;
+				row[bit >> 5] |= 1u << (bit & 31);
+			}
+		}
+		delete[] neighbors;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::IsNeighbor>
+//	Whether a node lists another node as its neighbor
+//-----------------------------------------------------------------------------
+bool Topology::IsNeighbor(uint8 _nodeId, uint8 _neighborId) const
+{
+	if (!IsValid(_nodeId) || !IsValid(_neighborId))
+	{
+		return false;
+	}
+
+	uint32 bit = _neighborId - 1;
+	return (m_rows[_nodeId - 1][bit >> 5] & (1u << (bit & 31))) != 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::GetDegree>
+//	Number of neighbors a node reports
+//-----------------------------------------------------------------------------
+uint32 Topology::GetDegree(uint8 _nodeId) const
+{
+	if (!IsValid(_nodeId))
+	{
+		return 0;
+	}
+
+	uint32 degree = 0;
+	uint32 const* row = m_rows[_nodeId - 1];
+	for (uint32 i = 0; i < RowWords; ++i)
+	{
+		degree += CountBits(row[i]);
+	}
+	return degree;
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::GetRow>
+//	Copy out the neighbor bitmap of a node
+//-----------------------------------------------------------------------------
+void Topology::GetRow(uint8 _nodeId, uint8* o_row) const
+{
+	if (!IsValid(_nodeId))
+	{
+		memset(o_row, 0, RowBytes);
+		return;
+	}
+
+	// Every Windows target is little endian, so the words already hold the
+	// bytes in routing table order.
+	memcpy(o_row, m_rows[_nodeId - 1], RowBytes);
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::GetHopCount>
+//	Hop count from one node to another
+//-----------------------------------------------------------------------------
+uint8 Topology::GetHopCount(uint8 _fromId, uint8 _toId) const
+{
+	if (!IsValid(_toId))
+	{
+		return Unreachable;
+	}
+	return Search(_fromId, _toId, NULL);
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::GetHopCounts>
+//	Hop count from one node to every node
+//-----------------------------------------------------------------------------
+void Topology::GetHopCounts(uint8 _fromId, uint8* o_hops) const
+{
+	Search(_fromId, 0, o_hops);
+}
+
+//-----------------------------------------------------------------------------
+//	<Topology::Search>
+//	Breadth first search over the bitsets.  Each level ORs together the rows
+//	of the frontier nodes and masks off the nodes already visited, so a level
+//	costs RowWords operations per frontier node.  Stops early when _toId is
+//	reached; fills o_hops (if given) for every node reached.
+//-----------------------------------------------------------------------------
+uint8 Topology::Search(uint8 _fromId, uint8 _toId, uint8* o_hops) const
+{
+	if (o_hops != NULL)
+	{
+		memset(o_hops, Unreachable, MaxNodes);
+	}
+	if (!IsValid(_fromId))
+	{
+		return Unreachable;
+	}
+
+	uint32 visited[RowWords] = { 0 };
+	uint32 frontier[RowWords] = { 0 };
+	uint32 start = _fromId - 1;
+	visited[start >> 5] = frontier[start >> 5] = 1u << (start & 31);
+	if (o_hops != NULL)
+	{
+		o_hops[start] = 0;
+	}
+	if (_toId == _fromId)
+	{
+		return 0;
+	}
+
+	for (uint32 hops = 1; hops < Unreachable; ++hops)
+	{
+		uint32 next[RowWords] = { 0 };
+		for (uint32 w = 0; w < RowWords; ++w)
+		{
+			uint32 word = frontier[w];
+			while (word != 0)
+			{
+				unsigned long b;
+				_BitScanForward(&b, word);
+				word &= word - 1;
+
+				uint32 const* row = m_rows[(w << 5) + b];
+				for (uint32 i = 0; i < RowWords; ++i)
+				{
+					next[i] |= row[i];
+				}
+			}
+		}
+
+		bool found = false;
+		for (uint32 i = 0; i < RowWords; ++i)
+		{
+			next[i] &= ~visited[i];
+			visited[i] |= next[i];
+			frontier[i] = next[i];
+			found = found || (next[i] != 0);
+		}
+		if (!found)
+		{
+			break;
+		}
+
+		if (o_hops != NULL)
+		{
+			for (uint32 w = 0; w < RowWords; ++w)
+			{
+				uint32 word = next[w];
+				while (word != 0)
+				{
+					unsigned long b;
+					_BitScanForward(&b, word);
+					word &= word - 1;
+					o_hops[(w << 5) + b] = (uint8)hops;
+				}
+			}
+		}
+
+		if (_toId != 0)
+		{
+			uint32 bit = _toId - 1;
+			if (next[bit >> 5] & (1u << (bit & 31)))
+			{
+				return (uint8)hops;
+			}
+		}
+	}
+	return Unreachable;
+}
@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+//
+//      Topology.h
+//
+//      Neighbor bitset matrix for a whole Z-Wave network
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Row n-1 holds the neighbor bitmap of node n, in the same layout as the
+		// Z-Wave routing table: node m is bit (m-1)%8 of byte (m-1)/8.  Rows are
+		// padded to whole 32-bit words so that the BFS can work a word at a time.
+		// Neighbor lists are reported by each node, so the matrix is not
+		// necessarily symmetric and the searches follow rows only.
+		class Topology
+		{
+		public:
+			enum
+			{
+				MaxNodes = NUM_NODE_BITFIELD_BYTES * 8,
+				RowBytes = NUM_NODE_BITFIELD_BYTES,
+				RowWords = (NUM_NODE_BITFIELD_BYTES + 3) / 4,
+				Unreachable = 0xff
+			};
+
+			Topology();
+
+			// Fill the matrix from OpenZWave's neighbor lists for every node
+			void Build(uint32 _homeId);
+
+			uint32 GetHomeId() const { return m_homeId; }
+
+			bool IsNeighbor(uint8 _nodeId, uint8 _neighborId) const;
+			uint32 GetDegree(uint8 _nodeId) const;
+			void GetRow(uint8 _nodeId, uint8* o_row) const;			// RowBytes bytes
+
+			// Hop count from one node to another, or Unreachable
+			uint8 GetHopCount(uint8 _fromId, uint8 _toId) const;
+
+			// Hop count from one node to every node, o_hops[n-1] for node n
+			void GetHopCounts(uint8 _fromId, uint8* o_hops) const;
+
+		private:
+			static bool IsValid(uint8 _nodeId) { return _nodeId >= 1 && _nodeId <= MaxNodes; }
+
+			uint8 Search(uint8 _fromId, uint8 _toId, uint8* o_hops) const;
+
+			uint32	m_homeId;
+			uint32	m_rows[MaxNodes][RowWords];
+		};
+	}
+}
@@ -0,0 +1,572 @@
+//-----------------------------------------------------------------------------
+//
+//      TrafficCounters.cpp
+//
+//      Messages, bytes, retries and latency per node and command class
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <cstring>
+#include "LogSink.h"
+#include "TrafficCounters.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+uint32 const TrafficCounters::c_latencyBounds[c_latencyBucketCount - 1] = { 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000 };
+
+volatile bool TrafficCounters::s_enabled = false;
+Lock TrafficCounters::s_readLock;
+Lock TrafficCounters::s_lock;
+TrafficCounters::EntryMap TrafficCounters::s_entries;
+std::vector<TrafficCounters::Home> TrafficCounters::s_homes;
+PTP_TIMER TrafficCounters::s_timer = NULL;
+uint32 TrafficCounters::s_intervalMs = TrafficCounters::c_defaultIntervalMs;
+uint32 TrafficCounters::s_frameHomeId = 0;
+TrafficCounters::Send TrafficCounters::s_sends[256];
+uint8 TrafficCounters::s_callbackNodes[256];
+
+namespace
+{
+	uint32 const c_maxNodes = 232;
+
+	// An answer later than the last bound is not taken to be one
+	int64 const c_maxWait = (int64)60000 * 10000;
+
+	uint64 Key(uint32 _homeId, uint8 _nodeId, uint8 _commandClassId)
+	{
+		return ((uint64)_homeId << 16) | ((uint64)_nodeId << 8) | _commandClassId;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::SetEnabled>
+//	Turn counting on or off.  Counts already made are kept.
+//-----------------------------------------------------------------------------
+void TrafficCounters::SetEnabled(bool _enabled)
+{
+	{
+		LockGuard guard(s_lock);
+		if (_enabled && !s_enabled)
+		{
+			// Each home's first read after this sets its baseline
+			for (size_t i = 0; i < s_homes.size(); ++i)
+			{
+				s_homes[i].m_sampled = false;
+			}
+			memset(s_sends, 0, sizeof(s_sends));
+		}
+		s_enabled = _enabled;
+	}
+
+	if (!_enabled)
+	{
+		StopTimer();
+		return;
+	}
+
+	// The frames come through the log sink's logger
+	if (Manager::Get() != NULL)
+	{
+		LogSink::Install();
+	}
+	StartTimer();
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::GetInterval>
+//	Milliseconds between reads of the node statistics
+//-----------------------------------------------------------------------------
+uint32 TrafficCounters::GetInterval()
+{
+	SharedLockGuard guard(s_lock);
+	return s_intervalMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::SetInterval>
+//	Change the time between reads of the node statistics
+//-----------------------------------------------------------------------------
+void TrafficCounters::SetInterval(uint32 _intervalMs)
+{
+	{
+		LockGuard guard(s_lock);
+		s_intervalMs = (_intervalMs > 0) ? _intervalMs : c_defaultIntervalMs;
+	}
+
+	// Restart the timer at the new period
+	StopTimer();
+	StartTimer();
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::Shutdown>
+//	Stop the timer and forget the drivers of a manager being destroyed
+//-----------------------------------------------------------------------------
+void TrafficCounters::Shutdown()
+{
+	StopTimer();
+
+	LockGuard guard(s_lock);
+	s_homes.clear();
+	s_frameHomeId = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::StopTimer>
+//	Stop reading the node statistics from the timer
+//-----------------------------------------------------------------------------
+void TrafficCounters::StopTimer()
+{
+	PTP_TIMER timer = NULL;
+	{
+		LockGuard guard(s_lock);
+		timer = s_timer;
+		s_timer = NULL;
+	}
+
+	// The callback takes s_lock, so wait for it outside
+	if (timer != NULL)
+	{
+		SetThreadpoolTimer(timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(timer, TRUE);
+		CloseThreadpoolTimer(timer);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::Reset>
+//	Forget a network's counts, and start again from the next read
+//-----------------------------------------------------------------------------
+void TrafficCounters::Reset(uint32 _homeId)
+{
+	LockGuard readGuard(s_readLock);
+	LockGuard guard(s_lock);
+	EntryMap::iterator first = s_entries.lower_bound(Key(_homeId, 0, 0));
+	EntryMap::iterator last = s_entries.upper_bound(Key(_homeId, 0xff, 0xff));
+	s_entries.erase(first, last);
+
+	for (size_t i = 0; i < s_homes.size(); ++i)
+	{
+		if (s_homes[i].m_homeId == _homeId)
+		{
+			s_homes[i].m_sampled = false;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::GetCounters>
+//	Copy a network's counters, by node and then by command class
+//-----------------------------------------------------------------------------
+void TrafficCounters::GetCounters(uint32 _homeId, std::vector<TrafficCounter>* o_counters)
+{
+	if (s_enabled)
+	{
+		Read();
+	}
+
+	o_counters->clear();
+	SharedLockGuard guard(s_lock);
+	EntryMap::const_iterator last = s_entries.upper_bound(Key(_homeId, 0xff, 0xff));
+	for (EntryMap::const_iterator it = s_entries.lower_bound(Key(_homeId, 0, 0)); it != last; ++it)
+	{
+		o_counters->push_back(it->second.m_counter);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::GetLastCounters>
+//	Copy the counters of several networks without reading the statistics
+//-----------------------------------------------------------------------------
+void TrafficCounters::GetLastCounters(std::vector<uint32> const& _homeIds, std::vector<TrafficCounter>* o_counters)
+{
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < _homeIds.size(); ++i)
+	{
+		EntryMap::const_iterator last = s_entries.upper_bound(Key(_homeIds[i], 0xff, 0xff));
+		for (EntryMap::const_iterator it = s_entries.lower_bound(Key(_homeIds[i], 0, 0)); it != last; ++it)
+		{
+			o_counters->push_back(it->second.m_counter);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::GetPercentile>
+//	Estimate a percentile of a histogram's round trips
+//-----------------------------------------------------------------------------
+uint32 TrafficCounters::GetPercentile(LatencyHistogram const& _histogram, uint32 _percent)
+{
+	if (_histogram.m_count == 0)
+	{
+		return 0;
+	}
+
+	uint64 rank = ((uint64)_histogram.m_count * _percent + 99) / 100;
+	uint64 seen = 0;
+	for (uint32 i = 0; i < c_latencyBucketCount - 1; ++i)
+	{
+		seen += _histogram.m_buckets[i];
+		if (seen >= rank)
+		{
+			return (c_latencyBounds[i] < _histogram.m_maxMs) ? c_latencyBounds[i] : _histogram.m_maxMs;
+		}
+	}
+	return _histogram.m_maxMs;
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::OnFrame>
+//	Count a frame parsed from the driver's log, and time the answers to the
+//	last SendData of each node
+//-----------------------------------------------------------------------------
+void TrafficCounters::OnFrame(FrameRecordHeader const& _header, uint8 const* _frame)
+{
+	if (_header.m_kind != FrameKind_Data)
+	{
+		return;
+	}
+
+	uint32 homeId = LogSink::GetHomeId();
+	if (homeId == 0)
+	{
+		return;
+	}
+
+	uint8 functionId = FrameFunctionId(_frame, _header.m_length);
+	bool request = FrameIsRequest(_frame, _header.m_length);
+
+	LockGuard guard(s_lock);
+	if (!s_enabled)
+	{
+		return;
+	}
+	if (homeId != s_frameHomeId)
+	{
+		s_frameHomeId = homeId;
+		memset(s_sends, 0, sizeof(s_sends));
+	}
+
+	if (_header.m_direction == FrameDirection_Sent)
+	{
+		if (functionId != c_frameFuncSendData || _header.m_nodeId == 0)
+		{
+			return;
+		}
+
+		TrafficCounter& counter = GetEntry(homeId, _header.m_nodeId, _header.m_commandClassId).m_counter;
+		++counter.m_framesSent;
+		counter.m_bytesSent += _header.m_length;
+		if (_header.m_attempt > 1)
+		{
+			++counter.m_retries;
+		}
+
+		// A resend is timed from the first attempt
+		Send& send = s_sends[_header.m_nodeId];
+		if (_header.m_attempt <= 1 || send.m_time == 0)
+		{
+			send.m_time = _header.m_time;
+		}
+		send.m_commandClassId = _header.m_commandClassId;
+		send.m_callbackId = _header.m_callbackId;
+		send.m_awaitingCallback = (_header.m_callbackId != 0);
+		send.m_awaitingResponse = true;
+		s_callbackNodes[_header.m_callbackId] = _header.m_nodeId;
+		return;
+	}
+
+	if (!request)
+	{
+		return;
+	}
+
+	if (functionId == c_frameFuncSendData && _header.m_callbackId != 0)
+	{
+		// The controller's callback: the node acknowledged, or the transmit failed
+		uint8 nodeId = s_callbackNodes[_header.m_callbackId];
+		Send& send = s_sends[nodeId];
+		if (nodeId != 0 && send.m_awaitingCallback && send.m_callbackId == _header.m_callbackId && _header.m_time - send.m_time <= c_maxWait)
+		{
+			Record(GetEntry(homeId, nodeId, send.m_commandClassId).m_counter.m_transmit, _header.m_time - send.m_time);
+		}
+		send.m_awaitingCallback = false;
+	}
+	else if (functionId == c_frameFuncApplicationCommand && _header.m_nodeId != 0)
+	{
+		TrafficCounter& counter = GetEntry(homeId, _header.m_nodeId, _header.m_commandClassId).m_counter;
+		++counter.m_framesReceived;
+		counter.m_bytesReceived += _header.m_length;
+
+		Send& send = s_sends[_header.m_nodeId];
+		if (send.m_awaitingResponse && send.m_commandClassId == _header.m_commandClassId)
+		{
+			if (_header.m_time - send.m_time <= c_maxWait)
+			{
+				Record(counter.m_response, _header.m_time - send.m_time);
+			}
+			send.m_awaitingResponse = false;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::OnNotification>
+//	Track the ready drivers, and count timeouts and values reported
+//-----------------------------------------------------------------------------
+void TrafficCounters::OnNotification(Notification const* _notification)
+{
+	uint32 homeId = _notification->GetHomeId();
+	switch (_notification->GetType())
+	{
+		case Notification::Type_DriverReady:
+		{
+			{
+				LockGuard guard(s_lock);
+				bool found = false;
+				for (size_t i = 0; i < s_homes.size(); ++i)
+				{
+					found = found || (s_homes[i].m_homeId == homeId);
+				}
+				if (!found)
+				{
+					Home home = { homeId, false };
+					s_homes.push_back(home);
+				}
+				if (!s_enabled)
+				{
+					return;
+				}
+			}
+
+			// A new manager has OpenZWave's logger again
+			LogSink::Install();
+			StartTimer();
+			break;
+		}
+		case Notification::Type_DriverRemoved:
+		case Notification::Type_DriverFailed:
+		{
+			LockGuard guard(s_lock);
+			for (size_t i = 0; i < s_homes.size(); ++i)
+			{
+				if (s_homes[i].m_homeId == homeId)
+				{
+					s_homes.erase(s_homes.begin() + i);
+					break;
+				}
+			}
+			break;
+		}
+		case Notification::Type_ValueChanged:
+		case Notification::Type_ValueRefreshed:
+		{
+			if (!s_enabled)
+			{
+				return;
+			}
+
+			LockGuard guard(s_lock);
+			++GetEntry(homeId, _notification->GetNodeId(), _notification->GetValueID().GetCommandClassId()).m_counter.m_reports;
+			break;
+		}
+		case Notification::Type_Notification:
+		{
+			if (!s_enabled || _notification->GetNotification() != Notification::Code_Timeout)
+			{
+				return;
+			}
+
+			// The notification does not say what timed out; the frames do, when they are for this driver
+			uint8 nodeId = _notification->GetNodeId();
+			LockGuard guard(s_lock);
+			uint8 commandClassId = 0;
+			if (homeId == s_frameHomeId && s_sends[nodeId].m_time != 0)
+			{
+				commandClassId = s_sends[nodeId].m_commandClassId;
+				s_sends[nodeId].m_awaitingCallback = false;
+				s_sends[nodeId].m_awaitingResponse = false;
+			}
+			++GetEntry(homeId, nodeId, commandClassId).m_counter.m_timeouts;
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK TrafficCounters::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	Read();
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::Read>
+//	Add what OpenZWave's message counts of each command class have grown by
+//	since the last read
+//-----------------------------------------------------------------------------
+void TrafficCounters::Read()
+{
+	Manager* manager = Manager::Get();
+	if (manager == NULL)
+	{
+		return;
+	}
+
+	// Two reads applied out of order would look like a driver restart
+	LockGuard readGuard(s_readLock);
+
+	std::vector<uint32> homeIds;
+	{
+		SharedLockGuard guard(s_lock);
+		for (size_t i = 0; i < s_homes.size(); ++i)
+		{
+			homeIds.push_back(s_homes[i].m_homeId);
+		}
+	}
+
+	for (size_t h = 0; h < homeIds.size(); ++h)
+	{
+		uint32 homeId = homeIds[h];
+
+		// The Manager is never called with s_lock held
+		std::vector<Sample> samples;
+		for (uint32 nodeId = 1; nodeId <= c_maxNodes; ++nodeId)
+		{
+			if (manager->GetNodeBasic(homeId, (uint8)nodeId) == 0)
+			{
+				continue;
+			}
+
+			Node::NodeData data;
+			manager->GetNodeStatistics(homeId, (uint8)nodeId, &data);
+			for (std::list<Node::CommandClassData>::const_iterator it = data.m_ccData.begin(); it != data.m_ccData.end(); ++it)
+			{
+				Sample sample = { (uint8)nodeId, it->m_commandClassId, it->m_sentCnt, it->m_receivedCnt };
+				samples.push_back(sample);
+			}
+		}
+
+		LockGuard guard(s_lock);
+		Home* home = NULL;
+		for (size_t i = 0; i < s_homes.size(); ++i)
+		{
+			if (s_homes[i].m_homeId == homeId)
+			{
+				home = &s_homes[i];
+			}
+		}
+		if (home == NULL || !s_enabled)
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < samples.size(); ++i)
+		{
+			Sample const& sample = samples[i];
+			Entry& entry = GetEntry(homeId, sample.m_nodeId, sample.m_commandClassId);
+			if (home->m_sampled)
+			{
+				// Counts only go backwards when the driver restarts
+				entry.m_counter.m_sent += (sample.m_sent >= entry.m_lastSent) ? sample.m_sent - entry.m_lastSent : sample.m_sent;
+				entry.m_counter.m_received += (sample.m_received >= entry.m_lastReceived) ? sample.m_received - entry.m_lastReceived : sample.m_received;
+			}
+			entry.m_lastSent = sample.m_sent;
+			entry.m_lastReceived = sample.m_received;
+		}
+		home->m_sampled = true;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::GetEntry>
+//	The counters of a node's command class, created empty.  Must be called
+//	with s_lock held.
+//-----------------------------------------------------------------------------
+TrafficCounters::Entry& TrafficCounters::GetEntry(uint32 _homeId, uint8 _nodeId, uint8 _commandClassId)
+{
+	uint64 key = Key(_homeId, _nodeId, _commandClassId);
+	EntryMap::iterator it = s_entries.lower_bound(key);
+	if (it == s_entries.end() || it->first != key)
+	{
+		Entry entry;
+		memset(&entry, 0, sizeof(entry));
+		entry.m_counter.m_homeId = _homeId;
+		entry.m_counter.m_nodeId = _nodeId;
+		entry.m_counter.m_commandClassId = _commandClassId;
+		it = s_entries.insert(it, EntryMap::value_type(key, entry));
+	}
+	return it->second;
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::Record>
+//	Add a round trip, in 100ns units, to a histogram
+//-----------------------------------------------------------------------------
+void TrafficCounters::Record(LatencyHistogram& _histogram, int64 _elapsed)
+{
+	uint32 ms = (_elapsed > 0) ? (uint32)(_elapsed / 10000) : 0;
+	uint32 bucket = 0;
+	while (bucket < c_latencyBucketCount - 1 && ms > c_latencyBounds[bucket])
+	{
+		++bucket;
+	}
+
+	++_histogram.m_buckets[bucket];
+	++_histogram.m_count;
+	_histogram.m_totalMs += ms;
+	if (ms > _histogram.m_maxMs)
+	{
+		_histogram.m_maxMs = ms;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<TrafficCounters::StartTimer>
+//	Read the node statistics periodically while enabled
+//-----------------------------------------------------------------------------
+void TrafficCounters::StartTimer()
+{
+	LockGuard guard(s_lock);
+	if (s_timer != NULL || !s_enabled)
+	{
+		return;
+	}
+
+	s_timer = CreateThreadpoolTimer(OnTimer, NULL, NULL);
+	if (s_timer != NULL)
+	{
+		// Negative due times are relative, in 100ns units
+		ULARGE_INTEGER due;
+		due.QuadPart = (ULONGLONG)(-((LONGLONG)s_intervalMs * 10000));
+		FILETIME dueTime;
+		dueTime.dwLowDateTime = due.LowPart;
+		dueTime.dwHighDateTime = due.HighPart;
+		SetThreadpoolTimer(s_timer, &dueTime, s_intervalMs, 0);
+	}
+}
@@ -0,0 +1,161 @@
+//-----------------------------------------------------------------------------
+//
+//      TrafficCounters.h
+//
+//      Messages, bytes, retries and latency per node and command class
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "FrameFormat.h"
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		uint32 const c_latencyBucketCount = 12;
+
+		struct LatencyHistogram
+		{
+			uint32	m_buckets[c_latencyBucketCount];	// Bucket i counts round trips up to TrafficCounters::c_latencyBounds[i]; the last has no bound
+			uint32	m_count;
+			uint64	m_totalMs;
+			uint32	m_maxMs;
+		};
+
+		struct TrafficCounter
+		{
+			uint32				m_homeId;
+			uint8				m_nodeId;
+			uint8				m_commandClassId;	// 0 for timeouts that could not be tied to a command class
+			uint64				m_sent;				// Messages, from OpenZWave's node statistics
+			uint64				m_received;
+			uint64				m_framesSent;		// SendData frames, from the driver's log
+			uint64				m_framesReceived;	// Application command frames
+			uint64				m_bytesSent;
+			uint64				m_bytesReceived;
+			uint64				m_retries;			// Frames sent again
+			uint64				m_timeouts;			// Timeout notifications
+			uint64				m_reports;			// Values changed or refreshed
+			LatencyHistogram	m_transmit;			// SendData to its callback, once the node acknowledged
+			LatencyHistogram	m_response;			// SendData to the node's next frame of the same command class
+		};
+
+		// Counters keyed by Home ID, node and command class, from three
+		// sources.  A threadpool timer reads OpenZWave's node statistics,
+		// which count the messages of each command class but nothing else.
+		// The frames FrameCapture parses from the driver's log give their
+		// size, their attempt, and the time to the callback and the answer;
+		// the log does not name the driver, so these are only counted while
+		// exactly one is ready.  Timeout and value notifications are counted
+		// as they arrive.  Counting starts when enabled.
+		class TrafficCounters
+		{
+		public:
+			static uint32 const c_defaultIntervalMs = 10000;
+			static uint32 const c_latencyBounds[c_latencyBucketCount - 1];	// Milliseconds
+
+			static bool IsEnabled() { return s_enabled; }
+			static void SetEnabled(bool _enabled);
+
+			// Milliseconds between reads of the node statistics
+			static uint32 GetInterval();
+			static void SetInterval(uint32 _intervalMs);
+
+			// Stop the timer before the manager is destroyed.  Counts are kept.
+			static void Shutdown();
+
+			static void Reset(uint32 _homeId);
+
+			// Reads the node statistics first, so the counts are current
+			static void GetCounters(uint32 _homeId, std::vector<TrafficCounter>* o_counters);
+
+			// The counters of several networks as of the timer's last read of
+			// the node statistics, without calling the Manager.  Appended to
+			// o_counters, which is not cleared.
+			static void GetLastCounters(std::vector<uint32> const& _homeIds, std::vector<TrafficCounter>* o_counters);
+
+			// The upper bound of the bucket holding a percentile, at most the maximum
+			static uint32 GetPercentile(LatencyHistogram const& _histogram, uint32 _percent);
+
+			static void OnFrame(FrameRecordHeader const& _header, uint8 const* _frame);
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			struct Entry
+			{
+				TrafficCounter	m_counter;
+				uint32			m_lastSent;			// OpenZWave's counts at the last read
+				uint32			m_lastReceived;
+			};
+
+			struct Home
+			{
+				uint32	m_homeId;
+				bool	m_sampled;					// The first read only sets the baseline
+			};
+
+			// The last SendData to a node, for the frames' driver
+			struct Send
+			{
+				int64	m_time;
+				uint8	m_commandClassId;
+				uint8	m_callbackId;
+				bool	m_awaitingCallback;
+				bool	m_awaitingResponse;
+			};
+
+			struct Sample
+			{
+				uint8	m_nodeId;
+				uint8	m_commandClassId;
+				uint32	m_sent;
+				uint32	m_received;
+			};
+
+			typedef std::map<uint64, Entry> EntryMap;
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+			static void Read();
+			static Entry& GetEntry(uint32 _homeId, uint8 _nodeId, uint8 _commandClassId);
+			static void Record(LatencyHistogram& _histogram, int64 _elapsed);
+			static void StartTimer();
+			static void StopTimer();
+
+			static volatile bool	s_enabled;
+
+			// Serialises reads of the node statistics
+			static Lock				s_readLock;
+
+			static Lock				s_lock;
+			static EntryMap			s_entries;
+			static std::vector<Home>	s_homes;			// Ready drivers
+			static PTP_TIMER		s_timer;
+			static uint32			s_intervalMs;
+			static uint32			s_frameHomeId;		// Driver s_sends belong to
+			static Send				s_sends[256];
+			static uint8			s_callbackNodes[256];	// Node of the last SendData with each callback ID
+		};
+	}
+}
@@ -0,0 +1,603 @@
+//-----------------------------------------------------------------------------
+//
+//      ValueHistory.cpp
+//
+//      Fixed-size ring of recent samples for every numeric value
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include <limits>
+#include "MemoryTracker.h"
+#include "ValueHistory.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HISTORY_SSE2 1
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#define HISTORY_NEON 1
+#endif
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool ValueHistory::s_enabled = false;
+uint32 ValueHistory::s_capacity = 256;
+Lock ValueHistory::s_lock;
+ValueHistory::HomeMap ValueHistory::s_homes;
+
+namespace
+{
+	// Fold a run of values into a running min, max and sum
+	void MinMaxSum(double const* _values, uint32 _count, double* io_min, double* io_max, double* io_sum)
+	{
+		uint32 i = 0;
+		double mn = *io_min;
+		double mx = *io_max;
+		double sum = *io_sum;
+
+#if HISTORY_SSE2
+		if (_count >= 4)
+		{
+			// Two independent accumulators hide the latency of addpd
+			__m128d vmin = _mm_set1_pd(mn);
+			__m128d vmax = _mm_set1_pd(mx);
+			__m128d vsum0 = _mm_setzero_pd();
+			__m128d vsum1 = _mm_setzero_pd();
+			for (; i + 4 <= _count; i += 4)
+			{
+				__m128d a = _mm_loadu_pd(_values + i);
+				__m128d b = _mm_loadu_pd(_values + i + 2);
+				vmin = _mm_min_pd(vmin, _mm_min_pd(a, b));
+				vmax = _mm_max_pd(vmax, _mm_max_pd(a, b));
+				vsum0 = _mm_add_pd(vsum0, a);
+				vsum1 = _mm_add_pd(vsum1, b);
+			}
+
+			double lanes[2];
+			_mm_storeu_pd(lanes, vmin);
+			mn = std::min(lanes[0], lanes[1]);
+			_mm_storeu_pd(lanes, vmax);
+			mx = std::max(lanes[0], lanes[1]);
+			_mm_storeu_pd(lanes, _mm_add_pd(vsum0, vsum1));
+			sum += lanes[0] + lanes[1];
+		}
+#elif HISTORY_NEON
+		if (_count >= 4)
+		{
+			float64x2_t vmin = vdupq_n_f64(mn);
+			float64x2_t vmax = vdupq_n_f64(mx);
+			float64x2_t vsum0 = vdupq_n_f64(0.0);
+			float64x2_t vsum1 = vdupq_n_f64(0.0);
+			for (; i + 4 <= _count; i += 4)
+			{
+				float64x2_t a = vld1q_f64(_values + i);
+				float64x2_t b = vld1q_f64(_values + i + 2);
+				vmin = vminq_f64(vmin, vminq_f64(a, b));
+				vmax = vmaxq_f64(vmax, vmaxq_f64(a, b));
+				vsum0 = vaddq_f64(vsum0, a);
+				vsum1 = vaddq_f64(vsum1, b);
+			}
+			mn = vminvq_f64(vmin);
+			mx = vmaxvq_f64(vmax);
+			sum += vaddvq_f64(vaddq_f64(vsum0, vsum1));
+		}
+#endif
+
+		for (; i < _count; ++i)
+		{
+			double value = _values[i];
+			mn = std::min(mn, value);
+			mx = std::max(mx, value);
+			sum += value;
+		}
+
+		*io_min = mn;
+		*io_max = mx;
+		*io_sum = sum;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::SetEnabled>
+//	Turn recording on or off
+//-----------------------------------------------------------------------------
+void ValueHistory::SetEnabled(bool _enabled)
+{
+	LockGuard guard(s_lock);
+	s_enabled = _enabled;
+	if (!_enabled)
+	{
+		EraseAll();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Shutdown>
+//	Drop every sample
+//-----------------------------------------------------------------------------
+void ValueHistory::Shutdown()
+{
+	LockGuard guard(s_lock);
+	EraseAll();
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::GetCapacity>
+//	Samples kept per value
+//-----------------------------------------------------------------------------
+uint32 ValueHistory::GetCapacity()
+{
+	SharedLockGuard guard(s_lock);
+	return s_capacity;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::SetCapacity>
+//	Change the samples kept per value, keeping the newest
+//-----------------------------------------------------------------------------
+void ValueHistory::SetCapacity(uint32 _capacity)
+{
+	if (_capacity == 0)
+	{
+		return;
+	}
+
+	LockGuard guard(s_lock);
+	s_capacity = _capacity;
+	for (HomeMap::iterator home = s_homes.begin(); home != s_homes.end(); ++home)
+	{
+		for (ValueMap::iterator it = home->second.begin(); it != home->second.end(); ++it)
+		{
+			Untrack(it->second, home->first);
+			Resize(it->second, _capacity);
+			Track(it->second, home->first);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::OnNotification>
+//	Record value changes, and forget removed values
+//-----------------------------------------------------------------------------
+void ValueHistory::OnNotification(Notification const* _notification)
+{
+	if (!s_enabled)
+	{
+		return;
+	}
+
+	switch (_notification->GetType())
+	{
+	case Notification::Type_ValueChanged:
+	{
+		ValueID const& valueId = _notification->GetValueID();
+		double value;
+		if (ReadValue(valueId, &value))
+		{
+			FILETIME now;
+			GetSystemTimeAsFileTime(&now);
+			Record(valueId, ((int64)now.dwHighDateTime << 32) | now.dwLowDateTime, value);
+		}
+		break;
+	}
+	case Notification::Type_ValueRemoved:
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator home = s_homes.find(_notification->GetHomeId());
+		if (home != s_homes.end())
+		{
+			ValueMap::iterator it = home->second.find(_notification->GetValueID().GetId());
+			if (it != home->second.end())
+			{
+				ValueMap::iterator next = it;
+				Erase(home, it, ++next);
+			}
+		}
+		break;
+	}
+	case Notification::Type_NodeRemoved:
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator home = s_homes.find(_notification->GetHomeId());
+		if (home != s_homes.end())
+		{
+			for (ValueMap::iterator it = home->second.begin(); it != home->second.end(); )
+			{
+				ValueMap::iterator next = it;
+				++next;
+				if (it->second.m_nodeId == _notification->GetNodeId())
+				{
+					Erase(home, it, next);
+				}
+				it = next;
+			}
+		}
+		break;
+	}
+	case Notification::Type_DriverRemoved:
+	{
+		LockGuard guard(s_lock);
+		HomeMap::iterator home = s_homes.find(_notification->GetHomeId());
+		if (home != s_homes.end())
+		{
+			Erase(home, home->second.begin(), home->second.end());
+			s_homes.erase(home);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Record>
+//	Add a sample, overwriting the oldest once the ring is full
+//-----------------------------------------------------------------------------
+void ValueHistory::Record(ValueID const& _valueId, int64 _time, double _value)
+{
+	LockGuard guard(s_lock);
+	if (!s_enabled)
+	{
+		return;
+	}
+
+	ValueMap& values = s_homes[_valueId.GetHomeId()];
+	ValueMap::iterator it = values.find(_valueId.GetId());
+	if (it == values.end())
+	{
+		Ring& ring = values[_valueId.GetId()];
+		ring.m_nodeId = _valueId.GetNodeId();
+		ring.m_start = 0;
+		ring.m_count = 0;
+		ring.m_times.resize(s_capacity);
+		ring.m_values.resize(s_capacity);
+		ring.m_trackedBytes = 0;
+		Track(ring, _valueId.GetHomeId());
+		it = values.find(_valueId.GetId());
+	}
+
+	Ring& ring = it->second;
+	uint32 capacity = (uint32)ring.m_times.size();
+	if (ring.m_count > 0)
+	{
+		int64 newest = ring.m_times[(ring.m_start + ring.m_count - 1) % capacity];
+		_time = std::max(_time, newest);
+	}
+
+	uint32 slot;
+	if (ring.m_count < capacity)
+	{
+		slot = (ring.m_start + ring.m_count) % capacity;
+		++ring.m_count;
+	}
+	else
+	{
+		slot = ring.m_start;
+		ring.m_start = (ring.m_start + 1) % capacity;
+	}
+	ring.m_times[slot] = _time;
+	ring.m_values[slot] = _value;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::GetSamples>
+//	Copy out the samples in a time range, oldest first
+//-----------------------------------------------------------------------------
+void ValueHistory::GetSamples(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, std::vector<int64>* o_times, std::vector<double>* o_values)
+{
+	o_times->clear();
+	o_values->clear();
+
+	SharedLockGuard guard(s_lock);
+	Ring const* ring = Find(_homeId, _valueId);
+	if (ring == NULL || _from >= _to)
+	{
+		return;
+	}
+
+	uint32 begin = LowerBound(*ring, _from);
+	uint32 end = LowerBound(*ring, _to);
+	uint32 capacity = (uint32)ring->m_times.size();
+	o_times->reserve(end - begin);
+	o_values->reserve(end - begin);
+
+	// At most two physical runs: up to the end of the buffer, then from its start
+	while (begin < end)
+	{
+		uint32 slot = (ring->m_start + begin) % capacity;
+		uint32 run = std::min(end - begin, capacity - slot);
+		o_times->insert(o_times->end(), ring->m_times.begin() + slot, ring->m_times.begin() + slot + run);
+		o_values->insert(o_values->end(), ring->m_values.begin() + slot, ring->m_values.begin() + slot + run);
+		begin += run;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Aggregate>
+//	Min, max, average and last value of each window of a time range
+//-----------------------------------------------------------------------------
+void ValueHistory::Aggregate(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, uint32 _windows, std::vector<HistoryAggregate>* o_aggregates)
+{
+	SplitRange(_from, _to, _windows, o_aggregates);
+	if (o_aggregates->empty())
+	{
+		return;
+	}
+
+	SharedLockGuard guard(s_lock);
+	Ring const* ring = Find(_homeId, _valueId);
+	if (ring == NULL)
+	{
+		return;
+	}
+
+	uint32 begin = LowerBound(*ring, _from);
+	for (size_t i = 0; i < o_aggregates->size(); ++i)
+	{
+		HistoryAggregate& aggregate = (*o_aggregates)[i];
+		uint32 end = LowerBound(*ring, aggregate.m_end);
+		Accumulate(*ring, begin, end, &aggregate);
+		begin = end;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::SplitRange>
+//	Zeroed, equal windows of a time range
+//-----------------------------------------------------------------------------
+void ValueHistory::SplitRange(int64 _from, int64 _to, uint32 _windows, std::vector<HistoryAggregate>* o_aggregates)
+{
+	o_aggregates->clear();
+	if (_windows == 0 || _from >= _to)
+	{
+		return;
+	}
+
+	// The caller's count is not trusted to size the result.  File times are
+	// in 100ns units, so a window is at least 10000 of them.
+	uint64 span = (uint64)_to - (uint64)_from;
+	uint64 limit = std::max<uint64>(span / 10000, 1);
+	uint32 windows = (uint32)std::min<uint64>(std::min<uint64>(_windows, MaxWindows), limit);
+
+	// span * i could overflow, so each boundary is the whole windows plus
+	// the spread remainder, which is less than windows * windows
+	uint64 width = span / windows;
+	uint64 remainder = span % windows;
+	o_aggregates->resize(windows);
+	for (uint32 i = 0; i < windows; ++i)
+	{
+		HistoryAggregate& aggregate = (*o_aggregates)[i];
+		memset(&aggregate, 0, sizeof(aggregate));
+		aggregate.m_start = (int64)((uint64)_from + width * i + remainder * i / windows);
+		aggregate.m_end = (int64)((uint64)_from + width * (i + 1) + remainder * (i + 1) / windows);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::ReadValue>
+//	The current value as a number, for the types that have one
+//-----------------------------------------------------------------------------
+bool ValueHistory::ReadValue(ValueID const& _valueId, double* o_value)
+{
+	Manager* manager = Manager::Get();
+	switch (_valueId.GetType())
+	{
+	case ValueID::ValueType_Bool:
+	case ValueID::ValueType_Button:
+	{
+		bool value;
+		if (!manager->GetValueAsBool(_valueId, &value))
+			return false;
+		*o_value = value ? 1.0 : 0.0;
+		return true;
+	}
+	case ValueID::ValueType_Byte:
+	{
+		uint8 value;
+		if (!manager->GetValueAsByte(_valueId, &value))
+			return false;
+		*o_value = value;
+		return true;
+	}
+	case ValueID::ValueType_Short:
+	{
+		int16 value;
+		if (!manager->GetValueAsShort(_valueId, &value))
+			return false;
+		*o_value = value;
+		return true;
+	}
+	case ValueID::ValueType_Int:
+	{
+		int32 value;
+		if (!manager->GetValueAsInt(_valueId, &value))
+			return false;
+		*o_value = value;
+		return true;
+	}
+	case ValueID::ValueType_Decimal:
+	{
+		float value;
+		if (!manager->GetValueAsFloat(_valueId, &value))
+			return false;
+		*o_value = value;
+		return true;
+	}
+	case ValueID::ValueType_List:
+	{
+		int32 value;
+		if (!manager->GetValueListSelection(_valueId, &value))
+			return false;
+		*o_value = value;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Find>
+//	The ring of a value, or NULL.  Must be called with s_lock held.
+//-----------------------------------------------------------------------------
+ValueHistory::Ring const* ValueHistory::Find(uint32 _homeId, uint64 _valueId)
+{
+	HomeMap::const_iterator home = s_homes.find(_homeId);
+	if (home == s_homes.end())
+	{
+		return NULL;
+	}
+	ValueMap::const_iterator it = home->second.find(_valueId);
+	return (it != home->second.end()) ? &it->second : NULL;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::LowerBound>
+//	Position, oldest first, of the first sample at or after a time
+//-----------------------------------------------------------------------------
+uint32 ValueHistory::LowerBound(Ring const& _ring, int64 _time)
+{
+	uint32 capacity = (uint32)_ring.m_times.size();
+	uint32 low = 0;
+	uint32 high = _ring.m_count;
+	while (low < high)
+	{
+		uint32 mid = low + (high - low) / 2;
+		if (_ring.m_times[(_ring.m_start + mid) % capacity] < _time)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Accumulate>
+//	Aggregate the samples at positions [_begin, _end), oldest first
+//-----------------------------------------------------------------------------
+void ValueHistory::Accumulate(Ring const& _ring, uint32 _begin, uint32 _end, HistoryAggregate* o_aggregate)
+{
+	if (_begin >= _end)
+	{
+		return;
+	}
+
+	uint32 capacity = (uint32)_ring.m_values.size();
+	double mn = std::numeric_limits<double>::infinity();
+	double mx = -std::numeric_limits<double>::infinity();
+	double sum = 0.0;
+	o_aggregate->m_count = _end - _begin;
+	o_aggregate->m_last = _ring.m_values[(_ring.m_start + _end - 1) % capacity];
+
+	while (_begin < _end)
+	{
+		uint32 slot = (_ring.m_start + _begin) % capacity;
+		uint32 run = std::min(_end - _begin, capacity - slot);
+		MinMaxSum(&_ring.m_values[slot], run, &mn, &mx, &sum);
+		_begin += run;
+	}
+
+	o_aggregate->m_min = mn;
+	o_aggregate->m_max = mx;
+	o_aggregate->m_average = sum / o_aggregate->m_count;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Resize>
+//	Change the capacity of a ring, keeping the newest samples in order
+//-----------------------------------------------------------------------------
+void ValueHistory::Resize(Ring& _ring, uint32 _capacity)
+{
+	uint32 capacity = (uint32)_ring.m_times.size();
+	uint32 keep = std::min(_ring.m_count, _capacity);
+	std::vector<int64> times(_capacity);
+	std::vector<double> values(_capacity);
+	for (uint32 i = 0; i < keep; ++i)
+	{
+		uint32 slot = (_ring.m_start + _ring.m_count - keep + i) % capacity;
+		times[i] = _ring.m_times[slot];
+		values[i] = _ring.m_values[slot];
+	}
+
+	_ring.m_times.swap(times);
+	_ring.m_values.swap(values);
+	_ring.m_start = 0;
+	_ring.m_count = keep;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Track>
+//	Report the memory of a ring to the memory report, if it is enabled
+//-----------------------------------------------------------------------------
+void ValueHistory::Track(Ring& _ring, uint32 _homeId)
+{
+	if (MemoryTracker::IsEnabled())
+	{
+		_ring.m_trackedBytes = (int64)_ring.m_times.size() * (sizeof(int64) + sizeof(double));
+		MemoryTracker::AddNativeBytes(_homeId, _ring.m_nodeId, _ring.m_trackedBytes);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Untrack>
+//	Take back whatever Track reported for a ring
+//-----------------------------------------------------------------------------
+void ValueHistory::Untrack(Ring& _ring, uint32 _homeId)
+{
+	if (_ring.m_trackedBytes != 0)
+	{
+		MemoryTracker::AddNativeBytes(_homeId, _ring.m_nodeId, -_ring.m_trackedBytes);
+		_ring.m_trackedBytes = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::Erase>
+//	Drop a range of rings of one home.  Must be called with s_lock held.
+//-----------------------------------------------------------------------------
+void ValueHistory::Erase(HomeMap::iterator _home, ValueMap::iterator _begin, ValueMap::iterator _end)
+{
+	for (ValueMap::iterator it = _begin; it != _end; ++it)
+	{
+		Untrack(it->second, _home->first);
+	}
+	_home->second.erase(_begin, _end);
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueHistory::EraseAll>
+//	Drop every ring.  Must be called with s_lock held.
+//-----------------------------------------------------------------------------
+void ValueHistory::EraseAll()
+{
+	for (HomeMap::iterator home = s_homes.begin(); home != s_homes.end(); ++home)
+	{
+		Erase(home, home->second.begin(), home->second.end());
+	}
+	s_homes.clear();
+}
@@ -0,0 +1,116 @@
+//-----------------------------------------------------------------------------
+//
+//      ValueHistory.h
+//
+//      Fixed-size ring of recent samples for every numeric value
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		struct HistoryAggregate
+		{
+			int64	m_start;			// Window, as UTC file times
+			int64	m_end;
+			uint32	m_count;			// Samples in the window; the rest is 0 if there are none
+			double	m_min;
+			double	m_max;
+			double	m_average;
+			double	m_last;
+		};
+
+		// Keeps the last samples of every bool, byte, short, int, decimal and
+		// list value, recorded from ValueChanged.  Times and values are stored
+		// in separate arrays, so that a time range is one or two contiguous
+		// runs of doubles that the aggregation can scan with SIMD.  Recording
+		// is skipped while the history is disabled, so the only cost in normal
+		// use is one flag test.
+		class ValueHistory
+		{
+		public:
+			static bool IsEnabled() { return s_enabled; }
+			static void SetEnabled(bool _enabled);			// Disabling drops every sample
+			static void Shutdown();							// Drops every sample, keeps the settings
+
+			// Samples kept per value.  Changing it keeps the newest samples.
+			static uint32 GetCapacity();
+			static void SetCapacity(uint32 _capacity);
+
+			static void OnNotification(Notification const* _notification);
+
+			// The current value as a number: bools and buttons are 0 or 1, and
+			// lists give the value of the selected item.  False for other types.
+			static bool ReadValue(ValueID const& _valueId, double* o_value);
+
+			// Add a sample.  Times earlier than the newest sample are moved up to
+			// it, so each ring stays in time order.
+			static void Record(ValueID const& _valueId, int64 _time, double _value);
+
+			// The samples in [_from, _to), oldest first
+			static void GetSamples(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, std::vector<int64>* o_times, std::vector<double>* o_values);
+
+			// [_from, _to) split into _windows equal windows.  There are at most
+			// MaxWindows windows, and none shorter than a millisecond.
+			static void Aggregate(uint32 _homeId, uint64 _valueId, int64 _from, int64 _to, uint32 _windows, std::vector<HistoryAggregate>* o_aggregates);
+
+			// Zeroed windows of [_from, _to), clamped as for Aggregate.  Shared
+			// with HistoryLogReader.
+			static void SplitRange(int64 _from, int64 _to, uint32 _windows, std::vector<HistoryAggregate>* o_aggregates);
+
+			enum { MaxWindows = 10000 };
+
+		private:
+			struct Ring
+			{
+				uint8				m_nodeId;
+				uint32				m_start;		// Physical index of the oldest sample
+				uint32				m_count;
+				std::vector<int64>	m_times;
+				std::vector<double>	m_values;
+				int64				m_trackedBytes;	// Reported to MemoryTracker
+			};
+
+			typedef std::map<uint64, Ring> ValueMap;
+			typedef std::map<uint32, ValueMap> HomeMap;
+
+			static Ring const* Find(uint32 _homeId, uint64 _valueId);
+			static uint32 LowerBound(Ring const& _ring, int64 _time);
+			static void Accumulate(Ring const& _ring, uint32 _begin, uint32 _end, HistoryAggregate* o_aggregate);
+			static void Resize(Ring& _ring, uint32 _capacity);
+			static void Track(Ring& _ring, uint32 _homeId);
+			static void Untrack(Ring& _ring, uint32 _homeId);
+			static void Erase(HomeMap::iterator _home, ValueMap::iterator _begin, ValueMap::iterator _end);
+			static void EraseAll();
+
+			static volatile bool	s_enabled;
+			static uint32			s_capacity;
+			static Lock				s_lock;
+			static HomeMap			s_homes;
+		};
+	}
+}
@@ -0,0 +1,299 @@
+//-----------------------------------------------------------------------------
+//
+//      ValueKeys.cpp
+//
+//      Dense integer keys for values that persist across restarts
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "FileMapping.h"
+#include "ValueKeys.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+volatile bool ValueKeys::s_open = false;
+Lock ValueKeys::s_lock;
+HANDLE ValueKeys::s_file = INVALID_HANDLE_VALUE;
+std::vector<ValueKeys::Record> ValueKeys::s_records;
+ValueKeys::KeyMap ValueKeys::s_keys;
+uint32 ValueKeys::s_saved = 0;
+
+namespace
+{
+	uint32 const c_keysMagic = 0x4B565A4F;		// "OZVK"
+	uint32 const c_keysVersion = 1;
+
+	struct KeysHeader
+	{
+		uint32	m_magic;
+		uint32	m_version;
+	};
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::Open>
+//	Load the key file, and keep it open to append new keys
+//-----------------------------------------------------------------------------
+bool ValueKeys::Open(std::wstring const& _path)
+{
+	Close();
+
+	HANDLE file = OpenFileHandle(_path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, OPEN_ALWAYS);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	std::vector<Record> records;
+	KeysHeader header;
+	if ((uint64)size.QuadPart == 0)
+	{
+		header.m_magic = c_keysMagic;
+		header.m_version = c_keysVersion;
+		DWORD written = 0;
+		if (!WriteFile(file, &header, sizeof(header), &written, NULL) || written != sizeof(header))
+		{
+			CloseHandle(file);
+			return false;
+		}
+	}
+	else
+	{
+		HANDLE mapping = NULL;
+		uint8 const* data = ((uint64)size.QuadPart >= sizeof(header)) ? MapFileReadOnly(file, &mapping) : NULL;
+		bool valid = false;
+		if (data != NULL)
+		{
+			memcpy(&header, data, sizeof(header));
+			valid = header.m_magic == c_keysMagic && header.m_version == c_keysVersion;
+			if (valid)
+			{
+				// A record cut short by a crash is dropped, and its key given out again
+				size_t count = (size_t)(((uint64)size.QuadPart - sizeof(header)) / sizeof(Record));
+				records.resize(count);
+				if (count != 0)
+				{
+					memcpy(&records[0], data + sizeof(header), count * sizeof(Record));
+				}
+			}
+			UnmapViewOfFile(data);
+		}
+		if (mapping != NULL)
+		{
+			CloseHandle(mapping);
+		}
+
+		LARGE_INTEGER end;
+		end.QuadPart = (LONGLONG)(sizeof(header) + records.size() * sizeof(Record));
+		if (!valid || !SetFilePointerEx(file, end, NULL, FILE_BEGIN) || !SetEndOfFile(file))
+		{
+			CloseHandle(file);
+			return false;
+		}
+	}
+
+	LockGuard guard(s_lock);
+	s_file = file;
+	s_records.swap(records);
+	s_saved = (uint32)s_records.size();
+	for (uint32 i = 0; i < (uint32)s_records.size(); ++i)
+	{
+		ValueID valueId = ToValueID(s_records[i]);
+		s_keys.insert(KeyMap::value_type(ValueKey(valueId.GetHomeId(), valueId.GetId()), i + 1));
+	}
+	s_open = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::Close>
+//	Close the key file and forget every key
+//-----------------------------------------------------------------------------
+void ValueKeys::Close()
+{
+	LockGuard guard(s_lock);
+	s_open = false;
+	if (s_file != INVALID_HANDLE_VALUE)
+	{
+		// Reserved keys were never given out, but saving them keeps the
+		// order the values were added in
+		Save();
+		CloseHandle(s_file);
+		s_file = INVALID_HANDLE_VALUE;
+	}
+	s_records.clear();
+	s_keys.clear();
+	s_saved = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::GetKey>
+//	The key of a value, saving it to the file first if it is new
+//-----------------------------------------------------------------------------
+uint32 ValueKeys::GetKey(ValueID const& _valueId)
+{
+	ValueKey valueKey(_valueId.GetHomeId(), _valueId.GetId());
+	{
+		SharedLockGuard guard(s_lock);
+		KeyMap::const_iterator it = s_keys.find(valueKey);
+		if (it != s_keys.end() && it->second <= s_saved)
+		{
+			return it->second;
+		}
+	}
+
+	LockGuard guard(s_lock);
+	if (s_file == INVALID_HANDLE_VALUE)
+	{
+		return 0;
+	}
+
+	// Another thread may have added or saved it since the shared lock was
+	// released
+	uint32 key = Reserve(valueKey, _valueId);
+	if (key > s_saved && !Save())
+	{
+		return 0;
+	}
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::GetValueID>
+//	The value a key was given to
+//-----------------------------------------------------------------------------
+bool ValueKeys::GetValueID(uint32 _key, ValueID* o_valueId)
+{
+	SharedLockGuard guard(s_lock);
+	if (_key == 0 || _key > s_saved)
+	{
+		return false;
+	}
+
+	*o_valueId = ToValueID(s_records[_key - 1]);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::GetCount>
+//	Number of keys given out
+//-----------------------------------------------------------------------------
+uint32 ValueKeys::GetCount()
+{
+	SharedLockGuard guard(s_lock);
+	return s_saved;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::OnNotification>
+//	Reserve a key for each value as it is added.  Nothing is written on
+//	the notification thread; the key is saved when it is first given out.
+//-----------------------------------------------------------------------------
+void ValueKeys::OnNotification(Notification const* _notification)
+{
+	if (_notification->GetType() == Notification::Type_ValueAdded && s_open)
+	{
+		ValueID valueId = _notification->GetValueID();
+		LockGuard guard(s_lock);
+		if (s_file != INVALID_HANDLE_VALUE)
+		{
+			Reserve(ValueKey(valueId.GetHomeId(), valueId.GetId()), valueId);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::Reserve>
+//	The key of a value, taking the next one if it has none.  Called with
+//	s_lock held exclusively.
+//-----------------------------------------------------------------------------
+uint32 ValueKeys::Reserve(ValueKey const& _valueKey, ValueID const& _valueId)
+{
+	KeyMap::const_iterator it = s_keys.find(_valueKey);
+	if (it != s_keys.end())
+	{
+		return it->second;
+	}
+
+	Record record;
+	record.m_homeId = _valueId.GetHomeId();
+	record.m_nodeId = _valueId.GetNodeId();
+	record.m_genre = (uint8)_valueId.GetGenre();
+	record.m_commandClassId = _valueId.GetCommandClassId();
+	record.m_instance = _valueId.GetInstance();
+	record.m_index = _valueId.GetIndex();
+	record.m_type = (uint8)_valueId.GetType();
+	record.m_reserved = 0;
+
+	s_records.push_back(record);
+	uint32 key = (uint32)s_records.size();
+	s_keys.insert(KeyMap::value_type(_valueKey, key));
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::Save>
+//	Append every reserved key to the file and flush it to disk.  Called
+//	with s_lock held exclusively.
+//-----------------------------------------------------------------------------
+bool ValueKeys::Save()
+{
+	if (s_saved == (uint32)s_records.size())
+	{
+		return true;
+	}
+
+	// A key is only given out once it is on disk, so a power loss cannot
+	// lose one a caller has stored.  Records partly written are cut off, and
+	// written again by the next call.
+	DWORD length = (DWORD)((s_records.size() - s_saved) * sizeof(Record));
+	DWORD written = 0;
+	if (!WriteFile(s_file, &s_records[s_saved], length, &written, NULL) || written != length || !FlushFileBuffers(s_file))
+	{
+		LARGE_INTEGER end;
+		end.QuadPart = (LONGLONG)(sizeof(KeysHeader) + s_saved * sizeof(Record));
+		if (SetFilePointerEx(s_file, end, NULL, FILE_BEGIN))
+		{
+			SetEndOfFile(s_file);
+		}
+		return false;
+	}
+
+	s_saved = (uint32)s_records.size();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ValueKeys::ToValueID>
+//	Rebuild a value's ID from its record
+//-----------------------------------------------------------------------------
+ValueID ValueKeys::ToValueID(Record const& _record)
+{
+	return ValueID(_record.m_homeId, _record.m_nodeId, (ValueID::ValueGenre)_record.m_genre, _record.m_commandClassId, _record.m_instance, _record.m_index, (ValueID::ValueType)_record.m_type);
+}
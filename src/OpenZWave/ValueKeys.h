@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------
+//
+//      ValueKeys.h
+//
+//      Dense integer keys for values that persist across restarts
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Gives every value a key from 1 up, in the order the values are first
+		// seen, and keeps the keys in a file so that a value gets the same key
+		// after a restart.  The file is an 8 byte header followed by one fixed
+		// size record per key, holding the parts of the value's ID (home, node,
+		// genre, command class, instance, index and type), so keys do not
+		// depend on how OpenZWave packs them into ValueID::GetId.  It is read
+		// with a single mapping when opened.
+		//
+		// ValueAdded only reserves the next key in memory, so the notification
+		// thread does no file I/O.  A key is given out, by GetKey, only once
+		// it and every key reserved before it have been appended and flushed
+		// to disk, so a key a caller holds survives a power loss.  Keys that
+		// were reserved but never given out can be lost, and their values may
+		// then get other keys after a restart.  Keys are never reused, so a
+		// store can index an array by them.
+		class ValueKeys
+		{
+		public:
+			// Load the key file, creating it if it does not exist.  False if it
+			// could not be opened or is not a key file.
+			static bool Open(std::wstring const& _path);
+			static void Close();
+			static bool IsOpen() { return s_open; }
+
+			// The key of a value, giving it the next key if it has none.  0 if
+			// no key file is open, or the key could not be saved.
+			static uint32 GetKey(ValueID const& _valueId);
+
+			// The value with a key.  False if the key has not been given out.
+			static bool GetValueID(uint32 _key, ValueID* o_valueId);
+
+			// Keys saved so far; every key up to this is in use
+			static uint32 GetCount();
+
+			// Reserve keys for values as they are added
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			struct Record
+			{
+				uint32	m_homeId;
+				uint8	m_nodeId;
+				uint8	m_genre;
+				uint8	m_commandClassId;
+				uint8	m_instance;
+				uint16	m_index;
+				uint8	m_type;
+				uint8	m_reserved;
+			};
+
+			typedef std::pair<uint32, uint64> ValueKey;
+			typedef std::map<ValueKey, uint32> KeyMap;
+
+			static uint32 Reserve(ValueKey const& _valueKey, ValueID const& _valueId);
+			static bool Save();
+			static ValueID ToValueID(Record const& _record);
+
+			static volatile bool	s_open;
+			static Lock				s_lock;
+			static HANDLE			s_file;
+			static std::vector<Record>	s_records;		// Indexed by key - 1
+			static KeyMap			s_keys;
+			static uint32			s_saved;		// Records on disk; the rest are reserved
+		};
+	}
+}
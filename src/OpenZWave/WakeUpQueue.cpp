@@ -0,0 +1,436 @@
+//-----------------------------------------------------------------------------
+//
+//      WakeUpQueue.cpp
+//
+//      Coalescing store for commands aimed at sleeping nodes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include <algorithm>
+#include "WakeUpQueue.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Native;
+
+Lock WakeUpQueue::s_lock;
+std::vector<WakeUpQueue*> WakeUpQueue::s_queues;
+
+namespace
+{
+	// Whether a new command should replace a held one
+	bool SameTarget(PendingCommand const& _a, PendingCommand const& _b)
+	{
+		if (_a.m_kind != _b.m_kind || _a.m_nodeId != _b.m_nodeId)
+		{
+			return false;
+		}
+
+		switch (_a.m_kind)
+		{
+		case PendingKind_ConfigParam:
+			return _a.m_index == _b.m_index;
+		case PendingKind_Association:
+			return _a.m_index == _b.m_index && _a.m_targetNodeId == _b.m_targetNodeId;
+		default:
+			return _a.m_valueId == _b.m_valueId;
+		}
+	}
+
+	// Node by node; within a node configuration, then associations with
+	// removals first, then values
+	bool FlushOrder(PendingCommand const& _a, PendingCommand const& _b)
+	{
+		if (_a.m_nodeId != _b.m_nodeId)
+			return _a.m_nodeId < _b.m_nodeId;
+		if (_a.m_kind != _b.m_kind)
+			return _a.m_kind < _b.m_kind;
+		if (_a.m_remove != _b.m_remove)
+			return _a.m_remove;
+		if (_a.m_index != _b.m_index)
+			return _a.m_index < _b.m_index;
+		if (_a.m_targetNodeId != _b.m_targetNodeId)
+			return _a.m_targetNodeId < _b.m_targetNodeId;
+		return _a.m_valueId < _b.m_valueId;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::WakeUpQueue>
+//	Constructor
+//-----------------------------------------------------------------------------
+WakeUpQueue::WakeUpQueue(uint32 _homeId, pfnOnCommandSent_t _callback, void* _context) :
+	m_homeId(_homeId),
+	m_callback(_callback),
+	m_context(_context)
+{
+	memset(m_flush, 0, sizeof(m_flush));
+	memset(m_wakes, 0, sizeof(m_wakes));
+	m_timer = CreateThreadpoolTimer(OnTimer, this, NULL);
+
+	LockGuard guard(s_lock);
+	s_queues.push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::~WakeUpQueue>
+//	Destructor.  Held commands are dropped.  Must not be called from the callback.
+//-----------------------------------------------------------------------------
+WakeUpQueue::~WakeUpQueue()
+{
+	{
+		LockGuard guard(s_lock);
+		s_queues.erase(std::remove(s_queues.begin(), s_queues.end(), this), s_queues.end());
+	}
+
+	if (m_timer != NULL)
+	{
+		SetThreadpoolTimer(m_timer, NULL, 0, 0);
+		WaitForThreadpoolTimerCallbacks(m_timer, TRUE);
+		CloseThreadpoolTimer(m_timer);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::Submit>
+//	Send a command to an awake node, or hold it until the node wakes up
+//-----------------------------------------------------------------------------
+SubmitResult WakeUpQueue::Submit(PendingCommand const& _command)
+{
+	uint8 nodeId = _command.m_nodeId;
+	if (nodeId == 0 || nodeId > MaxNodes)
+	{
+		return SubmitResult_Failed;
+	}
+
+	// OpenZWave is not called with m_lock held, so the node's state is read
+	// between two holds of it.  A wake-up handled in between changes the
+	// node's wake count, and the node is then taken to be awake.
+	uint32 wakes;
+	{
+		LockGuard guard(m_lock);
+		wakes = m_wakes[nodeId - 1];
+	}
+	bool asleep = IsAsleep(nodeId);
+	uint64 now = GetTickCount64();
+	{
+		LockGuard guard(m_lock);
+		if (m_wakes[nodeId - 1] != wakes)
+		{
+			asleep = false;
+		}
+
+		// While a node still has commands held, new ones join them so that
+		// they cannot overtake the older ones
+		std::vector<PendingCommand>& pending = m_pending[nodeId - 1];
+		if (asleep || !pending.empty())
+		{
+			SubmitResult result = SubmitResult_Queued;
+			std::vector<PendingCommand>::iterator it = pending.begin();
+			for (; it != pending.end(); ++it)
+			{
+				if (SameTarget(*it, _command))
+				{
+					break;
+				}
+			}
+
+			if (it != pending.end())
+			{
+				uint64 queuedAt = it->m_queuedAt;
+				uint32 writes = it->m_writes;
+				*it = _command;
+				it->m_queuedAt = queuedAt;
+				it->m_writes = writes + 1;
+				result = SubmitResult_Coalesced;
+			}
+			else
+			{
+				pending.push_back(_command);
+				pending.back().m_queuedAt = now;
+				pending.back().m_writes = 1;
+			}
+
+			if (!asleep)
+			{
+				m_flush[nodeId - 1] = true;
+				Schedule();
+			}
+			return result;
+		}
+	}
+
+	std::vector<PendingCommand> commands(1, _command);
+	commands[0].m_queuedAt = now;
+	commands[0].m_writes = 1;
+	return Send(commands) == 1 ? SubmitResult_Sent : SubmitResult_Failed;
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::GetPending>
+//	Commands held for a node, or for every node, in the order they will be sent
+//-----------------------------------------------------------------------------
+void WakeUpQueue::GetPending(uint8 _nodeId, std::vector<PendingCommand>* o_pending)
+{
+	o_pending->clear();
+	{
+		LockGuard guard(m_lock);
+		for (uint32 i = 0; i < MaxNodes; ++i)
+		{
+			if (_nodeId == 0 || _nodeId == i + 1)
+			{
+				o_pending->insert(o_pending->end(), m_pending[i].begin(), m_pending[i].end());
+			}
+		}
+	}
+	std::sort(o_pending->begin(), o_pending->end(), FlushOrder);
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::GetPendingCount>
+//	Number of commands held for every node
+//-----------------------------------------------------------------------------
+uint32 WakeUpQueue::GetPendingCount()
+{
+	LockGuard guard(m_lock);
+	uint32 count = 0;
+	for (uint32 i = 0; i < MaxNodes; ++i)
+	{
+		count += (uint32)m_pending[i].size();
+	}
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::Flush>
+//	Send a node's held commands now.  For a node that is still asleep they
+//	go to OpenZWave's own wake-up queue, uncoalesced from then on.
+//-----------------------------------------------------------------------------
+void WakeUpQueue::Flush(uint8 _nodeId)
+{
+	if (_nodeId == 0 || _nodeId > MaxNodes)
+	{
+		return;
+	}
+
+	std::vector<PendingCommand> commands;
+	{
+		LockGuard guard(m_lock);
+		commands.swap(m_pending[_nodeId - 1]);
+		m_flush[_nodeId - 1] = false;
+	}
+	std::sort(commands.begin(), commands.end(), FlushOrder);
+	Send(commands);
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::Cancel>
+//	Drop a node's held commands
+//-----------------------------------------------------------------------------
+uint32 WakeUpQueue::Cancel(uint8 _nodeId)
+{
+	if (_nodeId == 0 || _nodeId > MaxNodes)
+	{
+		return 0;
+	}
+
+	LockGuard guard(m_lock);
+	uint32 count = (uint32)m_pending[_nodeId - 1].size();
+	m_pending[_nodeId - 1].clear();
+	m_flush[_nodeId - 1] = false;
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::OnNotification>
+//	Forward OpenZWave notifications to every live queue
+//-----------------------------------------------------------------------------
+void WakeUpQueue::OnNotification(Notification const* _notification)
+{
+	Notification::NotificationType type = _notification->GetType();
+	if (type != Notification::Type_Notification && type != Notification::Type_NodeRemoved)
+	{
+		return;
+	}
+
+	SharedLockGuard guard(s_lock);
+	for (size_t i = 0; i < s_queues.size(); ++i)
+	{
+		s_queues[i]->HandleNotification(_notification);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::HandleNotification>
+//	Mark a node that woke up for flushing.  The commands are sent from the
+//	timer, so OpenZWave is never called back from its own notification thread.
+//-----------------------------------------------------------------------------
+void WakeUpQueue::HandleNotification(Notification const* _notification)
+{
+	uint8 nodeId = _notification->GetNodeId();
+	if (_notification->GetHomeId() != m_homeId || nodeId == 0 || nodeId > MaxNodes)
+	{
+		return;
+	}
+
+	LockGuard guard(m_lock);
+	if (_notification->GetType() == Notification::Type_NodeRemoved)
+	{
+		m_pending[nodeId - 1].clear();
+		m_flush[nodeId - 1] = false;
+	}
+	else if (_notification->GetNotification() == Notification::Code_Awake)
+	{
+		++m_wakes[nodeId - 1];
+		if (!m_pending[nodeId - 1].empty())
+		{
+			m_flush[nodeId - 1] = true;
+			Schedule();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::OnTimer>
+//	Thread pool callback
+//-----------------------------------------------------------------------------
+VOID CALLBACK WakeUpQueue::OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer)
+{
+	static_cast<WakeUpQueue*>(_context)->FlushMarked();
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::FlushMarked>
+//	Send the held commands of every node that woke up
+//-----------------------------------------------------------------------------
+void WakeUpQueue::FlushMarked()
+{
+	std::vector<PendingCommand> commands;
+	{
+		LockGuard guard(m_lock);
+		for (uint32 i = 0; i < MaxNodes; ++i)
+		{
+			if (m_flush[i])
+			{
+				commands.insert(commands.end(), m_pending[i].begin(), m_pending[i].end());
+				m_pending[i].clear();
+				m_flush[i] = false;
+			}
+		}
+	}
+	std::sort(commands.begin(), commands.end(), FlushOrder);
+	Send(commands);
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::Send>
+//	Hand the commands to OpenZWave and report each one.  Returns the number
+//	OpenZWave accepted.  Must be called without m_lock held.
+//-----------------------------------------------------------------------------
+uint32 WakeUpQueue::Send(std::vector<PendingCommand> const& _commands)
+{
+	Manager* manager = Manager::Get();
+	uint32 accepted = 0;
+	for (size_t i = 0; i < _commands.size(); ++i)
+	{
+		PendingCommand const& command = _commands[i];
+		bool success = true;
+		switch (command.m_kind)
+		{
+		case PendingKind_ConfigParam:
+			success = manager->SetConfigParam(m_homeId, command.m_nodeId, command.m_index, command.m_int, command.m_size);
+			break;
+		case PendingKind_Association:
+			if (command.m_remove)
+			{
+				manager->RemoveAssociation(m_homeId, command.m_nodeId, command.m_index, command.m_targetNodeId);
+			}
+			else
+			{
+				manager->AddAssociation(m_homeId, command.m_nodeId, command.m_index, command.m_targetNodeId);
+			}
+			break;
+		case PendingKind_Value:
+		{
+			ValueID id(m_homeId, command.m_valueId);
+			switch (command.m_type)
+			{
+			case PendingValueType_Bool:
+				success = manager->SetValue(id, command.m_int != 0);
+				break;
+			case PendingValueType_Byte:
+				success = manager->SetValue(id, (uint8)command.m_int);
+				break;
+			case PendingValueType_Short:
+				success = manager->SetValue(id, (int16)command.m_int);
+				break;
+			case PendingValueType_Int:
+				success = manager->SetValue(id, command.m_int);
+				break;
+			case PendingValueType_Decimal:
+				success = manager->SetValue(id, command.m_float);
+				break;
+			case PendingValueType_String:
+				success = manager->SetValue(id, command.m_string);
+				break;
+			}
+			break;
+		}
+		}
+
+		if (success)
+		{
+			++accepted;
+		}
+		if (m_callback != NULL)
+		{
+			m_callback(&command, success, (uint32)(GetTickCount64() - command.m_queuedAt), m_context);
+		}
+	}
+	return accepted;
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::IsAsleep>
+//	Whether commands for the node would wait for its next wake-up.
+//	OpenZWave reports nodes without the Wake Up command class as awake.
+//-----------------------------------------------------------------------------
+bool WakeUpQueue::IsAsleep(uint8 _nodeId)
+{
+	return !Manager::Get()->IsNodeAwake(m_homeId, _nodeId);
+}
+
+//-----------------------------------------------------------------------------
+//	<WakeUpQueue::Schedule>
+//	Run FlushMarked on the thread pool.  Must be called with m_lock held.
+//-----------------------------------------------------------------------------
+void WakeUpQueue::Schedule()
+{
+	if (m_timer == NULL)
+	{
+		return;
+	}
+
+	// A zero relative due time fires straight away
+	FILETIME dueTime;
+	dueTime.dwLowDateTime = 0;
+	dueTime.dwHighDateTime = 0;
+	SetThreadpoolTimer(m_timer, &dueTime, 0, 0);
+}
@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+//
+//      WakeUpQueue.h
+//
+//      Coalescing store for commands aimed at sleeping nodes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Lock.h"
+
+namespace OpenZWave
+{
+	namespace Native
+	{
+		// Flush order: configuration can change how a device interprets the
+		// other commands, and association removals make room for additions.
+		enum PendingKind
+		{
+			PendingKind_ConfigParam = 0,
+			PendingKind_Association,
+			PendingKind_Value
+		};
+
+		enum PendingValueType
+		{
+			PendingValueType_Bool = 0,
+			PendingValueType_Byte,
+			PendingValueType_Short,
+			PendingValueType_Int,
+			PendingValueType_Decimal,
+			PendingValueType_String
+		};
+
+		enum SubmitResult
+		{
+			SubmitResult_Sent = 0,			// The node was awake; sent straight away
+			SubmitResult_Failed,			// The node was awake, but OpenZWave rejected the command
+			SubmitResult_Queued,			// Held until the node wakes up
+			SubmitResult_Coalesced			// Replaced a command that was already held
+		};
+
+		struct PendingCommand
+		{
+			PendingCommand() :
+				m_kind(PendingKind_Value),
+				m_nodeId(0),
+				m_valueId(0),
+				m_index(0),
+				m_size(0),
+				m_targetNodeId(0),
+				m_remove(false),
+				m_type(PendingValueType_Int),
+				m_int(0),
+				m_float(0.0f),
+				m_writes(0),
+				m_queuedAt(0)
+			{
+			}
+
+			PendingKind			m_kind;
+			uint8				m_nodeId;
+			uint64				m_valueId;			// PendingKind_Value: ValueID::GetId
+			uint8				m_index;			// Configuration parameter or association group
+			uint8				m_size;				// Configuration parameter size in bytes
+			uint8				m_targetNodeId;		// Association target
+			bool				m_remove;			// Association removal rather than addition
+			PendingValueType	m_type;
+			int32				m_int;				// Bool, byte, short, int and configuration values
+			float				m_float;
+			std::string			m_string;
+			uint32				m_writes;			// Requests folded into this command
+			uint64				m_queuedAt;			// Tick count of the first of them
+		};
+
+		typedef void(*pfnOnCommandSent_t)(PendingCommand const* _command, bool _success, uint32 _waitedMs, void* _context);
+
+		// Holds commands for nodes that are asleep, and sends them when the
+		// node reports that it is awake.  A later request for the same value,
+		// configuration parameter or association replaces the held one, so
+		// the wake-up window carries one frame per target however many times
+		// it was edited.  Commands for nodes that are awake pass straight
+		// through.  The callback runs for every command sent, on the thread
+		// pool for held commands.
+		class WakeUpQueue
+		{
+		public:
+			WakeUpQueue(uint32 _homeId, pfnOnCommandSent_t _callback, void* _context);
+			~WakeUpQueue();
+
+			SubmitResult Submit(PendingCommand const& _command);
+
+			// Commands held for a node, in the order they will be sent.  Node 0 for every node.
+			void GetPending(uint8 _nodeId, std::vector<PendingCommand>* o_pending);
+			uint32 GetPendingCount();
+
+			// Send a node's held commands now, whether or not it is awake
+			void Flush(uint8 _nodeId);
+
+			// Drop a node's held commands.  Returns the number dropped.
+			uint32 Cancel(uint8 _nodeId);
+
+			// Forward OpenZWave notifications to every live queue
+			static void OnNotification(Notification const* _notification);
+
+		private:
+			WakeUpQueue(WakeUpQueue const&);
+			WakeUpQueue& operator=(WakeUpQueue const&);
+
+			enum
+			{
+				MaxNodes = NUM_NODE_BITFIELD_BYTES * 8
+			};
+
+			static VOID CALLBACK OnTimer(PTP_CALLBACK_INSTANCE _instance, PVOID _context, PTP_TIMER _timer);
+
+			void HandleNotification(Notification const* _notification);
+			void FlushMarked();
+			uint32 Send(std::vector<PendingCommand> const& _commands);
+			bool IsAsleep(uint8 _nodeId);
+			void Schedule();
+
+			uint32							m_homeId;
+			pfnOnCommandSent_t				m_callback;
+			void*							m_context;
+			PTP_TIMER						m_timer;
+
+			Lock							m_lock;
+			std::vector<PendingCommand>		m_pending[MaxNodes];
+			bool							m_flush[MaxNodes];		// Nodes awake with commands to send
+			uint32							m_wakes[MaxNodes];		// Awake notifications handled, for Submit
+
+			static Lock						s_lock;
+			static std::vector<WakeUpQueue*>	s_queues;
+		};
+	}
+}
@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWAdaptivePoller.cpp
+//
+//      CLI/C++ and WinRT wrapper for the adaptive polling scheduler
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWAdaptivePoller.h"
+
+using namespace OpenZWave;
+
+namespace
+{
+	// Milliseconds since a tick count, or 0xFFFFFFFF for never
+	uint32 Age(uint64 _at, uint64 _now)
+	{
+		if (_at == 0 || _now - _at >= 0xFFFFFFFF)
+		{
+			return 0xFFFFFFFF;
+		}
+		return (uint32)(_now - _at);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWAdaptivePoller::GetCounters>
+//	Interval and counters of every polled value
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWPollCounters>^ ZWAdaptivePoller::GetCounters()
+{
+	std::vector<Native::PollCounters> counters;
+	GetPoller()->GetCounters(&counters);
+	uint64 now = GetTickCount64();
+
+	cli::array<ZWPollCounters>^ result = gcnew cli::array<ZWPollCounters>((int32)counters.size());
+	for (size_t i = 0; i < counters.size(); ++i)
+	{
+		result[(int32)i] = ConvertCounters(counters[i], now);
+	}
+	return result;
+}
+#else
+Platform::Array<ZWPollCounters>^ ZWAdaptivePoller::GetCounters()
+{
+	std::vector<Native::PollCounters> counters;
+	GetPoller()->GetCounters(&counters);
+	uint64 now = GetTickCount64();
+
+	Platform::Array<ZWPollCounters>^ result = gcnew Platform::Array<ZWPollCounters>((uint32)counters.size());
+	for (size_t i = 0; i < counters.size(); ++i)
+	{
+		result[(uint32)i] = ConvertCounters(counters[i], now);
+	}
+	return result;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//	<ZWAdaptivePoller::ConvertCounters>
+//	Copy native counters into their managed form, with tick counts as ages
+//-----------------------------------------------------------------------------
+ZWPollCounters ZWAdaptivePoller::ConvertCounters(Native::PollCounters const& _counters, uint64 _now)
+{
+	ZWPollCounters counters;
+	counters.ValueId = _counters.m_valueId;
+	counters.NodeId = _counters.m_nodeId;
+	counters.MinInterval = _counters.m_minIntervalMs;
+	counters.MaxInterval = _counters.m_maxIntervalMs;
+	counters.Interval = _counters.m_intervalMs;
+	counters.Polls = _counters.m_polls;
+	counters.Skipped = _counters.m_skipped;
+	counters.Deferred = _counters.m_deferred;
+	counters.Timeouts = _counters.m_timeouts;
+	counters.Changes = _counters.m_changes;
+	counters.Unsolicited = _counters.m_unsolicited;
+	counters.LastPollDuration = _counters.m_lastPollMs;
+	counters.TimeSinceLastPoll = Age(_counters.m_lastPollAt, _now);
+	counters.TimeSinceLastReport = Age(_counters.m_lastReportAt, _now);
+	return counters;
+}
@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWAdaptivePoller.h
+//
+//      CLI/C++ and WinRT wrapper for the adaptive polling scheduler
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "AdaptivePoller.h"
+#include "ZWValueID.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>The interval and counters of a value polled by ZWAdaptivePoller.</summary>
+	public value struct ZWPollCounters
+	{
+		/// <summary>The ZWValueId.Id of the value.</summary>
+		uint64 ValueId;
+		/// <summary>ID of the node the value belongs to.</summary>
+		uint8 NodeId;
+		/// <summary>The shortest interval between polls, in milliseconds.</summary>
+		uint32 MinInterval;
+		/// <summary>The longest interval between polls, in milliseconds.</summary>
+		uint32 MaxInterval;
+		/// <summary>The current interval between polls, in milliseconds.</summary>
+		uint32 Interval;
+		/// <summary>Number of polls sent.</summary>
+		uint32 Polls;
+		/// <summary>Number of polls not sent because the node had reported the value on its own since the poll was planned.</summary>
+		uint32 Skipped;
+		/// <summary>Number of times a due poll was held back by the airtime budget.</summary>
+		uint32 Deferred;
+		/// <summary>Number of polls that got no answer.</summary>
+		uint32 Timeouts;
+		/// <summary>Number of reports that changed the value.</summary>
+		uint32 Changes;
+		/// <summary>Number of reports that were not answers to a poll.</summary>
+		uint32 Unsolicited;
+		/// <summary>Milliseconds between the last answered poll and its answer.</summary>
+		uint32 LastPollDuration;
+		/// <summary>Milliseconds since the last poll, or UInt32.MaxValue if there has been none.</summary>
+		uint32 TimeSinceLastPoll;
+		/// <summary>Milliseconds since the last report of the value, or UInt32.MaxValue if there has been none.</summary>
+		uint32 TimeSinceLastReport;
+	};
+
+	/// <summary>
+	/// Polls values at intervals that follow how often each value changes.
+	/// </summary>
+	/// <remarks>
+	/// <para>Each value starts at its shortest interval.  A poll that finds the value changed halves the interval,
+	/// one that does not lengthens it by half, and one that gets no answer doubles it, always within the value's
+	/// bounds.  When the node reports the value on its own, the next poll is put off by a full interval.</para>
+	/// <para>The time the controller spends on polls is charged against an hourly airtime budget, and polls that
+	/// do not fit are held back until it refills.</para>
+	/// <para>The poller polls with ZWManager.RefreshValue.  Do not also enable OpenZWave's polling, with
+	/// ZWManager.EnablePoll, for the same values.</para>
+	/// </remarks>
+	public ref class ZWAdaptivePoller sealed
+	{
+	public:
+		/// <summary>Creates a stopped poller for a network.  ZWManager.Initialize must have been called.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		ZWAdaptivePoller(uint32 homeId) :
+			m_homeId(homeId)
+		{
+			m_poller = new Native::AdaptivePoller(homeId);
+		}
+
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { GetPoller(); return m_homeId; } }
+
+		/// <summary>Gets or sets the milliseconds of controller time polls may use per hour.  0 means no limit.  The default is six minutes.</summary>
+		property uint32 AirtimeBudget
+		{
+			uint32 get() { return GetPoller()->GetAirtimeBudget(); }
+			void set(uint32 value) { GetPoller()->SetAirtimeBudget(value); }
+		}
+
+		/// <summary>Gets whether the poller is sending polls.</summary>
+		property bool IsRunning { bool get() { return GetPoller()->IsRunning(); } }
+
+		/// <summary>Polls a value, or changes the bounds of one already polled.</summary>
+		/// <param name="id">The unique identifier of the value.</param>
+		/// <param name="minInterval">The shortest interval between polls, in milliseconds.</param>
+		/// <param name="maxInterval">The longest interval between polls, in milliseconds.</param>
+		/// <returns>False if minInterval is 0 or greater than maxInterval.</returns>
+		bool Add(ZWValueId^ id, uint32 minInterval, uint32 maxInterval) { return GetPoller()->Add(id->CreateUnmanagedValueID().GetId(), minInterval, maxInterval); }
+
+		/// <summary>Stops polling a value.</summary>
+		/// <returns>False if the value was not polled.</returns>
+		bool Remove(ZWValueId^ id) { return GetPoller()->Remove(id->CreateUnmanagedValueID().GetId()); }
+
+		/// <summary>Starts sending polls.  Values that are due are polled straight away.</summary>
+		void Start() { GetPoller()->Start(); }
+
+		/// <summary>Stops sending polls.  Answers to polls already sent are still counted.</summary>
+		void Stop() { GetPoller()->Stop(); }
+
+		/// <summary>Gets the interval and counters of every polled value.</summary>
+#if __cplusplus_cli
+		cli::array<ZWPollCounters>^ GetCounters();
+#else
+		Platform::Array<ZWPollCounters>^ GetCounters();
+#endif
+
+#if __cplusplus_cli
+		/// <summary>Stops polling and releases the poller's timer.  Later calls throw ObjectDisposedException.</summary>
+		~ZWAdaptivePoller() { this->!ZWAdaptivePoller(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWAdaptivePoller()
+#else
+		~ZWAdaptivePoller()
+#endif
+		{
+			delete m_poller;
+			m_poller = NULL;
+		}
+
+		Native::AdaptivePoller* GetPoller() { return CheckDisposed(m_poller, L"ZWAdaptivePoller"); }
+
+		static ZWPollCounters ConvertCounters(Native::PollCounters const& _counters, uint64 _now);
+
+		uint32						m_homeId;
+		Native::AdaptivePoller*		m_poller;
+	};
+}
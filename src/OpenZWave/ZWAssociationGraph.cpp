@@ -0,0 +1,76 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWAssociationGraph.cpp
+//
+//      CLI/C++ and WinRT wrapper for the network association graph
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWAssociationGraph.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWAssociationGraph::ZWAssociationGraph>
+//	Read every group of every node and copy it out in one go
+//-----------------------------------------------------------------------------
+ZWAssociationGraph::ZWAssociationGraph
+(
+	uint32 homeId
+) :
+	m_homeId(homeId)
+{
+	Native::AssociationGraph graph;
+	graph.Build(homeId);
+	std::vector<Native::AssociationGroup> const& groups = graph.GetGroups();
+	std::vector<Native::AssociationEdge> const& edges = graph.GetEdges();
+
+#if __cplusplus_cli
+	m_groups = gcnew cli::array<ZWAssociationGroup>((int32)groups.size());
+	m_edges = gcnew cli::array<ZWAssociationEdge>((int32)edges.size());
+#else
+	m_groups = gcnew Platform::Array<ZWAssociationGroup>((uint32)groups.size());
+	m_edges = gcnew Platform::Array<ZWAssociationEdge>((uint32)edges.size());
+#endif
+
+	for (size_t i = 0; i < groups.size(); ++i)
+	{
+		Native::AssociationGroup const& native = groups[i];
+		ZWAssociationGroup group;
+		group.NodeId = native.m_nodeId;
+		group.GroupIdx = native.m_groupIdx;
+		group.MaxAssociations = native.m_maxAssociations;
+		group.MultiInstance = native.m_multiInstance;
+		group.Label = ConvertString(native.m_label);
+		group.FirstEdge = (int32)native.m_firstEdge;
+		group.EdgeCount = (int32)native.m_numEdges;
+		m_groups[(int32)i] = group;
+	}
+
+	for (size_t i = 0; i < edges.size(); ++i)
+	{
+		ZWAssociationEdge edge;
+		edge.NodeId = edges[i].m_nodeId;
+		edge.GroupIdx = edges[i].m_groupIdx;
+		edge.TargetNodeId = edges[i].m_targetNodeId;
+		m_edges[(int32)i] = edge;
+	}
+}
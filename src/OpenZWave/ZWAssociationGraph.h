@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWAssociationGraph.h
+//
+//      CLI/C++ and WinRT wrapper for the network association graph
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "AssociationGraph.h"
+#include "ZWConvert.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>One association: a node's group sends to a target node.</summary>
+	public value struct ZWAssociationEdge
+	{
+		/// <summary>ID of the node that owns the group.</summary>
+		uint8 NodeId;
+		/// <summary>One-based index of the group.</summary>
+		uint8 GroupIdx;
+		/// <summary>ID of the node the group sends to.</summary>
+		uint8 TargetNodeId;
+	};
+
+	/// <summary>One association group of a node.</summary>
+	public value struct ZWAssociationGroup
+	{
+		/// <summary>ID of the node that owns the group.</summary>
+		uint8 NodeId;
+		/// <summary>One-based index of the group.</summary>
+		uint8 GroupIdx;
+		/// <summary>The maximum number of targets the group can hold.</summary>
+		uint8 MaxAssociations;
+		/// <summary>Whether the group supports multi instance associations.</summary>
+		bool MultiInstance;
+		/// <summary>The label from the device configuration file.</summary>
+		String^ Label;
+		/// <summary>Index into GetEdges of the group's first edge.</summary>
+		int32 FirstEdge;
+		/// <summary>Number of edges of the group.</summary>
+		int32 EdgeCount;
+	};
+
+	/// <summary>An association to add or remove, passed to ZWManager.ApplyAssociationChanges.</summary>
+	public value struct ZWAssociationChange
+	{
+		/// <summary>ID of the node that owns the group.</summary>
+		uint8 NodeId;
+		/// <summary>One-based index of the group.</summary>
+		uint8 GroupIdx;
+		/// <summary>ID of the node to add to or remove from the group.</summary>
+		uint8 TargetNodeId;
+		/// <summary>true to remove the target, false to add it.</summary>
+		bool Remove;
+	};
+
+	/// <summary>Every association group and association in a network, returned by ZWManager.GetAssociationGraph.</summary>
+	/// <remarks>The graph is a snapshot taken when GetAssociationGraph was called.  Groups are sorted by node and group,
+	/// and the edges of each group are contiguous and sorted by target.</remarks>
+	public ref class ZWAssociationGraph sealed
+	{
+	internal:
+		ZWAssociationGraph(uint32 homeId);
+
+	public:
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { return m_homeId; } }
+
+		/// <summary>Gets every association group of every node.</summary>
+#if __cplusplus_cli
+		cli::array<ZWAssociationGroup>^ GetGroups() { return m_groups; }
+#else
+		Platform::Array<ZWAssociationGroup>^ GetGroups() { return m_groups; }
+#endif
+
+		/// <summary>Gets every association, as a flat list of node, group and target.</summary>
+#if __cplusplus_cli
+		cli::array<ZWAssociationEdge>^ GetEdges() { return m_edges; }
+#else
+		Platform::Array<ZWAssociationEdge>^ GetEdges() { return m_edges; }
+#endif
+
+	private:
+		uint32									m_homeId;
+#if __cplusplus_cli
+		cli::array<ZWAssociationGroup>^			m_groups;
+		cli::array<ZWAssociationEdge>^			m_edges;
+#else
+		Platform::Array<ZWAssociationGroup>^	m_groups;
+		Platform::Array<ZWAssociationEdge>^		m_edges;
+#endif
+	};
+}
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWChangeSet.cpp
+//
+//      CLI/C++ and WinRT wrapper for the changes to a network since a version
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWChangeSet.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWChangeSet::ZWChangeSet>
+//	Copy the native changes into managed arrays
+//-----------------------------------------------------------------------------
+ZWChangeSet::ZWChangeSet(uint32 homeId, Native::ChangeSet const& changes) :
+	m_homeId(homeId),
+	m_version(changes.m_version),
+	m_full(changes.m_full)
+{
+	uint32 nodeCount = (uint32)changes.m_nodes.size();
+	uint32 valueCount = (uint32)changes.m_values.size();
+	uint32 removedNodeCount = (uint32)changes.m_removedNodes.size();
+	uint32 removedValueCount = (uint32)changes.m_removedValues.size();
+#if __cplusplus_cli
+	m_nodes = gcnew cli::array<ZWSnapshotNode>((int32)nodeCount);
+	m_values = gcnew cli::array<ZWSnapshotValue>((int32)valueCount);
+	m_removedNodes = gcnew cli::array<uint8>((int32)removedNodeCount);
+	m_removedValues = gcnew cli::array<uint64>((int32)removedValueCount);
+#else
+	m_nodes = gcnew Platform::Array<ZWSnapshotNode>(nodeCount);
+	m_values = gcnew Platform::Array<ZWSnapshotValue>(valueCount);
+	m_removedNodes = gcnew Platform::Array<uint8>(removedNodeCount);
+	m_removedValues = gcnew Platform::Array<uint64>(removedValueCount);
+#endif
+
+	for (uint32 i = 0; i < nodeCount; ++i)
+	{
+		m_nodes[i] = ZWNetworkSnapshot::ConvertNode(changes.m_nodes[i]);
+	}
+	for (uint32 i = 0; i < valueCount; ++i)
+	{
+		m_values[i] = ZWNetworkSnapshot::ConvertValue(changes.m_values[i]);
+	}
+	for (uint32 i = 0; i < removedNodeCount; ++i)
+	{
+		m_removedNodes[i] = changes.m_removedNodes[i];
+	}
+	for (uint32 i = 0; i < removedValueCount; ++i)
+	{
+		m_removedValues[i] = changes.m_removedValues[i];
+	}
+}
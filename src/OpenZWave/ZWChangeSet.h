@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWChangeSet.h
+//
+//      CLI/C++ and WinRT wrapper for the changes to a network since a version
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "ChangeLog.h"
+#include "ZWNetworkSnapshot.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>
+	/// The nodes and values of a network that changed after a state version, returned by ZWManager.GetChangesSince.
+	/// </summary>
+	/// <remarks>
+	/// <para>Apply the removals first, then the nodes and values: removing a node removes its values.  A removed node
+	/// is never among the changed nodes.  When IsFullSnapshot is set, the nodes and values are the whole network
+	/// and replace everything the caller held.  This is also the case when a node was removed and added again.</para>
+	/// <para>Keep Version and pass it to the next call.</para>
+	/// </remarks>
+	public ref class ZWChangeSet sealed
+	{
+	internal:
+		ZWChangeSet(uint32 homeId, Native::ChangeSet const& changes);
+
+	public:
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { return m_homeId; } }
+		/// <summary>Gets the state version the changes run up to.</summary>
+		property uint64 Version { uint64 get() { return m_version; } }
+		/// <summary>Gets whether the changes are the whole network, because the version asked for was older than
+		/// the change log keeps, came from an earlier run, or the driver was removed or reset since.</summary>
+		property bool IsFullSnapshot { bool get() { return m_full; } }
+
+		/// <summary>Gets the nodes added or changed, as they are now, sorted by ID.</summary>
+#if __cplusplus_cli
+		cli::array<ZWSnapshotNode>^ GetNodes() { return m_nodes; }
+#else
+		Platform::Array<ZWSnapshotNode>^ GetNodes() { return m_nodes; }
+#endif
+
+		/// <summary>Gets the values added or changed, as they are now, sorted by ZWValueId.Id.</summary>
+#if __cplusplus_cli
+		cli::array<ZWSnapshotValue>^ GetValues() { return m_values; }
+#else
+		Platform::Array<ZWSnapshotValue>^ GetValues() { return m_values; }
+#endif
+
+		/// <summary>Gets the IDs of the nodes removed.</summary>
+#if __cplusplus_cli
+		cli::array<uint8>^ GetRemovedNodeIds() { return m_removedNodes; }
+#else
+		Platform::Array<uint8>^ GetRemovedNodeIds() { return m_removedNodes; }
+#endif
+
+		/// <summary>Gets the ZWValueId.Id of each value removed, other than those of the nodes removed.</summary>
+#if __cplusplus_cli
+		cli::array<uint64>^ GetRemovedValueIds() { return m_removedValues; }
+#else
+		Platform::Array<uint64>^ GetRemovedValueIds() { return m_removedValues; }
+#endif
+
+	private:
+		uint32	m_homeId;
+		uint64	m_version;
+		bool	m_full;
+#if __cplusplus_cli
+		cli::array<ZWSnapshotNode>^		m_nodes;
+		cli::array<ZWSnapshotValue>^	m_values;
+		cli::array<uint8>^				m_removedNodes;
+		cli::array<uint64>^				m_removedValues;
+#else
+		Platform::Array<ZWSnapshotNode>^	m_nodes;
+		Platform::Array<ZWSnapshotValue>^	m_values;
+		Platform::Array<uint8>^				m_removedNodes;
+		Platform::Array<uint64>^			m_removedValues;
+#endif
+	};
+}
@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWConfigWriter.h
+//
+//      CLI/C++ and WinRT wrapper for background configuration writes
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "ConfigWriter.h"
+
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	/// <summary>Counters and the result of the last write of a network's configuration file, returned by ZWManager.GetConfigWriteStats.</summary>
+	public value struct ZWConfigWriteStats
+	{
+		/// <summary>Number of writes requested, including those merged into a later write.</summary>
+		uint32 Requests;
+		/// <summary>Number of complete writes.</summary>
+		uint32 Writes;
+		/// <summary>Number of writes that did not produce a complete file and were rolled back.</summary>
+		uint32 Failures;
+		/// <summary>Milliseconds the last complete write took.</summary>
+		uint32 LastDuration;
+		/// <summary>Size of the file written by the last complete write.</summary>
+		uint64 LastBytes;
+		/// <summary>Bytes written by every complete write.</summary>
+		uint64 TotalBytes;
+		/// <summary>When the last complete write finished, as a UTC file time (DateTime.FromFileTimeUtc), or 0.</summary>
+		int64 LastWrittenAt;
+		/// <summary>Whether a requested write has not started yet.</summary>
+		bool IsPending;
+	};
+}
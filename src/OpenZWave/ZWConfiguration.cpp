@@ -0,0 +1,131 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWConfiguration.cpp
+//
+//      CLI/C++ and WinRT wrapper for node configuration snapshots and profiles
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWConfiguration.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWConfigurationJob::ZWConfigurationJob>
+//	Constructor
+//-----------------------------------------------------------------------------
+ZWConfigurationJob::ZWConfigurationJob
+(
+	uint32 homeId,
+	uint8 nodeId,
+	std::vector<Native::ConfigWrite> const& profile
+) :
+	m_homeId(homeId),
+	m_nodeId(nodeId)
+{
+#if __cplusplus_cli
+	// The delegate lives as long as the job, which deletes the native job
+	// (and so stops the callbacks) before it goes away.
+	m_onProgress = gcnew OnConfigProgressFromUnmanagedDelegate(this, &ZWConfigurationJob::OnProgressFromUnmanaged);
+	IntPtr ip = Marshal::GetFunctionPointerForDelegate(m_onProgress);
+	m_job = new Native::ConfigJob(homeId, nodeId, profile, (Native::pfnOnConfigProgress_t)ip.ToPointer(), NULL);
+#else
+	m_job = new Native::ConfigJob(homeId, nodeId, profile, OnProgressFromUnmanaged, reinterpret_cast<void*>(this));
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWConfigurationJob::GetResults>
+//	Every parameter of the profile with its outcome so far
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWConfigParameterResult>^ ZWConfigurationJob::GetResults()
+{
+	std::vector<Native::ConfigWrite> writes;
+	GetJob()->GetResults(&writes);
+
+	cli::array<ZWConfigParameterResult>^ results = gcnew cli::array<ZWConfigParameterResult>((int32)writes.size());
+	for (size_t i = 0; i < writes.size(); ++i)
+	{
+		results[(int32)i] = ConvertWrite(writes[i]);
+	}
+	return results;
+}
+#else
+Platform::Array<ZWConfigParameterResult>^ ZWConfigurationJob::GetResults()
+{
+	std::vector<Native::ConfigWrite> writes;
+	GetJob()->GetResults(&writes);
+
+	Platform::Array<ZWConfigParameterResult>^ results = gcnew Platform::Array<ZWConfigParameterResult>((uint32)writes.size());
+	for (size_t i = 0; i < writes.size(); ++i)
+	{
+		results[(uint32)i] = ConvertWrite(writes[i]);
+	}
+	return results;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//	<ZWConfigurationJob::ConvertWrite>
+//	Copy a native profile entry into its managed form
+//-----------------------------------------------------------------------------
+ZWConfigParameterResult ZWConfigurationJob::ConvertWrite(Native::ConfigWrite const& _write)
+{
+	ZWConfigParameterResult result;
+	result.CommandClassId = _write.m_commandClassId;
+	result.Instance = _write.m_instance;
+	result.Index = _write.m_index;
+	result.Value = ConvertString(_write.m_value);
+	result.Result = (ZWConfigResult)_write.m_result;
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWConfigurationJob::OnProgressFromUnmanaged>
+//	Raise ParameterCompleted for a settled parameter, or Completed
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+void ZWConfigurationJob::OnProgressFromUnmanaged(Native::ConfigWrite const* _write, uint32 _done, uint32 _total, void* _context)
+{
+	if (_write != NULL)
+	{
+		ParameterCompleted(this, gcnew ConfigParameterEventArgs(ConvertWrite(*_write), (int32)_done, (int32)_total));
+	}
+	else
+	{
+		Completed(this, gcnew ConfigurationCompletedEventArgs((int32)_total));
+	}
+}
+#else
+void ZWConfigurationJob::OnProgressFromUnmanaged(Native::ConfigWrite const* _write, uint32 _done, uint32 _total, void* _context)
+{
+	ZWConfigurationJob^ job = reinterpret_cast<ZWConfigurationJob^>(_context);
+	if (_write != NULL)
+	{
+		job->ParameterCompleted(job, gcnew ConfigParameterEventArgs(ConvertWrite(*_write), (int32)_done, (int32)_total));
+	}
+	else
+	{
+		job->Completed(job, gcnew ConfigurationCompletedEventArgs((int32)_total));
+	}
+}
+#endif
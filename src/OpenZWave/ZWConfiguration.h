@@ -0,0 +1,223 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWConfiguration.h
+//
+//      CLI/C++ and WinRT wrapper for node configuration snapshots and profiles
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "ConfigJob.h"
+#include "ConfigTable.h"
+#include "ZWEnums.h"
+#include "ZWConvert.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+using namespace Runtime::InteropServices;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	ref class ZWConfigurationJob;
+
+	/// <summary>One configuration value of a node, returned by ZWManager.GetNodeConfiguration.</summary>
+	/// <remarks>Pass an array of these, typically read from a reference device, to ZWManager.ApplyNodeConfiguration.
+	/// Parameters are matched on CommandClassId, Instance and Index; only Value is applied.</remarks>
+	public value struct ZWConfigParameter
+	{
+		/// <summary>The command class of the value, usually Configuration (0x70).</summary>
+		uint8 CommandClassId;
+		/// <summary>The instance of the command class.</summary>
+		uint8 Instance;
+		/// <summary>The parameter number.</summary>
+		uint16 Index;
+		/// <summary>The type of the value.</summary>
+		ZWValueType Type;
+		/// <summary>Whether the value can only be read.</summary>
+		bool ReadOnly;
+		/// <summary>The label from the device configuration file.</summary>
+		String^ Label;
+		/// <summary>The value, in the form used by ZWManager.GetValueAsString and SetValue.</summary>
+		String^ Value;
+	};
+
+	/// <summary>The outcome of one parameter of a configuration profile.</summary>
+	public enum class ZWConfigResult
+	{
+		/// <summary>The parameter was sent and the node has not reported it back yet.</summary>
+		Pending = Native::ConfigResult_Pending,
+		/// <summary>The node already had the profile's value, so nothing was sent.</summary>
+		Unchanged = Native::ConfigResult_Unchanged,
+		/// <summary>The node reported the profile's value.</summary>
+		Succeeded = Native::ConfigResult_Succeeded,
+		/// <summary>The write was rejected, the node reported a different value, or no report came in time.</summary>
+		Failed = Native::ConfigResult_Failed,
+		/// <summary>The node has no such parameter, or it is read only.</summary>
+		NotFound = Native::ConfigResult_NotFound
+	};
+
+	/// <summary>One parameter of a configuration profile and its outcome.</summary>
+	public value struct ZWConfigParameterResult
+	{
+		/// <summary>The command class of the value.</summary>
+		uint8 CommandClassId;
+		/// <summary>The instance of the command class.</summary>
+		uint8 Instance;
+		/// <summary>The parameter number.</summary>
+		uint16 Index;
+		/// <summary>The value from the profile.</summary>
+		String^ Value;
+		/// <summary>The outcome.</summary>
+		ZWConfigResult Result;
+	};
+
+	/// <summary>A parameter sent by a ZWConfigurationJob has a result.</summary>
+	public ref class ConfigParameterEventArgs sealed
+	{
+	internal:
+		ConfigParameterEventArgs(ZWConfigParameterResult result, int32 completed, int32 total) :
+			m_result(result),
+			m_completed(completed),
+			m_total(total)
+		{
+		}
+
+	public:
+		/// <summary>Gets the parameter and its outcome.</summary>
+		property ZWConfigParameterResult Result { ZWConfigParameterResult get() { return m_result; } }
+		/// <summary>Gets the number of parameters sent that have a result.</summary>
+		property int32 Completed { int32 get() { return m_completed; } }
+		/// <summary>Gets the number of parameters sent.</summary>
+		property int32 Total { int32 get() { return m_total; } }
+
+	private:
+		ZWConfigParameterResult	m_result;
+		int32					m_completed;
+		int32					m_total;
+	};
+
+	/// <summary>Every parameter sent by a ZWConfigurationJob has a result.</summary>
+	public ref class ConfigurationCompletedEventArgs sealed
+	{
+	internal:
+		ConfigurationCompletedEventArgs(int32 total) :
+			m_total(total)
+		{
+		}
+
+	public:
+		/// <summary>Gets the number of parameters sent.  Call GetResults for the outcome of each.</summary>
+		property int32 Total { int32 get() { return m_total; } }
+
+	private:
+		int32	m_total;
+	};
+
+	public delegate void ConfigParameterEventHandler(ZWConfigurationJob^ sender, ConfigParameterEventArgs^ e);
+	public delegate void ConfigurationCompletedEventHandler(ZWConfigurationJob^ sender, ConfigurationCompletedEventArgs^ e);
+
+#if __cplusplus_cli
+	[UnmanagedFunctionPointer(CallingConvention::Cdecl)]
+	private delegate void OnConfigProgressFromUnmanagedDelegate(Native::ConfigWrite const* _write, uint32 _done, uint32 _total, void* _context);
+#endif
+
+	/// <summary>
+	/// Applies a configuration profile to a node, returned by ZWManager.ApplyNodeConfiguration.
+	/// </summary>
+	/// <remarks>
+	/// <para>The profile is compared with OpenZWave's cached values when the job is created, and GetResults
+	/// shows which parameters differ.  Start sends only those, and each one is settled when the node reports
+	/// the parameter back.</para>
+	/// <para>Attach the event handlers before calling Start.  Do not dispose the job from a handler.</para>
+	/// </remarks>
+	public ref class ZWConfigurationJob sealed
+	{
+	internal:
+		ZWConfigurationJob(uint32 homeId, uint8 nodeId, std::vector<Native::ConfigWrite> const& profile);
+
+	public:
+		/// <summary>Raised, from OpenZWave's notification thread or a worker thread, when a parameter sent has a result.</summary>
+		event ConfigParameterEventHandler^ ParameterCompleted;
+
+		/// <summary>Raised once every parameter sent has a result, straight from Start if there was nothing to send.</summary>
+		event ConfigurationCompletedEventHandler^ Completed;
+
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { GetJob(); return m_homeId; } }
+
+		/// <summary>Gets the ID of the node being configured.</summary>
+		property uint8 NodeId { uint8 get() { GetJob(); return m_nodeId; } }
+
+		/// <summary>Gets whether the job has started and every parameter sent has a result.</summary>
+		property bool IsComplete { bool get() { return GetJob()->IsComplete(); } }
+
+		/// <summary>Sends the parameters that differ from the node's cached values.</summary>
+		/// <param name="timeout">Milliseconds to wait for the node to report the parameters back before they count
+		/// as failed.  Use 0 to wait indefinitely, for example for a sleeping node.</param>
+		/// <returns>The number of parameters sent.</returns>
+		int32 Start(uint32 timeout) { return (int32)GetJob()->Start(timeout); }
+
+		/// <summary>Gets every parameter of the profile with its outcome so far, in profile order.</summary>
+#if __cplusplus_cli
+		cli::array<ZWConfigParameterResult>^ GetResults();
+#else
+		Platform::Array<ZWConfigParameterResult>^ GetResults();
+#endif
+
+#if __cplusplus_cli
+		/// <summary>Stops the job and releases its timer.  Writes already sent are not undone.  Later calls throw ObjectDisposedException.</summary>
+		~ZWConfigurationJob() { this->!ZWConfigurationJob(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWConfigurationJob()
+#else
+		~ZWConfigurationJob()
+#endif
+		{
+			delete m_job;
+			m_job = NULL;
+		}
+
+		Native::ConfigJob* GetJob() { return CheckDisposed(m_job, L"ZWConfigurationJob"); }
+
+		static ZWConfigParameterResult ConvertWrite(Native::ConfigWrite const& _write);
+
+#if __cplusplus_cli
+		void OnProgressFromUnmanaged(Native::ConfigWrite const* _write, uint32 _done, uint32 _total, void* _context);
+
+		OnConfigProgressFromUnmanagedDelegate^	m_onProgress;
+#else
+	internal:
+		static void OnProgressFromUnmanaged(Native::ConfigWrite const* _write, uint32 _done, uint32 _total, void* _context);
+
+	private:
+#endif
+		uint32					m_homeId;
+		uint8					m_nodeId;
+		Native::ConfigJob*		m_job;
+	};
+}
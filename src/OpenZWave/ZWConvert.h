@@ -0,0 +1,62 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWConvert.h
+//
+//      String conversions shared by the CLI/C++ and WinRT wrappers
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	inline std::string ConvertString(String^ value) {
+#if __cplusplus_cli
+		return msclr::interop::marshal_as<std::string>(value);
+#else
+		std::wstring_convert<std::codecvt_utf8<wchar_t>> convert;
+		return convert.to_bytes(value->Data());
+#endif
+	}
+
+	inline String^ ConvertString(std::string const& value) {
+#if __cplusplus_cli
+		return gcnew String(value.c_str());
+#else
+		std::wstring_convert<std::codecvt_utf8<wchar_t>> convert;
+		std::wstring intermediateForm = convert.from_bytes(value);
+		return ref new Platform::String(intermediateForm.c_str());
+#endif
+	}
+
+	inline std::wstring ConvertPath(String^ value) {
+#if __cplusplus_cli
+		return msclr::interop::marshal_as<std::wstring>(value);
+#else
+		return std::wstring(value->Data());
+#endif
+	}
+}
@@ -0,0 +1,50 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWDisposed.h
+//
+//      The disposed check shared by the CLI/C++ and WinRT wrappers
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	// The native object of a wrapper, or an ObjectDisposedException if
+	// Dispose has deleted it
+	template <class T>
+	inline T* CheckDisposed(T* native, String^ objectName) {
+		if (native == NULL)
+		{
+#if __cplusplus_cli
+			throw gcnew ObjectDisposedException(objectName);
+#else
+			throw ref new ObjectDisposedException(objectName);
+#endif
+		}
+		return native;
+	}
+}
@@ -0,0 +1,52 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWFrameCapture.h
+//
+//      CLI/C++ and WinRT types for the Serial API frame capture
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "FrameCapture.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>Counters of the frame capture, returned by ZWManager.GetFrameCaptureStats.</summary>
+	public value struct ZWFrameCaptureStats
+	{
+		/// <summary>Number of frames, ACKs, NAKs, CANs and dropped commands captured.</summary>
+		uint64 Frames;
+		/// <summary>Number of records lost because the disk fell behind.</summary>
+		uint64 Dropped;
+		/// <summary>Number of bytes written to the segment files.</summary>
+		uint64 BytesWritten;
+		/// <summary>Number of segment files started.</summary>
+		uint32 Segments;
+		/// <summary>True while the capture is running.</summary>
+		bool Running;
+	};
+}
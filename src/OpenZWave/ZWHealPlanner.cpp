@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWHealPlanner.cpp
+//
+//      CLI/C++ and WinRT wrapper for the incremental heal planner
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWHealPlanner.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWHealPlanner::ZWHealPlanner>
+//	Constructor
+//-----------------------------------------------------------------------------
+ZWHealPlanner::ZWHealPlanner
+(
+	uint32 homeId
+) :
+	m_homeId(homeId)
+{
+#if __cplusplus_cli
+	// The delegate lives as long as the planner, which deletes the native
+	// planner (and so stops the callbacks) before it goes away.
+	m_onProgress = gcnew OnHealProgressFromUnmanagedDelegate(this, &ZWHealPlanner::OnProgressFromUnmanaged);
+	IntPtr ip = Marshal::GetFunctionPointerForDelegate(m_onProgress);
+	m_planner = new Native::HealPlanner(homeId, (Native::pfnOnHealProgress_t)ip.ToPointer(), NULL);
+#else
+	m_planner = new Native::HealPlanner(homeId, OnProgressFromUnmanaged, reinterpret_cast<void*>(this));
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWHealPlanner::GetPlan>
+//	Every node of the plan, worst first
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWHealPlanItem>^ ZWHealPlanner::GetPlan()
+{
+	std::vector<Native::HealCandidate> plan;
+	GetPlanner()->GetPlan(&plan);
+
+	cli::array<ZWHealPlanItem>^ items = gcnew cli::array<ZWHealPlanItem>((int32)plan.size());
+	for (size_t i = 0; i < plan.size(); ++i)
+	{
+		items[(int32)i] = ConvertCandidate(plan[i]);
+	}
+	return items;
+}
+#else
+Platform::Array<ZWHealPlanItem>^ ZWHealPlanner::GetPlan()
+{
+	std::vector<Native::HealCandidate> plan;
+	GetPlanner()->GetPlan(&plan);
+
+	Platform::Array<ZWHealPlanItem>^ items = gcnew Platform::Array<ZWHealPlanItem>((uint32)plan.size());
+	for (size_t i = 0; i < plan.size(); ++i)
+	{
+		items[(uint32)i] = ConvertCandidate(plan[i]);
+	}
+	return items;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//	<ZWHealPlanner::ConvertCandidate>
+//	Copy a native plan entry into its managed form
+//-----------------------------------------------------------------------------
+ZWHealPlanItem ZWHealPlanner::ConvertCandidate(Native::HealCandidate const& _candidate)
+{
+	ZWHealPlanItem item;
+	item.NodeId = _candidate.m_nodeId;
+	item.Action = (ZWHealAction)_candidate.m_action;
+	item.State = (ZWHealState)_candidate.m_state;
+	item.Score = _candidate.m_score;
+	item.FailureRate = _candidate.m_failureRate;
+	item.RetryRate = _candidate.m_retryRate;
+	item.AverageRtt = _candidate.m_averageRtt;
+	item.Degree = _candidate.m_degree;
+	item.Hops = _candidate.m_hops;
+	item.Failed = _candidate.m_failed;
+	item.Listening = _candidate.m_listening;
+	return item;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWHealPlanner::OnProgressFromUnmanaged>
+//	Raise the Progress event from the native planner's worker thread
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+void ZWHealPlanner::OnProgressFromUnmanaged(Native::HealCandidate const* _candidate, uint32 _done, uint32 _total, void* _context)
+{
+	Progress(this, gcnew HealProgressEventArgs(ConvertCandidate(*_candidate), (int32)_done, (int32)_total));
+}
+#else
+void ZWHealPlanner::OnProgressFromUnmanaged(Native::HealCandidate const* _candidate, uint32 _done, uint32 _total, void* _context)
+{
+	ZWHealPlanner^ planner = reinterpret_cast<ZWHealPlanner^>(_context);
+	planner->Progress(planner, gcnew HealProgressEventArgs(ConvertCandidate(*_candidate), (int32)_done, (int32)_total));
+}
+#endif
@@ -0,0 +1,245 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWHealPlanner.h
+//
+//      CLI/C++ and WinRT wrapper for the incremental heal planner
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "HealPlanner.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+using namespace Runtime::InteropServices;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	ref class ZWHealPlanner;
+
+	/// <summary>The controller command the heal planner uses for a node.</summary>
+	public enum class ZWHealAction
+	{
+		/// <summary>The node is not scheduled.</summary>
+		None = Native::HealAction_None,
+		/// <summary>AssignReturnRoute, for nodes whose messages fail or need retries.</summary>
+		ReturnRoute = Native::HealAction_ReturnRoute,
+		/// <summary>RequestNodeNeighborUpdate, for nodes with few neighbors or no short route from the controller.</summary>
+		NeighborUpdate = Native::HealAction_NeighborUpdate,
+		/// <summary>HealNetworkNode with return routes, for nodes with both problems.</summary>
+		Heal = Native::HealAction_Heal
+	};
+
+	/// <summary>Where a node is in the heal plan.</summary>
+	public enum class ZWHealState
+	{
+		/// <summary>The node scored below the threshold and is not scheduled.</summary>
+		Healthy = Native::HealState_Healthy,
+		/// <summary>The node is waiting for its command.</summary>
+		Pending = Native::HealState_Pending,
+		/// <summary>The command for the node is running.</summary>
+		Running = Native::HealState_Running,
+		/// <summary>The controller reported that the command succeeded.</summary>
+		Succeeded = Native::HealState_Succeeded,
+		/// <summary>The command failed or timed out.</summary>
+		Failed = Native::HealState_Failed,
+		/// <summary>The node needs healing but is failed or asleep, so no command is sent.</summary>
+		Skipped = Native::HealState_Skipped
+	};
+
+	/// <summary>The route health of one node, as ranked by ZWHealPlanner.Plan.</summary>
+	public value struct ZWHealPlanItem
+	{
+		/// <summary>ID of the node.</summary>
+		uint8 NodeId;
+		/// <summary>The command scheduled for the node.</summary>
+		ZWHealAction Action;
+		/// <summary>Where the node is in the plan.</summary>
+		ZWHealState State;
+		/// <summary>Route health score.  Higher is worse; nodes at or above the planner's threshold are scheduled.</summary>
+		float32 Score;
+		/// <summary>Failed sends per send since the previous plan.</summary>
+		float32 FailureRate;
+		/// <summary>Retries per send since the previous plan.</summary>
+		float32 RetryRate;
+		/// <summary>Average request round trip time, in milliseconds.</summary>
+		uint32 AverageRtt;
+		/// <summary>Number of neighbors the node reports.</summary>
+		int32 Degree;
+		/// <summary>Hops on the shortest route from the controller, or 255 if there is none.</summary>
+		int32 Hops;
+		/// <summary>Whether OpenZWave considers the node failed.</summary>
+		bool Failed;
+		/// <summary>Whether the node is always or frequently listening, and so can take part in controller commands.</summary>
+		bool Listening;
+	};
+
+	/// <summary>Progress of a heal plan, raised when a command starts and when it finishes.</summary>
+	public ref class HealProgressEventArgs sealed
+	{
+	internal:
+		HealProgressEventArgs(ZWHealPlanItem item, int32 completed, int32 total) :
+			m_item(item),
+			m_completed(completed),
+			m_total(total)
+		{
+		}
+
+	public:
+		/// <summary>Gets the node the command is for.</summary>
+		property ZWHealPlanItem Item { ZWHealPlanItem get() { return m_item; } }
+		/// <summary>Gets the number of scheduled nodes whose commands have finished.</summary>
+		property int32 Completed { int32 get() { return m_completed; } }
+		/// <summary>Gets the number of scheduled nodes.</summary>
+		property int32 Total { int32 get() { return m_total; } }
+
+	private:
+		ZWHealPlanItem	m_item;
+		int32			m_completed;
+		int32			m_total;
+	};
+
+	public delegate void HealProgressEventHandler(ZWHealPlanner^ sender, HealProgressEventArgs^ e);
+
+#if __cplusplus_cli
+	[UnmanagedFunctionPointer(CallingConvention::Cdecl)]
+	private delegate void OnHealProgressFromUnmanagedDelegate(Native::HealCandidate const* _candidate, uint32 _done, uint32 _total, void* _context);
+#endif
+
+	/// <summary>
+	/// Heals only the nodes whose routes have degraded, a few at a time, instead of the whole network.
+	/// </summary>
+	/// <remarks>
+	/// <para>Plan ranks every node using its neighbor list, the node statistics (failed sends, retries and
+	/// round trip time) and IsNodeFailed.  Start then sends AssignReturnRoute, RequestNodeNeighborUpdate or
+	/// HealNetworkNode to the degraded nodes, worst first, one at a time.</para>
+	/// <para>Commands are only started during the quiet hours, and the time the controller spends on them
+	/// is charged against an hourly airtime budget, so interactive traffic keeps priority.</para>
+	/// <para>Keep a reference to the planner while it runs.  Do not dispose it from a Progress handler.</para>
+	/// </remarks>
+	public ref class ZWHealPlanner sealed
+	{
+	public:
+		/// <summary>Creates a planner for a network.  ZWManager.Initialize must have been called.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		ZWHealPlanner(uint32 homeId);
+
+		/// <summary>Raised from a worker thread when a command starts and when it finishes.</summary>
+		event HealProgressEventHandler^ Progress;
+
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { GetPlanner(); return m_homeId; } }
+
+		/// <summary>Gets or sets the controller time, in milliseconds per hour, the planner may use.  0 means no limit.  The default is 5 minutes.</summary>
+		property uint32 AirtimeBudget
+		{
+			uint32 get() { return GetPlanner()->GetSettings().m_airtimeBudgetMs; }
+			void set(uint32 value) { Native::HealSettings settings = GetPlanner()->GetSettings(); settings.m_airtimeBudgetMs = value; GetPlanner()->SetSettings(settings); }
+		}
+
+		/// <summary>Gets or sets the local hour (0-23) from which commands may start.  The default is 1.</summary>
+		property int32 QuietHoursStart
+		{
+			int32 get() { return GetPlanner()->GetSettings().m_quietHoursStart; }
+			void set(int32 value) { Native::HealSettings settings = GetPlanner()->GetSettings(); settings.m_quietHoursStart = (uint8)(value % 24); GetPlanner()->SetSettings(settings); }
+		}
+
+		/// <summary>Gets or sets the local hour (0-23) at which commands stop starting.  Set it equal to QuietHoursStart to allow any time.  The default is 5.</summary>
+		property int32 QuietHoursEnd
+		{
+			int32 get() { return GetPlanner()->GetSettings().m_quietHoursEnd; }
+			void set(int32 value) { Native::HealSettings settings = GetPlanner()->GetSettings(); settings.m_quietHoursEnd = (uint8)(value % 24); GetPlanner()->SetSettings(settings); }
+		}
+
+		/// <summary>Gets or sets the score at or above which a node is scheduled.  The default is 1.</summary>
+		property float32 Threshold
+		{
+			float32 get() { return GetPlanner()->GetSettings().m_threshold; }
+			void set(float32 value) { Native::HealSettings settings = GetPlanner()->GetSettings(); settings.m_threshold = value; GetPlanner()->SetSettings(settings); }
+		}
+
+		/// <summary>Gets or sets how long, in milliseconds, to wait for a command's result before counting it as failed.  The default is 60 seconds.</summary>
+		property uint32 CommandTimeout
+		{
+			uint32 get() { return GetPlanner()->GetSettings().m_timeoutMs; }
+			void set(uint32 value) { Native::HealSettings settings = GetPlanner()->GetSettings(); settings.m_timeoutMs = value; GetPlanner()->SetSettings(settings); }
+		}
+
+		/// <summary>Gets whether the planner still has commands to send.</summary>
+		property bool IsRunning { bool get() { return GetPlanner()->IsRunning(); } }
+
+		/// <summary>Ranks every node and schedules the degraded ones, replacing any previous plan.</summary>
+		/// <remarks>Failure and retry rates are measured since the previous call, so calling Plan periodically
+		/// tracks recent degradation rather than the totals since startup.  Stops the planner if it is running.</remarks>
+		/// <returns>The number of nodes scheduled.</returns>
+		int32 Plan() { return (int32)GetPlanner()->Plan(); }
+
+		/// <summary>Gets every node of the plan, worst first.</summary>
+#if __cplusplus_cli
+		cli::array<ZWHealPlanItem>^ GetPlan();
+#else
+		Platform::Array<ZWHealPlanItem>^ GetPlan();
+#endif
+
+		/// <summary>Starts sending commands to the scheduled nodes.</summary>
+		void Start() { GetPlanner()->Start(); }
+
+		/// <summary>Stops sending commands.  A running command is cancelled and its node goes back to pending.</summary>
+		void Stop() { GetPlanner()->Stop(); }
+
+#if __cplusplus_cli
+		/// <summary>Stops the planner and releases its timer without waiting for the finalizer.  Later calls throw ObjectDisposedException.</summary>
+		~ZWHealPlanner() { this->!ZWHealPlanner(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWHealPlanner()
+#else
+		~ZWHealPlanner()
+#endif
+		{
+			delete m_planner;
+			m_planner = NULL;
+		}
+
+		Native::HealPlanner* GetPlanner() { return CheckDisposed(m_planner, L"ZWHealPlanner"); }
+
+		static ZWHealPlanItem ConvertCandidate(Native::HealCandidate const& _candidate);
+
+#if __cplusplus_cli
+		void OnProgressFromUnmanaged(Native::HealCandidate const* _candidate, uint32 _done, uint32 _total, void* _context);
+
+		OnHealProgressFromUnmanagedDelegate^	m_onProgress;
+#else
+	internal:
+		static void OnProgressFromUnmanaged(Native::HealCandidate const* _candidate, uint32 _done, uint32 _total, void* _context);
+
+	private:
+#endif
+		uint32						m_homeId;
+		Native::HealPlanner*		m_planner;
+	};
+}
@@ -0,0 +1,104 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWHistoryLog.cpp
+//
+//      CLI/C++ and WinRT wrapper for the on-disk history log
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWHistoryLog.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWHistoryLogReader::GetSamples>
+//	Recorded samples of a value in a time range
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWHistorySample>^ ZWHistoryLogReader::GetSamples
+#else
+Platform::Array<ZWHistorySample>^ ZWHistoryLogReader::GetSamples
+#endif
+(
+	uint32 homeId,
+	uint64 valueId,
+	int64 from,
+	int64 to
+)
+{
+	std::vector<int64> times;
+	std::vector<double> values;
+	GetReader()->GetSamples(homeId, valueId, from, to, &times, &values);
+
+#if __cplusplus_cli
+	cli::array<ZWHistorySample>^ samples = gcnew cli::array<ZWHistorySample>((int32)times.size());
+#else
+	Platform::Array<ZWHistorySample>^ samples = gcnew Platform::Array<ZWHistorySample>((uint32)times.size());
+#endif
+	for (uint32 i = 0; i < (uint32)times.size(); ++i)
+	{
+		ZWHistorySample sample;
+		sample.Timestamp = times[i];
+		sample.Value = values[i];
+		samples[i] = sample;
+	}
+	return samples;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWHistoryLogReader::GetAggregates>
+//	Aggregates of a value over the windows of a time range
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWHistoryAggregate>^ ZWHistoryLogReader::GetAggregates
+#else
+Platform::Array<ZWHistoryAggregate>^ ZWHistoryLogReader::GetAggregates
+#endif
+(
+	uint32 homeId,
+	uint64 valueId,
+	int64 from,
+	int64 to,
+	uint32 windows
+)
+{
+	std::vector<Native::HistoryAggregate> aggregates;
+	GetReader()->Aggregate(homeId, valueId, from, to, windows, &aggregates);
+
+#if __cplusplus_cli
+	cli::array<ZWHistoryAggregate>^ result = gcnew cli::array<ZWHistoryAggregate>((int32)aggregates.size());
+#else
+	Platform::Array<ZWHistoryAggregate>^ result = gcnew Platform::Array<ZWHistoryAggregate>((uint32)aggregates.size());
+#endif
+	for (uint32 i = 0; i < (uint32)aggregates.size(); ++i)
+	{
+		ZWHistoryAggregate aggregate;
+		aggregate.Start = aggregates[i].m_start;
+		aggregate.End = aggregates[i].m_end;
+		aggregate.Count = aggregates[i].m_count;
+		aggregate.Min = aggregates[i].m_min;
+		aggregate.Max = aggregates[i].m_max;
+		aggregate.Average = aggregates[i].m_average;
+		aggregate.Last = aggregates[i].m_last;
+		result[i] = aggregate;
+	}
+	return result;
+}
@@ -0,0 +1,181 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWHistoryLog.h
+//
+//      CLI/C++ and WinRT wrapper for the on-disk history log
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "HistoryLog.h"
+#include "HistoryLogReader.h"
+#include "ZWValueHistory.h"
+#include "ZWConvert.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>
+	/// Records every change of a numeric value to compressed files in a directory, to be read back with
+	/// ZWHistoryLogReader.
+	/// </summary>
+	/// <remarks>
+	/// <para>Samples are kept in memory in blocks of one value each, and a block is written once it is full or
+	/// older than FlushInterval.  Writing happens on the thread pool, never on the notification thread.  A
+	/// typical sensor reading takes 2 to 5 bytes.</para>
+	/// <para>Each log writes its own numbered segment files.  A segment is closed once it reaches SegmentSize,
+	/// and the oldest segments are deleted once the directory holds more than MaxTotalSize.  Samples still in
+	/// memory are lost if the process stops; the segments already written remain readable.</para>
+	/// <para>Recording starts when the log is created, after ZWManager.Initialize, and stops when it is disposed.
+	/// Only one log should write to a directory at a time.</para>
+	/// </remarks>
+	public ref class ZWHistoryLog sealed
+	{
+	public:
+		/// <summary>Starts recording into a directory, creating it if needed.</summary>
+		/// <param name="directory">The directory that holds the segment files.</param>
+		ZWHistoryLog(String^ directory)
+		{
+			m_log = new Native::HistoryLog(ConvertPath(directory));
+		}
+
+		/// <summary>Gets whether the directory could be written to.</summary>
+		property bool IsOpen { bool get() { return GetLog()->IsOpen(); } }
+
+		/// <summary>Gets or sets the longest time, in milliseconds, that a sample stays in memory.  The default is ten minutes.</summary>
+		property uint32 FlushInterval
+		{
+			uint32 get() { return GetLog()->GetFlushInterval(); }
+			void set(uint32 value) { GetLog()->SetFlushInterval(value); }
+		}
+
+		/// <summary>Gets or sets the size, in bytes, at which a segment file is closed.  The default is 4 MB.</summary>
+		property uint32 SegmentSize
+		{
+			uint32 get() { return GetLog()->GetSegmentSize(); }
+			void set(uint32 value) { GetLog()->SetSegmentSize(value); }
+		}
+
+		/// <summary>Gets or sets the size, in bytes, above which the oldest segments are deleted.  0 keeps every segment.  The default is 256 MB.</summary>
+		property uint64 MaxTotalSize
+		{
+			uint64 get() { return GetLog()->GetMaxTotalSize(); }
+			void set(uint64 value) { GetLog()->SetMaxTotalSize(value); }
+		}
+
+		/// <summary>Gets the number of samples recorded since the log was created.</summary>
+		property uint64 SamplesRecorded { uint64 get() { return GetLog()->GetSamplesRecorded(); } }
+
+		/// <summary>Gets the number of bytes of samples written since the log was created.</summary>
+		property uint64 BytesWritten { uint64 get() { return GetLog()->GetBytesWritten(); } }
+
+		/// <summary>Writes every sample still in memory, so that readers see it.</summary>
+		void Flush() { GetLog()->Flush(); }
+
+#if __cplusplus_cli
+		/// <summary>Stops recording, flushes the open segment and closes the log.  Later calls throw ObjectDisposedException.</summary>
+		~ZWHistoryLog() { this->!ZWHistoryLog(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWHistoryLog()
+#else
+		~ZWHistoryLog()
+#endif
+		{
+			delete m_log;
+			m_log = NULL;
+		}
+
+		Native::HistoryLog* GetLog() { return CheckDisposed(m_log, L"ZWHistoryLog"); }
+
+		Native::HistoryLog*		m_log;
+	};
+
+	/// <summary>
+	/// Reads the history written by a ZWHistoryLog, from this or another process.
+	/// </summary>
+	/// <remarks>
+	/// Only the blocks of the requested value that overlap the time range are read and decoded.  Samples that a
+	/// live log still holds in memory are not returned until it writes them.
+	/// </remarks>
+	public ref class ZWHistoryLogReader sealed
+	{
+	public:
+		/// <summary>Creates a reader for a directory of segment files.</summary>
+		/// <param name="directory">The directory passed to ZWHistoryLog.</param>
+		ZWHistoryLogReader(String^ directory)
+		{
+			m_reader = new Native::HistoryLogReader(ConvertPath(directory));
+		}
+
+		/// <summary>Gets the recorded samples of a value in a time range, oldest first.</summary>
+		/// <param name="homeId">The Home ID of the network the value belongs to.</param>
+		/// <param name="valueId">The ZWValueId.Id of the value.</param>
+		/// <param name="from">The start of the range, as a UTC file time.</param>
+		/// <param name="to">The end of the range, as a UTC file time.  It is not part of the range.</param>
+		/// <remarks>Timestamps are stored to the millisecond.</remarks>
+#if __cplusplus_cli
+		cli::array<ZWHistorySample>^ GetSamples(uint32 homeId, uint64 valueId, int64 from, int64 to);
+#else
+		Platform::Array<ZWHistorySample>^ GetSamples(uint32 homeId, uint64 valueId, int64 from, int64 to);
+#endif
+
+		/// <summary>Gets the minimum, maximum, average and last value of a value in each window of a time range.</summary>
+		/// <param name="homeId">The Home ID of the network the value belongs to.</param>
+		/// <param name="valueId">The ZWValueId.Id of the value.</param>
+		/// <param name="from">The start of the range, as a UTC file time.</param>
+		/// <param name="to">The end of the range, as a UTC file time.  It is not part of the range.</param>
+		/// <param name="windows">The number of equal windows to split the range into.  At most 10000 are returned, and none shorter than a millisecond.</param>
+#if __cplusplus_cli
+		cli::array<ZWHistoryAggregate>^ GetAggregates(uint32 homeId, uint64 valueId, int64 from, int64 to, uint32 windows);
+#else
+		Platform::Array<ZWHistoryAggregate>^ GetAggregates(uint32 homeId, uint64 valueId, int64 from, int64 to, uint32 windows);
+#endif
+
+#if __cplusplus_cli
+		/// <summary>Frees the reader.  It keeps no segment open between calls, so this only returns its memory.  Later calls throw ObjectDisposedException.</summary>
+		~ZWHistoryLogReader() { this->!ZWHistoryLogReader(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWHistoryLogReader()
+#else
+		~ZWHistoryLogReader()
+#endif
+		{
+			delete m_reader;
+			m_reader = NULL;
+		}
+
+		Native::HistoryLogReader* GetReader() { return CheckDisposed(m_reader, L"ZWHistoryLogReader"); }
+
+		Native::HistoryLogReader*	m_reader;
+	};
+}
@@ -0,0 +1,359 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWHostClient.cpp
+//
+//      CLI/C++ and WinRT client of a controller host in another process
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWHostClient.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::Connect>
+// Maps the section of a host
+//-----------------------------------------------------------------------------
+ZWHostClient^ ZWHostClient::Connect
+(
+	String^ name
+)
+{
+#if __cplusplus_cli
+	std::wstring nativeName = msclr::interop::marshal_as<std::wstring>(name);
+#else
+	std::wstring nativeName(name->Data());
+#endif
+	Native::HostClient* client = Native::HostClient::Open(nativeName);
+	return (client != NULL) ? gcnew ZWHostClient(client) : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetNotifications>
+// Gets the notifications published since the last call
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWNotification^>^ ZWHostClient::GetNotifications()
+#else
+Platform::Array<ZWNotification^>^ ZWHostClient::GetNotifications()
+#endif
+{
+	std::vector<Native::HostNotification> records;
+	Native::HostNotification batch[256];
+	for (;;)
+	{
+		uint32 count = GetClient()->Read(batch, 256);
+		records.insert(records.end(), batch, batch + count);
+		if (count < 256)
+		{
+			break;
+		}
+	}
+
+#if __cplusplus_cli
+	cli::array<ZWNotification^>^ notifications = gcnew cli::array<ZWNotification^>((int32)records.size());
+#else
+	Platform::Array<ZWNotification^>^ notifications = gcnew Platform::Array<ZWNotification^>((uint32)records.size());
+#endif
+	for (uint32 i = 0; i < (uint32)records.size(); ++i)
+	{
+		Native::HostNotification const& record = records[i];
+		notifications[i] = gcnew ZWNotification((ZWNotificationType)record.m_type, record.m_byte, record.m_event, ValueID(record.m_homeId, record.m_valueId));
+	}
+	return notifications;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueIds>
+// Gets the ID of every value the host has published
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWValueId^>^ ZWHostClient::GetValueIds()
+#else
+Platform::Array<ZWValueId^>^ ZWHostClient::GetValueIds()
+#endif
+{
+	std::vector<Native::HostValue> values;
+	GetClient()->GetValues(&values);
+
+#if __cplusplus_cli
+	cli::array<ZWValueId^>^ ids = gcnew cli::array<ZWValueId^>((int32)values.size());
+#else
+	Platform::Array<ZWValueId^>^ ids = gcnew Platform::Array<ZWValueId^>((uint32)values.size());
+#endif
+	for (uint32 i = 0; i < (uint32)values.size(); ++i)
+	{
+		ids[i] = gcnew ZWValueId(ValueID(values[i].m_homeId, values[i].m_valueId));
+	}
+	return ids;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueAsBool>
+// Gets a value as a Bool
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueAsBool
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] System::Boolean %
+#else
+	bool *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetValue(id, ZWValueType::Bool, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = value.m_int != 0;
+#else
+	*o_value = value.m_int != 0;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueAsByte>
+// Gets a value as a Byte
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueAsByte
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] System::Byte %
+#else
+	byte *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetValue(id, ZWValueType::Byte, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = (uint8)value.m_int;
+#else
+	*o_value = (uint8)value.m_int;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueAsShort>
+// Gets a value as an Int16
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueAsShort
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] System::Int16 %
+#else
+	int16 *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetValue(id, ZWValueType::Short, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = (int16)value.m_int;
+#else
+	*o_value = (int16)value.m_int;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueAsInt>
+// Gets a value as an Int32
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueAsInt
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] System::Int32 %
+#else
+	int32 *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetValue(id, ZWValueType::Int, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = value.m_int;
+#else
+	*o_value = value.m_int;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueAsFloat>
+// Gets a value as a Float
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueAsFloat
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] System::Single %
+#else
+	float *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetValue(id, ZWValueType::Decimal, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = value.m_float;
+#else
+	*o_value = value.m_float;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueAsString>
+// Gets a value as a String
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueAsString
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] String^ %
+#else
+	String^ *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetClient()->GetValue(id->HomeId, id->Id, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = ConvertString(std::string(value.m_string, value.m_stringLength));
+#else
+	*o_value = ConvertString(std::string(value.m_string, value.m_stringLength));
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValueListSelection>
+// Gets the value of the selected item of a list
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValueListSelection
+(
+	ZWValueId^ id,
+#if __cplusplus_cli
+	[Out] System::Int32 %
+#else
+	int32 *
+#endif
+	o_value
+)
+{
+	Native::HostValue value;
+	if (!GetValue(id, ZWValueType::List, &value))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_value = value.m_int;
+#else
+	*o_value = value.m_int;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::RequestNodeState>
+// Asks a node for all of its values
+//-----------------------------------------------------------------------------
+bool ZWHostClient::RequestNodeState
+(
+	uint32 homeId,
+	uint8 nodeId
+)
+{
+	Native::HostCommand command;
+	memset(&command, 0, sizeof(command));
+	command.m_command = Native::HostCommand_RequestNodeState;
+	command.m_homeId = homeId;
+	command.m_valueId = nodeId;
+	return GetClient()->Send(command, std::string());
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::Send>
+// Sends a command about a value to the host
+//-----------------------------------------------------------------------------
+bool ZWHostClient::Send
+(
+	Native::HostCommandType commandType,
+	ZWValueId^ id,
+	int32 intValue,
+	float floatValue,
+	std::string const& stringValue
+)
+{
+	Native::HostCommand command;
+	memset(&command, 0, sizeof(command));
+	command.m_command = commandType;
+	command.m_homeId = id->HomeId;
+	command.m_valueId = id->Id;
+	command.m_int = intValue;
+	command.m_float = floatValue;
+	return GetClient()->Send(command, stringValue);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWHostClient::GetValue>
+// Copies a value the host has published, if it is of the type
+//-----------------------------------------------------------------------------
+bool ZWHostClient::GetValue
+(
+	ZWValueId^ id,
+	ZWValueType type,
+	Native::HostValue* o_value
+)
+{
+	Native::HostClient* client = GetClient();
+	return id->Type == type && client->GetValue(id->HomeId, id->Id, o_value);
+}
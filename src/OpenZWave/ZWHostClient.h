@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWHostClient.h
+//
+//      CLI/C++ and WinRT client of a controller host in another process
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "HostClient.h"
+#include "ZWNotification.h"
+#include "ZWConvert.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+using namespace Runtime::InteropServices;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>
+	/// Uses the Z-Wave network of a ZWManager in another process, which shares it with ZWManager.StartHost.
+	/// </summary>
+	/// <remarks>
+	/// <para>Notifications and values are read from memory the host shares, without a call to the host, so any
+	/// number of clients can read them without slowing it or each other.  Commands are sent to the host's local
+	/// socket, and return once OpenZWave has accepted or refused them.</para>
+	/// <para>The host keeps only its latest notifications.  Call GetNotifications often enough that they are not
+	/// overwritten first; LostNotifications counts those that were.</para>
+	/// </remarks>
+	public ref class ZWHostClient sealed
+	{
+	internal:
+		ZWHostClient(Native::HostClient* client) :
+			m_client(client)
+		{
+		}
+
+	public:
+		/// <summary>Connects to a host.</summary>
+		/// <param name="name">The name the host was started with.</param>
+		/// <returns>The client, or null if no host of that name is running.</returns>
+		static ZWHostClient^ Connect(String^ name);
+
+		/// <summary>Gets whether the host is still running.  A host started again under the same name is followed.</summary>
+		property bool HostRunning { bool get() { return GetClient()->IsHostRunning(); } }
+
+		/// <summary>Gets the number of notifications the host overwrote before GetNotifications read them.</summary>
+		property uint64 LostNotifications { uint64 get() { return GetClient()->GetLostCount(); } }
+
+		/// <summary>Gets the notifications the host has published since the last call, or since Connect.</summary>
+#if __cplusplus_cli
+		cli::array<ZWNotification^>^ GetNotifications();
+#else
+		Platform::Array<ZWNotification^>^ GetNotifications();
+#endif
+
+		/// <summary>Gets the ID of every value the host has published and not removed.</summary>
+		/// <remarks>The host publishes values as OpenZWave adds them, so a client that connects late finds them here.</remarks>
+#if __cplusplus_cli
+		cli::array<ZWValueId^>^ GetValueIds();
+#else
+		Platform::Array<ZWValueId^>^ GetValueIds();
+#endif
+
+		/// <summary>Gets a value as a bool.</summary>
+		/// <returns>False if the host has not published the value, or it is not a ZWValueType.Bool.</returns>
+		bool GetValueAsBool(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] System::Boolean %
+#else
+			bool *
+#endif
+			o_value);
+
+		/// <summary>Gets a value as an 8-bit unsigned integer.</summary>
+		/// <returns>False if the host has not published the value, or it is not a ZWValueType.Byte.</returns>
+		bool GetValueAsByte(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] System::Byte %
+#else
+			byte *
+#endif
+			o_value);
+
+		/// <summary>Gets a value as a 16-bit signed integer.</summary>
+		/// <returns>False if the host has not published the value, or it is not a ZWValueType.Short.</returns>
+		bool GetValueAsShort(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] System::Int16 %
+#else
+			int16 *
+#endif
+			o_value);
+
+		/// <summary>Gets a value as a 32-bit signed integer.</summary>
+		/// <returns>False if the host has not published the value, or it is not a ZWValueType.Int.</returns>
+		bool GetValueAsInt(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] System::Int32 %
+#else
+			int32 *
+#endif
+			o_value);
+
+		/// <summary>Gets a value as a float.</summary>
+		/// <returns>False if the host has not published the value, or it is not a ZWValueType.Decimal.</returns>
+		bool GetValueAsFloat(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] System::Single %
+#else
+			float *
+#endif
+			o_value);
+
+		/// <summary>Gets a value as a string, whatever its type.</summary>
+		/// <remarks>The host shares the first 96 bytes of each string.  Read longer strings through a command of your own on the host.</remarks>
+		/// <returns>False if the host has not published the value.</returns>
+		bool GetValueAsString(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] String^ %
+#else
+			String^ *
+#endif
+			o_value);
+
+		/// <summary>Gets the value of the selected item of a list.</summary>
+		/// <returns>False if the host has not published the value, or it is not a ZWValueType.List.</returns>
+		bool GetValueListSelection(ZWValueId^ id,
+#if __cplusplus_cli
+			[Out] System::Int32 %
+#else
+			int32 *
+#endif
+			o_value);
+
+		/// <summary>Sets the state of a bool.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the value.</returns>
+		bool SetValue(ZWValueId^ id, bool value) { return Send(Native::HostCommand_SetBool, id, value ? 1 : 0, 0, std::string()); }
+
+		/// <summary>Sets the value of a byte.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the value.</returns>
+		bool SetValue(ZWValueId^ id, uint8 value) { return Send(Native::HostCommand_SetByte, id, value, 0, std::string()); }
+
+		/// <summary>Sets the value of a decimal.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the value.</returns>
+		bool SetValue(ZWValueId^ id, float value) { return Send(Native::HostCommand_SetFloat, id, 0, value, std::string()); }
+
+		/// <summary>Sets the value of a 32-bit signed integer.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the value.</returns>
+		bool SetValue(ZWValueId^ id, int32 value) { return Send(Native::HostCommand_SetInt, id, value, 0, std::string()); }
+
+		/// <summary>Sets the value of a 16-bit signed integer.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the value.</returns>
+		bool SetValue(ZWValueId^ id, int16 value) { return Send(Native::HostCommand_SetShort, id, value, 0, std::string()); }
+
+		/// <summary>Sets a value from a string, whatever its type.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the value.</returns>
+		bool SetValue(ZWValueId^ id, String^ value) { return Send(Native::HostCommand_SetString, id, 0, 0, ConvertString(value)); }
+
+		/// <summary>Sets the selected item in a list.</summary>
+		/// <returns>False if the host could not be reached, or the selection is not in the list.</returns>
+		bool SetValueListSelection(ZWValueId^ id, String^ selectedItem) { return Send(Native::HostCommand_SetListSelection, id, 0, 0, ConvertString(selectedItem)); }
+
+		/// <summary>Asks the node for the current state of a value.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the request.</returns>
+		bool RefreshValue(ZWValueId^ id) { return Send(Native::HostCommand_RefreshValue, id, 0, 0, std::string()); }
+
+		/// <summary>Asks a node for all of its values.</summary>
+		/// <returns>False if the host could not be reached, or OpenZWave refused the request.</returns>
+		bool RequestNodeState(uint32 homeId, uint8 nodeId);
+
+#if __cplusplus_cli
+		/// <summary>Disconnects from the host and unmaps its shared memory.  Later calls throw ObjectDisposedException.</summary>
+		~ZWHostClient() { this->!ZWHostClient(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWHostClient()
+#else
+		~ZWHostClient()
+#endif
+		{
+			delete m_client;
+			m_client = NULL;
+		}
+
+		Native::HostClient* GetClient() { return CheckDisposed(m_client, L"ZWHostClient"); }
+
+		bool Send(Native::HostCommandType commandType, ZWValueId^ id, int32 intValue, float floatValue, std::string const& stringValue);
+		bool GetValue(ZWValueId^ id, ZWValueType type, Native::HostValue* o_value);
+
+		Native::HostClient*	m_client;
+	};
+}
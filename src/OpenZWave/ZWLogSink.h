@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWLogSink.h
+//
+//      CLI/C++ and WinRT types for the asynchronous log sink
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "LogSink.h"
+#include "ZWEnums.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>A message logged by OpenZWave, captured by the log sink.</summary>
+	public value struct ZWLogRecord
+	{
+		/// <summary>When the message was logged, as a UTC file time (DateTime.FromFileTimeUtc).</summary>
+		int64 Time;
+		/// <summary>The Home ID of the network, or 0 when more or less than one driver is ready, since OpenZWave does not say which driver logged it.</summary>
+		uint32 HomeId;
+		/// <summary>The node the message is about, or 0.</summary>
+		uint8 NodeId;
+		/// <summary>The level the message was logged at.</summary>
+		ZWLogLevel Level;
+		/// <summary>The message, cut short after 471 bytes.</summary>
+		String^ Message;
+	};
+
+	/// <summary>Counters of the log sink, returned by ZWManager.GetLogSinkStats.</summary>
+	public value struct ZWLogSinkStats
+	{
+		/// <summary>Number of messages captured.</summary>
+		uint64 Written;
+		/// <summary>Number of messages lost because the ring was full.</summary>
+		uint64 Dropped;
+		/// <summary>Number of messages cut short.</summary>
+		uint64 Truncated;
+		/// <summary>Number of messages written to the file and raised in LogRecordsReceived.</summary>
+		uint64 Delivered;
+		/// <summary>Number of batches delivered.</summary>
+		uint64 Batches;
+		/// <summary>Number of messages the ring holds.</summary>
+		uint32 Capacity;
+		/// <summary>Number of messages in the ring, waiting for the next drain.</summary>
+		uint32 Pending;
+	};
+
+	/// <summary>Provides the batch of messages raised by the ZWManager.LogRecordsReceived event.</summary>
+	public ref class LogRecordsReceivedEventArgs sealed
+	{
+	internal:
+#if __cplusplus_cli
+		LogRecordsReceivedEventArgs(cli::array<ZWLogRecord>^ records) : m_records(records) {}
+#else
+		LogRecordsReceivedEventArgs(Platform::Array<ZWLogRecord>^ records) : m_records(records) {}
+#endif
+
+	public:
+		/// <summary>Gets the messages, oldest first.</summary>
+#if __cplusplus_cli
+		cli::array<ZWLogRecord>^ GetRecords() { return m_records; }
+#else
+		Platform::Array<ZWLogRecord>^ GetRecords() { return m_records; }
+#endif
+
+	private:
+#if __cplusplus_cli
+		cli::array<ZWLogRecord>^		m_records;
+#else
+		Platform::Array<ZWLogRecord>^	m_records;
+#endif
+	};
+}
@@ -55,6 +55,18 @@ void ZWManager::Initialize()
 	// Create the Manager singleton
 	Manager::Create();
 
+	// GetNodeInfo records are kept from here until the next Initialize
+	{
+		Native::LockGuard guard(*m_nodeInfoLock);
+#if __cplusplus_cli
+		m_nodeInfoHomes = gcnew cli::array<uint32>(0);
+		m_nodeInfos = gcnew cli::array<ZWNodeInfo^>(0);
+#else
+		m_nodeInfoHomes = gcnew Platform::Array<uint32>(0);
+		m_nodeInfos = gcnew Platform::Array<ZWNodeInfo^>(0);
+#endif
+	}
+
 	// Add a notification handler
 #if __cplusplus_cli
 	m_onNotification = gcnew OnNotificationFromUnmanagedDelegate(this, &ZWManager::OnNotificationFromUnmanaged);
@@ -68,6 +80,37 @@ void ZWManager::Initialize()
 	m_isInitialized = true;
 }
 
+//-----------------------------------------------------------------------------
+//	<ZWManager::Destroy>
+//	Delete the unmanaged Manager singleton object and reset the native state
+//-----------------------------------------------------------------------------
+void ZWManager::Destroy()
+{
+	// These still talk to OpenZWave: the last snapshot and configuration
+	// writes, and the timers, exporter and host that query the Manager
+	Native::NetworkSnapshot::Shutdown();
+	Native::ConfigWriter::Shutdown();
+	Native::StartupProfiler::Shutdown();
+	Native::TrafficCounters::Shutdown();
+	Native::MetricsExporter::Stop();
+	Native::ControllerHost::Stop();
+
+	Manager::Get()->Destroy();
+
+	// No notification can arrive any more, so nothing refills the tables
+	Native::ChangeLog::Shutdown();
+	Native::NodeRegistry::Shutdown();
+	Native::ConfigTable::Shutdown();
+	Native::PollTable::Shutdown();
+	Native::ValueHistory::Shutdown();
+	Native::MemoryTracker::Shutdown();
+	Native::ValueKeys::Close();
+
+	Native::FrameCapture::Stop();
+	Native::LogSink::Shutdown();
+	m_isInitialized = false;
+}
+
 //-----------------------------------------------------------------------------
 //	<ZWManager::OnNotificationFromUnmanaged>
 //	Trigger an event from the unmanaged notification callback
@@ -85,6 +128,7 @@ void ZWManager::OnNotificationFromUnmanaged
 	void* _context
 )
 {
+	ProcessNotification(_notification);
 	ZWNotification^ notification = gcnew ZWNotification(_notification);
 	NotificationReceived(this, gcnew NotificationReceivedEventArgs(notification));
 }
@@ -93,11 +137,98 @@ void ZWManager::OnNotificationFromUnmanaged
 void ZWManager::OnNotificationFromUnmanaged(Notification const* _notification, void* _context)
 {
 	ZWManager^ manager = reinterpret_cast<ZWManager^>(_context);
+	manager->ProcessNotification(_notification);
 	ZWNotification^ notification = gcnew ZWNotification((Notification *)_notification);
 	manager->NotificationReceived(manager, gcnew NotificationReceivedEventArgs(notification));
 }
 #endif
 
+//-----------------------------------------------------------------------------
+//	<ZWManager::OnLogRecordsFromUnmanaged>
+//	Raise a batch of the log sink from the thread pool
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+void ZWManager::OnLogRecordsFromUnmanaged
+(
+	Native::LogRecord* _records,
+	uint32 _count,
+	void* _context
+)
+{
+	RaiseLogRecords(_records, _count);
+}
+#else
+void ZWManager::OnLogRecordsFromUnmanaged(Native::LogRecord const* _records, uint32 _count, void* _context)
+{
+	ZWManager^ manager = reinterpret_cast<ZWManager^>(_context);
+	manager->RaiseLogRecords(_records, _count);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//	<ZWManager::RaiseLogRecords>
+//	Copy a batch of the log sink and raise LogRecordsReceived
+//-----------------------------------------------------------------------------
+void ZWManager::RaiseLogRecords(Native::LogRecord const* _records, uint32 _count)
+{
+#if __cplusplus_cli
+	cli::array<ZWLogRecord>^ records = gcnew cli::array<ZWLogRecord>((int32)_count);
+#else
+	Platform::Array<ZWLogRecord>^ records = gcnew Platform::Array<ZWLogRecord>(_count);
+#endif
+
+	for (uint32 i = 0; i < _count; ++i)
+	{
+		ZWLogRecord record;
+		record.Time = _records[i].m_time;
+		record.HomeId = _records[i].m_homeId;
+		record.NodeId = _records[i].m_nodeId;
+		record.Level = (ZWLogLevel)_records[i].m_level;
+		record.Message = ConvertString(std::string(_records[i].m_message, _records[i].m_length));
+		records[i] = record;
+	}
+	LogRecordsReceived(this, gcnew LogRecordsReceivedEventArgs(records));
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWManager::ProcessNotification>
+//	Update the wrapper's native state before the notification reaches managed code
+//-----------------------------------------------------------------------------
+void ZWManager::ProcessNotification(Notification const* _notification)
+{
+	if (Native::MemoryTracker::IsEnabled())
+	{
+		Native::MemoryTracker::OnNotification(_notification);
+	}
+	if (Native::ValueHistory::IsEnabled())
+	{
+		Native::ValueHistory::OnNotification(_notification);
+	}
+	if (Native::ValueKeys::IsOpen())
+	{
+		Native::ValueKeys::OnNotification(_notification);
+	}
+	if (Native::StartupProfiler::IsEnabled())
+	{
+		Native::StartupProfiler::OnNotification(_notification);
+	}
+	Native::HealPlanner::OnNotification(_notification);
+	Native::WakeUpQueue::OnNotification(_notification);
+	Native::ConfigTable::OnNotification(_notification);
+	Native::ConfigJob::OnNotification(_notification);
+	Native::ConfigWriter::OnNotification(_notification);
+	Native::AdaptivePoller::OnNotification(_notification);
+	Native::PollTable::OnNotification(_notification);
+	Native::HistoryLog::OnNotification(_notification);
+	Native::NetworkSnapshot::OnNotification(_notification);
+	Native::ChangeLog::OnNotification(_notification);
+	Native::NodeRegistry::OnNotification(_notification);
+	Native::LogSink::OnNotification(_notification);
+	Native::TrafficCounters::OnNotification(_notification);
+	Native::MetricsExporter::OnNotification(_notification);
+	Native::ControllerHost::OnNotification(_notification);
+}
+
 //-----------------------------------------------------------------------------
 // <ZWManager::GetValueAsBool>
 // Gets a value as a Bool
@@ -570,6 +701,133 @@ bool ZWManager::GetNodeClassInformation
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <ZWManager::FindNode>
+// Gets a node from the node registry
+//-----------------------------------------------------------------------------
+bool ZWManager::FindNode
+(
+	uint32 homeId,
+	uint8 nodeId,
+#if __cplusplus_cli
+	[Out] ZWSnapshotNode %o_node
+#else
+	ZWSnapshotNode *o_node
+#endif
+)
+{
+	Native::SnapshotNode node;
+	if (!Native::NodeRegistry::GetNode(homeId, nodeId, &node))
+	{
+		return false;
+	}
+#if __cplusplus_cli
+	o_node = ZWNetworkSnapshot::ConvertNode(node);
+#else
+	*o_node = ZWNetworkSnapshot::ConvertNode(node);
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetNodes>
+// Gets every node of a network from the node registry
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWSnapshotNode>^ ZWManager::GetNodes
+#else
+Platform::Array<ZWSnapshotNode>^ ZWManager::GetNodes
+#endif
+(
+	uint32 homeId
+)
+{
+	std::vector<Native::SnapshotNode> nodes;
+	Native::NodeRegistry::GetNodes(homeId, &nodes);
+#if __cplusplus_cli
+	cli::array<ZWSnapshotNode>^ result = gcnew cli::array<ZWSnapshotNode>((int32)nodes.size());
+#else
+	Platform::Array<ZWSnapshotNode>^ result = gcnew Platform::Array<ZWSnapshotNode>((uint32)nodes.size());
+#endif
+	for (uint32 i = 0; i < (uint32)nodes.size(); ++i)
+	{
+		result[i] = ZWNetworkSnapshot::ConvertNode(nodes[i]);
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetNodeInfo>
+// Gets the kept record of a node, making a new one if the node has changed
+//-----------------------------------------------------------------------------
+ZWNodeInfo^ ZWManager::GetNodeInfo
+(
+	uint32 homeId,
+	uint8 nodeId
+)
+{
+	if (!m_isInitialized || nodeId == 0 || nodeId > Native::NodeRegistry::c_maxNodes)
+	{
+		return nullptr;
+	}
+
+	ZWNodeInfo^ info = nullptr;
+	{
+		Native::SharedLockGuard guard(*m_nodeInfoLock);
+		for (uint32 i = 0; i < (uint32)m_nodeInfoHomes->Length; ++i)
+		{
+			if (m_nodeInfoHomes[i] == homeId)
+			{
+				info = m_nodeInfos[i * Native::NodeRegistry::c_maxNodes + nodeId - 1];
+				break;
+			}
+		}
+	}
+	uint32 stamp = (info != nullptr) ? info->Stamp : 0;
+
+	Native::SnapshotNode node;
+	uint32 current = Native::NodeRegistry::GetNodeIfChanged(homeId, nodeId, stamp, &node);
+	if (current == 0)
+	{
+		return nullptr;
+	}
+	if (current != stamp)
+	{
+		info = gcnew ZWNodeInfo(homeId, node, current);
+
+		Native::LockGuard guard(*m_nodeInfoLock);
+		uint32 home = 0;
+		while (home < (uint32)m_nodeInfoHomes->Length && m_nodeInfoHomes[home] != homeId)
+		{
+			++home;
+		}
+		if (home == (uint32)m_nodeInfoHomes->Length)
+		{
+			// Another network; its records go after those already kept
+#if __cplusplus_cli
+			cli::array<uint32>^ homes = gcnew cli::array<uint32>(home + 1);
+			cli::array<ZWNodeInfo^>^ infos = gcnew cli::array<ZWNodeInfo^>((home + 1) * Native::NodeRegistry::c_maxNodes);
+#else
+			Platform::Array<uint32>^ homes = gcnew Platform::Array<uint32>(home + 1);
+			Platform::Array<ZWNodeInfo^>^ infos = gcnew Platform::Array<ZWNodeInfo^>((home + 1) * Native::NodeRegistry::c_maxNodes);
+#endif
+			for (uint32 i = 0; i < home; ++i)
+			{
+				homes[i] = m_nodeInfoHomes[i];
+			}
+			for (uint32 i = 0; i < (uint32)m_nodeInfos->Length; ++i)
+			{
+				infos[i] = m_nodeInfos[i];
+			}
+			homes[home] = homeId;
+			m_nodeInfoHomes = homes;
+			m_nodeInfos = infos;
+		}
+		m_nodeInfos[home * Native::NodeRegistry::c_maxNodes + nodeId - 1] = info;
+	}
+	return info;
+}
+
 //-----------------------------------------------------------------------------
 // <ZWManager::GetSwitchPoint>
 // Get switchpoint data from the schedule
@@ -605,6 +863,420 @@ bool ZWManager::GetSwitchPoint
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <ZWManager::EnablePoll>
+// Enable the polling of many values
+//-----------------------------------------------------------------------------
+int32 ZWManager::EnablePoll
+(
+#if __cplusplus_cli
+	cli::array<ZWValueId^>^ valueIds,
+#else
+	const Platform::Array<ZWValueId^>^ valueIds,
+#endif
+	uint8 intensity
+)
+{
+	std::vector<ValueID> ids;
+	ids.reserve(valueIds->Length);
+	for (uint32 i = 0; i < (uint32)valueIds->Length; ++i)
+	{
+		ids.push_back(valueIds[i]->CreateUnmanagedValueID());
+	}
+	return (int32)Native::PollTable::EnablePoll(ids, intensity);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::DisablePoll>
+// Disable the polling of many values
+//-----------------------------------------------------------------------------
+int32 ZWManager::DisablePoll
+(
+#if __cplusplus_cli
+	cli::array<ZWValueId^>^ valueIds
+#else
+	const Platform::Array<ZWValueId^>^ valueIds
+#endif
+)
+{
+	std::vector<ValueID> ids;
+	ids.reserve(valueIds->Length);
+	for (uint32 i = 0; i < (uint32)valueIds->Length; ++i)
+	{
+		ids.push_back(valueIds[i]->CreateUnmanagedValueID());
+	}
+	return (int32)Native::PollTable::DisablePoll(ids);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetPolledValues>
+// Gets every polled value with its intensity and report statistics
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWPolledValue>^ ZWManager::GetPolledValues
+#else
+Platform::Array<ZWPolledValue>^ ZWManager::GetPolledValues
+#endif
+(
+	uint32 homeId
+)
+{
+	std::vector<Native::PolledValue> values;
+	Native::PollTable::GetPolledValues(homeId, &values);
+	uint64 now = GetTickCount64();
+
+#if __cplusplus_cli
+	cli::array<ZWPolledValue>^ polled = gcnew cli::array<ZWPolledValue>((int32)values.size());
+#else
+	Platform::Array<ZWPolledValue>^ polled = gcnew Platform::Array<ZWPolledValue>((uint32)values.size());
+#endif
+	for (uint32 i = 0; i < (uint32)values.size(); ++i)
+	{
+		ZWPolledValue value;
+		value.ValueId = values[i].m_valueId;
+		value.NodeId = values[i].m_nodeId;
+		value.Intensity = values[i].m_intensity;
+		value.Reports = values[i].m_reports;
+		value.TimeSinceLastReport = (values[i].m_lastReportAt == 0 || now - values[i].m_lastReportAt >= 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32)(now - values[i].m_lastReportAt);
+		value.ReportInterval = values[i].m_reportIntervalMs;
+		polled[i] = value;
+	}
+	return polled;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetValueHistory>
+// Gets the recorded samples of a value in a time range
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWHistorySample>^ ZWManager::GetValueHistory
+#else
+Platform::Array<ZWHistorySample>^ ZWManager::GetValueHistory
+#endif
+(
+	ZWValueId^ id,
+	int64 from,
+	int64 to
+)
+{
+	ValueID valueId = id->CreateUnmanagedValueID();
+	std::vector<int64> times;
+	std::vector<double> values;
+	Native::ValueHistory::GetSamples(valueId.GetHomeId(), valueId.GetId(), from, to, &times, &values);
+
+#if __cplusplus_cli
+	cli::array<ZWHistorySample>^ samples = gcnew cli::array<ZWHistorySample>((int32)times.size());
+#else
+	Platform::Array<ZWHistorySample>^ samples = gcnew Platform::Array<ZWHistorySample>((uint32)times.size());
+#endif
+	for (uint32 i = 0; i < (uint32)times.size(); ++i)
+	{
+		ZWHistorySample sample;
+		sample.Timestamp = times[i];
+		sample.Value = values[i];
+		samples[i] = sample;
+	}
+	return samples;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetValueHistoryAggregates>
+// Gets the aggregates of a value over the windows of a time range
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWHistoryAggregate>^ ZWManager::GetValueHistoryAggregates
+#else
+Platform::Array<ZWHistoryAggregate>^ ZWManager::GetValueHistoryAggregates
+#endif
+(
+	ZWValueId^ id,
+	int64 from,
+	int64 to,
+	uint32 windows
+)
+{
+	ValueID valueId = id->CreateUnmanagedValueID();
+	std::vector<Native::HistoryAggregate> aggregates;
+	Native::ValueHistory::Aggregate(valueId.GetHomeId(), valueId.GetId(), from, to, windows, &aggregates);
+
+#if __cplusplus_cli
+	cli::array<ZWHistoryAggregate>^ result = gcnew cli::array<ZWHistoryAggregate>((int32)aggregates.size());
+#else
+	Platform::Array<ZWHistoryAggregate>^ result = gcnew Platform::Array<ZWHistoryAggregate>((uint32)aggregates.size());
+#endif
+	for (uint32 i = 0; i < (uint32)aggregates.size(); ++i)
+	{
+		ZWHistoryAggregate aggregate;
+		aggregate.Start = aggregates[i].m_start;
+		aggregate.End = aggregates[i].m_end;
+		aggregate.Count = aggregates[i].m_count;
+		aggregate.Min = aggregates[i].m_min;
+		aggregate.Max = aggregates[i].m_max;
+		aggregate.Average = aggregates[i].m_average;
+		aggregate.Last = aggregates[i].m_last;
+		result[i] = aggregate;
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::OpenValueKeys>
+// Loads the file of persistent value keys
+//-----------------------------------------------------------------------------
+bool ZWManager::OpenValueKeys
+(
+	String^ path
+)
+{
+	return Native::ValueKeys::Open(ConvertPath(path));
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetValueIdFromKey>
+// Gets the value that a persistent key was given to
+//-----------------------------------------------------------------------------
+ZWValueId^ ZWManager::GetValueIdFromKey
+(
+	uint32 key
+)
+{
+	ValueID valueId((uint32)0, (uint64)0);
+	if (!Native::ValueKeys::GetValueID(key, &valueId))
+	{
+		return nullptr;
+	}
+	return gcnew ZWValueId(valueId);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::LoadNetworkSnapshot>
+// Maps a snapshot file saved by SaveNetworkSnapshot
+//-----------------------------------------------------------------------------
+ZWNetworkSnapshot^ ZWManager::LoadNetworkSnapshot
+(
+	String^ path
+)
+{
+	Native::NetworkSnapshot* snapshot = Native::NetworkSnapshot::Load(ConvertPath(path));
+	if (snapshot == NULL)
+	{
+		return nullptr;
+	}
+	return gcnew ZWNetworkSnapshot(snapshot);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetChangesSince>
+// Gets the nodes and values of a network changed after a state version
+//-----------------------------------------------------------------------------
+ZWChangeSet^ ZWManager::GetChangesSince
+(
+	uint32 homeId,
+	uint64 version
+)
+{
+	Native::ChangeSet changes;
+	Native::ChangeLog::GetChangesSince(homeId, version, &changes);
+	return gcnew ZWChangeSet(homeId, changes);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetStartupProfile>
+// Gets the query stage timeline of a network
+//-----------------------------------------------------------------------------
+ZWStartupProfile^ ZWManager::GetStartupProfile
+(
+	uint32 homeId
+)
+{
+	Native::StartupProfile profile;
+	if (!Native::StartupProfiler::GetProfile(homeId, &profile))
+	{
+		return nullptr;
+	}
+	return gcnew ZWStartupProfile(profile);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetConfigWriteStats>
+// Gets the counters of a network's configuration file writes
+//-----------------------------------------------------------------------------
+ZWConfigWriteStats ZWManager::GetConfigWriteStats
+(
+	uint32 homeId
+)
+{
+	Native::ConfigWriteStats native;
+	Native::ConfigWriter::GetStats(homeId, &native);
+
+	ZWConfigWriteStats stats;
+	stats.Requests = native.m_requests;
+	stats.Writes = native.m_writes;
+	stats.Failures = native.m_failures;
+	stats.LastDuration = native.m_lastDurationMs;
+	stats.LastBytes = native.m_lastBytes;
+	stats.TotalBytes = native.m_totalBytes;
+	stats.LastWrittenAt = native.m_lastWrittenAt;
+	stats.IsPending = native.m_pending;
+	return stats;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::StartLogSink>
+// Replaces OpenZWave's logger with the asynchronous sink
+//-----------------------------------------------------------------------------
+bool ZWManager::StartLogSink
+(
+	ZWLogLevel level,
+	uint32 capacity,
+	String^ path
+)
+{
+#if __cplusplus_cli
+	if (m_onLogRecords == nullptr)
+	{
+		m_onLogRecords = gcnew OnLogRecordsFromUnmanagedDelegate(this, &ZWManager::OnLogRecordsFromUnmanaged);
+		m_gchLogRecords = GCHandle::Alloc(m_onLogRecords);
+	}
+	IntPtr ip = Marshal::GetFunctionPointerForDelegate(m_onLogRecords);
+	Native::LogSink::SetCallback((Native::LogSink::pfnOnRecords_t)ip.ToPointer(), NULL);
+#else
+	Native::LogSink::SetCallback(OnLogRecordsFromUnmanaged, reinterpret_cast<void*>(this));
+#endif
+
+	std::wstring file = (path != nullptr) ? ConvertPath(path) : std::wstring();
+	return Native::LogSink::Start((LogLevel)level, capacity, file);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetLogSinkStats>
+// Gets the counters of the log sink
+//-----------------------------------------------------------------------------
+ZWLogSinkStats ZWManager::GetLogSinkStats()
+{
+	Native::LogSinkStats native;
+	Native::LogSink::GetStats(&native);
+
+	ZWLogSinkStats stats;
+	stats.Written = native.m_written;
+	stats.Dropped = native.m_dropped;
+	stats.Truncated = native.m_truncated;
+	stats.Delivered = native.m_delivered;
+	stats.Batches = native.m_batches;
+	stats.Capacity = native.m_capacity;
+	stats.Pending = native.m_pending;
+	return stats;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetFrameCaptureStats>
+// Gets the counters of the frame capture
+//-----------------------------------------------------------------------------
+ZWFrameCaptureStats ZWManager::GetFrameCaptureStats()
+{
+	Native::FrameCaptureStats native;
+	Native::FrameCapture::GetStats(&native);
+
+	ZWFrameCaptureStats stats;
+	stats.Frames = native.m_frames;
+	stats.Dropped = native.m_dropped;
+	stats.BytesWritten = native.m_bytesWritten;
+	stats.Segments = native.m_segments;
+	stats.Running = native.m_running;
+	return stats;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetTrafficReport>
+// Gets the traffic counters of a network
+//-----------------------------------------------------------------------------
+ZWTrafficReport^ ZWManager::GetTrafficReport
+(
+	uint32 homeId
+)
+{
+	std::vector<Native::TrafficCounter> counters;
+	Native::TrafficCounters::GetCounters(homeId, &counters);
+	return gcnew ZWTrafficReport(homeId, counters);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::RenderMetrics>
+// Gets the text of a scrape of the metrics exporter
+//-----------------------------------------------------------------------------
+String^ ZWManager::RenderMetrics()
+{
+	std::vector<char> buffer;
+	uint32 length = Native::MetricsExporter::Render(&buffer);
+	return ConvertString(std::string(&buffer[0], length));
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::GetNodeConfiguration>
+// Gets every configuration value of a node
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWConfigParameter>^ ZWManager::GetNodeConfiguration
+#else
+Platform::Array<ZWConfigParameter>^ ZWManager::GetNodeConfiguration
+#endif
+(
+	uint32 homeId,
+	uint8 nodeId
+)
+{
+	std::vector<Native::ConfigParameter> parameters;
+	Native::ConfigTable::GetParameters(homeId, nodeId, &parameters);
+
+#if __cplusplus_cli
+	cli::array<ZWConfigParameter>^ snapshot = gcnew cli::array<ZWConfigParameter>((int32)parameters.size());
+#else
+	Platform::Array<ZWConfigParameter>^ snapshot = gcnew Platform::Array<ZWConfigParameter>((uint32)parameters.size());
+#endif
+	for (uint32 i = 0; i < (uint32)parameters.size(); ++i)
+	{
+		ZWConfigParameter parameter;
+		parameter.CommandClassId = parameters[i].m_commandClassId;
+		parameter.Instance = parameters[i].m_instance;
+		parameter.Index = parameters[i].m_index;
+		parameter.Type = (ZWValueType)parameters[i].m_type;
+		parameter.ReadOnly = parameters[i].m_readOnly;
+		parameter.Label = ConvertString(parameters[i].m_label);
+		parameter.Value = ConvertString(parameters[i].m_value);
+		snapshot[i] = parameter;
+	}
+	return snapshot;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWManager::ApplyNodeConfiguration>
+// Compare a profile with a node's configuration
+//-----------------------------------------------------------------------------
+ZWConfigurationJob^ ZWManager::ApplyNodeConfiguration
+(
+	uint32 homeId,
+	uint8 nodeId,
+#if __cplusplus_cli
+	cli::array<ZWConfigParameter>^ profile
+#else
+	const Platform::Array<ZWConfigParameter>^ profile
+#endif
+)
+{
+	std::vector<Native::ConfigWrite> writes(profile->Length);
+	for (uint32 i = 0; i < (uint32)writes.size(); ++i)
+	{
+		ZWConfigParameter parameter = profile[i];
+		writes[i].m_valueId = 0;
+		writes[i].m_commandClassId = parameter.CommandClassId;
+		writes[i].m_instance = parameter.Instance;
+		writes[i].m_index = parameter.Index;
+		writes[i].m_value = ConvertString(parameter.Value);
+		writes[i].m_result = Native::ConfigResult_Pending;
+	}
+	return gcnew ZWConfigurationJob(homeId, nodeId, writes);
+}
+
 //-----------------------------------------------------------------------------
 // <ZWManager::GetAssociations>
 // Gets the associations for a group
@@ -654,5 +1326,73 @@ uint32 ZWManager::GetAssociations
 }
 #endif
 
+//-----------------------------------------------------------------------------
+// <ZWManager::ApplyAssociationChanges>
+// Send only the association changes that alter a group
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWAssociationChange>^ ZWManager::ApplyAssociationChanges
+(
+	uint32 homeId,
+	cli::array<ZWAssociationChange>^ changes
+)
+{
+	std::vector<Native::AssociationChange> requested(changes->Length);
+	for (int32 i = 0; i < changes->Length; ++i)
+	{
+		requested[i].m_nodeId = changes[i].NodeId;
+		requested[i].m_groupIdx = changes[i].GroupIdx;
+		requested[i].m_targetNodeId = changes[i].TargetNodeId;
+		requested[i].m_remove = changes[i].Remove;
+	}
+
+	std::vector<Native::AssociationChange> commands;
+	Native::AssociationGraph::ComputeCommands(homeId, requested, &commands);
+	Native::AssociationGraph::Apply(homeId, commands);
+
+	cli::array<ZWAssociationChange>^ sent = gcnew cli::array<ZWAssociationChange>((int32)commands.size());
+	for (size_t i = 0; i < commands.size(); ++i)
+	{
+		sent[(int32)i].NodeId = commands[i].m_nodeId;
+		sent[(int32)i].GroupIdx = commands[i].m_groupIdx;
+		sent[(int32)i].TargetNodeId = commands[i].m_targetNodeId;
+		sent[(int32)i].Remove = commands[i].m_remove;
+	}
+	return sent;
+}
+#else
+Platform::Array<ZWAssociationChange>^ ZWManager::ApplyAssociationChanges
+(
+	uint32 homeId,
+	const Platform::Array<ZWAssociationChange>^ changes
+)
+{
+	std::vector<Native::AssociationChange> requested(changes->Length);
+	for (uint32 i = 0; i < changes->Length; ++i)
+	{
+		requested[i].m_nodeId = changes[i].NodeId;
+		requested[i].m_groupIdx = changes[i].GroupIdx;
+		requested[i].m_targetNodeId = changes[i].TargetNodeId;
+		requested[i].m_remove = changes[i].Remove;
+	}
+
+	std::vector<Native::AssociationChange> commands;
+	Native::AssociationGraph::ComputeCommands(homeId, requested, &commands);
+	Native::AssociationGraph::Apply(homeId, commands);
+
+	Platform::Array<ZWAssociationChange>^ sent = gcnew Platform::Array<ZWAssociationChange>((uint32)commands.size());
+	for (size_t i = 0; i < commands.size(); ++i)
+	{
+		ZWAssociationChange change;
+		change.NodeId = commands[i].m_nodeId;
+		change.GroupIdx = commands[i].m_groupIdx;
+		change.TargetNodeId = commands[i].m_targetNodeId;
+		change.Remove = commands[i].m_remove;
+		sent[(uint32)i] = change;
+	}
+	return sent;
+}
+#endif
+
 
 
@@ -32,7 +32,29 @@
 
 #include "ZWEnums.h"
 #include "ZWValueID.h"
+#include "ZWConvert.h"
 #include "ZWNotification.h"
+#include "ZWMemoryReport.h"
+#include "ZWNetworkTopology.h"
+#include "ZWHealPlanner.h"
+#include "ZWAssociationGraph.h"
+#include "ZWWakeUpQueue.h"
+#include "ZWConfiguration.h"
+#include "ZWAdaptivePoller.h"
+#include "ZWPolling.h"
+#include "ZWValueHistory.h"
+#include "ZWHistoryLog.h"
+#include "ZWNetworkSnapshot.h"
+#include "ZWChangeSet.h"
+#include "NodeRegistry.h"
+#include "ZWNodeInfo.h"
+#include "ZWStartupProfile.h"
+#include "ZWConfigWriter.h"
+#include "ZWLogSink.h"
+#include "ZWFrameCapture.h"
+#include "ZWTrafficReport.h"
+#include "MetricsExporter.h"
+#include "ControllerHost.h"
 
 using namespace OpenZWave;
 #if __cplusplus_cli
@@ -48,12 +70,16 @@ namespace OpenZWave
 	ref class ZWManager;
 
 	public delegate void NotificationReceivedEventHandler(ZWManager^ sender, NotificationReceivedEventArgs^ e);
+	public delegate void LogRecordsReceivedEventHandler(ZWManager^ sender, LogRecordsReceivedEventArgs^ e);
 
 #if __cplusplus_cli
 
 	[UnmanagedFunctionPointer(CallingConvention::Cdecl)]
 	private delegate void OnNotificationFromUnmanagedDelegate(Notification* _notification, void* _context);
 
+	[UnmanagedFunctionPointer(CallingConvention::Cdecl)]
+	private delegate void OnLogRecordsFromUnmanagedDelegate(Native::LogRecord* _records, uint32 _count, void* _context);
+
 #else
 	private delegate void OnNotificationFromUnmanagedDelegate(void *_notification, void* _context);
 #endif
@@ -108,10 +134,22 @@ namespace OpenZWave
 	private:
 
 		bool m_isInitialized = false;
+
+		// The latest GetNodeInfo record of each node.  Each network asked for gets c_maxNodes entries of
+		// m_nodeInfos, in the order of m_nodeInfoHomes.  Both are made by Initialize and replaced together
+		// when another network is added, under m_nodeInfoLock, which lives as long as the manager.
+#if __cplusplus_cli
+		cli::array<uint32>^ m_nodeInfoHomes;
+		cli::array<ZWNodeInfo^>^ m_nodeInfos;
+#else
+		Platform::Array<uint32>^ m_nodeInfoHomes;
+		Platform::Array<ZWNodeInfo^>^ m_nodeInfos;
+#endif
+		Native::Lock* m_nodeInfoLock;
 #if __cplusplus_cli
 		static ZWManager^ s_instance = nullptr;
 #endif
-		ZWManager() { }
+		ZWManager() : m_nodeInfoLock(new Native::Lock()) { }
 
 	public:
 		/// <summary>Gets a reference to the single ZWManager instance</summary>
@@ -122,6 +160,11 @@ namespace OpenZWave
 		/// <summary>Event fired when a notification is received from the controller or a node</summary>
 		event NotificationReceivedEventHandler^ NotificationReceived;
 
+		/// <summary>Event fired from a thread pool thread with each batch of messages taken from the log sink</summary>
+		/// <remarks>Handlers must not call StopLogSink or FlushLogSink.  GetLogSinkStats may be called.</remarks>
+		/// <seealso cref="StartLogSink" />
+		event LogRecordsReceivedEventHandler^ LogRecordsReceived;
+
 		/// <summary>Creates the Manager singleton object.</summary>
 		/// <remarks>
 		/// The Manager provides the public interface to OpenZWave, exposing all the functionality required to add Z-Wave support to an application.
@@ -134,8 +177,11 @@ namespace OpenZWave
 		void Initialize();
 
 		/// <summary>Deletes the Manager and cleans up any associated objects.</summary>
+		/// <remarks>The wrapper forgets what it learned from the notifications, so nodes, values, configuration and poll
+		/// tables, history samples and the change log start empty after the next Initialize.  An open value key file is closed.
+		/// Memory tracking and history recording keep their settings.</remarks>
 		/// <seealso cref="Initialize" />
-		void Destroy() { Manager::Get()->Destroy(); m_isInitialized = false; }
+		void Destroy();
 
 		/// <summary>Get the Version Number of OZW as a string</summary>
 		/// <returns>A String representing the version number as MAJOR.MINOR.REVISION</returns>
@@ -342,6 +388,38 @@ namespace OpenZWave
 		// \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_HOMEID if the Driver cannot be found
 		uint8 GetPollIntensity(ZWValueId^ valueId) { return Manager::Get()->GetPollIntensity(valueId->CreateUnmanagedValueID()); }
 
+		/// <summary>Enable the polling of many values at once.</summary>
+		/// <param name="valueIds">The IDs of the values to start polling.</param>
+		/// <param name="intensity">number of polling for one polling interval.</param>
+		/// <returns>The number of values for which polling was enabled.</returns>
+		/// <seealso cref="GetPolledValues" />
+#if __cplusplus_cli
+		int32 EnablePoll(cli::array<ZWValueId^>^ valueIds, uint8 intensity);
+#else
+		int32 EnablePoll(const Platform::Array<ZWValueId^>^ valueIds, uint8 intensity);
+#endif
+
+		/// <summary>Disable the polling of many values at once.</summary>
+		/// <param name="valueIds">The IDs of the values to stop polling.</param>
+		/// <returns>The number of values for which polling was disabled.</returns>
+#if __cplusplus_cli
+		int32 DisablePoll(cli::array<ZWValueId^>^ valueIds);
+#else
+		int32 DisablePoll(const Platform::Array<ZWValueId^>^ valueIds);
+#endif
+
+		/// <summary>Get every value that is polled, with its intensity and report statistics.</summary>
+		/// <remarks>This replaces an IsPolled and GetPollIntensity call per value.  Values whose polling was enabled
+		/// before ZWManager.Initialize, for example from a device configuration file, are included once OpenZWave
+		/// has sent their PollingEnabled notification.</remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>The polled values, ordered by ZWValueId.Id.</returns>
+#if __cplusplus_cli
+		cli::array<ZWPolledValue>^ GetPolledValues(uint32 homeId);
+#else
+		Platform::Array<ZWPolledValue>^ GetPolledValues(uint32 homeId);
+#endif
+
 		/*@}*/
 
 		//-----------------------------------------------------------------------------
@@ -472,6 +550,15 @@ namespace OpenZWave
 			uint32 homeId, uint8 nodeId, Platform::Array<byte>^ *o_associations);
 #endif
 
+		/// <summary>Get the neighbor lists of every node in the network.</summary>
+		/// <remarks>
+		/// The whole 232 x 232 neighbor matrix is built in one native pass.  Use it instead of calling
+		/// GetNodeNeighbors for every node when drawing the mesh or analysing routes.
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>A snapshot of the neighbor matrix, with degree, reachability and hop count helpers.</returns>
+		ZWNetworkTopology^ GetNetworkTopology(uint32 homeId) { return gcnew ZWNetworkTopology(homeId); }
+
 		/// <summary>Get the manufacturer name of a device.</summary>
 		/// <remarks>
 		/// The manufacturer name would normally be handled by the Manufacturer Specific commmand class,
@@ -683,6 +770,51 @@ namespace OpenZWave
 		/// <returns>name of current query stage as a string.</returns>
 		String^ GetNodeQueryStage(uint32 homeId, uint8 nodeId) { return ConvertString(Manager::Get()->GetNodeQueryStage(homeId, nodeId)); }
 
+		/// <summary>Gets the static attributes of a node from the node registry.</summary>
+		/// <remarks>
+		/// <para>The registry keeps the classes, version, baud rate, capability flags and names of every node,
+		/// read from OpenZWave when the node is added and again on NodeProtocolInfo, NodeNaming and
+		/// EssentialNodeQueriesComplete, so finding the node of a notification is an array lookup rather than
+		/// a call per attribute.
+		/// Nodes are dropped from it when removed, and with their network when the driver is.</para>
+		/// <para>Use it instead of keeping nodes in a list and searching it on every notification.</para>
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the node.</param>
+		/// <param name="nodeId">The ID of the node to find.</param>
+		/// <param name="o_node">Set to the node's attributes.</param>
+		/// <returns>False if the node has not been added, or has been removed.</returns>
+		/// <seealso cref="GetNodes" />
+		bool FindNode(
+#if __cplusplus_cli
+			uint32 homeId, uint8 nodeId, [Out] ZWSnapshotNode %o_node);
+#else
+			uint32 homeId, uint8 nodeId, ZWSnapshotNode *o_node);
+#endif
+
+		/// <summary>Gets the static attributes of every node of a network from the node registry.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>The nodes, sorted by ID.  Empty if the network is unknown.</returns>
+		/// <seealso cref="FindNode" />
+#if __cplusplus_cli
+		cli::array<ZWSnapshotNode>^ GetNodes(uint32 homeId);
+#else
+		Platform::Array<ZWSnapshotNode>^ GetNodes(uint32 homeId);
+#endif
+
+		/// <summary>Gets the static attributes of a node in one immutable record.</summary>
+		/// <remarks>
+		/// <para>Use it instead of calling IsNodeListeningDevice, GetNodeVersion, GetNodeGeneric, GetNodeManufacturerId
+		/// and the rest one by one, each of which locks OpenZWave and converts a string.  The record is made from the
+		/// node registry and kept; the same record is returned until a NodeProtocolInfo, NodeNaming or
+		/// EssentialNodeQueriesComplete notification for the node, so a view can call it on every property bind.
+		/// Records are kept for each network separately, and it may be called from any thread.</para>
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the node.</param>
+		/// <param name="nodeId">The ID of the node to query.</param>
+		/// <returns>The record, or null if the node has not been added, or has been removed.</returns>
+		/// <seealso cref="FindNode" />
+		ZWNodeInfo^ GetNodeInfo(uint32 homeId, uint8 nodeId);
+
 		/*@}*/
 
 		//-----------------------------------------------------------------------------
@@ -1227,6 +1359,34 @@ namespace OpenZWave
 		/// <seealso cref="ValueID" />
 		/// <seealso cref="Notification" />
 		void RequestAllConfigParams(uint32 homeId, uint8 nodeId) { Manager::Get()->RequestAllConfigParams(homeId, nodeId); }
+
+		/// <summary>Gets every configuration value of a node in one call.</summary>
+		/// <remarks>The values come from OpenZWave's cache, so nothing is sent to the node.  Call RequestAllConfigParams
+		/// first if the cache may be stale.</remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the node.</param>
+		/// <param name="nodeId">The ID of the node to read.</param>
+		/// <returns>The node's Config genre values, sorted by command class, instance and index.</returns>
+		/// <seealso cref="ApplyNodeConfiguration" />
+#if __cplusplus_cli
+		cli::array<ZWConfigParameter>^ GetNodeConfiguration(uint32 homeId, uint8 nodeId);
+#else
+		Platform::Array<ZWConfigParameter>^ GetNodeConfiguration(uint32 homeId, uint8 nodeId);
+#endif
+
+		/// <summary>Prepares to bring a node's configuration in line with a profile.</summary>
+		/// <remarks>The profile is usually the result of GetNodeConfiguration for a reference device of the same
+		/// model.  Each entry is compared with the node's cached value, and the returned job sends only the ones
+		/// that differ when it is started.</remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the node.</param>
+		/// <param name="nodeId">The ID of the node to configure.</param>
+		/// <param name="profile">The parameters to apply, matched on CommandClassId, Instance and Index.</param>
+		/// <returns>A job that has not been started.</returns>
+		/// <seealso cref="GetNodeConfiguration" />
+#if __cplusplus_cli
+		ZWConfigurationJob^ ApplyNodeConfiguration(uint32 homeId, uint8 nodeId, cli::array<ZWConfigParameter>^ profile);
+#else
+		ZWConfigurationJob^ ApplyNodeConfiguration(uint32 homeId, uint8 nodeId, const Platform::Array<ZWConfigParameter>^ profile);
+#endif
 		/*@}*/
 
 		//-----------------------------------------------------------------------------
@@ -1317,6 +1477,30 @@ namespace OpenZWave
 		/// <seealso cref="GetAssociations" />
 		/// <seealso cref="AddAssociation" />
 		void RemoveAssociation(uint32 homeId, uint8 nodeId, uint8 groupIdx, uint8 targetNodeId) { return Manager::Get()->RemoveAssociation(homeId, nodeId, groupIdx, targetNodeId); }
+
+		/// <summary>Gets every association group and association of every node in the network.</summary>
+		/// <remarks>All groups are read in one pass, instead of one GetNumGroups, GetAssociations and GetMaxAssociations call per node and group.</remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>A snapshot of the association graph.</returns>
+		/// <seealso cref="ApplyAssociationChanges" />
+		ZWAssociationGraph^ GetAssociationGraph(uint32 homeId) { return gcnew ZWAssociationGraph(homeId); }
+
+		/// <summary>Adds and removes many associations at once.</summary>
+		/// <remarks>Only the changes that alter a group are sent: adding a target that is already in the group, or removing one
+		/// that is not, sends nothing.  When several changes name the same association the last one wins.  The commands for
+		/// each group are sent together, removals first, and additions that would overflow the group are dropped.  As with
+		/// AddAssociation, commands for a sleeping node are queued until it wakes up.</remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <param name="changes">The associations to add or remove.</param>
+		/// <returns>The changes that were actually sent, in the order they were sent.</returns>
+		/// <seealso cref="GetAssociationGraph" />
+		/// <seealso cref="AddAssociation" />
+		/// <seealso cref="RemoveAssociation" />
+#if __cplusplus_cli
+		cli::array<ZWAssociationChange>^ ApplyAssociationChanges(uint32 homeId, cli::array<ZWAssociationChange>^ changes);
+#else
+		Platform::Array<ZWAssociationChange>^ ApplyAssociationChanges(uint32 homeId, const Platform::Array<ZWAssociationChange>^ changes);
+#endif
 		/*@}*/
 
 		//-----------------------------------------------------------------------------
@@ -1366,6 +1550,7 @@ namespace OpenZWave
 		/// Can take a while on larger networks.</remarks>
 		/// <param name="homeId">The Home ID of the Z-Wave network to be healed.</param>
 		/// <param name="doRR">Whether to perform return routes initialization.</param>
+		/// <seealso cref="ZWHealPlanner" />
 		void HealNetwork(uint32 homeId, bool doRR) { Manager::Get()->HealNetwork(homeId, doRR); }
 
 		/// <summary>Start the Inclusion Process to add a Node to the Network.</summary>
@@ -1557,35 +1742,470 @@ namespace OpenZWave
 		/// <returns>true if a command was running and was cancelled.</returns>
 		bool CancelControllerCommand(uint32 homeId) { return Manager::Get()->CancelControllerCommand(homeId); }
 
+		/// <summary>
+		/// Enables or disables counting of the objects and native memory held by the wrapper.
+		/// </summary>
+		/// <remarks>
+		/// Tracking adds a lock and a map lookup to every ZWValueId, ZWNotification and event
+		/// argument created, so it is off by default.  Set it before calling AddDriver so that
+		/// the value counts in the memory report include the values loaded at startup.
+		/// </remarks>
+		/// <seealso cref="GetMemoryReport" />
+		property bool MemoryTrackingEnabled
+		{
+			bool get() { return Native::MemoryTracker::IsEnabled(); }
+			void set(bool value) { Native::MemoryTracker::SetEnabled(value); }
+		}
+
+		/// <summary>
+		/// Takes a snapshot of the memory used by the wrapper, broken down per controller and node.
+		/// </summary>
+		/// <returns>The memory report.  It is empty unless MemoryTrackingEnabled is set.</returns>
+		/// <seealso cref="MemoryTrackingEnabled" />
+		ZWMemoryReport^ GetMemoryReport() { return gcnew ZWMemoryReport(); }
+
+		/// <summary>
+		/// Enables or disables the native history of value changes.
+		/// </summary>
+		/// <remarks>
+		/// While enabled, every ValueChanged of a bool, button, byte, short, int, decimal or list value adds a
+		/// sample to a ring kept for that value, before the notification is raised.  The last
+		/// ValueHistoryCapacity samples of each value are kept.  Disabling the history drops every sample.
+		/// </remarks>
+		/// <seealso cref="GetValueHistory" />
+		/// <seealso cref="GetValueHistoryAggregates" />
+		property bool ValueHistoryEnabled
+		{
+			bool get() { return Native::ValueHistory::IsEnabled(); }
+			void set(bool value) { Native::ValueHistory::SetEnabled(value); }
+		}
+
+		/// <summary>
+		/// Gets or sets the number of samples kept per value.  The default is 256.
+		/// </summary>
+		/// <remarks>Each sample takes 16 bytes.  Changing the capacity keeps the newest samples.</remarks>
+		property uint32 ValueHistoryCapacity
+		{
+			uint32 get() { return Native::ValueHistory::GetCapacity(); }
+			void set(uint32 value) { Native::ValueHistory::SetCapacity(value); }
+		}
+
+		/// <summary>Gets the recorded samples of a value in a time range, oldest first.</summary>
+		/// <param name="id">The unique identifier of the value.</param>
+		/// <param name="from">The start of the range, as a UTC file time (DateTime.ToFileTimeUtc).</param>
+		/// <param name="to">The end of the range, as a UTC file time.  It is not part of the range.</param>
+		/// <returns>The samples.  It is empty unless ValueHistoryEnabled is set.</returns>
+		/// <seealso cref="ValueHistoryEnabled" />
 #if __cplusplus_cli
-	private:
-		void  OnNotificationFromUnmanaged(Notification* _notification, void* _context);					// Forward notification to managed delegates hooked via Event addhandler 
-	
-		GCHandle										m_gchNotification;
-		OnNotificationFromUnmanagedDelegate^			m_onNotification;
+		cli::array<ZWHistorySample>^ GetValueHistory(ZWValueId^ id, int64 from, int64 to);
 #else
-	internal:
-		static void OnNotificationFromUnmanaged(OpenZWave::Notification const * _notification, void * _context);
+		Platform::Array<ZWHistorySample>^ GetValueHistory(ZWValueId^ id, int64 from, int64 to);
 #endif
 
-	private:
-		std::string ConvertString(String^ value) {
+		/// <summary>Gets the min, max, average and last value of a value over equal windows of a time range.</summary>
+		/// <remarks>The aggregation runs over the native ring, so drawing a sparkline does not copy the samples.</remarks>
+		/// <param name="id">The unique identifier of the value.</param>
+		/// <param name="from">The start of the range, as a UTC file time (DateTime.ToFileTimeUtc).</param>
+		/// <param name="to">The end of the range, as a UTC file time.  It is not part of the range.</param>
+		/// <param name="windows">The number of windows to split the range into.  At most 10000 are returned, and none shorter than a millisecond.</param>
+		/// <returns>One aggregate per window, oldest first.</returns>
+		/// <seealso cref="ValueHistoryEnabled" />
 #if __cplusplus_cli
-			return msclr::interop::marshal_as<std::string>(value);
+		cli::array<ZWHistoryAggregate>^ GetValueHistoryAggregates(ZWValueId^ id, int64 from, int64 to, uint32 windows);
 #else
-			std::wstring_convert<std::codecvt_utf8<wchar_t>> convert;
-			return convert.to_bytes(value->Data());
+		Platform::Array<ZWHistoryAggregate>^ GetValueHistoryAggregates(ZWValueId^ id, int64 from, int64 to, uint32 windows);
 #endif
+
+		/// <summary>
+		/// Loads the file of persistent value keys, creating it if it does not exist.
+		/// </summary>
+		/// <remarks>
+		/// <para>While the file is open, every value gets a key from 1 up the first time it is added or its
+		/// ZWValueId.GetKey is called.  ZWValueId.GetKey returns a key only once it is flushed to disk, and a value
+		/// gets the same key every time the file is loaded, so external stores can use it in place of the home,
+		/// node, command class, instance and index.  Keys are never reused, even after the value is removed.</para>
+		/// <para>Adding a value only reserves its key in memory.  Reserved keys are written, in one flush, by the
+		/// next GetKey that needs one of them, or by CloseValueKeys.  Those never given out are lost if the process
+		/// ends first, and their values may get other keys the next time.</para>
+		/// <para>Open the file before ZWManager.AddDriver, so that values loaded from the network cache get their
+		/// keys in the order they are added.</para>
+		/// </remarks>
+		/// <param name="path">The path of the key file.</param>
+		/// <returns>False if the file could not be opened or is not a key file.</returns>
+		/// <seealso cref="ZWValueId.GetKey" />
+		bool OpenValueKeys(String^ path);
+
+		/// <summary>Closes the file of persistent value keys.  ZWValueId.GetKey returns 0 until one is opened again.</summary>
+		void CloseValueKeys() { Native::ValueKeys::Close(); }
+
+		/// <summary>Gets the number of value keys saved to the file.  Every key from 1 up to this number is in use.</summary>
+		property uint32 ValueKeyCount { uint32 get() { return Native::ValueKeys::GetCount(); } }
+
+		/// <summary>Gets the value that a persistent key was given to.</summary>
+		/// <param name="key">A key from ZWValueId.GetKey.</param>
+		/// <returns>The value, or null if the key has not been given out.</returns>
+		ZWValueId^ GetValueIdFromKey(uint32 key);
+
+		/// <summary>
+		/// Saves the nodes and values of a network, with their metadata and current values, to a snapshot file.
+		/// </summary>
+		/// <remarks>
+		/// <para>The snapshot holds every node and value added since ZWManager.Initialize.  The file is replaced only
+		/// once the new snapshot is complete.</para>
+		/// <para>On the next start, load it with LoadNetworkSnapshot right after AddDriver, to fill the
+		/// application's tables without waiting for AllNodesQueried.</para>
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <param name="path">The path of the snapshot file.</param>
+		/// <returns>False if the network is unknown or the file could not be written.</returns>
+		/// <seealso cref="LoadNetworkSnapshot" />
+		/// <seealso cref="SetNetworkSnapshotAutoSave" />
+		bool SaveNetworkSnapshot(uint32 homeId, String^ path) { return Native::NetworkSnapshot::Save(homeId, ConvertPath(path)); }
+
+		/// <summary>
+		/// Saves a network's snapshot periodically, and when the manager is destroyed.
+		/// </summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <param name="path">The path of the snapshot file.</param>
+		/// <param name="interval">Milliseconds between saves.  Use 0 to stop saving the network.</param>
+		/// <seealso cref="SaveNetworkSnapshot" />
+		void SetNetworkSnapshotAutoSave(uint32 homeId, String^ path, uint32 interval) { Native::NetworkSnapshot::SetAutoSave(homeId, ConvertPath(path), interval); }
+
+		/// <summary>
+		/// Loads a snapshot saved by SaveNetworkSnapshot.
+		/// </summary>
+		/// <remarks>
+		/// The file is mapped rather than read, so loading takes the same time however big the network is.
+		/// Notifications received after loading mark the snapshot's values as current or removed, and
+		/// ZWNetworkSnapshot.StaleCount falls to 0 as the network is queried.
+		/// </remarks>
+		/// <param name="path">The path of the snapshot file.</param>
+		/// <returns>The snapshot, or null if the file is missing or is not a snapshot.</returns>
+		/// <seealso cref="SaveNetworkSnapshot" />
+		ZWNetworkSnapshot^ LoadNetworkSnapshot(String^ path);
+
+		/// <summary>
+		/// Gets the version of the latest change to any node or value, on any network.
+		/// </summary>
+		/// <remarks>
+		/// Every notification that adds, changes or removes a node or value moves the version on.  Keep the
+		/// version a client last synchronized at and pass it to GetChangesSince.
+		/// </remarks>
+		/// <seealso cref="GetChangesSince" />
+		property uint64 StateVersion { uint64 get() { return Native::ChangeLog::GetVersion(); } }
+
+		/// <summary>
+		/// Gets the nodes and values of a network added, changed or removed after a state version.
+		/// </summary>
+		/// <remarks>
+		/// <para>Each node and value changed is returned once, as it is now, however often it changed.  The last
+		/// 8192 changes are kept; a client further behind, or holding a version from an earlier run, gets the whole
+		/// network with ZWChangeSet.IsFullSnapshot set.  Pass 0 to get the whole network to start with.</para>
+		/// <para>A value refreshed with no change in its value is not a change.</para>
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <param name="version">The ZWChangeSet.Version of the last call, or StateVersion when the client last read the network.</param>
+		/// <returns>The changes, with the version to pass next time.</returns>
+		/// <seealso cref="StateVersion" />
+		ZWChangeSet^ GetChangesSince(uint32 homeId, uint64 version);
+
+		/// <summary>
+		/// Enables or disables the timeline of the query stages each node goes through.
+		/// </summary>
+		/// <remarks>
+		/// <para>While enabled, the stage of a node is read whenever a notification arrives for it, and every
+		/// 250 milliseconds until AllNodesQueried, and each change is recorded.  Set it before calling AddDriver,
+		/// so the profile starts when the driver is ready.  Enabling it later starts the profile from the
+		/// next notification.</para>
+		/// <para>Disabling it stops the sampling but keeps the profiles recorded so far.</para>
+		/// </remarks>
+		/// <seealso cref="GetStartupProfile" />
+		property bool StartupProfilingEnabled
+		{
+			bool get() { return Native::StartupProfiler::IsEnabled(); }
+			void set(bool value) { Native::StartupProfiler::SetEnabled(value); }
+		}
+
+		/// <summary>
+		/// Gets the query stage timeline of a network, with the nodes and stages that took the most time.
+		/// </summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>The profile, or null if none has been recorded for the network.</returns>
+		/// <seealso cref="StartupProfilingEnabled" />
+		ZWStartupProfile^ GetStartupProfile(uint32 homeId);
+
+		/// <summary>
+		/// Writes the configuration file of a network now, on the calling thread.
+		/// </summary>
+		/// <remarks>
+		/// OpenZWave rewrites the whole zwcfg_0x&lt;homeId&gt;.xml file in the user path.  The current file is first
+		/// renamed to zwcfg_0x&lt;homeId&gt;.xml.bak, and put back if the new file is not complete.  On large networks
+		/// the write takes long enough to stall the caller, so prefer RequestWriteConfig.
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>True if a complete file was written.</returns>
+		/// <seealso cref="RequestWriteConfig" />
+		/// <seealso cref="RecoverConfig" />
+		bool WriteConfig(uint32 homeId) { return Native::ConfigWriter::Write(homeId); }
+
+		/// <summary>
+		/// Asks for the configuration file of a network to be written on a background thread.
+		/// </summary>
+		/// <remarks>
+		/// The write starts once no request has arrived for ConfigWriteDelay, or once the first request has waited
+		/// ConfigWriteMaxDelay, so a burst of changes is saved with one write.  Pending writes are done when the
+		/// manager is destroyed.
+		/// </remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <seealso cref="SetConfigAutoWrite" />
+		/// <seealso cref="FlushConfig" />
+		/// <seealso cref="GetConfigWriteStats" />
+		void RequestWriteConfig(uint32 homeId) { Native::ConfigWriter::Request(homeId); }
+
+		/// <summary>Does a requested write of a network's configuration file now, on the calling thread.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>False if a pending write did not produce a complete file.</returns>
+		bool FlushConfig(uint32 homeId) { return Native::ConfigWriter::Flush(homeId); }
+
+		/// <summary>
+		/// Requests a write of a network's configuration file after each change that OpenZWave saves in it.
+		/// </summary>
+		/// <remarks>Node names and locations, nodes added or removed, association groups and configuration
+		/// parameters request a write, so SetNodeName, SetNodeLocation, AddAssociation and the like are saved
+		/// without the application calling RequestWriteConfig.</remarks>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <param name="enabled">True to request writes from the network's notifications.</param>
+		void SetConfigAutoWrite(uint32 homeId, bool enabled) { Native::ConfigWriter::SetAutoWrite(homeId, enabled); }
+
+		/// <summary>Gets whether changes to a network request a write of its configuration file.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		bool GetConfigAutoWrite(uint32 homeId) { return Native::ConfigWriter::GetAutoWrite(homeId); }
+
+		/// <summary>Gets or sets the milliseconds without a request before a requested write starts.  The default is 2000.</summary>
+		property uint32 ConfigWriteDelay
+		{
+			uint32 get() { return Native::ConfigWriter::GetDelay(); }
+			void set(uint32 value) { Native::ConfigWriter::SetDelay(value); }
+		}
+
+		/// <summary>Gets or sets the longest a requested write waits while requests keep arriving.  The default is 30000 milliseconds.</summary>
+		property uint32 ConfigWriteMaxDelay
+		{
+			uint32 get() { return Native::ConfigWriter::GetMaxDelay(); }
+			void set(uint32 value) { Native::ConfigWriter::SetMaxDelay(value); }
+		}
+
+		/// <summary>Gets the number of writes of a network's configuration file, and the duration and size of the last one.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		ZWConfigWriteStats GetConfigWriteStats(uint32 homeId);
+
+		/// <summary>
+		/// Restores the configuration files that a crash left missing or cut short from their backups.
+		/// </summary>
+		/// <remarks>Call it after Initialize and before AddDriver, so OpenZWave loads the restored files.</remarks>
+		/// <returns>The number of files restored.</returns>
+		uint32 RecoverConfig() { return Native::ConfigWriter::Recover(); }
+
+		/// <summary>
+		/// Replaces OpenZWave's log file with an asynchronous sink.
+		/// </summary>
+		/// <remarks>
+		/// <para>OpenZWave's own logger writes each message to its file on the driver thread, which slows message
+		/// handling at the Detail and Debug levels.  The sink formats each message into a slot of an in-memory ring
+		/// instead, without locking or allocating, and a thread pool timer takes the messages out in batches: it
+		/// appends them to the file in one write, and raises LogRecordsReceived.  When the ring is full, new
+		/// messages are dropped and counted in GetLogSinkStats.</para>
+		/// <para>The sink replaces OpenZWave's logger until Destroy, so SetLogFileName has no effect, and the sink
+		/// must be started again after each Initialize.  It turns logging on; SetLoggingState(false) still turns
+		/// it off.</para>
+		/// </remarks>
+		/// <param name="level">The most detailed level to capture.</param>
+		/// <param name="capacity">The number of messages the ring holds, rounded up to a power of two, or 0 for 4096.
+		/// Only the first start after Initialize sets it.</param>
+		/// <param name="path">The file to append the messages to, in the format of OpenZWave's log, or null for none.</param>
+		/// <returns>False if the file could not be opened.</returns>
+		/// <seealso cref="LogRecordsReceived" />
+		/// <seealso cref="StopLogSink" />
+		bool StartLogSink(ZWLogLevel level, uint32 capacity, String^ path);
+
+		/// <summary>Stops capturing messages, delivers those in the ring and closes the file.</summary>
+		/// <remarks>OpenZWave's own logger is not restored until the manager is destroyed.</remarks>
+		void StopLogSink() { Native::LogSink::Stop(); }
+
+		/// <summary>Gets or sets the most detailed level the log sink captures.</summary>
+		property ZWLogLevel LogSinkLevel
+		{
+			ZWLogLevel get() { return (ZWLogLevel)Native::LogSink::GetLevel(); }
+			void set(ZWLogLevel value) { Native::LogSink::SetLevel((LogLevel)value); }
+		}
+
+		/// <summary>Gets or sets the milliseconds between batches of the log sink.  The default is 250 milliseconds.</summary>
+		property uint32 LogSinkInterval
+		{
+			uint32 get() { return Native::LogSink::GetInterval(); }
+			void set(uint32 value) { Native::LogSink::SetInterval(value); }
+		}
+
+		/// <summary>Delivers the messages in the log sink's ring now, on the calling thread.</summary>
+		void FlushLogSink() { Native::LogSink::Flush(); }
+
+		/// <summary>Gets the number of messages the log sink has captured, dropped and delivered.</summary>
+		/// <remarks>The counters are read without waiting for a batch being delivered, so the call never blocks.</remarks>
+		ZWLogSinkStats GetLogSinkStats();
+
+		/// <summary>
+		/// Starts recording the frames exchanged with the controller to binary segment files.
+		/// </summary>
+		/// <remarks>
+		/// <para>OpenZWave does not expose the serial port, so the capture reads the frames back out of the messages
+		/// the driver logs for every frame sent and received, and every ACK, NAK, CAN and dropped command.  It takes
+		/// them from the logger the log sink installs, whatever the log sink's level, so it turns logging on, and
+		/// SetLoggingState(false) stops it too.  Each frame is parsed once and stored as a fixed size record with
+		/// its raw bytes, so a capture of a busy network stays small and is read without parsing text.</para>
+		/// <para>The records are written by a thread pool timer to frames-NNNNNNNN.ozf files in the directory.  A new
+		/// file is started when one reaches the segment size, and the oldest are deleted beyond the segment count.
+		/// Decode them with the OpenZWaveFrameDecoder tool, which lists the frames and reports retries, NAKs and the
+		/// round trip times of each command.</para>
+		/// </remarks>
+		/// <param name="directory">The directory of the segment files, created if missing.</param>
+		/// <param name="segmentSize">The bytes after which a new file is started, or 0 for 4 MB.</param>
+		/// <param name="maxSegments">The number of files to keep, or 0 for 8.</param>
+		/// <returns>False if the directory could not be written.  A capture already running is stopped first.</returns>
+		/// <seealso cref="StopFrameCapture" />
+		bool StartFrameCapture(String^ directory, uint32 segmentSize, uint32 maxSegments) { return Native::FrameCapture::Start(ConvertPath(directory), segmentSize, maxSegments); }
+
+		/// <summary>Stops the frame capture, writes the frames still buffered and closes the file.</summary>
+		void StopFrameCapture() { Native::FrameCapture::Stop(); }
+
+		/// <summary>Writes the frames buffered by the frame capture now, on the calling thread.</summary>
+		void FlushFrameCapture() { Native::FrameCapture::Flush(); }
+
+		/// <summary>Gets the number of frames the capture has recorded and written.</summary>
+		ZWFrameCaptureStats GetFrameCaptureStats();
+
+		/// <summary>
+		/// Enables or disables counting the traffic of each node and command class.
+		/// </summary>
+		/// <remarks>
+		/// <para>The counts come from three sources.  OpenZWave's node statistics give the messages sent and
+		/// received of each command class, and are read every TrafficCounterInterval and by GetTrafficReport.  The
+		/// frames the driver logs give the bytes and retries, and the time from each SendData to its callback and to
+		/// the node's answer; they are read through the logger of the log sink, which counting installs, so
+		/// OpenZWave's own log file is replaced as StartLogSink describes.  Timeout and value notifications are
+		/// counted as they arrive.</para>
+		/// <para>Counting starts when enabled.  Disabling it keeps the counts made so far.</para>
+		/// </remarks>
+		/// <seealso cref="GetTrafficReport" />
+		property bool TrafficCountersEnabled
+		{
+			bool get() { return Native::TrafficCounters::IsEnabled(); }
+			void set(bool value) { Native::TrafficCounters::SetEnabled(value); }
+		}
+
+		/// <summary>Gets or sets the milliseconds between reads of the node statistics.  The default is 10 seconds.</summary>
+		property uint32 TrafficCounterInterval
+		{
+			uint32 get() { return Native::TrafficCounters::GetInterval(); }
+			void set(uint32 value) { Native::TrafficCounters::SetInterval(value); }
 		}
 
-		String^ ConvertString(std::string value) {
+		/// <summary>
+		/// Gets the traffic of every node and command class of a network, with its round trip histograms.
+		/// </summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		/// <returns>The counters since counting was enabled or reset.</returns>
+		/// <seealso cref="TrafficCountersEnabled" />
+		ZWTrafficReport^ GetTrafficReport(uint32 homeId);
+
+		/// <summary>Clears the traffic counters of a network.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		void ResetTrafficCounters(uint32 homeId) { Native::TrafficCounters::Reset(homeId); }
+
+		/// <summary>
+		/// Starts serving metrics in the OpenMetrics text format, for Prometheus, on a local TCP port.
+		/// </summary>
+		/// <remarks>
+		/// <para>The exporter answers GET /metrics on 127.0.0.1 only, so it cannot be reached from the network.  Each
+		/// scrape reads the statistics of every ready driver and its nodes: notifications by type since the exporter
+		/// started, the send queue, the driver's frame, retry and error counters, each node's messages, failures and
+		/// average round trips, the log sink and frame capture counters, and, while TrafficCountersEnabled, the round
+		/// trip histograms of each node and command class.</para>
+		/// <para>Scrapes are answered one at a time on a thread pool thread.  Each one asks OpenZWave about every
+		/// possible node ID of every ready driver, and copies the statistics of each node that exists, so set the
+		/// scrape interval no shorter than needed.  The round trip histograms are as of the last read, every
+		/// TrafficCounterInterval.</para>
+		/// </remarks>
+		/// <param name="port">The port to listen on.</param>
+		/// <returns>False if the port could not be bound.  An exporter already running is stopped first.</returns>
+		/// <seealso cref="StopMetricsExporter" />
+		bool StartMetricsExporter(uint16 port) { return Native::MetricsExporter::Start(port, std::wstring()); }
+
+		/// <summary>Starts serving metrics as StartMetricsExporter does, on a Unix domain socket.</summary>
+		/// <remarks>Unix domain sockets need Windows 10 version 1803 or later.  A file left at the path by an earlier run is replaced.</remarks>
+		/// <param name="path">The path of the socket file, removed again when the exporter stops.</param>
+		/// <returns>False if the socket could not be created or bound.  An exporter already running is stopped first.</returns>
+		bool StartMetricsExporterOnSocket(String^ path) { return Native::MetricsExporter::Start(0, ConvertPath(path)); }
+
+		/// <summary>Stops serving metrics, after the scrape being answered.</summary>
+		void StopMetricsExporter() { Native::MetricsExporter::Stop(); }
+
+		/// <summary>Gets whether the metrics exporter is running.</summary>
+		property bool MetricsExporterRunning { bool get() { return Native::MetricsExporter::IsRunning(); } }
+
+		/// <summary>Gets the text a scrape of the metrics exporter would return, whether or not it is running.</summary>
+		String^ RenderMetrics();
+
+		/// <summary>
+		/// Shares this process's Z-Wave networks with other processes, which use them through ZWHostClient.
+		/// </summary>
+		/// <remarks>
+		/// <para>Only one process can own a controller.  The host copies every notification into a ring in shared
+		/// memory, and the current state of every value into a table beside it, so clients read both without a call
+		/// to this process and without adding traffic on the serial port.  Clients send their commands, such as
+		/// SetValue and RefreshValue, to a local socket that only this machine can reach; they are served one at a
+		/// time on a thread pool thread.  Each command must carry a random token the host puts in its shared memory,
+		/// which only processes in the same session can open.</para>
+		/// <para>Values are shared as OpenZWave adds them, so start the host before AddDriver.</para>
+		/// </remarks>
+		/// <param name="name">The name clients pass to ZWHostClient.Connect.</param>
+		/// <param name="port">The loopback port for commands, or 0 to let the system pick one.  Clients find it from the name.</param>
+		/// <returns>False if the shared memory or the socket could not be created, or a host in another process is already
+		/// running under the name or listening on the socket.  A host already running in this process is stopped first.</returns>
+		/// <seealso cref="StopHost" />
+		bool StartHost(String^ name, uint16 port) { return Native::ControllerHost::Start(ConvertPath(name), port, std::wstring()); }
+
+		/// <summary>Shares this process's Z-Wave networks as StartHost does, with commands sent to a Unix domain socket.</summary>
+		/// <param name="name">The name clients pass to ZWHostClient.Connect.</param>
+		/// <param name="path">The path of the socket file, shorter than 128 characters.</param>
+		/// <returns>False if the shared memory or the socket could not be created, or a host in another process is already
+		/// running under the name or listening on the socket.  A host already running in this process is stopped first.</returns>
+		bool StartHostOnSocket(String^ name, String^ path) { return Native::ControllerHost::Start(ConvertPath(name), 0, ConvertPath(path)); }
+
+		/// <summary>Stops sharing the networks.  Clients see ZWHostClient.HostRunning become false.</summary>
+		void StopHost() { Native::ControllerHost::Stop(); }
+
+		/// <summary>Gets whether the networks are being shared.</summary>
+		property bool HostRunning { bool get() { return Native::ControllerHost::IsRunning(); } }
+
+	internal:
+		void ProcessNotification(Notification const* _notification);									// Native bookkeeping done before the managed notification is raised
+
 #if __cplusplus_cli
-			return gcnew String(value.c_str());
+	private:
+		void  OnNotificationFromUnmanaged(Notification* _notification, void* _context);					// Forward notification to managed delegates hooked via Event addhandler 
+	
+		void  OnLogRecordsFromUnmanaged(Native::LogRecord* _records, uint32 _count, void* _context);		// Forward a batch of the log sink to LogRecordsReceived
+
+		GCHandle										m_gchNotification;
+		OnNotificationFromUnmanagedDelegate^			m_onNotification;
+		GCHandle										m_gchLogRecords;
+		OnLogRecordsFromUnmanagedDelegate^				m_onLogRecords;
 #else
-			std::wstring_convert<std::codecvt_utf8<wchar_t>> convert;
-			std::wstring intermediateForm = convert.from_bytes(value);
-			return ref new Platform::String(intermediateForm.c_str());
+	internal:
+		static void OnNotificationFromUnmanaged(OpenZWave::Notification const * _notification, void * _context);
+		static void OnLogRecordsFromUnmanaged(Native::LogRecord const* _records, uint32 _count, void* _context);
 #endif
-		}
+	internal:
+		void RaiseLogRecords(Native::LogRecord const* _records, uint32 _count);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWMemoryReport.cpp
+//
+//      CLI/C++ and WinRT wrapper for the wrapper's memory instrumentation
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWMemoryReport.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWMemoryReport::ZWMemoryReport>
+//	Take a snapshot of the tracked memory and aggregate it per home
+//-----------------------------------------------------------------------------
+ZWMemoryReport::ZWMemoryReport()
+{
+	std::vector<Native::MemoryUsage> usage;
+	Native::MemoryTracker::GetUsage(&usage);
+
+	uint32 numHomes = 0;
+	for (size_t i = 0; i < usage.size(); ++i)
+	{
+		if (i == 0 || usage[i].m_homeId != usage[i - 1].m_homeId)
+			++numHomes;
+	}
+
+#if __cplusplus_cli
+	m_nodes = gcnew cli::array<ZWNodeMemoryUsage>((int32)usage.size());
+	m_homes = gcnew cli::array<ZWHomeMemoryUsage>(numHomes);
+#else
+	m_nodes = gcnew Platform::Array<ZWNodeMemoryUsage>((uint32)usage.size());
+	m_homes = gcnew Platform::Array<ZWHomeMemoryUsage>(numHomes);
+#endif
+
+	m_total.HomeId = 0;
+	m_total.NodeCount = (int32)usage.size();
+	m_total.LiveValueIds = 0;
+	m_total.LiveNotifications = 0;
+	m_total.LiveEventArgs = 0;
+	m_total.NativeBytes = 0;
+	m_total.ValueCount = 0;
+
+	int32 home = -1;
+	for (size_t i = 0; i < usage.size(); ++i)
+	{
+		Native::MemoryUsage const& u = usage[i];
+
+		ZWNodeMemoryUsage node;
+		node.HomeId = u.m_homeId;
+		node.NodeId = u.m_nodeId;
+		node.LiveValueIds = u.m_live[Native::TrackedObject_ValueId];
+		node.LiveNotifications = u.m_live[Native::TrackedObject_Notification];
+		node.LiveEventArgs = u.m_live[Native::TrackedObject_EventArgs];
+		node.NativeBytes = u.m_nativeBytes;
+		node.ValueCount = u.m_valueCount;
+		m_nodes[(int32)i] = node;
+
+		if (i == 0 || u.m_homeId != usage[i - 1].m_homeId)
+		{
+			++home;
+			ZWHomeMemoryUsage empty;
+			empty.HomeId = u.m_homeId;
+			empty.NodeCount = 0;
+			empty.LiveValueIds = 0;
+			empty.LiveNotifications = 0;
+			empty.LiveEventArgs = 0;
+			empty.NativeBytes = 0;
+			empty.ValueCount = 0;
+			m_homes[home] = empty;
+		}
+
+		ZWHomeMemoryUsage totals = m_homes[home];
+		totals.NodeCount += 1;
+		totals.LiveValueIds += node.LiveValueIds;
+		totals.LiveNotifications += node.LiveNotifications;
+		totals.LiveEventArgs += node.LiveEventArgs;
+		totals.NativeBytes += node.NativeBytes;
+		totals.ValueCount += node.ValueCount;
+		m_homes[home] = totals;
+
+		m_total.LiveValueIds += node.LiveValueIds;
+		m_total.LiveNotifications += node.LiveNotifications;
+		m_total.LiveEventArgs += node.LiveEventArgs;
+		m_total.NativeBytes += node.NativeBytes;
+		m_total.ValueCount += node.ValueCount;
+	}
+}
@@ -0,0 +1,148 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWMemoryReport.h
+//
+//      CLI/C++ and WinRT wrapper for the wrapper's memory instrumentation
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "MemoryTracker.h"
+
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	/// <summary>Memory used by the wrapper on behalf of a single node.</summary>
+	public value struct ZWNodeMemoryUsage
+	{
+		/// <summary>Home ID of the controller that manages the node.</summary>
+		uint32 HomeId;
+		/// <summary>ID of the node. 0 and 255 hold objects not bound to a node (for example driver notifications).</summary>
+		uint8 NodeId;
+		/// <summary>Number of live ZWValueId instances for the node.</summary>
+		int32 LiveValueIds;
+		/// <summary>Number of live ZWNotification instances for the node.</summary>
+		int32 LiveNotifications;
+		/// <summary>Number of live NotificationReceivedEventArgs instances for the node.</summary>
+		int32 LiveEventArgs;
+		/// <summary>Native bytes owned by the wrapper for the node.</summary>
+		int64 NativeBytes;
+		/// <summary>Number of values OpenZWave currently holds for the node.</summary>
+		int32 ValueCount;
+	};
+
+	/// <summary>Memory used by the wrapper on behalf of all nodes of one controller.</summary>
+	public value struct ZWHomeMemoryUsage
+	{
+		/// <summary>Home ID of the controller.</summary>
+		uint32 HomeId;
+		/// <summary>Number of nodes with tracked memory.</summary>
+		int32 NodeCount;
+		/// <summary>Number of live ZWValueId instances.</summary>
+		int32 LiveValueIds;
+		/// <summary>Number of live ZWNotification instances.</summary>
+		int32 LiveNotifications;
+		/// <summary>Number of live NotificationReceivedEventArgs instances.</summary>
+		int32 LiveEventArgs;
+		/// <summary>Native bytes owned by the wrapper.</summary>
+		int64 NativeBytes;
+		/// <summary>Number of values OpenZWave currently holds.</summary>
+		int32 ValueCount;
+	};
+
+	/// <summary>A snapshot of the memory used by the wrapper, returned by ZWManager.GetMemoryReport.</summary>
+	/// <remarks>The counts are only maintained while ZWManager.MemoryTrackingEnabled is set. Enable it before
+	/// calling AddDriver so that the value counts include the values loaded at startup.</remarks>
+	public ref class ZWMemoryReport sealed
+	{
+	internal:
+		ZWMemoryReport();
+
+	public:
+		/// <summary>Gets the number of live ZWValueId instances.</summary>
+		property int32 LiveValueIds { int32 get() { return m_total.LiveValueIds; } }
+		/// <summary>Gets the number of live ZWNotification instances.</summary>
+		property int32 LiveNotifications { int32 get() { return m_total.LiveNotifications; } }
+		/// <summary>Gets the number of live NotificationReceivedEventArgs instances.</summary>
+		property int32 LiveEventArgs { int32 get() { return m_total.LiveEventArgs; } }
+		/// <summary>Gets the native bytes owned by the wrapper.</summary>
+		property int64 NativeBytes { int64 get() { return m_total.NativeBytes; } }
+		/// <summary>Gets the number of values OpenZWave currently holds.</summary>
+		property int32 ValueCount { int32 get() { return m_total.ValueCount; } }
+
+		/// <summary>Gets the breakdown per controller.</summary>
+#if __cplusplus_cli
+		cli::array<ZWHomeMemoryUsage>^ GetHomes() { return m_homes; }
+#else
+		Platform::Array<ZWHomeMemoryUsage>^ GetHomes() { return m_homes; }
+#endif
+
+		/// <summary>Gets the breakdown per node, sorted by home and node ID.</summary>
+#if __cplusplus_cli
+		cli::array<ZWNodeMemoryUsage>^ GetNodes() { return m_nodes; }
+#else
+		Platform::Array<ZWNodeMemoryUsage>^ GetNodes() { return m_nodes; }
+#endif
+
+	private:
+		ZWHomeMemoryUsage						m_total;
+#if __cplusplus_cli
+		cli::array<ZWHomeMemoryUsage>^			m_homes;
+		cli::array<ZWNodeMemoryUsage>^			m_nodes;
+#else
+		Platform::Array<ZWHomeMemoryUsage>^		m_homes;
+		Platform::Array<ZWNodeMemoryUsage>^		m_nodes;
+#endif
+	};
+
+	// Attached to a ZWNotification or event args only while tracking is enabled,
+	// so that untracked objects do not pay for a finalizer.
+	ref class ZWTrackedObjectToken sealed
+	{
+	internal:
+		ZWTrackedObjectToken(Native::TrackedObject type, uint32 homeId, uint8 nodeId) :
+			m_type(type),
+			m_homeId(homeId),
+			m_nodeId(nodeId)
+		{
+			Native::MemoryTracker::OnCreated(m_type, m_homeId, m_nodeId, 0);
+		}
+
+		static ZWTrackedObjectToken^ Create(Native::TrackedObject type, uint32 homeId, uint8 nodeId)
+		{
+			return Native::MemoryTracker::IsEnabled() ? gcnew ZWTrackedObjectToken(type, homeId, nodeId) : nullptr;
+		}
+
+	private:
+#if __cplusplus_cli
+		!ZWTrackedObjectToken()
+#else
+		~ZWTrackedObjectToken()
+#endif
+		{
+			Native::MemoryTracker::OnDestroyed(m_type, m_homeId, m_nodeId, 0);
+		}
+
+		Native::TrackedObject	m_type;
+		uint32					m_homeId;
+		uint8					m_nodeId;
+	};
+}
@@ -0,0 +1,137 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNetworkSnapshot.cpp
+//
+//      CLI/C++ and WinRT wrapper for network snapshots
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWNetworkSnapshot.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkSnapshot::GetNodes>
+//	Every node in the snapshot
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWSnapshotNode>^ ZWNetworkSnapshot::GetNodes()
+#else
+Platform::Array<ZWSnapshotNode>^ ZWNetworkSnapshot::GetNodes()
+#endif
+{
+	uint32 count = GetSnapshot()->GetNodeCount();
+#if __cplusplus_cli
+	cli::array<ZWSnapshotNode>^ nodes = gcnew cli::array<ZWSnapshotNode>((int32)count);
+#else
+	Platform::Array<ZWSnapshotNode>^ nodes = gcnew Platform::Array<ZWSnapshotNode>(count);
+#endif
+
+	Native::SnapshotNode native;
+	for (uint32 i = 0; i < count; ++i)
+	{
+		GetSnapshot()->GetNode(i, &native);
+		nodes[i] = ConvertNode(native);
+	}
+	return nodes;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkSnapshot::GetValues>
+//	Every value in the snapshot, with its state
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWSnapshotValue>^ ZWNetworkSnapshot::GetValues()
+#else
+Platform::Array<ZWSnapshotValue>^ ZWNetworkSnapshot::GetValues()
+#endif
+{
+	uint32 count = GetSnapshot()->GetValueCount();
+#if __cplusplus_cli
+	cli::array<ZWSnapshotValue>^ values = gcnew cli::array<ZWSnapshotValue>((int32)count);
+#else
+	Platform::Array<ZWSnapshotValue>^ values = gcnew Platform::Array<ZWSnapshotValue>(count);
+#endif
+
+	Native::SnapshotValue native;
+	for (uint32 i = 0; i < count; ++i)
+	{
+		GetSnapshot()->GetValue(i, &native);
+		values[i] = ConvertValue(native);
+	}
+	return values;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkSnapshot::ConvertNode>
+//	Copy a native node
+//-----------------------------------------------------------------------------
+ZWSnapshotNode ZWNetworkSnapshot::ConvertNode(Native::SnapshotNode const& native)
+{
+	ZWSnapshotNode node;
+	node.NodeId = native.m_nodeId;
+	node.Basic = native.m_basic;
+	node.Generic = native.m_generic;
+	node.Specific = native.m_specific;
+	node.Version = native.m_version;
+	node.Security = native.m_security;
+	node.MaxBaudRate = native.m_maxBaudRate;
+	node.IsListening = (native.m_flags & Native::SnapshotNodeFlag_Listening) != 0;
+	node.IsFrequentListening = (native.m_flags & Native::SnapshotNodeFlag_FrequentListening) != 0;
+	node.IsBeaming = (native.m_flags & Native::SnapshotNodeFlag_Beaming) != 0;
+	node.IsRouting = (native.m_flags & Native::SnapshotNodeFlag_Routing) != 0;
+	node.IsSecurity = (native.m_flags & Native::SnapshotNodeFlag_Security) != 0;
+	node.IsZWavePlus = (native.m_flags & Native::SnapshotNodeFlag_ZWavePlus) != 0;
+	node.Type = ConvertString(native.m_type);
+	node.ManufacturerName = ConvertString(native.m_manufacturerName);
+	node.ProductName = ConvertString(native.m_productName);
+	node.Name = ConvertString(native.m_name);
+	node.Location = ConvertString(native.m_location);
+	node.ManufacturerId = ConvertString(native.m_manufacturerId);
+	node.ProductType = ConvertString(native.m_productType);
+	node.ProductId = ConvertString(native.m_productId);
+	return node;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkSnapshot::ConvertValue>
+//	Copy a native value
+//-----------------------------------------------------------------------------
+ZWSnapshotValue ZWNetworkSnapshot::ConvertValue(Native::SnapshotValue const& native)
+{
+	ZWSnapshotValue value;
+	value.ValueId = native.m_valueId;
+	value.NodeId = native.m_nodeId;
+	value.Genre = (ZWValueGenre)native.m_genre;
+	value.CommandClassId = native.m_commandClassId;
+	value.Instance = native.m_instance;
+	value.Index = native.m_index;
+	value.Type = (ZWValueType)native.m_type;
+	value.Label = ConvertString(native.m_label);
+	value.Units = ConvertString(native.m_units);
+	value.Help = ConvertString(native.m_help);
+	value.ReadOnly = (native.m_flags & Native::SnapshotValueFlag_ReadOnly) != 0;
+	value.IsSet = (native.m_flags & Native::SnapshotValueFlag_Set) != 0;
+	value.IsPolled = (native.m_flags & Native::SnapshotValueFlag_Polled) != 0;
+	value.Value = ConvertString(native.m_value);
+	value.State = (ZWSnapshotValueState)native.m_state;
+	return value;
+}
@@ -0,0 +1,211 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNetworkSnapshot.h
+//
+//      CLI/C++ and WinRT wrapper for network snapshots
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "NetworkSnapshot.h"
+#include "ZWEnums.h"
+#include "ZWValueID.h"
+#include "ZWConvert.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>Whether a value in a snapshot has been confirmed by the live network.</summary>
+	public enum class ZWSnapshotValueState
+	{
+		/// <summary>The value has not been reported since the snapshot was loaded, so the snapshot's value may be out of date.</summary>
+		Stale = Native::SnapshotValueState_Stale,
+		/// <summary>The node has reported the value, changed or unchanged, since the snapshot was loaded.  Read it with ZWManager.</summary>
+		Current = Native::SnapshotValueState_Current,
+		/// <summary>The value, or its node, has been removed since the snapshot was loaded.</summary>
+		Removed = Native::SnapshotValueState_Removed
+	};
+
+	/// <summary>A node as it was when a snapshot was saved.</summary>
+	public value struct ZWSnapshotNode
+	{
+		/// <summary>ID of the node.</summary>
+		uint8 NodeId;
+		/// <summary>The basic device class.</summary>
+		uint8 Basic;
+		/// <summary>The generic device class.</summary>
+		uint8 Generic;
+		/// <summary>The specific device class.</summary>
+		uint8 Specific;
+		/// <summary>The Z-Wave protocol version.</summary>
+		uint8 Version;
+		/// <summary>The security byte.</summary>
+		uint8 Security;
+		/// <summary>The maximum baud rate.</summary>
+		uint32 MaxBaudRate;
+		/// <summary>Whether the node is always listening.</summary>
+		bool IsListening;
+		/// <summary>Whether the node is a frequent listening (FLiRS) device.</summary>
+		bool IsFrequentListening;
+		/// <summary>Whether the node supports beaming.</summary>
+		bool IsBeaming;
+		/// <summary>Whether the node routes messages for others.</summary>
+		bool IsRouting;
+		/// <summary>Whether the node supports security.</summary>
+		bool IsSecurity;
+		/// <summary>Whether the node is a Z-Wave Plus device.</summary>
+		bool IsZWavePlus;
+		/// <summary>The type, as returned by ZWManager.GetNodeType.</summary>
+		String^ Type;
+		/// <summary>The manufacturer name.</summary>
+		String^ ManufacturerName;
+		/// <summary>The product name.</summary>
+		String^ ProductName;
+		/// <summary>The name given to the node.</summary>
+		String^ Name;
+		/// <summary>The location given to the node.</summary>
+		String^ Location;
+		/// <summary>The manufacturer ID, as a hexadecimal string.</summary>
+		String^ ManufacturerId;
+		/// <summary>The product type, as a hexadecimal string.</summary>
+		String^ ProductType;
+		/// <summary>The product ID, as a hexadecimal string.</summary>
+		String^ ProductId;
+	};
+
+	/// <summary>A value as it was when a snapshot was saved.</summary>
+	public value struct ZWSnapshotValue
+	{
+		/// <summary>The ZWValueId.Id of the value.</summary>
+		uint64 ValueId;
+		/// <summary>ID of the node the value belongs to.</summary>
+		uint8 NodeId;
+		/// <summary>The genre of the value.</summary>
+		ZWValueGenre Genre;
+		/// <summary>The command class of the value.</summary>
+		uint8 CommandClassId;
+		/// <summary>The instance of the command class.</summary>
+		uint8 Instance;
+		/// <summary>The index of the value within the command class instance.</summary>
+		uint16 Index;
+		/// <summary>The type of the value.</summary>
+		ZWValueType Type;
+		/// <summary>The label.</summary>
+		String^ Label;
+		/// <summary>The units.</summary>
+		String^ Units;
+		/// <summary>The help text.</summary>
+		String^ Help;
+		/// <summary>Whether the value can only be read.</summary>
+		bool ReadOnly;
+		/// <summary>Whether the value had been reported by the device when the snapshot was saved.</summary>
+		bool IsSet;
+		/// <summary>Whether the value was polled by OpenZWave.</summary>
+		bool IsPolled;
+		/// <summary>The value, in the form returned by ZWManager.GetValueAsString.</summary>
+		String^ Value;
+		/// <summary>Whether the value has been confirmed by the live network since the snapshot was loaded.</summary>
+		ZWSnapshotValueState State;
+	};
+
+	/// <summary>
+	/// The nodes and values of a network as they were when saved, returned by ZWManager.LoadNetworkSnapshot.
+	/// </summary>
+	/// <remarks>
+	/// <para>The snapshot file stays mapped while the object is alive, and nodes and values are read from it as
+	/// they are asked for.  From the moment it is loaded, notifications from the network mark each value as
+	/// current or removed; the values still stale are the ones the application should not trust yet.</para>
+	/// <para>Dispose the snapshot once the network has been queried.  While it is loaded, the file cannot be
+	/// replaced, so saving to the same path fails.</para>
+	/// </remarks>
+	public ref class ZWNetworkSnapshot sealed
+	{
+	internal:
+		ZWNetworkSnapshot(Native::NetworkSnapshot* snapshot) :
+			m_snapshot(snapshot)
+		{
+		}
+
+	public:
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { return GetSnapshot()->GetHomeId(); } }
+
+		/// <summary>Gets when the snapshot was saved, as a UTC file time (DateTime.FromFileTimeUtc).</summary>
+		property int64 SavedAt { int64 get() { return GetSnapshot()->GetSavedAt(); } }
+
+		/// <summary>Gets the number of nodes in the snapshot.</summary>
+		property uint32 NodeCount { uint32 get() { return GetSnapshot()->GetNodeCount(); } }
+
+		/// <summary>Gets the number of values in the snapshot.</summary>
+		property uint32 ValueCount { uint32 get() { return GetSnapshot()->GetValueCount(); } }
+
+		/// <summary>Gets the number of values not reported since the snapshot was loaded.</summary>
+		property uint32 StaleCount { uint32 get() { return GetSnapshot()->GetStaleCount(); } }
+
+		/// <summary>Gets every node, sorted by ID.</summary>
+#if __cplusplus_cli
+		cli::array<ZWSnapshotNode>^ GetNodes();
+#else
+		Platform::Array<ZWSnapshotNode>^ GetNodes();
+#endif
+
+		/// <summary>Gets every value, sorted by ZWValueId.Id, with its current state.</summary>
+#if __cplusplus_cli
+		cli::array<ZWSnapshotValue>^ GetValues();
+#else
+		Platform::Array<ZWSnapshotValue>^ GetValues();
+#endif
+
+		/// <summary>Gets whether a value has been confirmed by the live network.</summary>
+		/// <returns>Removed if the value is not in the snapshot.</returns>
+		ZWSnapshotValueState GetValueState(ZWValueId^ id) { return (ZWSnapshotValueState)GetSnapshot()->GetState(id->CreateUnmanagedValueID().GetId()); }
+
+#if __cplusplus_cli
+		/// <summary>Unmaps the snapshot, so that its file can be replaced.  Later calls throw ObjectDisposedException.</summary>
+		~ZWNetworkSnapshot() { this->!ZWNetworkSnapshot(); }
+#endif
+
+	internal:
+		static ZWSnapshotNode ConvertNode(Native::SnapshotNode const& native);
+		static ZWSnapshotValue ConvertValue(Native::SnapshotValue const& native);
+
+	private:
+#if __cplusplus_cli
+		!ZWNetworkSnapshot()
+#else
+		~ZWNetworkSnapshot()
+#endif
+		{
+			delete m_snapshot;
+			m_snapshot = NULL;
+		}
+
+		Native::NetworkSnapshot* GetSnapshot() { return CheckDisposed(m_snapshot, L"ZWNetworkSnapshot"); }
+
+		Native::NetworkSnapshot*	m_snapshot;
+	};
+}
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNetworkTopology.cpp
+//
+//      CLI/C++ and WinRT wrapper for the network neighbor matrix
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWNetworkTopology.h"
+
+using namespace OpenZWave;
+
+#if __cplusplus_cli
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkTopology::GetHopCounts>
+//	Hop count from one node to every node
+//-----------------------------------------------------------------------------
+cli::array<Byte>^ ZWNetworkTopology::GetHopCounts(uint8 fromId)
+{
+	cli::array<Byte>^ hops = gcnew cli::array<Byte>(Native::Topology::MaxNodes);
+	pin_ptr<Byte> data = &hops[0];
+	m_topology->GetHopCounts(fromId, data);
+	return hops;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkTopology::GetRow>
+//	Neighbor bitmap of one node
+//-----------------------------------------------------------------------------
+cli::array<Byte>^ ZWNetworkTopology::GetRow(uint8 nodeId)
+{
+	cli::array<Byte>^ row = gcnew cli::array<Byte>(Native::Topology::RowBytes);
+	pin_ptr<Byte> data = &row[0];
+	m_topology->GetRow(nodeId, data);
+	return row;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkTopology::GetMatrix>
+//	Neighbor bitmaps of every node
+//-----------------------------------------------------------------------------
+cli::array<Byte>^ ZWNetworkTopology::GetMatrix()
+{
+	cli::array<Byte>^ matrix = gcnew cli::array<Byte>(Native::Topology::MaxNodes * Native::Topology::RowBytes);
+	pin_ptr<Byte> data = &matrix[0];
+	for (uint32 nodeId = 1; nodeId <= Native::Topology::MaxNodes; ++nodeId)
+	{
+		m_topology->GetRow((uint8)nodeId, data + (nodeId - 1) * Native::Topology::RowBytes);
+	}
+	return matrix;
+}
+
+#else
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkTopology::GetHopCounts>
+//	Hop count from one node to every node
+//-----------------------------------------------------------------------------
+Platform::Array<byte>^ ZWNetworkTopology::GetHopCounts(uint8 fromId)
+{
+	Platform::Array<byte>^ hops = gcnew Platform::Array<byte>(Native::Topology::MaxNodes);
+	m_topology->GetHopCounts(fromId, hops->Data);
+	return hops;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkTopology::GetRow>
+//	Neighbor bitmap of one node
+//-----------------------------------------------------------------------------
+Platform::Array<byte>^ ZWNetworkTopology::GetRow(uint8 nodeId)
+{
+	Platform::Array<byte>^ row = gcnew Platform::Array<byte>(Native::Topology::RowBytes);
+	m_topology->GetRow(nodeId, row->Data);
+	return row;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWNetworkTopology::GetMatrix>
+//	Neighbor bitmaps of every node
+//-----------------------------------------------------------------------------
+Platform::Array<byte>^ ZWNetworkTopology::GetMatrix()
+{
+	Platform::Array<byte>^ matrix = gcnew Platform::Array<byte>(Native::Topology::MaxNodes * Native::Topology::RowBytes);
+	for (uint32 nodeId = 1; nodeId <= Native::Topology::MaxNodes; ++nodeId)
+	{
+		m_topology->GetRow((uint8)nodeId, matrix->Data + (nodeId - 1) * Native::Topology::RowBytes);
+	}
+	return matrix;
+}
+
+#endif
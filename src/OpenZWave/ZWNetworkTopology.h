@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNetworkTopology.h
+//
+//      CLI/C++ and WinRT wrapper for the network neighbor matrix
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "Topology.h"
+
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	/// <summary>
+	/// The neighbor lists of every node in a network, returned by ZWManager.GetNetworkTopology.
+	/// </summary>
+	/// <remarks>
+	/// The matrix is a snapshot taken when GetNetworkTopology was called.  Each node reports its own
+	/// neighbors, so the matrix is not necessarily symmetric; the hop count and reachability helpers
+	/// follow the links as reported by the node they start from.
+	/// </remarks>
+	public ref class ZWNetworkTopology sealed
+	{
+	internal:
+		ZWNetworkTopology(uint32 homeId)
+		{
+			m_topology = new Native::Topology();
+			m_topology->Build(homeId);
+		}
+
+	public:
+		/// <summary>Number of rows in the matrix, and the highest node ID it can hold.</summary>
+		static property int32 MaxNodes { int32 get() { return Native::Topology::MaxNodes; } }
+
+		/// <summary>Number of bytes in one row of the matrix.</summary>
+		static property int32 RowBytes { int32 get() { return Native::Topology::RowBytes; } }
+
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { return m_topology->GetHomeId(); } }
+
+		/// <summary>Whether a node lists another node as its neighbor.</summary>
+		/// <param name="nodeId">The node whose neighbor list is checked.</param>
+		/// <param name="neighborId">The possible neighbor.</param>
+		bool IsNeighbor(uint8 nodeId, uint8 neighborId) { return m_topology->IsNeighbor(nodeId, neighborId); }
+
+		/// <summary>Gets the number of neighbors a node reports.</summary>
+		/// <param name="nodeId">The ID of the node.</param>
+		int32 GetDegree(uint8 nodeId) { return (int32)m_topology->GetDegree(nodeId); }
+
+		/// <summary>Whether a route of any length exists from one node to another.</summary>
+		/// <param name="fromId">The ID of the node the route starts from.</param>
+		/// <param name="toId">The ID of the node the route ends at.</param>
+		bool IsReachable(uint8 fromId, uint8 toId) { return m_topology->GetHopCount(fromId, toId) != Native::Topology::Unreachable; }
+
+		/// <summary>Gets the number of hops on the shortest route from one node to another.</summary>
+		/// <param name="fromId">The ID of the node the route starts from.</param>
+		/// <param name="toId">The ID of the node the route ends at.</param>
+		/// <returns>The hop count, 0 if the nodes are the same, or -1 if there is no route.</returns>
+		int32 GetHopCount(uint8 fromId, uint8 toId)
+		{
+			uint8 hops = m_topology->GetHopCount(fromId, toId);
+			return (hops == Native::Topology::Unreachable) ? -1 : (int32)hops;
+		}
+
+		/// <summary>Gets the number of hops from one node to every node.</summary>
+		/// <param name="fromId">The ID of the node the routes start from.</param>
+		/// <returns>MaxNodes entries.  Entry n-1 holds the hop count to node n, or 255 if there is no route.</returns>
+#if __cplusplus_cli
+		cli::array<Byte>^ GetHopCounts(uint8 fromId);
+#else
+		Platform::Array<byte>^ GetHopCounts(uint8 fromId);
+#endif
+
+		/// <summary>Gets the neighbor bitmap of a node.</summary>
+		/// <param name="nodeId">The ID of the node.</param>
+		/// <returns>RowBytes bytes.  Node n is a neighbor if bit (n-1)%8 of byte (n-1)/8 is set.</returns>
+#if __cplusplus_cli
+		cli::array<Byte>^ GetRow(uint8 nodeId);
+#else
+		Platform::Array<byte>^ GetRow(uint8 nodeId);
+#endif
+
+		/// <summary>Gets the whole matrix.</summary>
+		/// <returns>MaxNodes rows of RowBytes bytes each.  Row n-1 holds the neighbor bitmap of node n.</returns>
+#if __cplusplus_cli
+		cli::array<Byte>^ GetMatrix();
+#else
+		Platform::Array<byte>^ GetMatrix();
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWNetworkTopology()
+#else
+		~ZWNetworkTopology()
+#endif
+		{
+			delete m_topology;
+		}
+
+		Native::Topology*	m_topology;
+	};
+}
@@ -0,0 +1,55 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNodeInfo.cpp
+//
+//      CLI/C++ and WinRT wrapper for the static attributes of a node
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWNodeInfo.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWNodeInfo::ZWNodeInfo>
+//	Copy a node's attributes, converting its strings once
+//-----------------------------------------------------------------------------
+ZWNodeInfo::ZWNodeInfo(uint32 homeId, Native::SnapshotNode const& node, uint32 stamp) :
+	m_homeId(homeId),
+	m_stamp(stamp),
+	m_nodeId(node.m_nodeId),
+	m_basic(node.m_basic),
+	m_generic(node.m_generic),
+	m_specific(node.m_specific),
+	m_version(node.m_version),
+	m_security(node.m_security),
+	m_flags(node.m_flags),
+	m_maxBaudRate(node.m_maxBaudRate)
+{
+	m_type = ConvertString(node.m_type);
+	m_manufacturerName = ConvertString(node.m_manufacturerName);
+	m_productName = ConvertString(node.m_productName);
+	m_name = ConvertString(node.m_name);
+	m_location = ConvertString(node.m_location);
+	m_manufacturerId = ConvertString(node.m_manufacturerId);
+	m_productType = ConvertString(node.m_productType);
+	m_productId = ConvertString(node.m_productId);
+}
@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNodeInfo.h
+//
+//      CLI/C++ and WinRT wrapper for the static attributes of a node
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "NodeRegistry.h"
+#include "ZWConvert.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>
+	/// The static attributes of a node, returned by ZWManager.GetNodeInfo.
+	/// </summary>
+	/// <remarks>
+	/// A record never changes.  ZWManager.GetNodeInfo returns the same record for a node until OpenZWave
+	/// reports new protocol info, names or essential query results for it, so it is cheap to call on every
+	/// property bind, and a changed reference means the node changed.
+	/// </remarks>
+	public ref class ZWNodeInfo sealed
+	{
+	internal:
+		ZWNodeInfo(uint32 homeId, Native::SnapshotNode const& node, uint32 stamp);
+
+		// The stamp of the registry slot the record was made from
+		property uint32 Stamp { uint32 get() { return m_stamp; } }
+
+	public:
+		/// <summary>Gets the Home ID of the network the node is in.</summary>
+		property uint32 HomeId { uint32 get() { return m_homeId; } }
+		/// <summary>Gets the ID of the node.</summary>
+		property uint8 NodeId { uint8 get() { return m_nodeId; } }
+		/// <summary>Gets the basic device class, as ZWManager.GetNodeBasic returns.</summary>
+		property uint8 Basic { uint8 get() { return m_basic; } }
+		/// <summary>Gets the generic device class, as ZWManager.GetNodeGeneric returns.</summary>
+		property uint8 Generic { uint8 get() { return m_generic; } }
+		/// <summary>Gets the specific device class, as ZWManager.GetNodeSpecific returns.</summary>
+		property uint8 Specific { uint8 get() { return m_specific; } }
+		/// <summary>Gets the Z-Wave protocol version, as ZWManager.GetNodeVersion returns.</summary>
+		property uint8 Version { uint8 get() { return m_version; } }
+		/// <summary>Gets the security byte, as ZWManager.GetNodeSecurity returns.</summary>
+		property uint8 Security { uint8 get() { return m_security; } }
+		/// <summary>Gets the maximum baud rate, as ZWManager.GetNodeMaxBaudRate returns.</summary>
+		property uint32 MaxBaudRate { uint32 get() { return m_maxBaudRate; } }
+		/// <summary>Gets whether the node is a listening device that does not go to sleep.</summary>
+		property bool IsListeningDevice { bool get() { return (m_flags & Native::SnapshotNodeFlag_Listening) != 0; } }
+		/// <summary>Gets whether the node is a frequent listening (FLiRS) device.</summary>
+		property bool IsFrequentListeningDevice { bool get() { return (m_flags & Native::SnapshotNodeFlag_FrequentListening) != 0; } }
+		/// <summary>Gets whether the node supports beaming.</summary>
+		property bool IsBeamingDevice { bool get() { return (m_flags & Native::SnapshotNodeFlag_Beaming) != 0; } }
+		/// <summary>Gets whether the node routes messages for other nodes.</summary>
+		property bool IsRoutingDevice { bool get() { return (m_flags & Native::SnapshotNodeFlag_Routing) != 0; } }
+		/// <summary>Gets whether the node supports security.</summary>
+		property bool IsSecurityDevice { bool get() { return (m_flags & Native::SnapshotNodeFlag_Security) != 0; } }
+		/// <summary>Gets whether the node is a Z-Wave Plus device.</summary>
+		property bool IsZWavePlus { bool get() { return (m_flags & Native::SnapshotNodeFlag_ZWavePlus) != 0; } }
+		/// <summary>Gets the type, as ZWManager.GetNodeType returns.</summary>
+		property String^ Type { String^ get() { return m_type; } }
+		/// <summary>Gets the manufacturer name.</summary>
+		property String^ ManufacturerName { String^ get() { return m_manufacturerName; } }
+		/// <summary>Gets the product name.</summary>
+		property String^ ProductName { String^ get() { return m_productName; } }
+		/// <summary>Gets the name given to the node.</summary>
+		property String^ Name { String^ get() { return m_name; } }
+		/// <summary>Gets the location given to the node.</summary>
+		property String^ Location { String^ get() { return m_location; } }
+		/// <summary>Gets the manufacturer ID, as a hexadecimal string.</summary>
+		property String^ ManufacturerId { String^ get() { return m_manufacturerId; } }
+		/// <summary>Gets the product type, as a hexadecimal string.</summary>
+		property String^ ProductType { String^ get() { return m_productType; } }
+		/// <summary>Gets the product ID, as a hexadecimal string.</summary>
+		property String^ ProductId { String^ get() { return m_productId; } }
+
+	private:
+		uint32	m_homeId;
+		uint32	m_stamp;
+		uint8	m_nodeId;
+		uint8	m_basic;
+		uint8	m_generic;
+		uint8	m_specific;
+		uint8	m_version;
+		uint8	m_security;
+		uint8	m_flags;				// Native::SnapshotNodeFlag
+		uint32	m_maxBaudRate;
+		String^	m_type;
+		String^	m_manufacturerName;
+		String^	m_productName;
+		String^	m_name;
+		String^	m_location;
+		String^	m_manufacturerId;
+		String^	m_productType;
+		String^	m_productId;
+	};
+}
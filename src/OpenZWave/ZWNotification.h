@@ -32,6 +32,7 @@
 #pragma once
 #include "ZWEnums.h"
 #include "ZWValueId.h"
+#include "ZWMemoryReport.h"
 
 using namespace OpenZWave;
 
@@ -45,15 +46,14 @@ namespace OpenZWave
 	public ref class NotificationReceivedEventArgs sealed
 	{
 	internal:
-		NotificationReceivedEventArgs(ZWNotification^ notification) : m_notification(notification)
-		{
-		}
+		NotificationReceivedEventArgs(ZWNotification^ notification);
 	public:
 		/// <summary>Get the notification from the event argument.</summary>
 		property ZWNotification^ Notification { ZWNotification^ get() { return m_notification; } }
 
 	private:
 		ZWNotification^ m_notification;
+		ZWTrackedObjectToken^ m_token;
 	};
 
 	/// <summary>
@@ -75,6 +75,17 @@ namespace OpenZWave
 			}
 
 			m_valueId = gcnew ZWValueId(notification->GetValueID());
+			m_token = ZWTrackedObjectToken::Create(Native::TrackedObject_Notification, notification->GetHomeId(), notification->GetNodeId());
+		}
+
+		// A notification published by ControllerHost in another process
+		ZWNotification(ZWNotificationType type, uint8 byte, uint8 nodeEvent, ValueID const& valueId)
+		{
+			m_type = type;
+			m_byte = byte;
+			m_event = nodeEvent;
+			m_valueId = gcnew ZWValueId(valueId);
+			m_token = ZWTrackedObjectToken::Create(Native::TrackedObject_Notification, valueId.GetHomeId(), valueId.GetNodeId());
 		}
 
 	public:
@@ -98,5 +109,12 @@ namespace OpenZWave
 		ZWValueId^	m_valueId;
 		uint8		m_byte;
 		uint8		m_event;
+		ZWTrackedObjectToken^	m_token;
 	};
+
+	inline NotificationReceivedEventArgs::NotificationReceivedEventArgs(ZWNotification^ notification) :
+		m_notification(notification),
+		m_token(ZWTrackedObjectToken::Create(Native::TrackedObject_EventArgs, notification->HomeId, notification->NodeId))
+	{
+	}
 }
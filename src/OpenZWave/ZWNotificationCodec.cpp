@@ -0,0 +1,309 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNotificationCodec.cpp
+//
+//      CLI/C++ and WinRT encoder and decoder of notification records
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWNotificationCodec.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWNotificationRecord::ZWNotificationRecord>
+//	Copy a decoded record
+//-----------------------------------------------------------------------------
+ZWNotificationRecord::ZWNotificationRecord(Native::NotificationRecord const& record) :
+	m_hasValue((record.m_flags & Native::NotificationRecordFlag_Value) != 0),
+	m_intValue(record.m_int),
+	m_truncated((record.m_flags & Native::NotificationRecordFlag_Truncated) != 0)
+{
+	m_notification = gcnew ZWNotification((ZWNotificationType)record.m_type, record.m_byte, record.m_event, ValueID(record.m_homeId, record.m_valueId));
+	if (record.m_string != NULL)
+	{
+		m_stringValue = ConvertString(std::string(record.m_string, record.m_stringLength));
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ZWNotificationCodec::Encode>
+// Encodes a notification
+//-----------------------------------------------------------------------------
+int32 ZWNotificationCodec::Encode
+(
+	ZWNotification^ notification,
+#if __cplusplus_cli
+	cli::array<Byte>^ buffer,
+#else
+	Platform::WriteOnlyArray<byte>^ buffer,
+#endif
+	int32 offset
+)
+{
+	if (offset < 0 || offset >= (int32)buffer->Length)
+	{
+		return 0;
+	}
+
+#if __cplusplus_cli
+	pin_ptr<uint8> p = &buffer[offset];
+	uint8* data = p;
+#else
+	uint8* data = buffer->Data + offset;
+#endif
+	std::string string;
+	return (int32)Encode(notification, data, (uint32)((int32)buffer->Length - offset), &string);
+}
+
+//-----------------------------------------------------------------------------
+// <ZWNotificationCodec::EncodeBatch>
+// Encodes notifications until the buffer is full
+//-----------------------------------------------------------------------------
+int32 ZWNotificationCodec::EncodeBatch
+(
+#if __cplusplus_cli
+	cli::array<ZWNotification^>^ notifications,
+	int32 start,
+	cli::array<Byte>^ buffer,
+	int32 offset,
+	System::Int32 %o_length
+#else
+	const Platform::Array<ZWNotification^>^ notifications,
+	int32 start,
+	Platform::WriteOnlyArray<byte>^ buffer,
+	int32 offset,
+	int32 *o_length
+#endif
+)
+{
+#if __cplusplus_cli
+	o_length = 0;
+#else
+	*o_length = 0;
+#endif
+	if (start < 0 || offset < 0 || offset >= (int32)buffer->Length)
+	{
+		return 0;
+	}
+
+#if __cplusplus_cli
+	pin_ptr<uint8> p = &buffer[offset];
+	uint8* data = p;
+#else
+	uint8* data = buffer->Data + offset;
+#endif
+	uint32 capacity = (uint32)((int32)buffer->Length - offset);
+	uint32 length = 0;
+	std::string string;
+
+	int32 index = start;
+	for (; index < (int32)notifications->Length; ++index)
+	{
+		uint32 size = Encode(notifications[index], data + length, capacity - length, &string);
+		if (size == 0)
+		{
+			break;
+		}
+		length += size;
+	}
+
+#if __cplusplus_cli
+	o_length = (int32)length;
+#else
+	*o_length = (int32)length;
+#endif
+	return index - start;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWNotificationCodec::Decode>
+// Decodes the record at an offset
+//-----------------------------------------------------------------------------
+int32 ZWNotificationCodec::Decode
+(
+#if __cplusplus_cli
+	cli::array<Byte>^ buffer,
+	int32 offset,
+	int32 length,
+	ZWNotificationRecord^ %o_record
+#else
+	const Platform::Array<byte>^ buffer,
+	int32 offset,
+	int32 length,
+	ZWNotificationRecord^ *o_record
+#endif
+)
+{
+#if __cplusplus_cli
+	o_record = nullptr;
+#else
+	*o_record = nullptr;
+#endif
+	if (offset < 0 || length < 0 || offset > (int32)buffer->Length - length)
+	{
+		return -1;
+	}
+	if (length == 0)
+	{
+		return 0;
+	}
+
+#if __cplusplus_cli
+	pin_ptr<uint8> p = &buffer[offset];
+	uint8 const* data = p;
+#else
+	uint8 const* data = buffer->Data + offset;
+#endif
+	Native::NotificationRecord record;
+	uint32 consumed = 0;
+	switch (Native::NotificationCodec::Decode(data, (uint32)length, &record, &consumed))
+	{
+	case Native::NotificationDecode_Record:
+		{
+#if __cplusplus_cli
+			o_record = gcnew ZWNotificationRecord(record);
+#else
+			*o_record = gcnew ZWNotificationRecord(record);
+#endif
+			return (int32)consumed;
+		}
+	case Native::NotificationDecode_Skipped:
+		{
+			return (int32)consumed;
+		}
+	case Native::NotificationDecode_Incomplete:
+		{
+			return 0;
+		}
+	default:
+		{
+			return -1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ZWNotificationCodec::DecodeBatch>
+// Decodes every complete record
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWNotificationRecord^>^ ZWNotificationCodec::DecodeBatch
+#else
+Platform::Array<ZWNotificationRecord^>^ ZWNotificationCodec::DecodeBatch
+#endif
+(
+#if __cplusplus_cli
+	cli::array<Byte>^ buffer,
+	int32 offset,
+	int32 length,
+	System::Int32 %o_consumed
+#else
+	const Platform::Array<byte>^ buffer,
+	int32 offset,
+	int32 length,
+	int32 *o_consumed
+#endif
+)
+{
+#if __cplusplus_cli
+	o_consumed = 0;
+#else
+	*o_consumed = 0;
+#endif
+	if (offset < 0 || length < 0 || offset > (int32)buffer->Length - length)
+	{
+		return nullptr;
+	}
+
+	if (length == 0)
+	{
+#if __cplusplus_cli
+		return gcnew cli::array<ZWNotificationRecord^>(0);
+#else
+		return gcnew Platform::Array<ZWNotificationRecord^>(0);
+#endif
+	}
+
+	// The strings of the records point into the buffer, which stays pinned
+	// until they are copied
+#if __cplusplus_cli
+	pin_ptr<uint8> p = &buffer[offset];
+	uint8 const* data = p;
+#else
+	uint8 const* data = buffer->Data + offset;
+#endif
+	std::vector<Native::NotificationRecord> records;
+	Native::NotificationRecord record;
+	uint32 position = 0;
+	for (;;)
+	{
+		uint32 consumed = 0;
+		Native::NotificationDecodeResult result = Native::NotificationCodec::Decode(data + position, (uint32)length - position, &record, &consumed);
+		if (result == Native::NotificationDecode_Incomplete)
+		{
+			break;
+		}
+		if (result == Native::NotificationDecode_Invalid)
+		{
+			return nullptr;
+		}
+		if (result == Native::NotificationDecode_Record)
+		{
+			records.push_back(record);
+		}
+		position += consumed;
+	}
+
+#if __cplusplus_cli
+	cli::array<ZWNotificationRecord^>^ decoded = gcnew cli::array<ZWNotificationRecord^>((int32)records.size());
+#else
+	Platform::Array<ZWNotificationRecord^>^ decoded = gcnew Platform::Array<ZWNotificationRecord^>((uint32)records.size());
+#endif
+	for (uint32 i = 0; i < (uint32)records.size(); ++i)
+	{
+		decoded[i] = gcnew ZWNotificationRecord(records[i]);
+	}
+
+#if __cplusplus_cli
+	o_consumed = (int32)position;
+#else
+	*o_consumed = (int32)position;
+#endif
+	return decoded;
+}
+
+//-----------------------------------------------------------------------------
+// <ZWNotificationCodec::Encode>
+// Encodes a notification into native memory
+//-----------------------------------------------------------------------------
+uint32 ZWNotificationCodec::Encode
+(
+	ZWNotification^ notification,
+	uint8* buffer,
+	uint32 capacity,
+	std::string* io_string
+)
+{
+	Native::NotificationRecord record;
+	Native::NotificationCodec::Capture((uint8)notification->Type, (uint8)notification->Code, notification->Event, notification->ValueId->CreateUnmanagedValueID(), io_string, &record);
+	return Native::NotificationCodec::Encode(record, buffer, capacity);
+}
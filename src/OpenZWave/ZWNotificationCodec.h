@@ -0,0 +1,144 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWNotificationCodec.h
+//
+//      CLI/C++ and WinRT encoder and decoder of notification records
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "NotificationCodec.h"
+#include "ZWNotification.h"
+#include "ZWConvert.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+using namespace Runtime::InteropServices;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>A notification decoded by ZWNotificationCodec, with the value it carried.</summary>
+	public ref class ZWNotificationRecord sealed
+	{
+	internal:
+		ZWNotificationRecord(Native::NotificationRecord const& record);
+
+	public:
+		/// <summary>Gets the notification.</summary>
+		property ZWNotification^ Notification { ZWNotification^ get() { return m_notification; } }
+		/// <summary>Gets whether the record carries a value, as it does for ValueAdded, ValueChanged and ValueRefreshed.</summary>
+		property bool HasValue { bool get() { return m_hasValue; } }
+		/// <summary>Gets the value of a Bool (1 or 0), Byte, Short, Int or Button, or the value of the selected item of a List.</summary>
+		property int32 IntValue { int32 get() { return m_intValue; } }
+		/// <summary>Gets the value of any other type as ZWManager.GetValueAsString would, or the selected item of a List.  Null if the type has no string.</summary>
+		property String^ StringValue { String^ get() { return m_stringValue; } }
+		/// <summary>Gets whether StringValue was cut short, after 32768 bytes of UTF-8.</summary>
+		property bool Truncated { bool get() { return m_truncated; } }
+
+	private:
+		ZWNotification^	m_notification;
+		bool			m_hasValue;
+		int32			m_intValue;
+		String^			m_stringValue;
+		bool			m_truncated;
+	};
+
+	/// <summary>
+	/// Encodes notifications, with their values, into compact binary records for forwarding to other processes
+	/// and machines, and decodes them there.
+	/// </summary>
+	/// <remarks>
+	/// <para>Each record starts with its length and a format version, so a stream of them can be cut anywhere
+	/// and resumed, and a decoder skips records of a version it does not know.  Numbers are written as varints;
+	/// a typical ValueChanged of an Int takes about 20 bytes.</para>
+	/// <para>The value of a notification is read from OpenZWave when it is encoded, so encode notifications as
+	/// they are received.  Encoding allocates nothing but the records' strings; pass a batch to EncodeBatch to
+	/// reuse even those.</para>
+	/// </remarks>
+	public ref class ZWNotificationCodec sealed
+	{
+	public:
+		/// <summary>Gets the version of the records this build writes.</summary>
+		static property uint8 FormatVersion { uint8 get() { return Native::c_notificationCodecVersion; } }
+
+		/// <summary>Encodes a notification.</summary>
+		/// <param name="notification">The notification.</param>
+		/// <param name="buffer">The buffer to write the record to.</param>
+		/// <param name="offset">Where in the buffer to write it.</param>
+		/// <returns>The number of bytes written, or 0 if the record did not fit.</returns>
+		static int32 Encode(ZWNotification^ notification,
+#if __cplusplus_cli
+			cli::array<Byte>^ buffer,
+#else
+			Platform::WriteOnlyArray<byte>^ buffer,
+#endif
+			int32 offset);
+
+		/// <summary>Encodes as many notifications as fit, one after the other.</summary>
+		/// <param name="notifications">The notifications.</param>
+		/// <param name="start">The index of the first notification to encode.</param>
+		/// <param name="buffer">The buffer to write the records to.</param>
+		/// <param name="offset">Where in the buffer to write the first.</param>
+		/// <param name="o_length">Set to the number of bytes written.</param>
+		/// <returns>The number of notifications encoded.  Pass start plus this to encode the rest into another buffer.</returns>
+		static int32 EncodeBatch(
+#if __cplusplus_cli
+			cli::array<ZWNotification^>^ notifications, int32 start, cli::array<Byte>^ buffer, int32 offset, [Out] System::Int32 %o_length);
+#else
+			const Platform::Array<ZWNotification^>^ notifications, int32 start, Platform::WriteOnlyArray<byte>^ buffer, int32 offset, int32 *o_length);
+#endif
+
+		/// <summary>Decodes the record at an offset.</summary>
+		/// <param name="buffer">The received bytes.</param>
+		/// <param name="offset">Where the record starts.</param>
+		/// <param name="length">The number of bytes received from the offset on.</param>
+		/// <param name="o_record">Set to the record, or null if none was decoded.</param>
+		/// <returns>The number of bytes the record takes, including one of an unknown version, which is skipped
+		/// with o_record null.  0 if more bytes are needed, and -1 if the bytes are not a record.</returns>
+		static int32 Decode(
+#if __cplusplus_cli
+			cli::array<Byte>^ buffer, int32 offset, int32 length, [Out] ZWNotificationRecord^ %o_record);
+#else
+			const Platform::Array<byte>^ buffer, int32 offset, int32 length, ZWNotificationRecord^ *o_record);
+#endif
+
+		/// <summary>Decodes every complete record in a run of received bytes.</summary>
+		/// <param name="buffer">The received bytes.</param>
+		/// <param name="offset">Where the first record starts.</param>
+		/// <param name="length">The number of bytes received from the offset on.</param>
+		/// <param name="o_consumed">Set to the number of bytes decoded.  The bytes after them start a record
+		/// still being received.</param>
+		/// <returns>The records, oldest first, or null if the bytes are not records.</returns>
+#if __cplusplus_cli
+		static cli::array<ZWNotificationRecord^>^ DecodeBatch(cli::array<Byte>^ buffer, int32 offset, int32 length, [Out] System::Int32 %o_consumed);
+#else
+		static Platform::Array<ZWNotificationRecord^>^ DecodeBatch(const Platform::Array<byte>^ buffer, int32 offset, int32 length, int32 *o_consumed);
+#endif
+
+	private:
+		ZWNotificationCodec() {}
+
+		static uint32 Encode(ZWNotification^ notification, uint8* buffer, uint32 capacity, std::string* io_string);
+	};
+}
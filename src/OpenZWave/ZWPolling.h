@@ -0,0 +1,51 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWPolling.h
+//
+//      CLI/C++ and WinRT wrapper for the polled value set
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "PollTable.h"
+
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	/// <summary>A value that OpenZWave polls, returned by ZWManager.GetPolledValues.</summary>
+	/// <remarks>Answers to polls arrive as ordinary value reports, so the report times stand in for poll times.
+	/// Reports the device sends on its own are counted as well.</remarks>
+	public value struct ZWPolledValue
+	{
+		/// <summary>The ZWValueId.Id of the value.</summary>
+		uint64 ValueId;
+		/// <summary>ID of the node the value belongs to.</summary>
+		uint8 NodeId;
+		/// <summary>The poll intensity: 1 to poll every time through the list, 2 every other time, and so on.</summary>
+		uint8 Intensity;
+		/// <summary>Number of reports of the value since polling was enabled.</summary>
+		uint32 Reports;
+		/// <summary>Milliseconds since the last report, or UInt32.MaxValue if there has been none.</summary>
+		uint32 TimeSinceLastReport;
+		/// <summary>Milliseconds between the last two reports, or 0 until there have been two.</summary>
+		uint32 ReportInterval;
+	};
+}
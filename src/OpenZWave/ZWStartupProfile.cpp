@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWStartupProfile.cpp
+//
+//      CLI/C++ and WinRT wrapper for the startup profiler
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWStartupProfile.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWStartupProfile::ZWStartupProfile>
+//	Copy the native profile into managed arrays
+//-----------------------------------------------------------------------------
+ZWStartupProfile::ZWStartupProfile(Native::StartupProfile const& profile) :
+	m_homeId(profile.m_homeId),
+	m_elapsed(profile.m_elapsed),
+	m_awakeNodesQueried(profile.m_awakeNodesQueried),
+	m_allNodesQueried(profile.m_allNodesQueried),
+	m_someDead(profile.m_someDead)
+{
+#if __cplusplus_cli
+	m_spans = gcnew cli::array<ZWQueryStageSpan>((int32)profile.m_spans.size());
+	m_nodes = gcnew cli::array<ZWNodeStartup>((int32)profile.m_nodes.size());
+	m_stages = gcnew cli::array<ZWStageStartup>((int32)profile.m_stages.size());
+#else
+	m_spans = gcnew Platform::Array<ZWQueryStageSpan>((uint32)profile.m_spans.size());
+	m_nodes = gcnew Platform::Array<ZWNodeStartup>((uint32)profile.m_nodes.size());
+	m_stages = gcnew Platform::Array<ZWStageStartup>((uint32)profile.m_stages.size());
+#endif
+
+	for (uint32 i = 0; i < (uint32)profile.m_spans.size(); ++i)
+	{
+		Native::QueryStageSpan const& native = profile.m_spans[i];
+		ZWQueryStageSpan span;
+		span.NodeId = native.m_nodeId;
+		span.Stage = (ZWQueryStage)native.m_stage;
+		span.Enter = native.m_enter;
+		span.Exit = native.m_exit;
+		span.Retries = native.m_retries;
+		span.IsOpen = native.m_open;
+		m_spans[i] = span;
+	}
+
+	for (uint32 i = 0; i < (uint32)profile.m_nodes.size(); ++i)
+	{
+		Native::NodeStartup const& native = profile.m_nodes[i];
+		ZWNodeStartup node;
+		node.NodeId = native.m_nodeId;
+		node.Time = native.m_time;
+		node.IsComplete = native.m_complete;
+		node.SlowestStage = (ZWQueryStage)native.m_slowestStage;
+		node.SlowestStageTime = native.m_slowestTime;
+		node.Retries = native.m_retries;
+		m_nodes[i] = node;
+	}
+
+	for (uint32 i = 0; i < (uint32)profile.m_stages.size(); ++i)
+	{
+		Native::StageStartup const& native = profile.m_stages[i];
+		ZWStageStartup stage;
+		stage.Stage = (ZWQueryStage)native.m_stage;
+		stage.Time = native.m_time;
+		stage.NodeCount = native.m_nodeCount;
+		stage.Retries = native.m_retries;
+		stage.SlowestNodeId = native.m_slowestNodeId;
+		stage.SlowestNodeTime = native.m_slowestTime;
+		m_stages[i] = stage;
+	}
+}
@@ -0,0 +1,199 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWStartupProfile.h
+//
+//      CLI/C++ and WinRT wrapper for the startup profiler
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "StartupProfiler.h"
+
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	/// <summary>The stages OpenZWave goes through to query a node, in the order they run.</summary>
+	/// <remarks>The names match the strings returned by ZWManager.GetNodeQueryStage.</remarks>
+	public enum class ZWQueryStage
+	{
+		/// <summary>Get the protocol information.</summary>
+		ProtocolInfo = Native::QueryStage_ProtocolInfo,
+		/// <summary>Ping the node to see if it is alive.</summary>
+		Probe = Native::QueryStage_Probe,
+		/// <summary>Start the wake up process if the node sleeps.  Sleeping nodes wait here until they next wake.</summary>
+		WakeUp = Native::QueryStage_WakeUp,
+		/// <summary>Get the manufacturer and product IDs.</summary>
+		ManufacturerSpecific1 = Native::QueryStage_ManufacturerSpecific1,
+		/// <summary>Get the supported command classes.</summary>
+		NodeInfo = Native::QueryStage_NodeInfo,
+		/// <summary>Get the Z-Wave Plus information.</summary>
+		NodePlusInfo = Native::QueryStage_NodePlusInfo,
+		/// <summary>Get the secured command classes.</summary>
+		SecurityReport = Native::QueryStage_SecurityReport,
+		/// <summary>Get the manufacturer and product IDs again, if they were not loaded from the cache.</summary>
+		ManufacturerSpecific2 = Native::QueryStage_ManufacturerSpecific2,
+		/// <summary>Get the command class versions.</summary>
+		Versions = Native::QueryStage_Versions,
+		/// <summary>Get the multi-instance and multi-channel endpoints.</summary>
+		Instances = Native::QueryStage_Instances,
+		/// <summary>Get the values that do not change.</summary>
+		Static = Native::QueryStage_Static,
+		/// <summary>Load the node from the network cache.</summary>
+		CacheLoad = Native::QueryStage_CacheLoad,
+		/// <summary>Ping a node loaded from the cache to see if it is alive.</summary>
+		Probe1 = Native::QueryStage_Probe1,
+		/// <summary>Get the association groups.</summary>
+		Associations = Native::QueryStage_Associations,
+		/// <summary>Get the routing table.</summary>
+		Neighbors = Native::QueryStage_Neighbors,
+		/// <summary>Get the values that change rarely.</summary>
+		Session = Native::QueryStage_Session,
+		/// <summary>Get the values that change often.</summary>
+		Dynamic = Native::QueryStage_Dynamic,
+		/// <summary>Get the configuration parameters.</summary>
+		Configuration = Native::QueryStage_Configuration,
+		/// <summary>The node has been fully queried.</summary>
+		Complete = Native::QueryStage_Complete,
+		/// <summary>The node is not being queried.</summary>
+		None = Native::QueryStage_None,
+		/// <summary>A stage name this wrapper does not know.</summary>
+		Unknown = Native::QueryStage_Unknown
+	};
+
+	/// <summary>The time a node spent in one query stage.</summary>
+	/// <remarks>Times are milliseconds since the driver was ready.</remarks>
+	public value struct ZWQueryStageSpan
+	{
+		/// <summary>ID of the node.</summary>
+		uint8 NodeId;
+		/// <summary>The stage.</summary>
+		ZWQueryStage Stage;
+		/// <summary>When the node was first seen in the stage.</summary>
+		uint64 Enter;
+		/// <summary>When the node was seen in the next stage, or the time of the profile if it is still in this one.</summary>
+		uint64 Exit;
+		/// <summary>Message timeouts in the stage, plus one if the node had been in the stage before.</summary>
+		uint32 Retries;
+		/// <summary>Whether the node is still in the stage.</summary>
+		bool IsOpen;
+	};
+
+	/// <summary>How long one node took to be queried.</summary>
+	public value struct ZWNodeStartup
+	{
+		/// <summary>ID of the node.</summary>
+		uint8 NodeId;
+		/// <summary>Milliseconds from the driver being ready until the node was complete, or until now.</summary>
+		uint64 Time;
+		/// <summary>Whether the node reached the Complete stage.</summary>
+		bool IsComplete;
+		/// <summary>The stage the node spent most time in.</summary>
+		ZWQueryStage SlowestStage;
+		/// <summary>Milliseconds spent in SlowestStage.</summary>
+		uint64 SlowestStageTime;
+		/// <summary>Retries over every stage.</summary>
+		uint32 Retries;
+	};
+
+	/// <summary>How long every node spent in one query stage.</summary>
+	public value struct ZWStageStartup
+	{
+		/// <summary>The stage.</summary>
+		ZWQueryStage Stage;
+		/// <summary>Milliseconds spent in the stage, summed over every node.</summary>
+		uint64 Time;
+		/// <summary>Number of nodes seen in the stage.</summary>
+		uint32 NodeCount;
+		/// <summary>Retries in the stage over every node.</summary>
+		uint32 Retries;
+		/// <summary>ID of the node that spent most time in the stage.</summary>
+		uint8 SlowestNodeId;
+		/// <summary>Milliseconds the slowest node spent in the stage.</summary>
+		uint64 SlowestNodeTime;
+	};
+
+	/// <summary>
+	/// The query stage timeline of a network since the driver was ready, returned by ZWManager.GetStartupProfile.
+	/// </summary>
+	/// <remarks>
+	/// OpenZWave has no notification for stage changes, so the profiler reads each node's stage when a notification
+	/// arrives for it and every 250 milliseconds until AllNodesQueried.  Stages shorter than that may be missed, and
+	/// every time is accurate to the sampling period.
+	/// </remarks>
+	public ref class ZWStartupProfile sealed
+	{
+	internal:
+		ZWStartupProfile(Native::StartupProfile const& profile);
+
+	public:
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { return m_homeId; } }
+
+		/// <summary>Gets the milliseconds from the driver being ready until AllNodesQueried, or until now.</summary>
+		property uint64 Elapsed { uint64 get() { return m_elapsed; } }
+
+		/// <summary>Gets when AwakeNodesQueried was reported, or 0 if it has not been.</summary>
+		property uint64 AwakeNodesQueried { uint64 get() { return m_awakeNodesQueried; } }
+
+		/// <summary>Gets when AllNodesQueried or AllNodesQueriedSomeDead was reported, or 0 if neither has been.</summary>
+		property uint64 AllNodesQueried { uint64 get() { return m_allNodesQueried; } }
+
+		/// <summary>Gets whether the query finished with AllNodesQueriedSomeDead.</summary>
+		property bool SomeDead { bool get() { return m_someDead; } }
+
+		/// <summary>Gets the timeline, sorted by node and then by time.</summary>
+#if __cplusplus_cli
+		cli::array<ZWQueryStageSpan>^ GetSpans() { return m_spans; }
+#else
+		Platform::Array<ZWQueryStageSpan>^ GetSpans() { return m_spans; }
+#endif
+
+		/// <summary>Gets the time each node took, slowest first.  The first nodes are the ones that held up AllNodesQueried.</summary>
+#if __cplusplus_cli
+		cli::array<ZWNodeStartup>^ GetNodes() { return m_nodes; }
+#else
+		Platform::Array<ZWNodeStartup>^ GetNodes() { return m_nodes; }
+#endif
+
+		/// <summary>Gets the time spent in each stage, most first.</summary>
+#if __cplusplus_cli
+		cli::array<ZWStageStartup>^ GetStages() { return m_stages; }
+#else
+		Platform::Array<ZWStageStartup>^ GetStages() { return m_stages; }
+#endif
+
+	private:
+		uint32								m_homeId;
+		uint64								m_elapsed;
+		uint64								m_awakeNodesQueried;
+		uint64								m_allNodesQueried;
+		bool								m_someDead;
+#if __cplusplus_cli
+		cli::array<ZWQueryStageSpan>^		m_spans;
+		cli::array<ZWNodeStartup>^			m_nodes;
+		cli::array<ZWStageStartup>^			m_stages;
+#else
+		Platform::Array<ZWQueryStageSpan>^	m_spans;
+		Platform::Array<ZWNodeStartup>^		m_nodes;
+		Platform::Array<ZWStageStartup>^	m_stages;
+#endif
+	};
+}
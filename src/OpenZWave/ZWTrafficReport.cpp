@@ -0,0 +1,132 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWTrafficReport.cpp
+//
+//      CLI/C++ and WinRT wrapper for the traffic counters of a network
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWTrafficReport.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWTrafficReport::ZWTrafficReport>
+//	Copy the native counters into managed arrays
+//-----------------------------------------------------------------------------
+ZWTrafficReport::ZWTrafficReport(uint32 homeId, std::vector<Native::TrafficCounter> const& counters) :
+	m_homeId(homeId)
+{
+	uint32 count = (uint32)counters.size();
+#if __cplusplus_cli
+	m_counters = gcnew cli::array<ZWTrafficCounter>((int32)count);
+	m_transmit = gcnew cli::array<uint32>((int32)(count * Native::c_latencyBucketCount));
+	m_response = gcnew cli::array<uint32>((int32)(count * Native::c_latencyBucketCount));
+#else
+	m_counters = gcnew Platform::Array<ZWTrafficCounter>(count);
+	m_transmit = gcnew Platform::Array<uint32>(count * Native::c_latencyBucketCount);
+	m_response = gcnew Platform::Array<uint32>(count * Native::c_latencyBucketCount);
+#endif
+
+	for (uint32 i = 0; i < count; ++i)
+	{
+		Native::TrafficCounter const& native = counters[i];
+		ZWTrafficCounter counter;
+		counter.NodeId = native.m_nodeId;
+		counter.CommandClassId = native.m_commandClassId;
+		counter.Sent = native.m_sent;
+		counter.Received = native.m_received;
+		counter.FramesSent = native.m_framesSent;
+		counter.FramesReceived = native.m_framesReceived;
+		counter.BytesSent = native.m_bytesSent;
+		counter.BytesReceived = native.m_bytesReceived;
+		counter.Retries = native.m_retries;
+		counter.Timeouts = native.m_timeouts;
+		counter.Reports = native.m_reports;
+		counter.TransmitCount = native.m_transmit.m_count;
+		counter.TransmitMeanMs = (native.m_transmit.m_count > 0) ? (uint32)(native.m_transmit.m_totalMs / native.m_transmit.m_count) : 0;
+		counter.TransmitP95Ms = Native::TrafficCounters::GetPercentile(native.m_transmit, 95);
+		counter.TransmitMaxMs = native.m_transmit.m_maxMs;
+		counter.ResponseCount = native.m_response.m_count;
+		counter.ResponseMeanMs = (native.m_response.m_count > 0) ? (uint32)(native.m_response.m_totalMs / native.m_response.m_count) : 0;
+		counter.ResponseP95Ms = Native::TrafficCounters::GetPercentile(native.m_response, 95);
+		counter.ResponseMaxMs = native.m_response.m_maxMs;
+		m_counters[i] = counter;
+
+		for (uint32 j = 0; j < Native::c_latencyBucketCount; ++j)
+		{
+			m_transmit[i * Native::c_latencyBucketCount + j] = native.m_transmit.m_buckets[j];
+			m_response[i * Native::c_latencyBucketCount + j] = native.m_response.m_buckets[j];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWTrafficReport::GetLatencyBounds>
+//	The upper bounds of the histogram buckets
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<uint32>^ ZWTrafficReport::GetLatencyBounds()
+#else
+Platform::Array<uint32>^ ZWTrafficReport::GetLatencyBounds()
+#endif
+{
+	uint32 count = Native::c_latencyBucketCount - 1;
+#if __cplusplus_cli
+	cli::array<uint32>^ bounds = gcnew cli::array<uint32>((int32)count);
+#else
+	Platform::Array<uint32>^ bounds = gcnew Platform::Array<uint32>(count);
+#endif
+
+	for (uint32 i = 0; i < count; ++i)
+	{
+		bounds[i] = Native::TrafficCounters::c_latencyBounds[i];
+	}
+	return bounds;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWTrafficReport::GetHistogram>
+//	Copy one counter's buckets
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<uint32>^ ZWTrafficReport::GetHistogram(cli::array<uint32>^ buckets, uint32 index)
+#else
+Platform::Array<uint32>^ ZWTrafficReport::GetHistogram(Platform::Array<uint32>^ buckets, uint32 index)
+#endif
+{
+	if (index >= (uint32)m_counters->Length)
+	{
+		return nullptr;
+	}
+
+#if __cplusplus_cli
+	cli::array<uint32>^ histogram = gcnew cli::array<uint32>((int32)Native::c_latencyBucketCount);
+#else
+	Platform::Array<uint32>^ histogram = gcnew Platform::Array<uint32>(Native::c_latencyBucketCount);
+#endif
+
+	for (uint32 i = 0; i < Native::c_latencyBucketCount; ++i)
+	{
+		histogram[i] = buckets[index * Native::c_latencyBucketCount + i];
+	}
+	return histogram;
+}
@@ -0,0 +1,149 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWTrafficReport.h
+//
+//      CLI/C++ and WinRT wrapper for the traffic counters of a network
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "TrafficCounters.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	/// <summary>The traffic of one command class of one node.</summary>
+	/// <remarks>Round trip times are in milliseconds.  Percentiles are the upper bound of the histogram bucket they fall in.</remarks>
+	public value struct ZWTrafficCounter
+	{
+		/// <summary>ID of the node.</summary>
+		uint8 NodeId;
+		/// <summary>The command class, or 0 for timeouts that could not be tied to one.</summary>
+		uint8 CommandClassId;
+		/// <summary>Messages sent, from OpenZWave's node statistics.</summary>
+		uint64 Sent;
+		/// <summary>Messages received, from OpenZWave's node statistics.</summary>
+		uint64 Received;
+		/// <summary>SendData frames written to the controller, including retries.</summary>
+		uint64 FramesSent;
+		/// <summary>Application command frames received from the node.</summary>
+		uint64 FramesReceived;
+		/// <summary>Bytes of the frames sent, from start of frame to checksum.</summary>
+		uint64 BytesSent;
+		/// <summary>Bytes of the frames received.</summary>
+		uint64 BytesReceived;
+		/// <summary>Frames sent again because the first attempt failed.</summary>
+		uint64 Retries;
+		/// <summary>Messages that timed out.</summary>
+		uint64 Timeouts;
+		/// <summary>Values changed or refreshed.</summary>
+		uint64 Reports;
+		/// <summary>Number of SendData callbacks timed: the node acknowledged, or the controller gave up.</summary>
+		uint32 TransmitCount;
+		/// <summary>Mean time from SendData to its callback.</summary>
+		uint32 TransmitMeanMs;
+		/// <summary>95th percentile of the time from SendData to its callback.</summary>
+		uint32 TransmitP95Ms;
+		/// <summary>Longest time from SendData to its callback.</summary>
+		uint32 TransmitMaxMs;
+		/// <summary>Number of answers timed: the node's next frame of the same command class after a SendData.</summary>
+		uint32 ResponseCount;
+		/// <summary>Mean time from SendData to the answer.</summary>
+		uint32 ResponseMeanMs;
+		/// <summary>95th percentile of the time from SendData to the answer.</summary>
+		uint32 ResponseP95Ms;
+		/// <summary>Longest time from SendData to the answer.</summary>
+		uint32 ResponseMaxMs;
+	};
+
+	/// <summary>
+	/// The traffic of a network by node and command class, returned by ZWManager.GetTrafficReport.
+	/// </summary>
+	/// <remarks>
+	/// Sent and Received come from OpenZWave's node statistics.  The frame counts, bytes, retries and round trips
+	/// come from the frames the driver logs, which do not name the driver, so they are only counted while exactly
+	/// one driver is ready.  Everything is counted from when counting was enabled or reset.
+	/// </remarks>
+	public ref class ZWTrafficReport sealed
+	{
+	internal:
+		ZWTrafficReport(uint32 homeId, std::vector<Native::TrafficCounter> const& counters);
+
+	public:
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { return m_homeId; } }
+
+		/// <summary>Gets the counters, sorted by node and then by command class.</summary>
+#if __cplusplus_cli
+		cli::array<ZWTrafficCounter>^ GetCounters() { return m_counters; }
+#else
+		Platform::Array<ZWTrafficCounter>^ GetCounters() { return m_counters; }
+#endif
+
+		/// <summary>Gets the upper bounds, in milliseconds, of the histogram buckets.  The last bucket has no bound.</summary>
+#if __cplusplus_cli
+		cli::array<uint32>^ GetLatencyBounds();
+#else
+		Platform::Array<uint32>^ GetLatencyBounds();
+#endif
+
+		/// <summary>Gets the histogram of the times from SendData to its callback of a counter.</summary>
+		/// <param name="index">The index of the counter in GetCounters.</param>
+		/// <returns>The number of round trips in each bucket, one more than GetLatencyBounds, or null if the index is out of range.</returns>
+#if __cplusplus_cli
+		cli::array<uint32>^ GetTransmitHistogram(uint32 index) { return GetHistogram(m_transmit, index); }
+#else
+		Platform::Array<uint32>^ GetTransmitHistogram(uint32 index) { return GetHistogram(m_transmit, index); }
+#endif
+
+		/// <summary>Gets the histogram of the times from SendData to the answer of a counter.</summary>
+		/// <param name="index">The index of the counter in GetCounters.</param>
+		/// <returns>The number of round trips in each bucket, one more than GetLatencyBounds, or null if the index is out of range.</returns>
+#if __cplusplus_cli
+		cli::array<uint32>^ GetResponseHistogram(uint32 index) { return GetHistogram(m_response, index); }
+#else
+		Platform::Array<uint32>^ GetResponseHistogram(uint32 index) { return GetHistogram(m_response, index); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		cli::array<uint32>^ GetHistogram(cli::array<uint32>^ buckets, uint32 index);
+#else
+		Platform::Array<uint32>^ GetHistogram(Platform::Array<uint32>^ buckets, uint32 index);
+#endif
+
+		uint32								m_homeId;
+#if __cplusplus_cli
+		cli::array<ZWTrafficCounter>^		m_counters;
+		cli::array<uint32>^					m_transmit;			// Every counter's buckets, one after the other
+		cli::array<uint32>^					m_response;
+#else
+		Platform::Array<ZWTrafficCounter>^	m_counters;
+		Platform::Array<uint32>^			m_transmit;
+		Platform::Array<uint32>^			m_response;
+#endif
+	};
+}
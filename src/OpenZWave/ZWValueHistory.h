@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWValueHistory.h
+//
+//      CLI/C++ and WinRT wrapper for the value history
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "ValueHistory.h"
+
+using namespace OpenZWave;
+
+namespace OpenZWave
+{
+	/// <summary>One recorded value, returned by ZWManager.GetValueHistory.</summary>
+	public value struct ZWHistorySample
+	{
+		/// <summary>When the change was received, as a UTC file time (DateTime.FromFileTimeUtc).</summary>
+		int64 Timestamp;
+		/// <summary>The value.  Bools are 0 or 1, and lists give the value of the selected item.</summary>
+		double Value;
+	};
+
+	/// <summary>The samples in one window of a time range, returned by ZWManager.GetValueHistoryAggregates.</summary>
+	public value struct ZWHistoryAggregate
+	{
+		/// <summary>The start of the window, as a UTC file time.</summary>
+		int64 Start;
+		/// <summary>The end of the window, as a UTC file time.  It is not part of the window.</summary>
+		int64 End;
+		/// <summary>The number of samples in the window.  If it is 0, the other fields are 0 as well.</summary>
+		uint32 Count;
+		/// <summary>The smallest value in the window.</summary>
+		double Min;
+		/// <summary>The largest value in the window.</summary>
+		double Max;
+		/// <summary>The mean of the values in the window.</summary>
+		double Average;
+		/// <summary>The newest value in the window.</summary>
+		double Last;
+	};
+}
@@ -30,6 +30,8 @@
 
 #pragma once
 #include "ZWEnums.h"
+#include "MemoryTracker.h"
+#include "ValueKeys.h"
 
 using namespace OpenZWave;
 
@@ -70,6 +72,7 @@ namespace OpenZWave
 		)
 		{
 			m_valueId = new ValueID(homeId, nodeId, (ValueID::ValueGenre)genre, commandClassId, instance, valueIndex, (ValueID::ValueType)type);
+			Track();
 		}
 
 		/// <summary>Gets the Home ID of the driver that controls the node containing the value.</summary>
@@ -110,6 +113,15 @@ namespace OpenZWave
 		/// across restarts of OpenZWave.</summary>
 		property uint64	Id { uint64 get() { return m_valueId->GetId(); } }
 
+		/// <summary>Gets a small integer that identifies this value, and stays the same across restarts of
+		/// OpenZWave.  Keys start at 1 and are given out in the order values are first seen, so they can index
+		/// an array.</summary>
+		/// <remarks>The key, and any reserved before it, is written and flushed to the key file before it is
+		/// first returned, so that call waits for the disk.  Later calls only look the key up.</remarks>
+		/// <returns>The key, or 0 if no key file has been opened with ZWManager.OpenValueKeys or the new key could
+		/// not be written.  A key that could not be written is given out again on the next call.</returns>
+		uint32 GetKey() { return Native::ValueKeys::GetKey(*m_valueId); }
+
 	private:
 #if __cplusplus_cli
 		!ZWValueId()
@@ -117,13 +129,23 @@ namespace OpenZWave
 		~ZWValueId()
 #endif
 		{
+			if (m_tracked)
+				Native::MemoryTracker::OnDestroyed(Native::TrackedObject_ValueId, m_valueId->GetHomeId(), m_valueId->GetNodeId(), sizeof(ValueID));
 			delete m_valueId;
 		}
 
+		void Track()
+		{
+			m_tracked = Native::MemoryTracker::IsEnabled();
+			if (m_tracked)
+				Native::MemoryTracker::OnCreated(Native::TrackedObject_ValueId, m_valueId->GetHomeId(), m_valueId->GetNodeId(), sizeof(ValueID));
+		}
+
 	internal:
 		ZWValueId(ValueID const& valueId)
 		{
 			m_valueId = new ValueID(valueId);
+			Track();
 		}
 
 		ValueID CreateUnmanagedValueID() { return ValueID(*m_valueId); }
@@ -136,5 +158,6 @@ namespace OpenZWave
 
 	private:
 		ValueID* m_valueId;
+		bool m_tracked;
     };
 }
@@ -0,0 +1,244 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWWakeUpQueue.cpp
+//
+//      CLI/C++ and WinRT wrapper for the wake-up aware command queue
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "pch.h"
+#include "ZWWakeUpQueue.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::ZWWakeUpQueue>
+//	Constructor
+//-----------------------------------------------------------------------------
+ZWWakeUpQueue::ZWWakeUpQueue
+(
+	uint32 homeId
+) :
+	m_homeId(homeId)
+{
+#if __cplusplus_cli
+	// The delegate lives as long as the queue, which deletes the native
+	// queue (and so stops the callbacks) before it goes away.
+	m_onCommandSent = gcnew OnCommandSentFromUnmanagedDelegate(this, &ZWWakeUpQueue::OnCommandSentFromUnmanaged);
+	IntPtr ip = Marshal::GetFunctionPointerForDelegate(m_onCommandSent);
+	m_queue = new Native::WakeUpQueue(homeId, (Native::pfnOnCommandSent_t)ip.ToPointer(), NULL);
+#else
+	m_queue = new Native::WakeUpQueue(homeId, OnCommandSentFromUnmanaged, reinterpret_cast<void*>(this));
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::SetValue>
+//	Typed value writes
+//-----------------------------------------------------------------------------
+ZWQueueResult ZWWakeUpQueue::SetValue(ZWValueId^ id, bool value)
+{
+	Native::PendingCommand command = ValueCommand(id, Native::PendingValueType_Bool);
+	command.m_int = value ? 1 : 0;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+ZWQueueResult ZWWakeUpQueue::SetValue(ZWValueId^ id, uint8 value)
+{
+	Native::PendingCommand command = ValueCommand(id, Native::PendingValueType_Byte);
+	command.m_int = value;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+ZWQueueResult ZWWakeUpQueue::SetValue(ZWValueId^ id, float value)
+{
+	Native::PendingCommand command = ValueCommand(id, Native::PendingValueType_Decimal);
+	command.m_float = value;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+ZWQueueResult ZWWakeUpQueue::SetValue(ZWValueId^ id, int32 value)
+{
+	Native::PendingCommand command = ValueCommand(id, Native::PendingValueType_Int);
+	command.m_int = value;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+ZWQueueResult ZWWakeUpQueue::SetValue(ZWValueId^ id, int16 value)
+{
+	Native::PendingCommand command = ValueCommand(id, Native::PendingValueType_Short);
+	command.m_int = value;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+ZWQueueResult ZWWakeUpQueue::SetValue(ZWValueId^ id, String^ value)
+{
+	Native::PendingCommand command = ValueCommand(id, Native::PendingValueType_String);
+	command.m_string = ConvertString(value);
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::SetConfigParam>
+//	Configuration parameter write
+//-----------------------------------------------------------------------------
+ZWQueueResult ZWWakeUpQueue::SetConfigParam(uint8 nodeId, uint8 param, int32 value, uint8 size)
+{
+	Native::PendingCommand command;
+	command.m_kind = Native::PendingKind_ConfigParam;
+	command.m_nodeId = nodeId;
+	command.m_index = param;
+	command.m_int = value;
+	command.m_size = size;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::AddAssociation>
+//	Association addition
+//-----------------------------------------------------------------------------
+ZWQueueResult ZWWakeUpQueue::AddAssociation(uint8 nodeId, uint8 groupIdx, uint8 targetNodeId)
+{
+	Native::PendingCommand command;
+	command.m_kind = Native::PendingKind_Association;
+	command.m_nodeId = nodeId;
+	command.m_index = groupIdx;
+	command.m_targetNodeId = targetNodeId;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::RemoveAssociation>
+//	Association removal
+//-----------------------------------------------------------------------------
+ZWQueueResult ZWWakeUpQueue::RemoveAssociation(uint8 nodeId, uint8 groupIdx, uint8 targetNodeId)
+{
+	Native::PendingCommand command;
+	command.m_kind = Native::PendingKind_Association;
+	command.m_nodeId = nodeId;
+	command.m_index = groupIdx;
+	command.m_targetNodeId = targetNodeId;
+	command.m_remove = true;
+	return (ZWQueueResult)GetQueue()->Submit(command);
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::GetPending>
+//	Commands held for a node, in the order they will be sent
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+cli::array<ZWPendingCommand>^ ZWWakeUpQueue::GetPending(uint8 nodeId)
+{
+	std::vector<Native::PendingCommand> pending;
+	GetQueue()->GetPending(nodeId, &pending);
+
+	uint64 now = GetTickCount64();
+	cli::array<ZWPendingCommand>^ commands = gcnew cli::array<ZWPendingCommand>((int32)pending.size());
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		commands[(int32)i] = ConvertCommand(pending[i], (uint32)(now - pending[i].m_queuedAt));
+	}
+	return commands;
+}
+#else
+Platform::Array<ZWPendingCommand>^ ZWWakeUpQueue::GetPending(uint8 nodeId)
+{
+	std::vector<Native::PendingCommand> pending;
+	GetQueue()->GetPending(nodeId, &pending);
+
+	uint64 now = GetTickCount64();
+	Platform::Array<ZWPendingCommand>^ commands = gcnew Platform::Array<ZWPendingCommand>((uint32)pending.size());
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		commands[(uint32)i] = ConvertCommand(pending[i], (uint32)(now - pending[i].m_queuedAt));
+	}
+	return commands;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::ValueCommand>
+//	A value write for the given ValueID, without its value
+//-----------------------------------------------------------------------------
+Native::PendingCommand ZWWakeUpQueue::ValueCommand(ZWValueId^ id, Native::PendingValueType type)
+{
+	Native::PendingCommand command;
+	command.m_kind = Native::PendingKind_Value;
+	command.m_nodeId = id->NodeId;
+	command.m_valueId = id->Id;
+	command.m_type = type;
+	return command;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::ConvertCommand>
+//	Copy a native command into its managed form
+//-----------------------------------------------------------------------------
+ZWPendingCommand ZWWakeUpQueue::ConvertCommand(Native::PendingCommand const& _command, uint32 _waitedMs)
+{
+	ZWPendingCommand command;
+	command.Kind = (ZWPendingCommandKind)_command.m_kind;
+	command.NodeId = _command.m_nodeId;
+	command.ValueId = _command.m_valueId;
+	command.Index = _command.m_index;
+	command.TargetNodeId = _command.m_targetNodeId;
+	command.Remove = _command.m_remove;
+	command.Writes = _command.m_writes;
+	command.WaitTime = _waitedMs;
+
+	if (_command.m_kind == Native::PendingKind_Association)
+	{
+		command.Value = nullptr;
+	}
+	else if (_command.m_kind == Native::PendingKind_Value && _command.m_type == Native::PendingValueType_String)
+	{
+		command.Value = ConvertString(_command.m_string);
+	}
+	else if (_command.m_kind == Native::PendingKind_Value && _command.m_type == Native::PendingValueType_Bool)
+	{
+		command.Value = ConvertString(std::string(_command.m_int != 0 ? "True" : "False"));
+	}
+	else if (_command.m_kind == Native::PendingKind_Value && _command.m_type == Native::PendingValueType_Decimal)
+	{
+		command.Value = ConvertString(std::to_string(_command.m_float));
+	}
+	else
+	{
+		command.Value = ConvertString(std::to_string(_command.m_int));
+	}
+	return command;
+}
+
+//-----------------------------------------------------------------------------
+//	<ZWWakeUpQueue::OnCommandSentFromUnmanaged>
+//	Raise the CommandSent event for a command handed to OpenZWave
+//-----------------------------------------------------------------------------
+#if __cplusplus_cli
+void ZWWakeUpQueue::OnCommandSentFromUnmanaged(Native::PendingCommand const* _command, bool _success, uint32 _waitedMs, void* _context)
+{
+	CommandSent(this, gcnew CommandSentEventArgs(ConvertCommand(*_command, _waitedMs), _success));
+}
+#else
+void ZWWakeUpQueue::OnCommandSentFromUnmanaged(Native::PendingCommand const* _command, bool _success, uint32 _waitedMs, void* _context)
+{
+	ZWWakeUpQueue^ queue = reinterpret_cast<ZWWakeUpQueue^>(_context);
+	queue->CommandSent(queue, gcnew CommandSentEventArgs(ConvertCommand(*_command, _waitedMs), _success));
+}
+#endif
@@ -0,0 +1,223 @@
+//-----------------------------------------------------------------------------
+//
+//      ZWWakeUpQueue.h
+//
+//      CLI/C++ and WinRT wrapper for the wake-up aware command queue
+//
+//      SOFTWARE NOTICE AND LICENSE
+//
+//      This file is part of OpenZWave.
+//
+//      OpenZWave is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU Lesser General Public License as published
+//      by the Free Software Foundation, either version 3 of the License,
+//      or (at your option) any later version.
+//
+//      OpenZWave is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU Lesser General Public License for more details.
+//
+//      You should have received a copy of the GNU Lesser General Public License
+//      along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "WakeUpQueue.h"
+#include "ZWValueID.h"
+#include "ZWConvert.h"
+#include "ZWDisposed.h"
+
+using namespace OpenZWave;
+#if __cplusplus_cli
+using namespace System;
+using namespace Runtime::InteropServices;
+#else
+using namespace Platform;
+#endif
+
+namespace OpenZWave
+{
+	ref class ZWWakeUpQueue;
+
+	/// <summary>What a held command changes.</summary>
+	public enum class ZWPendingCommandKind
+	{
+		/// <summary>A configuration parameter, from SetConfigParam.</summary>
+		ConfigParam = Native::PendingKind_ConfigParam,
+		/// <summary>An association, from AddAssociation or RemoveAssociation.</summary>
+		Association = Native::PendingKind_Association,
+		/// <summary>A value, from SetValue.</summary>
+		Value = Native::PendingKind_Value
+	};
+
+	/// <summary>What ZWWakeUpQueue did with a command.</summary>
+	public enum class ZWQueueResult
+	{
+		/// <summary>The node was awake, and the command was sent straight away.</summary>
+		Sent = Native::SubmitResult_Sent,
+		/// <summary>The node was awake, but OpenZWave rejected the command.</summary>
+		Failed = Native::SubmitResult_Failed,
+		/// <summary>The node is asleep, and the command is held until it wakes up.</summary>
+		Queued = Native::SubmitResult_Queued,
+		/// <summary>The node is asleep, and the command replaced one already held for the same target.</summary>
+		Coalesced = Native::SubmitResult_Coalesced
+	};
+
+	/// <summary>A command held by ZWWakeUpQueue, or one it has sent.</summary>
+	public value struct ZWPendingCommand
+	{
+		/// <summary>What the command changes.</summary>
+		ZWPendingCommandKind Kind;
+		/// <summary>ID of the node the command is for.</summary>
+		uint8 NodeId;
+		/// <summary>For a value, the ZWValueId.Id of the value.  Otherwise 0.</summary>
+		uint64 ValueId;
+		/// <summary>For a configuration parameter, its index.  For an association, the group.  Otherwise 0.</summary>
+		uint8 Index;
+		/// <summary>For an association, the target node.  Otherwise 0.</summary>
+		uint8 TargetNodeId;
+		/// <summary>For an association, true if the target is removed rather than added.</summary>
+		bool Remove;
+		/// <summary>The value or configuration parameter value, as text.</summary>
+		String^ Value;
+		/// <summary>Number of requests folded into the command.</summary>
+		uint32 Writes;
+		/// <summary>Milliseconds since the first of them was made.</summary>
+		uint32 WaitTime;
+	};
+
+	/// <summary>A command that ZWWakeUpQueue has handed to OpenZWave.</summary>
+	public ref class CommandSentEventArgs sealed
+	{
+	internal:
+		CommandSentEventArgs(ZWPendingCommand command, bool success) :
+			m_command(command),
+			m_success(success)
+		{
+		}
+
+	public:
+		/// <summary>Gets the command.  Its WaitTime is how long it was held.</summary>
+		property ZWPendingCommand Command { ZWPendingCommand get() { return m_command; } }
+		/// <summary>Gets whether OpenZWave accepted the command.</summary>
+		property bool Success { bool get() { return m_success; } }
+
+	private:
+		ZWPendingCommand	m_command;
+		bool				m_success;
+	};
+
+	public delegate void CommandSentEventHandler(ZWWakeUpQueue^ sender, CommandSentEventArgs^ e);
+
+#if __cplusplus_cli
+	[UnmanagedFunctionPointer(CallingConvention::Cdecl)]
+	private delegate void OnCommandSentFromUnmanagedDelegate(Native::PendingCommand const* _command, bool _success, uint32 _waitedMs, void* _context);
+#endif
+
+	/// <summary>
+	/// Holds commands for sleeping nodes in the wrapper, and sends them when the node wakes up.
+	/// </summary>
+	/// <remarks>
+	/// <para>A command for a node that is awake is sent straight away.  A command for a sleeping node is held,
+	/// and replaces any command already held for the same value, configuration parameter or association, so a
+	/// setting edited several times costs one frame in the wake-up window.</para>
+	/// <para>When the node reports that it is awake the held commands are sent, configuration first, then
+	/// association removals and additions, then values.  If the node goes back to sleep before they are
+	/// delivered, OpenZWave keeps them for its next wake-up.</para>
+	/// <para>Held commands are dropped if the queue is disposed.  Do not dispose it from a CommandSent handler.</para>
+	/// </remarks>
+	public ref class ZWWakeUpQueue sealed
+	{
+	public:
+		/// <summary>Creates a queue for a network.  ZWManager.Initialize must have been called.</summary>
+		/// <param name="homeId">The Home ID of the Z-Wave controller that manages the network.</param>
+		ZWWakeUpQueue(uint32 homeId);
+
+		/// <summary>Raised for every command sent, from a worker thread for held commands.</summary>
+		event CommandSentEventHandler^ CommandSent;
+
+		/// <summary>Gets the Home ID of the network.</summary>
+		property uint32 HomeId { uint32 get() { GetQueue(); return m_homeId; } }
+
+		/// <summary>Gets the number of commands held for every node.</summary>
+		property int32 PendingCount { int32 get() { return (int32)GetQueue()->GetPendingCount(); } }
+
+		/// <summary>Sets the state of a bool, or holds it until the node wakes up.</summary>
+		ZWQueueResult SetValue(ZWValueId^ id, bool value);
+		/// <summary>Sets the value of a byte, or holds it until the node wakes up.</summary>
+		ZWQueueResult SetValue(ZWValueId^ id, uint8 value);
+		/// <summary>Sets the value of a decimal, or holds it until the node wakes up.</summary>
+		ZWQueueResult SetValue(ZWValueId^ id, float value);
+		/// <summary>Sets the value of a 32-bit signed integer, or holds it until the node wakes up.</summary>
+		ZWQueueResult SetValue(ZWValueId^ id, int32 value);
+		/// <summary>Sets the value of a 16-bit signed integer, or holds it until the node wakes up.</summary>
+		ZWQueueResult SetValue(ZWValueId^ id, int16 value);
+		/// <summary>Sets the value from a string, or holds it until the node wakes up.</summary>
+		ZWQueueResult SetValue(ZWValueId^ id, String^ value);
+
+		/// <summary>Sets a configuration parameter, or holds it until the node wakes up.</summary>
+		/// <param name="nodeId">The ID of the node to configure.</param>
+		/// <param name="param">The index of the parameter.</param>
+		/// <param name="value">The value to which the parameter should be set.</param>
+		/// <param name="size">The size of the parameter in bytes: 1, 2 or 4.</param>
+		ZWQueueResult SetConfigParam(uint8 nodeId, uint8 param, int32 value, uint8 size);
+
+		/// <summary>Adds a node to an association group, or holds the change until the node wakes up.</summary>
+		ZWQueueResult AddAssociation(uint8 nodeId, uint8 groupIdx, uint8 targetNodeId);
+
+		/// <summary>Removes a node from an association group, or holds the change until the node wakes up.</summary>
+		ZWQueueResult RemoveAssociation(uint8 nodeId, uint8 groupIdx, uint8 targetNodeId);
+
+		/// <summary>Gets the commands held for a node, in the order they will be sent.</summary>
+		/// <param name="nodeId">The ID of the node, or 0 for every node.</param>
+#if __cplusplus_cli
+		cli::array<ZWPendingCommand>^ GetPending(uint8 nodeId);
+#else
+		Platform::Array<ZWPendingCommand>^ GetPending(uint8 nodeId);
+#endif
+
+		/// <summary>Sends a node's held commands now, without waiting for it to wake up.</summary>
+		/// <remarks>For a node that is still asleep the commands go to OpenZWave's own wake-up queue.</remarks>
+		void Flush(uint8 nodeId) { GetQueue()->Flush(nodeId); }
+
+		/// <summary>Drops a node's held commands.</summary>
+		/// <returns>The number of commands dropped.</returns>
+		int32 Cancel(uint8 nodeId) { return (int32)GetQueue()->Cancel(nodeId); }
+
+#if __cplusplus_cli
+		/// <summary>Drops the held commands and releases the queue's timer.  Later calls throw ObjectDisposedException.</summary>
+		~ZWWakeUpQueue() { this->!ZWWakeUpQueue(); }
+#endif
+
+	private:
+#if __cplusplus_cli
+		!ZWWakeUpQueue()
+#else
+		~ZWWakeUpQueue()
+#endif
+		{
+			delete m_queue;
+			m_queue = NULL;
+		}
+
+		Native::WakeUpQueue* GetQueue() { return CheckDisposed(m_queue, L"ZWWakeUpQueue"); }
+
+		static Native::PendingCommand ValueCommand(ZWValueId^ id, Native::PendingValueType type);
+		static ZWPendingCommand ConvertCommand(Native::PendingCommand const& _command, uint32 _waitedMs);
+
+#if __cplusplus_cli
+		void OnCommandSentFromUnmanaged(Native::PendingCommand const* _command, bool _success, uint32 _waitedMs, void* _context);
+
+		OnCommandSentFromUnmanagedDelegate^	m_onCommandSent;
+#else
+	internal:
+		static void OnCommandSentFromUnmanaged(Native::PendingCommand const* _command, bool _success, uint32 _waitedMs, void* _context);
+
+	private:
+#endif
+		uint32						m_homeId;
+		Native::WakeUpQueue*		m_queue;
+	};
+}
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 // Platform includes
+// winsock2.h first, or Windows.h brings in the older winsock.h
+#include <winsock2.h>
 #include "Windows.h"
 #include "stdio.h"
 
@@ -26,6 +28,7 @@
 #include "Options.h"
 #include "ValueID.h"
 #include "Driver.h"
+#include "Node.h"
 #include "Log.h"
 
 //UWP